@@ -7,6 +7,7 @@
 #include <glm/gtc/type_ptr.hpp>
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#include "sphereShader/src/TexturePacker.h"
 
 using namespace std;
 using namespace glm;
@@ -14,14 +15,14 @@ using namespace glm;
 const char* fragmentShaderSource = R"(
 #version 330 core
 in vec2 TexCoords;
+flat in float Layer;
 out vec4 FragColor;  // Changed from 'color' to standard 'FragColor'
 
-uniform sampler2D textures[5];
-uniform int faceIndex;  // Added uniform for face selection
+uniform sampler2DArray textures;  // one layer per face image
 
 void main()
 {
-    FragColor = texture(textures[faceIndex], TexCoords);
+    FragColor = texture(textures, vec3(TexCoords, Layer));
 }
 )";
 
@@ -29,42 +30,93 @@ const char* vertexShaderSource = R"(
 #version 330 core
 layout(location = 0) in vec3 vertexPosition_modelspace;
 layout(location = 1) in vec2 vertexTexCoords;
+layout(location = 2) in float vertexLayer;
 
 out vec2 TexCoords;
+flat out float Layer;
 
 uniform mat4 MVP;  // Removed duplicate 'model' uniform
 
 void main()
 {
     TexCoords = vertexTexCoords;
+    Layer = vertexLayer;
     gl_Position = MVP * vec4(vertexPosition_modelspace, 1.0);
 }
 )";
 
-GLuint loadTexture(const char* filename) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    int width, height, nrChannels;
-    unsigned char* data = stbi_load(filename, &width, &height, &nrChannels, 0);
-    if (data) {
-        GLenum format = (nrChannels == 3) ? GL_RGB : GL_RGBA;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+// Loads the images into one GL_TEXTURE_2D_ARRAY, one layer each, so all faces
+// are drawn with a single bind and draw call. The layers are the size of the
+// largest image; smaller images keep their size and have their edges repeated
+// to the end of the layer, so their texture coordinates are remapped by the
+// packer. An image that fails to load becomes a gray pixel.
+GLuint loadTextureArray(const vector<const char*>& filenames, Image::TexturePacker& packer) {
+    vector<unsigned char*> images;
+    unsigned char gray[3] = {128, 128, 128};
+    for (const char* filename : filenames) {
+        int width, height, nrChannels;
+        unsigned char* data = stbi_load(filename, &width, &height, &nrChannels, 3);
+        if (data) {
+            packer.add(width, height, data);
+        } else {
+            std::cerr << "Failed to load texture: " << filename << std::endl;
+            packer.add(1, 1, gray);
+        }
+        images.push_back(data);
+    }
+
+    GLuint textureID = 0;
+    if (packer.packArray()) {
+        int width = packer.getPageWidth();
+        int height = packer.getPageHeight();
+        int layers = packer.getPageCount();
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGB8, width, height, layers, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+
+        vector<unsigned char> layer(packer.getPageSize(3));
+        for (int i = 0; i < layers; ++i) {
+            packer.buildPage(i, 3, layer.data());
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, GL_RGB, GL_UNSIGNED_BYTE, layer.data());
+        }
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+        // clamp, the remapped coordinates of smaller images cannot repeat
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     } else {
-        std::cerr << "Failed to load texture: " << filename << std::endl;
+        std::cerr << "Failed to pack textures: " << packer.getError() << std::endl;
     }
 
-    stbi_image_free(data);
+    for (unsigned char* data : images)
+        stbi_image_free(data);
     return textureID;
 }
 
+// Remaps the texture coordinates of each face into its image of the packer,
+// and returns the layer of each vertex.
+vector<GLfloat> remapTexCoords(vector<GLfloat>& texCoords, const Image::TexturePacker& packer) {
+    // first vertex and vertex count of each face, and its image
+    const int faces[5][3] = {
+        {0, 4, 4},      // base
+        {4, 3, 0},
+        {7, 3, 1},
+        {10, 3, 2},
+        {13, 3, 3},
+    };
+
+    vector<GLfloat> layers(texCoords.size() / 2);
+    for (const auto& face : faces) {
+        packer.remapUvs(face[2], &texCoords[face[0] * 2], face[1]);
+        for (int i = 0; i < face[1]; ++i)
+            layers[face[0] + i] = (GLfloat)packer.getPage(face[2]);
+    }
+    return layers;
+}
+
 
 vector<GLfloat> createPyramid(const vec3& c, float baseSize, float height) {
     float half = baseSize / 2.0f;
@@ -196,24 +248,21 @@ int main() {
 
     vec3 pyramidCenter(0.0f, 0.0f, 0.0f);
 
-    // creating list of textures for each face
-    GLuint texture1 = loadTexture("texture1.jpg");
-    GLuint texture2 = loadTexture("texture2.jpg");
-    GLuint texture3 = loadTexture("texture3.jpg");
-    GLuint texture4 = loadTexture("texture4.jpg");
-    GLuint textureBase = loadTexture("textureBase.jpg");
-    GLuint textures[] = {texture1, texture2, texture3, texture4, textureBase};
-    int numIdenticalFaces = 4;
+    // one texture array for all faces: four sides, then the base
+    Image::TexturePacker packer;
+    GLuint textureArray = loadTextureArray({"wood1.jpg", "wood2.jpg", "wood3.jpg", "wood4.jpg", "wall.jpg"}, packer);
 
     vector<GLfloat> pyramidVertices = createPyramid(pyramidCenter, 1.0f, 1.5f);
     vector<GLuint> pyramidIndices = createPyramidIndices();
     vector<GLfloat> pyramidTexCoords = createTexCoords();
+    vector<GLfloat> pyramidLayers = remapTexCoords(pyramidTexCoords, packer);
 
-    GLuint VBO, VAO, EBO, TBO;
+    GLuint VBO, VAO, EBO, TBO, LBO;
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
     glGenBuffers(1, &TBO);
+    glGenBuffers(1, &LBO);
 
     glBindVertexArray(VAO);
 
@@ -232,6 +281,12 @@ int main() {
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
     glEnableVertexAttribArray(1);
 
+    glBindBuffer(GL_ARRAY_BUFFER, LBO);
+    glBufferData(GL_ARRAY_BUFFER, pyramidLayers.size() * sizeof(GLfloat), pyramidLayers.data(), GL_STATIC_DRAW);
+
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), (GLvoid*)0);
+    glEnableVertexAttribArray(2);
+
     glBindVertexArray(0);
 
     GLuint shaderProgram = createShaderProgram(fragmentShaderSource);
@@ -256,7 +311,9 @@ int main() {
     mat4 MVP = Projection * View * Model;
 
     GLuint MVPLocation = glGetUniformLocation(shaderProgram, "MVP");
+    glUseProgram(shaderProgram);
     glUniformMatrix4fv(MVPLocation, 1, GL_FALSE, value_ptr(MVP));
+    glUniform1i(glGetUniformLocation(shaderProgram, "textures"), 0);
 
     glViewport(0, 0, 1024, 768);
 
@@ -272,25 +329,10 @@ int main() {
         MVP = Projection * View * Model;
         glUniformMatrix4fv(MVPLocation, 1, GL_FALSE, value_ptr(MVP));
 
-        // Bind all textures at once
-        for (int i = 0; i < 5; ++i) {
-            glActiveTexture(GL_TEXTURE0 + i);
-            glBindTexture(GL_TEXTURE_2D, textures[i]);
-            glUniform1i(glGetUniformLocation(shaderProgram, ("textures[" + to_string(i) + "]").c_str()), i);
-        }
-
-        // Draw the pyramid faces
-        GLint faceIndexLoc = glGetUniformLocation(shaderProgram, "faceIndex");
-        
-        // Draw the four side faces
-        for (int i = 0; i < 4; ++i) {
-            glUniform1i(faceIndexLoc, i);
-            glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, (void*)(i * 3 * sizeof(GLuint)));
-        }
-
-        // Draw the base face
-        glUniform1i(faceIndexLoc, 4);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(12 * sizeof(GLuint)));
+        // One bind and one draw for all faces, the layer comes with each vertex
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+        glDrawElements(GL_TRIANGLES, (GLsizei)pyramidIndices.size(), GL_UNSIGNED_INT, (void*)0);
 
         glfwSwapBuffers(window);
         glfwPollEvents();
@@ -299,6 +341,9 @@ int main() {
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+    glDeleteBuffers(1, &TBO);
+    glDeleteBuffers(1, &LBO);
+    glDeleteTextures(1, &textureArray);
 
     glfwTerminate();
     return 0;
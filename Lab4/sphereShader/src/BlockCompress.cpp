@@ -0,0 +1,795 @@
+///////////////////////////////////////////////////////////////////////////////
+// BlockCompress.cpp
+// =================
+// BC1 (DXT1), BC3 (DXT5) and BC4 (RGTC1) block compression of 8-bit images
+// The color indices are chosen by the squared RGB distance to the 4 decoded
+// palette colors, 4 pixels at a time with SSE2. The palettes are built the
+// same way as decodeBlocks(), (2 * c0 + c1) / 3 etc. with integer division,
+// so the errors measured by the encoder are the errors of the decoder.
+//
+// Dependencies: MipChain, ThreadPool
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "BlockCompress.h"
+#include "MipChain.h"
+#include "ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLOCK_SSE2  1
+#include <emmintrin.h>
+#endif
+
+namespace Image
+{
+
+// minimum rows of blocks per band for the thread pool
+const int MIN_BAND_BLOCK_ROWS = 4;
+
+// 16 pixels of a block as separate channels for SIMD
+struct ColorBlock
+{
+    float r[16];
+    float g[16];
+    float b[16];
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// 565 color <-> 8-bit RGB
+///////////////////////////////////////////////////////////////////////////////
+static inline int quantize565(const float color[3])
+{
+    int r = (int)(color[0] * (31 / 255.0f) + 0.5f);
+    int g = (int)(color[1] * (63 / 255.0f) + 0.5f);
+    int b = (int)(color[2] * (31 / 255.0f) + 0.5f);
+    r = (r < 0) ? 0 : (r > 31 ? 31 : r);
+    g = (g < 0) ? 0 : (g > 63 ? 63 : g);
+    b = (b < 0) ? 0 : (b > 31 ? 31 : b);
+    return (r << 11) | (g << 5) | b;
+}
+
+static inline void expand565(int color, int rgb[3])
+{
+    int r = (color >> 11) & 31;
+    int g = (color >> 5) & 63;
+    int b = color & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+// 4 colors of c0 > c1 (or always), or 3 colors and black of c0 <= c1
+static void buildColorPalette(int c0, int c1, bool fourColors, int palette[4][3])
+{
+    expand565(c0, palette[0]);
+    expand565(c1, palette[1]);
+    for(int i = 0; i < 3; ++i)
+    {
+        if(fourColors || c0 > c1)
+        {
+            palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+            palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+        }
+        else
+        {
+            palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+            palette[3][i] = 0;
+        }
+    }
+}
+
+// 8 values of a0 > a1, or 6 values, 0 and 255 of a0 <= a1
+static void buildAlphaPalette(int a0, int a1, int palette[8])
+{
+    palette[0] = a0;
+    palette[1] = a1;
+    if(a0 > a1)
+    {
+        for(int i = 2; i < 8; ++i)
+            palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+    }
+    else
+    {
+        for(int i = 2; i < 6; ++i)
+            palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// choose the nearest palette color of each pixel, return the squared error
+///////////////////////////////////////////////////////////////////////////////
+static int selectColorIndices(const ColorBlock& block, const int palette[4][3], unsigned char indices[16])
+{
+#if defined(BLOCK_SSE2)
+    __m128 total = _mm_setzero_ps();
+    for(int i = 0; i < 16; i += 4)
+    {
+        __m128 r = _mm_loadu_ps(block.r + i);
+        __m128 g = _mm_loadu_ps(block.g + i);
+        __m128 b = _mm_loadu_ps(block.b + i);
+        __m128 best = _mm_set1_ps(1e30f);
+        __m128i bestIndex = _mm_setzero_si128();
+        for(int k = 0; k < 4; ++k)
+        {
+            __m128 dr = _mm_sub_ps(r, _mm_set1_ps((float)palette[k][0]));
+            __m128 dg = _mm_sub_ps(g, _mm_set1_ps((float)palette[k][1]));
+            __m128 db = _mm_sub_ps(b, _mm_set1_ps((float)palette[k][2]));
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+            __m128i less = _mm_castps_si128(_mm_cmplt_ps(d, best));
+            best = _mm_min_ps(d, best);
+            bestIndex = _mm_or_si128(_mm_andnot_si128(less, bestIndex), _mm_and_si128(less, _mm_set1_epi32(k)));
+        }
+        total = _mm_add_ps(total, best);
+
+        // 4 indices in the low bytes of 32-bit lanes
+        __m128i packed = _mm_packs_epi32(bestIndex, bestIndex);
+        packed = _mm_packus_epi16(packed, packed);
+        int four = _mm_cvtsi128_si32(packed);
+        memcpy(indices + i, &four, 4);
+    }
+    // the errors are integers below 2^24, so the float sum is exact
+    float sums[4];
+    _mm_storeu_ps(sums, total);
+    return (int)(sums[0] + sums[1] + sums[2] + sums[3]);
+#else
+    int error = 0;
+    for(int i = 0; i < 16; ++i)
+    {
+        int best = 0x7fffffff;
+        for(int k = 0; k < 4; ++k)
+        {
+            int dr = (int)block.r[i] - palette[k][0];
+            int dg = (int)block.g[i] - palette[k][1];
+            int db = (int)block.b[i] - palette[k][2];
+            int d = dr * dr + dg * dg + db * db;
+            if(d < best)
+            {
+                best = d;
+                indices[i] = (unsigned char)k;
+            }
+        }
+        error += best;
+    }
+    return error;
+#endif
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// indices by the position of each pixel between the endpoints (fast)
+///////////////////////////////////////////////////////////////////////////////
+static int projectColorIndices(const ColorBlock& block, const int palette[4][3], unsigned char indices[16])
+{
+    // 0, 1/3, 2/3, 1 from c1 to c0 are indices 1, 3, 2, 0
+    static const unsigned char ORDER[4] = { 1, 3, 2, 0 };
+    float dir[3], length = 0;
+    for(int i = 0; i < 3; ++i)
+    {
+        dir[i] = (float)(palette[0][i] - palette[1][i]);
+        length += dir[i] * dir[i];
+    }
+    float scale = (length > 0) ? 3 / length : 0;
+
+    int error = 0;
+    for(int i = 0; i < 16; ++i)
+    {
+        float t = ((block.r[i] - palette[1][0]) * dir[0] + (block.g[i] - palette[1][1]) * dir[1] +
+                   (block.b[i] - palette[1][2]) * dir[2]) * scale;
+        int q = (int)(t + 0.5f);
+        q = (q < 0) ? 0 : (q > 3 ? 3 : q);
+        int k = ORDER[q];
+        indices[i] = (unsigned char)k;
+
+        int dr = (int)block.r[i] - palette[k][0];
+        int dg = (int)block.g[i] - palette[k][1];
+        int db = (int)block.b[i] - palette[k][2];
+        error += dr * dr + dg * dg + db * db;
+    }
+    return error;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// endpoints on the principal axis of the colors
+// The axis is found by power iteration of the covariance matrix, and the
+// endpoints are the pixels with the min and max projection on it.
+///////////////////////////////////////////////////////////////////////////////
+static void computeAxisEndpoints(const ColorBlock& block, float e0[3], float e1[3])
+{
+    const float* channels[3] = { block.r, block.g, block.b };
+    float mean[3], minColor[3], maxColor[3];
+    for(int c = 0; c < 3; ++c)
+    {
+        mean[c] = 0;
+        minColor[c] = maxColor[c] = channels[c][0];
+        for(int i = 0; i < 16; ++i)
+        {
+            mean[c] += channels[c][i];
+            minColor[c] = (channels[c][i] < minColor[c]) ? channels[c][i] : minColor[c];
+            maxColor[c] = (channels[c][i] > maxColor[c]) ? channels[c][i] : maxColor[c];
+        }
+        mean[c] /= 16;
+    }
+
+    float cov[6] = {0, 0, 0, 0, 0, 0};     // rr, rg, rb, gg, gb, bb
+    for(int i = 0; i < 16; ++i)
+    {
+        float r = block.r[i] - mean[0];
+        float g = block.g[i] - mean[1];
+        float b = block.b[i] - mean[2];
+        cov[0] += r * r;
+        cov[1] += r * g;
+        cov[2] += r * b;
+        cov[3] += g * g;
+        cov[4] += g * b;
+        cov[5] += b * b;
+    }
+
+    float axis[3] = { maxColor[0] - minColor[0], maxColor[1] - minColor[1], maxColor[2] - minColor[2] };
+    for(int iteration = 0; iteration < 4; ++iteration)
+    {
+        float x = axis[0] * cov[0] + axis[1] * cov[1] + axis[2] * cov[2];
+        float y = axis[0] * cov[1] + axis[1] * cov[3] + axis[2] * cov[4];
+        float z = axis[0] * cov[2] + axis[1] * cov[4] + axis[2] * cov[5];
+        float m = fabsf(x) > fabsf(y) ? fabsf(x) : fabsf(y);
+        m = fabsf(z) > m ? fabsf(z) : m;
+        if(m < 1e-6f)
+            break;          // solid color, keep the current axis
+        axis[0] = x / m;
+        axis[1] = y / m;
+        axis[2] = z / m;
+    }
+
+    int minIndex = 0, maxIndex = 0;
+    float minDot = 1e30f, maxDot = -1e30f;
+    for(int i = 0; i < 16; ++i)
+    {
+        float d = block.r[i] * axis[0] + block.g[i] * axis[1] + block.b[i] * axis[2];
+        if(d < minDot)
+        {
+            minDot = d;
+            minIndex = i;
+        }
+        if(d > maxDot)
+        {
+            maxDot = d;
+            maxIndex = i;
+        }
+    }
+    e0[0] = block.r[maxIndex];
+    e0[1] = block.g[maxIndex];
+    e0[2] = block.b[maxIndex];
+    e1[0] = block.r[minIndex];
+    e1[1] = block.g[minIndex];
+    e1[2] = block.b[minIndex];
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// endpoints of the bounding box, inset by 1/16 of the range
+///////////////////////////////////////////////////////////////////////////////
+static void computeBoxEndpoints(const ColorBlock& block, float e0[3], float e1[3])
+{
+    const float* channels[3] = { block.r, block.g, block.b };
+    for(int c = 0; c < 3; ++c)
+    {
+        float minValue = channels[c][0], maxValue = channels[c][0];
+        for(int i = 1; i < 16; ++i)
+        {
+            minValue = (channels[c][i] < minValue) ? channels[c][i] : minValue;
+            maxValue = (channels[c][i] > maxValue) ? channels[c][i] : maxValue;
+        }
+        float inset = (maxValue - minValue) / 16;
+        e0[c] = maxValue - inset;
+        e1[c] = minValue + inset;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// least squares endpoints for the given indices, false if it is singular
+// Each pixel is w * e0 + (1 - w) * e1 with w = 1, 0, 2/3, 1/3 by its index.
+///////////////////////////////////////////////////////////////////////////////
+static bool solveEndpoints(const ColorBlock& block, const unsigned char indices[16], float e0[3], float e1[3])
+{
+    static const float WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3, 1.0f / 3 };
+    float aa = 0, bb = 0, ab = 0;
+    float ax[3] = {0, 0, 0}, bx[3] = {0, 0, 0};
+    for(int i = 0; i < 16; ++i)
+    {
+        float a = WEIGHTS[indices[i]];
+        float b = 1 - a;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        ax[0] += a * block.r[i];
+        ax[1] += a * block.g[i];
+        ax[2] += a * block.b[i];
+        bx[0] += b * block.r[i];
+        bx[1] += b * block.g[i];
+        bx[2] += b * block.b[i];
+    }
+
+    float det = aa * bb - ab * ab;
+    if(fabsf(det) < 1e-6f)
+        return false;
+
+    for(int c = 0; c < 3; ++c)
+    {
+        e0[c] = (ax[c] * bb - bx[c] * ab) / det;
+        e1[c] = (bx[c] * aa - ax[c] * ab) / det;
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// quantize the endpoints in 4-color mode (c0 > c1) and choose the indices
+// c0 and c1 are swapped if needed, and made different if they are the same.
+///////////////////////////////////////////////////////////////////////////////
+static int fitEndpoints(const ColorBlock& block, const float e0[3], const float e1[3], bool project,
+                        int& c0, int& c1, unsigned char indices[16])
+{
+    c0 = quantize565(e0);
+    c1 = quantize565(e1);
+    if(c0 < c1)
+    {
+        int t = c0;
+        c0 = c1;
+        c1 = t;
+    }
+    else if(c0 == c1)
+    {
+        if(c1 > 0)
+            --c1;
+        else
+            ++c0;
+    }
+
+    int palette[4][3];
+    buildColorPalette(c0, c1, true, palette);
+    return project ? projectColorIndices(block, palette, indices) : selectColorIndices(block, palette, indices);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// encode RGB of 16 RGBA pixels to 8 bytes
+///////////////////////////////////////////////////////////////////////////////
+static void encodeColorBlock(const unsigned char* pixels, BlockQuality quality, unsigned char* dst)
+{
+    ColorBlock block;
+    for(int i = 0; i < 16; ++i)
+    {
+        block.r[i] = pixels[i*4];
+        block.g[i] = pixels[i*4+1];
+        block.b[i] = pixels[i*4+2];
+    }
+
+    float e0[3], e1[3];
+    int c0, c1, error;
+    unsigned char indices[16];
+    if(quality == QUALITY_FAST)
+    {
+        computeBoxEndpoints(block, e0, e1);
+        error = fitEndpoints(block, e0, e1, true, c0, c1, indices);
+    }
+    else
+    {
+        computeAxisEndpoints(block, e0, e1);
+        error = fitEndpoints(block, e0, e1, false, c0, c1, indices);
+
+        if(quality == QUALITY_HIGH)
+        {
+            int boxC0, boxC1;
+            unsigned char boxIndices[16];
+            computeBoxEndpoints(block, e0, e1);
+            int boxError = fitEndpoints(block, e0, e1, false, boxC0, boxC1, boxIndices);
+            if(boxError < error)
+            {
+                error = boxError;
+                c0 = boxC0;
+                c1 = boxC1;
+                memcpy(indices, boxIndices, 16);
+            }
+        }
+
+        // refine the endpoints with the indices while the error decreases
+        int iterationCount = (quality == QUALITY_HIGH) ? 3 : 1;
+        for(int i = 0; i < iterationCount && error > 0; ++i)
+        {
+            int newC0, newC1;
+            unsigned char newIndices[16];
+            if(!solveEndpoints(block, indices, e0, e1))
+                break;
+            int newError = fitEndpoints(block, e0, e1, false, newC0, newC1, newIndices);
+            if(newError >= error)
+                break;
+            error = newError;
+            c0 = newC0;
+            c1 = newC1;
+            memcpy(indices, newIndices, 16);
+        }
+    }
+
+    unsigned int bits = 0;
+    for(int i = 0; i < 16; ++i)
+        bits |= (unsigned int)indices[i] << (i * 2);
+    dst[0] = (unsigned char)c0;
+    dst[1] = (unsigned char)(c0 >> 8);
+    dst[2] = (unsigned char)c1;
+    dst[3] = (unsigned char)(c1 >> 8);
+    dst[4] = (unsigned char)bits;
+    dst[5] = (unsigned char)(bits >> 8);
+    dst[6] = (unsigned char)(bits >> 16);
+    dst[7] = (unsigned char)(bits >> 24);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// choose the nearest of 8 values for each pixel, return the squared error
+///////////////////////////////////////////////////////////////////////////////
+static int selectAlphaIndices(const unsigned char values[16], const int palette[8], unsigned char indices[16])
+{
+    int error = 0;
+    for(int i = 0; i < 16; ++i)
+    {
+        int best = 0x7fffffff;
+        for(int k = 0; k < 8; ++k)
+        {
+            int d = (values[i] - palette[k]) * (values[i] - palette[k]);
+            if(d < best)
+            {
+                best = d;
+                indices[i] = (unsigned char)k;
+            }
+        }
+        error += best;
+    }
+    return error;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// encode 16 values to 8 bytes, BC4 or the alpha of BC3
+///////////////////////////////////////////////////////////////////////////////
+static void encodeAlphaBlock(const unsigned char values[16], BlockQuality quality, unsigned char* dst)
+{
+    int minValue = values[0], maxValue = values[0];
+    for(int i = 1; i < 16; ++i)
+    {
+        minValue = (values[i] < minValue) ? values[i] : minValue;
+        maxValue = (values[i] > maxValue) ? values[i] : maxValue;
+    }
+
+    // 8-value mode, a0 = max > a1 = min
+    int a0 = maxValue, a1 = minValue;
+    unsigned char indices[16];
+    if(a0 == a1)
+    {
+        memset(indices, 0, 16);
+    }
+    else if(quality == QUALITY_FAST)
+    {
+        // 0~7 from min to max are indices 1, 7, 6, ... 2, 0
+        int range = a0 - a1;
+        for(int i = 0; i < 16; ++i)
+        {
+            int t = ((values[i] - a1) * 7 + range / 2) / range;
+            indices[i] = (unsigned char)((t == 7) ? 0 : (t == 0 ? 1 : 8 - t));
+        }
+    }
+    else
+    {
+        int palette[8];
+        buildAlphaPalette(a0, a1, palette);
+        int error = selectAlphaIndices(values, palette, indices);
+
+        // 6-value mode between the values except 0 and 255, which are exact
+        if(quality == QUALITY_HIGH && error > 0 && (minValue == 0 || maxValue == 255))
+        {
+            int low = 255, high = 0;
+            for(int i = 0; i < 16; ++i)
+            {
+                if(values[i] != 0 && values[i] != 255)
+                {
+                    low = (values[i] < low) ? values[i] : low;
+                    high = (values[i] > high) ? values[i] : high;
+                }
+            }
+            if(low > high)
+                low = high = 0;     // only 0 and 255
+
+            unsigned char indices6[16];
+            buildAlphaPalette(low, high, palette);
+            if(selectAlphaIndices(values, palette, indices6) < error)
+            {
+                a0 = low;
+                a1 = high;
+                memcpy(indices, indices6, 16);
+            }
+        }
+    }
+
+    unsigned long long bits = 0;
+    for(int i = 0; i < 16; ++i)
+        bits |= (unsigned long long)indices[i] << (i * 3);
+    dst[0] = (unsigned char)a0;
+    dst[1] = (unsigned char)a1;
+    for(int i = 0; i < 6; ++i)
+        dst[i + 2] = (unsigned char)(bits >> (i * 8));
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// decode 8 bytes of color to 16 RGBA pixels
+///////////////////////////////////////////////////////////////////////////////
+static void decodeColorBlock(const unsigned char* src, bool fourColors, unsigned char* pixels)
+{
+    int c0 = src[0] | (src[1] << 8);
+    int c1 = src[2] | (src[3] << 8);
+    unsigned int bits = src[4] | (src[5] << 8) | (src[6] << 16) | ((unsigned int)src[7] << 24);
+
+    int palette[4][3];
+    buildColorPalette(c0, c1, fourColors, palette);
+    bool transparent = !fourColors && c0 <= c1;
+    for(int i = 0; i < 16; ++i)
+    {
+        int k = (bits >> (i * 2)) & 3;
+        pixels[i*4]   = (unsigned char)palette[k][0];
+        pixels[i*4+1] = (unsigned char)palette[k][1];
+        pixels[i*4+2] = (unsigned char)palette[k][2];
+        pixels[i*4+3] = (transparent && k == 3) ? 0 : 255;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// decode 8 bytes to 16 values
+///////////////////////////////////////////////////////////////////////////////
+static void decodeAlphaBlock(const unsigned char* src, unsigned char values[16])
+{
+    int palette[8];
+    buildAlphaPalette(src[0], src[1], palette);
+
+    unsigned long long bits = 0;
+    for(int i = 0; i < 6; ++i)
+        bits |= (unsigned long long)src[i + 2] << (i * 8);
+    for(int i = 0; i < 16; ++i)
+        values[i] = (unsigned char)palette[(bits >> (i * 3)) & 7];
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// copy a 4x4 block to 16 RGBA pixels, repeating the edge pixels
+///////////////////////////////////////////////////////////////////////////////
+static void loadBlock(const unsigned char* src, int width, int height, int channelCount,
+                      int blockX, int blockY, unsigned char* pixels)
+{
+    for(int y = 0; y < 4; ++y)
+    {
+        int sy = blockY * 4 + y;
+        sy = (sy < height) ? sy : height - 1;
+        for(int x = 0; x < 4; ++x)
+        {
+            int sx = blockX * 4 + x;
+            sx = (sx < width) ? sx : width - 1;
+            const unsigned char* p = src + ((std::size_t)sy * width + sx) * channelCount;
+            unsigned char* d = pixels + (y * 4 + x) * 4;
+            d[0] = p[0];
+            d[1] = (channelCount == 1) ? p[0] : p[1];
+            d[2] = (channelCount == 1) ? p[0] : p[2];
+            d[3] = (channelCount == 4) ? p[3] : 255;
+        }
+    }
+}
+
+// copy 16 RGBA pixels to the image, except outside of the image
+static void storeBlock(const unsigned char* pixels, int blockX, int blockY, unsigned char* dst,
+                       int width, int height, int channelCount)
+{
+    for(int y = 0; y < 4 && blockY * 4 + y < height; ++y)
+    {
+        for(int x = 0; x < 4 && blockX * 4 + x < width; ++x)
+        {
+            const unsigned char* p = pixels + (y * 4 + x) * 4;
+            unsigned char* d = dst + ((std::size_t)(blockY * 4 + y) * width + blockX * 4 + x) * channelCount;
+            for(int i = 0; i < channelCount; ++i)
+                d[i] = p[i];
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// block format for the number of channels, and the size of the blocks
+///////////////////////////////////////////////////////////////////////////////
+BlockFormat getBlockFormat(int channelCount)
+{
+    if(channelCount == 1)
+        return BLOCK_BC4;
+    else if(channelCount == 4)
+        return BLOCK_BC3;
+    else
+        return BLOCK_BC1;
+}
+
+std::size_t getBlockDataSize(BlockFormat format, int width, int height)
+{
+    std::size_t blockCount = (std::size_t)((width + 3) / 4) * ((height + 3) / 4);
+    return blockCount * ((format == BLOCK_BC3) ? 16 : 8);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// encode all blocks, in bands of block rows if pool is given
+///////////////////////////////////////////////////////////////////////////////
+void encodeBlocks(const unsigned char* src, int width, int height, int channelCount, BlockFormat format,
+                  unsigned char* dst, BlockQuality quality, ThreadPool* pool)
+{
+    const int blockWidth = (width + 3) / 4;
+    const int blockHeight = (height + 3) / 4;
+    const int blockSize = (format == BLOCK_BC3) ? 16 : 8;
+
+    auto encodeRows = [=](int first, int last)
+    {
+        unsigned char pixels[64];
+        unsigned char values[16];
+        for(int by = first; by < last; ++by)
+        {
+            for(int bx = 0; bx < blockWidth; ++bx)
+            {
+                loadBlock(src, width, height, channelCount, bx, by, pixels);
+                unsigned char* block = dst + ((std::size_t)by * blockWidth + bx) * blockSize;
+                if(format == BLOCK_BC1)
+                {
+                    encodeColorBlock(pixels, quality, block);
+                }
+                else
+                {
+                    int channel = (format == BLOCK_BC4) ? 0 : 3;
+                    for(int i = 0; i < 16; ++i)
+                        values[i] = pixels[i*4 + channel];
+                    encodeAlphaBlock(values, quality, block);
+                    if(format == BLOCK_BC3)
+                        encodeColorBlock(pixels, quality, block + 8);
+                }
+            }
+        }
+    };
+
+    if(pool)
+        pool->parallelFor(blockHeight, encodeRows, MIN_BAND_BLOCK_ROWS);
+    else
+        encodeRows(0, blockHeight);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// decode all blocks to an image with channelCount channels
+///////////////////////////////////////////////////////////////////////////////
+void decodeBlocks(const unsigned char* src, int width, int height, BlockFormat format,
+                  unsigned char* dst, int channelCount)
+{
+    const int blockWidth = (width + 3) / 4;
+    const int blockHeight = (height + 3) / 4;
+    const int blockSize = (format == BLOCK_BC3) ? 16 : 8;
+
+    unsigned char pixels[64];
+    unsigned char values[16];
+    for(int by = 0; by < blockHeight; ++by)
+    {
+        for(int bx = 0; bx < blockWidth; ++bx)
+        {
+            const unsigned char* block = src + ((std::size_t)by * blockWidth + bx) * blockSize;
+            if(format == BLOCK_BC4)
+            {
+                decodeAlphaBlock(block, values);
+                for(int i = 0; i < 16; ++i)
+                {
+                    pixels[i*4] = pixels[i*4+1] = pixels[i*4+2] = values[i];
+                    pixels[i*4+3] = 255;
+                }
+            }
+            else if(format == BLOCK_BC3)
+            {
+                decodeColorBlock(block + 8, true, pixels);
+                decodeAlphaBlock(block, values);
+                for(int i = 0; i < 16; ++i)
+                    pixels[i*4+3] = values[i];
+            }
+            else
+            {
+                decodeColorBlock(block, false, pixels);
+            }
+            storeBlock(pixels, bx, by, dst, width, height, channelCount);
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// PSNR = 10 * log10(255^2 / mean squared error)
+///////////////////////////////////////////////////////////////////////////////
+double computePSNR(const unsigned char* data1, const unsigned char* data2, std::size_t count)
+{
+    unsigned long long sum = 0;
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        int d = data1[i] - data2[i];
+        sum += d * d;
+    }
+    if(sum == 0)
+        return std::numeric_limits<double>::infinity();
+    return 10.0 * log10(255.0 * 255.0 * count / (double)sum);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// CompressedChain
+///////////////////////////////////////////////////////////////////////////////
+CompressedChain::CompressedChain() : format(BLOCK_BC1)
+{
+}
+
+bool CompressedChain::build(const MipChain& mips, BlockFormat format, BlockQuality quality, ThreadPool* pool)
+{
+    clear();
+    if(mips.getLevelCount() == 0)
+    {
+        errorMessage = "The mip chain is empty.";
+        return false;
+    }
+    this->format = format;
+
+    std::size_t size = 0;
+    for(int i = 0; i < mips.getLevelCount(); ++i)
+    {
+        Level level = { mips.getWidth(i), mips.getHeight(i), size };
+        levels.push_back(level);
+        size += getBlockDataSize(format, level.width, level.height);
+    }
+
+    buffer.resize(size);
+    for(int i = 0; i < mips.getLevelCount(); ++i)
+    {
+        encodeBlocks(mips.getData(i), mips.getWidth(i), mips.getHeight(i), mips.getChannelCount(), format,
+                     &buffer[levels[i].offset], quality, pool);
+    }
+    return true;
+}
+
+void CompressedChain::clear()
+{
+    levels.clear();
+    std::vector<unsigned char>().swap(buffer);
+    errorMessage.clear();
+}
+
+} // namespace Image
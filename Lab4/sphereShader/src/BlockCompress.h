@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+// BlockCompress.h
+// ===============
+// BC1 (DXT1), BC3 (DXT5) and BC4 (RGTC1) block compression of 8-bit images
+// The image is split into 4x4 blocks (edge pixels are repeated to fill the
+// blocks of the right and bottom edges), and each block is encoded to 8 bytes
+// (BC1, BC4) or 16 bytes (BC3), 4 to 8 times smaller than RGB/RGBA texels.
+// - BC1: opaque RGB, two 565 endpoints and 4 colors in between
+// - BC3: RGBA, BC4 block for alpha followed by BC1 block for RGB
+// - BC4: single channel (gray or red), two 8-bit endpoints and 8 values
+// The source is RGB(A) order, so use Bmp::read() with ORDER_RGB.
+//
+// Quality presets:
+// - QUALITY_FAST:   bounding box endpoints, indices by projection
+// - QUALITY_NORMAL: principal axis endpoints, 1 least squares refinement
+// - QUALITY_HIGH:   3 refinements, also tries bounding box and the 6-value
+//                   alpha mode, and keeps the smallest error
+// decodeBlocks() and computePSNR() check the quality on CPU.
+//
+// Dependencies: MipChain, ThreadPool
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef IMAGE_BLOCK_COMPRESS_H
+#define IMAGE_BLOCK_COMPRESS_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+class ThreadPool;
+
+namespace Image
+{
+    class MipChain;
+
+    enum BlockFormat
+    {
+        BLOCK_BC1 = 0,                              // 8 bytes per block
+        BLOCK_BC3,                                  // 16 bytes per block
+        BLOCK_BC4                                   // 8 bytes per block
+    };
+
+    enum BlockQuality
+    {
+        QUALITY_FAST = 0,
+        QUALITY_NORMAL,
+        QUALITY_HIGH
+    };
+
+    // BC4 for 1 channel, BC1 for 3 channels, BC3 for 4 channels
+    BlockFormat getBlockFormat(int channelCount);
+    std::size_t getBlockDataSize(BlockFormat format, int width, int height);
+
+    // encode an image with 1, 3 or 4 channels (BC4 takes the 1st channel)
+    // If pool is given, the rows of blocks are encoded by its threads.
+    void encodeBlocks(const unsigned char* src, int width, int height, int channelCount, BlockFormat format,
+                      unsigned char* dst, BlockQuality quality=QUALITY_NORMAL, ThreadPool* pool=0);
+
+    // decode blocks to an image with 1, 3 or 4 channels
+    // BC4 is copied to all color channels, alpha is 255 except BC3 and the
+    // transparent color of BC1 blocks in 3-color mode.
+    void decodeBlocks(const unsigned char* src, int width, int height, BlockFormat format,
+                      unsigned char* dst, int channelCount);
+
+    // peak signal to noise ratio in dB of 2 arrays of 8-bit values,
+    // infinity if they are identical
+    double computePSNR(const unsigned char* data1, const unsigned char* data2, std::size_t count);
+
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // all levels of a MipChain compressed in one buffer, level 0 first
+    ///////////////////////////////////////////////////////////////////////////
+    class CompressedChain
+    {
+    public:
+        CompressedChain();
+
+        bool build(const MipChain& mips, BlockFormat format, BlockQuality quality=QUALITY_NORMAL, ThreadPool* pool=0);
+        void clear();
+
+        BlockFormat getFormat() const               { return format; }
+        int  getLevelCount() const                  { return (int)levels.size(); }
+        int  getWidth(int level) const              { return levels[level].width; }
+        int  getHeight(int level) const             { return levels[level].height; }
+        const unsigned char* getData(int level) const { return &buffer[levels[level].offset]; }
+        std::size_t getDataSize(int level) const    { return getBlockDataSize(format, levels[level].width, levels[level].height); }
+
+        const unsigned char* getBuffer() const      { return buffer.empty() ? 0 : &buffer[0]; }
+        std::size_t getBufferSize() const           { return buffer.size(); }
+        const char* getError() const                { return errorMessage.c_str(); }
+
+    private:
+        struct Level
+        {
+            int width;
+            int height;
+            std::size_t offset;                     // in buffer
+        };
+
+        BlockFormat format;
+        std::vector<Level> levels;
+        std::vector<unsigned char> buffer;
+        std::string errorMessage;
+    };
+}
+
+#endif // IMAGE_BLOCK_COMPRESS_H
@@ -1,8 +1,18 @@
 // Bmp.cpp
 // =======
 // BMP image loader
-// It reads only 8/24/32-bit uncompressed and 8-bit RLE compression format.
+// It reads only 8/24/32-bit uncompressed and 8-bit/4-bit RLE compression format.
+// 4-bit RLE is decoded as 8-bit grayscale with the luma of its palette.
 //
+// 2026-10-19: Fixed overflow of row sizes in parseHeader() with large widths.
+// 2026-10-19: Added RLE4 decoding and RLE8 encoding in save().
+// 2026-10-19: save() writes packed header and bands with single system calls.
+// 2026-10-19: Added BmpReader/BmpWriter for streaming, save() writes by bands.
+// 2026-10-19: Decode row bands in parallel with ThreadPool, including RLE8.
+// 2026-10-19: Use PixelConvert for channel swizzles.
+// 2026-10-19: Decode rows in one pass with padding strip, flip and swizzle.
+// 2026-10-19: Create RGB copy lazily in getDataRGB(), added move ctor/assignment.
+// 2026-10-19: Read with memory mapped file and parse header from memory.
 // 2022-09-28: Added BITFIELDS=3 compression mode (RGBA with bit masks)
 // 2019-07-20: Fixed clearing memory in getColorCount()
 // 2018-08-10: Fixed dealloc memory in save()
@@ -15,15 +25,21 @@
 //
 //  AUTHOR: Song Ho Ahn (song.ahn@gmail.com)
 // CREATED: 2006-05-08
-// UPDATED: 2022-09-30
+// UPDATED: 2026-10-19
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <fstream>
 #include <iostream>
 #include <cstring>                      // for memcpy()
 #include <cstdlib>                      // for abs()
+#include <climits>                      // for INT_MAX, INT_MIN
 #include <bitset>                       // for bitset<>()
+#include <functional>
 #include "Bmp.h"
+#include "MappedFile.h"
+#include "PixelConvert.h"
+#include "ThreadPool.h"
+#include "BmpWriter.h"
 //using std::ifstream;
 //using std::ofstream;
 //using std::ios;
@@ -34,13 +50,41 @@ using namespace Image;
 // macro to swap 4-byte endian (big <-> little)
 #define SWAP4(x) (((x >> 24) & 0x000000FF) | ((x >> 8) & 0x0000FF00) | ((x << 8) & 0x00FF0000) | ((x << 24) & 0xFF000000)) 
 
+// read 4-byte little-endian value from unaligned memory
+static inline unsigned int readInt32(const unsigned char* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+// copy and fill RLE spans (< 256 bytes) 8 bytes at a time
+// The compiler expands memcpy()/memset() of a count known to be small into
+// rep movs/stos, which is slow for short unaligned spans.
+static inline void copyPixels(unsigned char* dst, const unsigned char* src, int count)
+{
+    int i = 0;
+    for(; i + 8 <= count; i += 8)
+        memcpy(dst + i, src + i, 8);
+    for(; i < count; ++i)
+        dst[i] = src[i];
+}
+
+static inline void fillPixels(unsigned char* dst, unsigned char value, int count)
+{
+    unsigned long long values = value * 0x0101010101010101ULL;
+    int i = 0;
+    for(; i + 8 <= count; i += 8)
+        memcpy(dst + i, &values, 8);
+    for(; i < count; ++i)
+        dst[i] = value;
+}
+
 
 
 ///////////////////////////////////////////////////////////////////////////////
 // default constructor
 ///////////////////////////////////////////////////////////////////////////////
 Bmp::Bmp() : width(0), height(0), bitCount(0), dataSize(0), data(0), dataRGB(0),
-             errorMessage("No error.")
+             rgb(false), errorMessage("No error.")
 {
 }
 
@@ -50,6 +94,7 @@ Bmp::Bmp() : width(0), height(0), bitCount(0), dataSize(0), data(0), dataRGB(0),
 // copy constructor
 // We need DEEP COPY for dynamic memory variables because the compiler inserts
 // default copy constructor automatically for you, BUT it is only SHALLOW COPY
+// The RGB copy is not copied, it will be created again when it is needed.
 ///////////////////////////////////////////////////////////////////////////////
 Bmp::Bmp(const Bmp &rhs)
 {
@@ -58,6 +103,7 @@ Bmp::Bmp(const Bmp &rhs)
     height = rhs.getHeight();
     bitCount = rhs.getBitCount();
     dataSize = rhs.getDataSize();
+    rgb = rhs.isRGB();
     errorMessage = rhs.getError();
 
     if(rhs.getData())       // allocate memory only if the pointer is not NULL
@@ -68,13 +114,21 @@ Bmp::Bmp(const Bmp &rhs)
     else
         data = 0;           // array is not allocated yet, set to 0
 
-    if(rhs.getDataRGB())    // allocate memory only if the pointer is not NULL
-    {
-        dataRGB = new unsigned char[dataSize];
-        memcpy(dataRGB, rhs.getDataRGB(), dataSize); // deep copy
-    }
-    else
-        dataRGB = 0;        // array is not allocated yet, set to 0
+    dataRGB = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// move constructor
+// take over the buffers of rhs, and leave rhs empty
+///////////////////////////////////////////////////////////////////////////////
+Bmp::Bmp(Bmp &&rhs) : width(rhs.width), height(rhs.height), bitCount(rhs.bitCount),
+                      dataSize(rhs.dataSize), data(rhs.data), dataRGB(rhs.dataRGB),
+                      rgb(rhs.rgb), errorMessage(rhs.errorMessage)
+{
+    rhs.data = rhs.dataRGB = 0;
+    rhs.init();
 }
 
 
@@ -101,11 +155,15 @@ Bmp& Bmp::operator=(const Bmp &rhs)
     if(this == &rhs)        // avoid self-assignment (A = A)
         return *this;
 
+    // release the previous buffers first
+    this->init();
+
     // copy member variables
     width = rhs.getWidth();
     height = rhs.getHeight();
     bitCount = rhs.getBitCount();
     dataSize = rhs.getDataSize();
+    rgb = rhs.isRGB();
     errorMessage = rhs.getError();
 
     if(rhs.getData())       // allocate memory only if the pointer is not NULL
@@ -113,17 +171,33 @@ Bmp& Bmp::operator=(const Bmp &rhs)
         data = new unsigned char[dataSize];
         memcpy(data, rhs.getData(), dataSize);
     }
-    else
-        data = 0;
 
-    if(rhs.getDataRGB())   // allocate memory only if the pointer is not NULL
-    {
-        dataRGB = new unsigned char[dataSize];
-        memcpy(dataRGB, rhs.getDataRGB(), dataSize);
-    }
-    else
-        dataRGB = 0;
+    return *this;
+}
+
+
 
+///////////////////////////////////////////////////////////////////////////////
+// move assignment operator
+///////////////////////////////////////////////////////////////////////////////
+Bmp& Bmp::operator=(Bmp &&rhs)
+{
+    if(this == &rhs)
+        return *this;
+
+    this->init();
+
+    width = rhs.width;
+    height = rhs.height;
+    bitCount = rhs.bitCount;
+    dataSize = rhs.dataSize;
+    data = rhs.data;
+    dataRGB = rhs.dataRGB;
+    rgb = rhs.rgb;
+    errorMessage = rhs.errorMessage;
+
+    rhs.data = rhs.dataRGB = 0;
+    rhs.init();
     return *this;
 }
 
@@ -135,6 +209,7 @@ Bmp& Bmp::operator=(const Bmp &rhs)
 void Bmp::init()
 {
     width = height = bitCount = dataSize = 0;
+    rgb = false;
     errorMessage = "No error.";
 
     delete [] data;
@@ -145,6 +220,47 @@ void Bmp::init()
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+// return image data as RGB order
+// If data is already RGB order (or 8-bit grayscale), it returns data itself.
+// Otherwise, it creates an RGB copy on the first call and keeps it until the
+// next read(). Call convertToRGB() instead if BGR data is not needed.
+// NOTE: the first call is not thread-safe on a shared Bmp object.
+///////////////////////////////////////////////////////////////////////////////
+const unsigned char* Bmp::getDataRGB() const
+{
+    if(rgb || bitCount == 8 || !data)
+        return data;
+
+    if(!dataRGB)
+    {
+        dataRGB = new unsigned char[dataSize];
+        memcpy(dataRGB, data, dataSize);
+        swapRedBlue(dataRGB, dataSize, bitCount/8);
+    }
+    return dataRGB;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// convert image data to RGB order in place, and free the RGB copy if any
+///////////////////////////////////////////////////////////////////////////////
+void Bmp::convertToRGB()
+{
+    if(rgb || !data)
+        return;
+
+    if(bitCount == 24 || bitCount == 32)
+        swapRedBlue(data, dataSize, bitCount/8);
+    rgb = true;
+
+    delete [] dataRGB;
+    dataRGB = 0;
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // print itself for debug
 ///////////////////////////////////////////////////////////////////////////////
@@ -162,9 +278,10 @@ void Bmp::printSelf() const
 
 ///////////////////////////////////////////////////////////////////////////////
 // read a BMP image header infos and datafile and load
-// If height < 0, the bitmap is top-to-bottom orientation.
+// The file is memory mapped, so the header is parsed from memory, then the
+// pixels are decoded by decode() into the data array.
 ///////////////////////////////////////////////////////////////////////////////
-bool Bmp::read(const char* fileName)
+bool Bmp::read(const char* fileName, ChannelOrder order, ThreadPool* pool)
 {
     this->init();   // clear out all values
 
@@ -175,228 +292,300 @@ bool Bmp::read(const char* fileName)
         return false;
     }
 
-    // open a BMP file as binary mode
-    std::ifstream inFile;
-    inFile.open(fileName, std::ios::binary);    // binary mode
-    if(!inFile.good())
+    // map the whole BMP file
+    MappedFile file;
+    if(!file.open(fileName))
     {
         errorMessage = "Failed to open a BMP file to read.";
         return false;            // exit if failed
     }
 
-    // list of entries in BMP header
-    char id[2];             // magic identifier "BM" (2 bytes)
-    int fileSize;           // file size in bytes (4)
-    short reserved1;        // reserved 1 (2)
-    short reserved2;        // reserved 2 (2)
-    int dataOffset;         // starting offset of bitmap data (4)
-    int infoHeaderSize;     // info header size (4)
-    int width;              // image width (4)
-    int height;             // image height (4)
-    short planeCount;       // # of planes (2)
-    short bitCount;         // # of bits per pixel (2)
-    int compression;        // compression mode (4)
-    int dataSizeWithPaddings; // bitmap data size with paddings in bytes (4)
-    int xResolution;        // horizontal pixels per metre (4)
-    int yResolution;        // vertical pixels per metre (4)
-    int colorCount;         // # of colours used (4)
-    int importantColorCount;// # of important colours (4)
-    unsigned int redMask;   // red channel bit mask
-    unsigned int greenMask; // green channel bit mask
-    unsigned int blueMask;  // blue channel bit mask
-    unsigned int alphaMask; // alpha channel bit mask
-
-    // read BMP header infos
-    inFile.read(id, 2);                         // should be "BM"
-    inFile.read((char*)&fileSize, 4);           // should be same as file size
-    inFile.read((char*)&reserved1, 2);          // should be 0
-    inFile.read((char*)&reserved2, 2);          // should be 0
-    inFile.read((char*)&dataOffset, 4);
-    inFile.read((char*)&infoHeaderSize, 4);     // should be 40
-    inFile.read((char*)&width, 4);
-    inFile.read((char*)&height, 4);
-    inFile.read((char*)&planeCount, 2);         // should be 1
-    inFile.read((char*)&bitCount, 2);           // 1, 4, 8, 24, or 32
-    inFile.read((char*)&compression, 4);        // 0(uncompressed), 1(8-bit RLE), 2(4-bit RLE), 3(RGB with mask)
-    inFile.read((char*)&dataSizeWithPaddings, 4);
-    inFile.read((char*)&xResolution, 4);
-    inFile.read((char*)&yResolution, 4);
-    inFile.read((char*)&colorCount, 4);
-    inFile.read((char*)&importantColorCount, 4);
-    inFile.read((char*)&redMask, 4);
-    inFile.read((char*)&greenMask, 4);
-    inFile.read((char*)&blueMask, 4);
-    inFile.read((char*)&alphaMask, 4);
-
-    // bit masks need byte swap
-    redMask = SWAP4(redMask);
-    greenMask = SWAP4(greenMask);
-    blueMask = SWAP4(blueMask);
-    alphaMask = SWAP4(alphaMask);
-
-    /*
-    //@@ DEBUG
-    std::cout << "  RED: " << std::bitset<32>(redMask) << std::endl;
-    std::cout << "GREEN: " << std::bitset<32>(greenMask) << std::endl;
-    std::cout << " BLUE: " << std::bitset<32>(blueMask) << std::endl;
-    std::cout << "ALPHA: " << std::bitset<32>(alphaMask) << std::endl;
-    */
-
-    // check magic ID, "BM"
-    if(id[0] != 'B' && id[1] != 'M')
-    {
-        // it is not BMP file, close the opened file and exit
-        inFile.close();
-        errorMessage = "Magic ID is invalid.";
+    BmpHeader header;
+    if(!parseHeader(file.getData(), file.getSize(), header, errorMessage))
         return false;
-    }
 
-    // it supports only 8-bit grayscale, 24-bit BGR or 32-bit BGRA
-    if(bitCount < 8)
+    // output channels, 24-bit is expanded to RGBA if requested
+    // 4-bit RLE is decoded to 8-bit grayscale
+    int channelCount = getChannelCount(header.bitCount < 8 ? 8 : header.bitCount, order);
+    int lineWidth = header.width * channelCount;
+    int lineCount = abs(header.height);
+
+    // dataSize is int, RLE images are not limited by the file size
+    std::size_t imageSize = (std::size_t)lineWidth * lineCount;
+    if(imageSize > (std::size_t)INT_MAX)
     {
-        inFile.close();
-        errorMessage = "Unsupported format.";
+        errorMessage = "Image is too large.";
         return false;
     }
 
-    // it supports only uncompressed, 8-bit RLE compressed and BITFIELDS uncompressed formats
-    // 0=uncompressed, 1=RLE8, 2=RLE4, 3=BITFIELDS, 4=JPEG, 5=PNG
-    if(compression != 0 && compression != 1 && compression != 3)
+    // now it is ready to store info and image data
+    this->width = header.width;
+    this->height = lineCount;
+    this->bitCount = channelCount * 8;
+    this->dataSize = (int)imageSize;
+    this->rgb = (order != ORDER_BGR) && channelCount > 1;
+
+    // allocate data array, RGB copy is created later by getDataRGB() if needed
+    data = new unsigned char [dataSize];
+    decode(file.getData(), file.getSize(), header, order, data, lineWidth, pool);
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// decode the pixels of a BMP file in memory to dst
+// Each source row is read once and written to its final (flipped) position
+// without paddings in the requested channel order, stride bytes apart.
+// If a thread pool is given and the image is large, the rows are split into
+// bands decoded in parallel. RLE data is scanned once first to find where
+// each scanline starts.
+// If height < 0, the bitmap is top-to-bottom orientation.
+///////////////////////////////////////////////////////////////////////////////
+void Bmp::decode(const unsigned char* fileData, std::size_t fileSize, const BmpHeader& header, ChannelOrder order,
+                 unsigned char* dst, std::ptrdiff_t stride, ThreadPool* pool)
+{
+    int srcBitCount = (header.bitCount < 8) ? 8 : header.bitCount;
+    int srcChannelCount = srcBitCount / 8;
+    int channelCount = getChannelCount(srcBitCount, order);
+    if(srcChannelCount == 1)
+        order = ORDER_BGR;      // grayscale has no channel order
+
+    // NOTE: height can be negative
+    int width = header.width;
+    int srcLineWidth = width * srcChannelCount + header.paddings;
+    int lineWidth = width * channelCount;
+    int lineCount = abs(header.height);
+
+    // BMP is bottom-to-top orientation by default, so the first source row is
+    // the last row of image. But if the height is negative value, then it is
+    // top-to-bottom orientation. Each source row is written at its final row.
+    const unsigned char* src = fileData + header.dataOffset;
+    const unsigned char* srcEnd = fileData + fileSize;
+    unsigned char* line0 = dst;
+    if(header.height > 0)
     {
-        inFile.close();
-        errorMessage = "Unsupported compression mode.";
-        return false;
+        line0 = dst + (std::ptrdiff_t)(lineCount - 1) * stride;
+        stride = -stride;
     }
 
-    // make sure 8:8:8:8 for BITFIELDS mode 
-    if(compression == 3)
+    bool parallel = pool && (std::size_t)lineWidth * lineCount >= (std::size_t)PARALLEL_THRESHOLD;
+
+    // the source rows [first, last) are independent of the other rows
+    std::function<void(int, int)> decodeLines;
+    std::vector<RleLine> rleLines;
+    unsigned char grays[16];
+    if(header.compression == 1 || header.compression == 2)  // 8-bit or 4-bit RLE(Run Length Encode)
     {
-        if(std::bitset<32>(redMask).count() > 8 ||
-           std::bitset<32>(greenMask).count() > 8 ||
-           std::bitset<32>(blueMask).count() > 8 ||
-           std::bitset<32>(alphaMask).count() > 8)
+        if(header.compression == 2)
+            buildGrayTable(fileData, fileSize, header, grays, 16);
+
+        // find where each scanline starts first for the bands, or decode the
+        // whole image from the first scanline without scanning
+        if(parallel)
         {
-            inFile.close();
-            errorMessage = "Unsupported BI_BITFILEDS mode.";
-            return false;
+            scanRLE(src, srcEnd, header.bitCount, width, lineCount, rleLines);
+        }
+        else
+        {
+            RleLine start = {0, 0};
+            rleLines.assign(1, start);
         }
+        decodeLines = [&](int first, int last)
+        {
+            // skipped pixels (end of line or delta) stay 0
+            if(stride == lineWidth || stride == -lineWidth)
+            {
+                unsigned char* bandStart = (stride > 0) ? line0 + (std::size_t)first * lineWidth
+                                                        : line0 + (std::ptrdiff_t)(last - 1) * stride;
+                memset(bandStart, 0, (std::size_t)(last - first) * lineWidth);
+            }
+            else
+            {
+                for(int i = first; i < last; ++i)
+                    memset(line0 + (std::ptrdiff_t)i * stride, 0, lineWidth);
+            }
+            for(int i = first; i < last; ++i)
+            {
+                if(rleLines[i].offset >= 0)
+                {
+                    if(header.compression == 1)
+                        decodeRLE8(src + rleLines[i].offset, srcEnd, rleLines[i].x, i, last, width, line0, stride);
+                    else
+                        decodeRLE4(src + rleLines[i].offset, srcEnd, rleLines[i].x, i, last, width, line0, stride, grays);
+                    break;
+                }
+            }
+        };
+    }
+    else                                    // uncompressed or BITFIELDS
+    {
+        //@@TODO: assuming bit masks are BGRA order for BITFIELDS mode
+        decodeLines = [&](int first, int last)
+        {
+            for(int i = first; i < last; ++i)
+                convertRow(src + (std::size_t)i * srcLineWidth, line0 + (std::ptrdiff_t)i * stride, width, header.bitCount, order);
+        };
     }
 
-    // do not trust the file size in header, recalculate it
-    inFile.seekg(0, std::ios::end);
-    fileSize = (int)inFile.tellg();
+    // bands of at least 256KB are worth a task
+    if(parallel)
+        pool->parallelFor(lineCount, decodeLines, (1 << 18) / lineWidth + 1);
+    else
+        decodeLines(0, lineCount);
+}
 
-    // compute the number of paddings
-    // In BMP, each scanline must be divisible evenly by 4.
-    // If not divisible by 4, then each line adds
-    // extra paddings. So it can be divided evenly by 4.
-    int paddings = (4 - ((width * bitCount / 8) % 4)) % 4;
 
-    // compute data size without paddings
-    // NOTE: height can be negative
-    int dataSize = width * abs(height) * bitCount / 8;
 
-    // recompute data size with paddings (do not trust the data size in header)
-    dataSizeWithPaddings = fileSize - dataOffset;   // it maybe greater than "dataSize+(height*paddings)" because 4-byte boundary for file size
+///////////////////////////////////////////////////////////////////////////////
+// parse BMP header from memory
+// The fields are little-endian at fixed offsets:
+//   0: "BM", 2: file size, 10: data offset, 14: info header size, 18: width,
+//  22: height, 26: planes, 28: bit count, 30: compression, 46: colors used,
+//  54: RGBA bit masks (BITFIELDS, right after 40-byte info header)
+// The file size and data size in the header are not trusted; the size of
+// buffer is used instead. No bytes after the bit masks (70) are read.
+///////////////////////////////////////////////////////////////////////////////
+bool Bmp::parseHeader(const unsigned char* buffer, std::size_t size, BmpHeader& header, std::string& error)
+{
+    const std::size_t HEADER_SIZE = 54;         // fileHeader(14) + infoHeader(40)
 
-    // now it is ready to store info and image data
-    this->width = width;
-    this->height = abs(height);
-    this->bitCount = bitCount;
-    this->dataSize = dataSize;
-
-    // allocate data arrays
-    // add extra bytes for paddings if width is not divisible by 4
-    data = new unsigned char [dataSizeWithPaddings];
-    dataRGB = new unsigned char [dataSize];
-
-/*@@ we don't use palette for 8-bit indexed grayscale mode. Instead, we use the index value as the intensity of the pixel.
-    // for loading palette
-    unsigned char* palette = 0; // for palette for indexed mode
-    int paletteSize = 0;
-
-    // if bit count is 8 (256 grayscale), then it uses palette (indexed mode)
-    // build palette lookup table = (4 * colorCount) bytes
-    if(bitCount == 8)
+    if(!buffer || size < HEADER_SIZE)
     {
-        // count palette size
-        // palette is placed between BMP header and data
-        paletteSize = dataOffset - 54;              // BMP header size is 54 bytes total
-
-        // allocate palette array
-        palette = new unsigned char[paletteSize];
-
-        // get number of colors used
-        int colorCount = paletteSize / 4;       // each palette has 4 entries(B,G,R,A)
-
-        // copy palette data
-        inFile.seekg(54, std::ios::beg);        // palette starts right after BMP header block (54 bytes)
-        inFile.read((char*)palette, paletteSize);
+        error = "File is too small for BMP header.";
+        return false;
     }
-*/
 
-    if(compression == 0)                    // uncompressed
+    // check magic ID, "BM"
+    if(buffer[0] != 'B' || buffer[1] != 'M')
     {
-        inFile.seekg(dataOffset, std::ios::beg); // move cursor to the starting position of data
-        inFile.read((char*)data, dataSizeWithPaddings);
+        error = "Magic ID is invalid.";
+        return false;
     }
-    else if(compression == 1)               // 8-bit RLE(Run Length Encode) compressed
+
+    header.dataOffset  = (int)readInt32(buffer + 10);
+    header.width       = (int)readInt32(buffer + 18);
+    header.height      = (int)readInt32(buffer + 22);
+    header.bitCount    = buffer[28] | (buffer[29] << 8);
+    header.compression = (int)readInt32(buffer + 30);
+    header.paletteOffset = (int)(14 + readInt32(buffer + 14));
+    header.colorCount  = (int)readInt32(buffer + 46);
+    header.redMask = header.greenMask = header.blueMask = header.alphaMask = 0;
+
+    // it supports only 8-bit grayscale, 24-bit BGR or 32-bit BGRA, and 4-bit for RLE4
+    if(header.bitCount != 8 && header.bitCount != 24 && header.bitCount != 32 &&
+       !(header.bitCount == 4 && header.compression == 2))
     {
-        // get length of encoded data
-        int size = fileSize - dataOffset;
+        error = "Unsupported format.";
+        return false;
+    }
 
-        // allocate tmp array to store the encoded data
-        unsigned char *encData = new unsigned char[size];
+    // it supports only uncompressed, 8-bit/4-bit RLE compressed and BITFIELDS uncompressed formats
+    // 0=uncompressed, 1=RLE8, 2=RLE4, 3=BITFIELDS, 4=JPEG, 5=PNG
+    if(header.compression != 0 && header.compression != 1 && header.compression != 2 && header.compression != 3)
+    {
+        error = "Unsupported compression mode.";
+        return false;
+    }
 
-        // read data from file
-        inFile.seekg(dataOffset, std::ios::beg);
-        inFile.read((char*)encData, size);
+    // RLE8 must be 8-bit, and RLE4 must be 4-bit
+    if((header.compression == 1 && header.bitCount != 8) || (header.compression == 2 && header.bitCount != 4))
+    {
+        error = "Unsupported compression mode.";
+        return false;
+    }
 
-        // decode RLE into image data buffer
-        decodeRLE8(encData, data);
+    // make sure 8:8:8:8 for BITFIELDS mode
+    if(header.compression == 3)
+    {
+        if(size < HEADER_SIZE + 16)
+        {
+            error = "File is too small for BMP header.";
+            return false;
+        }
 
-        // deallocate encoded data buffer after decoding
-        delete [] encData;
+        // bit masks need byte swap
+        header.redMask   = readInt32(buffer + 54);
+        header.greenMask = readInt32(buffer + 58);
+        header.blueMask  = readInt32(buffer + 62);
+        header.alphaMask = readInt32(buffer + 66);
+        header.redMask   = SWAP4(header.redMask);
+        header.greenMask = SWAP4(header.greenMask);
+        header.blueMask  = SWAP4(header.blueMask);
+        header.alphaMask = SWAP4(header.alphaMask);
+
+        if(std::bitset<32>(header.redMask).count() > 8 ||
+           std::bitset<32>(header.greenMask).count() > 8 ||
+           std::bitset<32>(header.blueMask).count() > 8 ||
+           std::bitset<32>(header.alphaMask).count() > 8)
+        {
+            error = "Unsupported BI_BITFILEDS mode.";
+            return false;
+        }
     }
-    else if(compression == 3)               // BITFIELDS mode
-    {
-        //@@TODO: assuming bit masks are BGRA order
-        // Use bit masks to get correct colour channels
-        inFile.seekg(dataOffset, std::ios::beg); // move cursor to the starting position of data
-        inFile.read((char*)data, dataSizeWithPaddings);
 
-        //std::string bitOrder = Bmp::orderBitMasks(redMask, greenMask, blueMask, alphaMask);
+    // width * bitCount of the rows is computed in int (up to 32 bits), and
+    // abs() of INT_MIN is undefined
+    if(header.width <= 0 || header.width > INT_MAX / 32 ||
+       header.height == 0 || header.height == INT_MIN ||
+       header.dataOffset < (int)HEADER_SIZE || (std::size_t)header.dataOffset >= size)
+    {
+        error = "Invalid image size or data offset.";
+        return false;
     }
 
-    // close it after reading
-    inFile.close();
+    // compute the number of paddings
+    // In BMP, each scanline must be divisible evenly by 4.
+    // If not divisible by 4, then each line adds
+    // extra paddings. So it can be divided evenly by 4.
+    std::size_t lineWidth = (std::size_t)header.width * header.bitCount / 8;
+    header.paddings = (int)((4 - (lineWidth % 4)) % 4);
 
-    // we don't need paddings, trim paddings from each line
-    // Note that there is no padding in RLE compressed data
-    if((compression == 0 || compression == 3) && paddings > 0)
+    // all rows must be in the buffer, the last row may miss the paddings
+    // The sizes are in 64-bit, so a large height cannot wrap the end around.
+    if(header.compression == 0 || header.compression == 3)
     {
-        int lineWidth = width * bitCount / 8;
-
-        // copy line by line
-        int lineCount = abs(height);
-        for(int i = 1; i < lineCount; ++i)
+        unsigned long long lineCount = (unsigned long long)abs(header.height);
+        unsigned long long end = (unsigned long long)header.dataOffset +
+                                 (lineCount - 1) * (lineWidth + header.paddings) + lineWidth;
+        if(end > size)
         {
-            memcpy(&data[i*lineWidth], &data[i*(lineWidth+paddings)], lineWidth);
+            error = "Image data is truncated.";
+            return false;
         }
     }
 
-    // BMP is bottom-to-top orientation by default, flip image vertically
-    // But if the height is negative value, then it is top-to-bottom orientation.
-    if(height > 0)
-        flipImage(data, width, height, bitCount/8);
+    return true;
+}
 
-    // the colour components order of BMP image is BGR
-    // convert image data to RGB order for convenience
-    memcpy(dataRGB, data, dataSize);    // copy data to dataRGB first
-    if(bitCount == 24 || bitCount == 32)
-        swapRedBlue(dataRGB, dataSize, bitCount/8);
 
-    return true;
+
+///////////////////////////////////////////////////////////////////////////////
+// the number of output channels for the channel order
+// 24-bit is expanded to RGBA for ORDER_RGBA, others keep the channels.
+///////////////////////////////////////////////////////////////////////////////
+int Bmp::getChannelCount(int bitCount, ChannelOrder order)
+{
+    if(order == ORDER_RGBA && bitCount == 24)
+        return 4;
+    return bitCount / 8;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// convert a row of BMP pixels without paddings to the channel order
+///////////////////////////////////////////////////////////////////////////////
+void Bmp::convertRow(const unsigned char* src, unsigned char* dst, int width, int bitCount, ChannelOrder order)
+{
+    if(order == ORDER_BGR || bitCount == 8)
+        memcpy(dst, src, (std::size_t)width * bitCount / 8);
+    else if(bitCount == 32)
+        swapRedBlue32(src, dst, width);
+    else if(order == ORDER_RGBA)
+        convertBGRToRGBA(src, dst, width);
+    else
+        swapRedBlue24(src, dst, width);
 }
 
 
@@ -404,9 +593,14 @@ bool Bmp::read(const char* fileName)
 ///////////////////////////////////////////////////////////////////////////////
 // save an image as an uncompressed BMP format
 // We assume the source image is RGB order, so it must be converted BGR order.
-// If height < 0, the bitmap is top-to-bottom orientation.
+// If height < 0, the bitmap is top-to-bottom orientation. Otherwise, the rows
+// of data are bottom-to-top. The rows are written in the given order.
+// The rows are converted and written by bands with BmpWriter, so no copy of
+// the whole image is made.
+// RLE8 bitmaps must be bottom-to-top, so if height < 0, the rows are written
+// from the last one with a positive height instead.
 ///////////////////////////////////////////////////////////////////////////////
-bool Bmp::save(const char* fileName, int w, int h, int channelCount, const unsigned char* data)
+bool Bmp::save(const char* fileName, int w, int h, int channelCount, const unsigned char* data, bool rle)
 {
     // reset error message
     errorMessage = "No error.";
@@ -417,160 +611,27 @@ bool Bmp::save(const char* fileName, int w, int h, int channelCount, const unsig
         return false;
     }
 
-    if(w == 0 || h == 0)
-    {
-        errorMessage = "Zero width or height.";
-        return false;
-    }
-
-    // list of entries in BMP header
-    char id[2];             // magic identifier "BM" (2 bytes)
-    int fileSize;           // file size in bytes (4)
-    short reserved1;        // reserved 1 (2)
-    short reserved2;        // reserved 2 (2)
-    int dataOffset;         // starting offset of bitmap data (4)
-    int infoHeaderSize;     // info header size (4)
-    int width;              // image width (4)
-    int height;             // image height (4)
-    short planeCount;       // # of planes (2)
-    short bitCount;         // # of bits per pixel (2)
-    int compression;        // compression mode (4)
-    int dataSizeWithPaddings; // bitmap data size in bytes with padding (4)
-    int xResolution;        // horizontal pixels per metre (4)
-    int yResolution;        // vertical pixels per metre (4)
-    int colorCount;         // # of colours used (4)
-    int importantColorCount;// # of important colours (4)
-
-    int paletteSize;        // size of palette block in bytes
-
-    // compute paddings per each line
-    // In BMP, each scanline must be divisible evenly by 4
-    // If not, add extra paddings in each line, it can be divisible by 4.
-    int paddings = (4 - ((w * channelCount) % 4)) % 4;
-
-    // compute data size without paddings
-    int dataSize = w * abs(h) * channelCount;
-
-    // fill vars for BMP header infos
-    id[0] = 'B';
-    id[1] = 'M';
-    reserved1 = reserved2 = 0;
-    width = w;
-    height = h;
-    planeCount = 1;
-    bitCount = channelCount * 8;
-    compression = 0;
-    dataSizeWithPaddings = dataSize + (h * paddings);
-    xResolution = yResolution = 2835;   // 72 pixels/inch = 2835 pixels/m
-    colorCount = 0;
-    importantColorCount = 0;
-    infoHeaderSize = 40;                // should be 40 bytes
-    dataOffset = 54;                    // fileHeader(14) + infoHeader(40)
-    fileSize = dataSizeWithPaddings + dataOffset;
-
-    // 8-bit grayscale image need palette
-    // correct colorCount, dataOffset and fileSize
-    if(channelCount == 1)
-    {
-        colorCount = 256;                   // always use max number of colors for 8-bit gray scale
-        paletteSize = colorCount * 4;       // BGRA for each
-        dataOffset = 54 + paletteSize;      // add up palette size
-        fileSize = dataSizeWithPaddings + dataOffset;   // reset file size
-    }
-
-    // allocate output data array
-    unsigned char* tmpData = new unsigned char [dataSize];
-
-    // copy image data
-    memcpy(tmpData, data, dataSize);
-
-    // flip the image upside down
-    // If height is negative, then it is top-to-bottom orientation
-    // flip the bitmat to bottom-to-top
-    if(height < 0)
-        flipImage(tmpData, width, height, channelCount);
-
-    // convert RGB to BGR order
-    if(channelCount == 3 || channelCount == 4)
-        swapRedBlue(tmpData, dataSize, channelCount);
-
-    // add paddings(0s) if the width of image is not divisible by 4
-    unsigned char* dataWithPaddings = 0;
-    if(paddings > 0)
-    {
-        // allocate an array
-        // add extra bytes for paddings in case the width is not divisible by 4
-        dataWithPaddings = new unsigned char [dataSizeWithPaddings];
-
-        int lineWidth = width * channelCount;       // line width in bytes
-
-        // copy single line at a time
-        int lineCount = abs(height);
-        for(int i = 0; i < lineCount; ++i)
-        {
-            // restore data by adding paddings
-            memcpy(&dataWithPaddings[i*(lineWidth+paddings)], &tmpData[i*lineWidth], lineWidth);
+    rle = rle && (channelCount == 1);
+    bool reversed = rle && (h < 0);
 
-            // insert 0s for paddings after copying the current line
-            for(int j = 1; j <= paddings; ++j)
-                dataWithPaddings[(i+1)*(lineWidth+paddings) - j] = (unsigned char)0;
-        }
-    }
-
-    // open output file to write data
-    std::ofstream outFile;
-    outFile.open(fileName, std::ios::binary);
-    if(!outFile.good())
+    BmpWriter writer;
+    if(!writer.open(fileName, w, reversed ? -h : h, channelCount, ORDER_RGB, rle))
     {
-        errorMessage = "Failed to open an optput file.";
-        delete [] tmpData;
-        delete [] dataWithPaddings;
-        return false;   // exit if failed
+        errorMessage = writer.getError();
+        return false;
     }
 
-    // write header
-    outFile.put(id[0]);
-    outFile.put(id[1]);
-    outFile.write((char*)&fileSize, 4);
-    outFile.write((char*)&reserved1, 2);
-    outFile.write((char*)&reserved2, 2);
-    outFile.write((char*)&dataOffset, 4);
-    outFile.write((char*)&infoHeaderSize, 4);
-    outFile.write((char*)&width, 4);
-    outFile.write((char*)&height, 4);
-    outFile.write((char*)&planeCount, 2);
-    outFile.write((char*)&bitCount, 2);
-    outFile.write((char*)&compression, 4);
-    outFile.write((char*)&dataSizeWithPaddings, 4);
-    outFile.write((char*)&xResolution, 4);
-    outFile.write((char*)&yResolution, 4);
-    outFile.write((char*)&colorCount, 4);
-    outFile.write((char*)&importantColorCount, 4);
-
-    // For 8-bit grayscale, insert palette between header block and data block
-    if(bitCount == 8)
+    // the writer converts and writes by bands, close() reports any failure
+    int lineCount = abs(h);
+    if(reversed)
+        writer.writeRows(data + (std::size_t)(lineCount - 1) * w, lineCount, -(std::ptrdiff_t)w);
+    else
+        writer.writeRows(data, lineCount);
+    if(!writer.close())
     {
-        unsigned char* palette = new unsigned char[paletteSize]; // each entry has 4 bytes(B,G,R,A)
-        buildGrayScalePalette(palette, paletteSize);
-
-        // write palette to the file
-        outFile.write((char*)palette, paletteSize);
-        delete [] palette;
+        errorMessage = writer.getError();
+        return false;
     }
-
-    // write image data
-    if(paddings == 0)
-        outFile.write((char*)tmpData, dataSize);                        // without padding
-    else
-        outFile.write((char*)dataWithPaddings, dataSizeWithPaddings);   // with paddings
-
-    // close the opened file
-    outFile.close();
-
-    // deallocate tmp buffer
-    delete [] tmpData;
-    delete [] dataWithPaddings;
-
     return true;
 }
 
@@ -580,10 +641,12 @@ bool Bmp::save(const char* fileName, int w, int h, int channelCount, const unsig
 
 ///////////////////////////////////////////////////////////////////////////////
 // decode 8-bit RLE data into uncompressed data
-// This routine needs 2 pointers: the pointer to the encoded input data and
-// the pointer to the decoded output data. The length of input array is not
-// necessary because the last 2 bytes of input data must be 00 and 01, which
-// tells the end of data. So it can stop decoding process.
+// It starts at the beginning of the scanline, line, at the horizontal
+// position, x, and stops when it reaches lastLine, the end of bitmap (00 01)
+// or encEnd. The pixels outside of width are ignored.
+// The scanlines are in the order of RLE data (bottom-to-top for positive
+// height), and the scanline i is written at data + i * stride, so a negative
+// stride flips the image.
 //
 // BMP uses 2-value RLE scheme: the first value contains a count of the number
 // of pixels in the run, and the second value contains the value of the pixel
@@ -613,82 +676,227 @@ bool Bmp::save(const char* fileName, int w, int h, int channelCount, const unsig
 // example, 00 02 03 04 means move the cursor 3 pixels right, and 4 pixels
 // upward. (Note that BMP is bottom-to-top orientation.)
 ///////////////////////////////////////////////////////////////////////////////
-bool Bmp::decodeRLE8(const unsigned char *encData, unsigned char *outData)
+void Bmp::decodeRLE8(const unsigned char *encData, const unsigned char *encEnd, int x, int line, int lastLine,
+                     int width, unsigned char *data, std::ptrdiff_t stride)
 {
-    // check NULL pointer
-    if(!encData || !outData)
-        return false;
-
     unsigned char first, second;
-    int i;
-    bool stop = false;
+    int count;
 
-    // start decoding, stop when it reaches at the end of decoded data
-    while(!stop)
+    // x never goes beyond width, so the count of pixels to write is never negative
+    while(line < lastLine && encEnd - encData >= 2)
     {
         // grab 2 bytes at the current position
         first = *encData++;
         second = *encData++;
+        unsigned char* out = data + (std::ptrdiff_t)line * stride;
 
         if(first)                   // encoded run mode
         {
-            for(i=0; i < first; ++i)
-                *outData++ = second;
+            count = (first < width - x) ? first : width - x;
+            fillPixels(out + x, second, count);
+            x += count;
         }
-        else
+        else if(second == 0)        // end of scanline
+        {
+            ++line;
+            x = 0;
+        }
+        else if(second == 1)        // reached the end of bitmap
+        {
+            break;
+        }
+        else if(second == 2)        // delta, move the cursor right and up
+        {
+            if(encEnd - encData < 2)
+                break;
+            x = (encData[0] < width - x) ? x + encData[0] : width;
+            line += encData[1];
+            encData += 2;
+        }
+        else                        // unencoded run mode (second >= 3)
         {
-            if(second == 1)         // reached the end of bitmap
-                stop = true;        // must stop decoding
+            if(encEnd - encData < second)
+                break;
+            count = (second < width - x) ? second : width - x;
+            copyPixels(out + x, encData, count);
+            x += count;
+
+            // skip a padding 0 if it is odd number, it may be missing at the end
+            count = second + (second & 1);
+            encData += (count < encEnd - encData) ? count : encEnd - encData;
+        }
+    }
+}
 
-            else if(second == 2)    // delta mark
-                encData += 2;       // do nothing, but move the cursor 2 more bytes
 
-            else                    // unencoded run mode (second >= 3)
-            {
-                for(i=0; i < second; ++i)
-                    *outData++ = *encData++;
 
-                if(second % 2)      // if it is odd number, then there is a padding 0. ignore it
-                    encData++;
+///////////////////////////////////////////////////////////////////////////////
+// decode 4-bit RLE data into 8-bit grayscale data
+// It is the same as decodeRLE8(), except the pixels are 4-bit indices to the
+// palette: an encoded run repeats the 2 pixels in the high and low nibbles of
+// the second value alternately, and an unencoded run packs 2 pixels per byte
+// and is padded to 2 bytes. The indices are mapped to gray values by grays.
+// 1st  2nd  EncodedValue  DecodedValue
+// ===  ===  ============  ============
+//  05   12  (none)        1 2 1 2 1
+//  00   05  12 34 50 00   1 2 3 4 5
+///////////////////////////////////////////////////////////////////////////////
+void Bmp::decodeRLE4(const unsigned char *encData, const unsigned char *encEnd, int x, int line, int lastLine,
+                     int width, unsigned char *data, std::ptrdiff_t stride, const unsigned char *grays)
+{
+    unsigned char first, second;
+    int count;
+
+    while(line < lastLine && encEnd - encData >= 2)
+    {
+        first = *encData++;
+        second = *encData++;
+        unsigned char* out = data + (std::ptrdiff_t)line * stride;
+
+        if(first)                   // encoded run mode
+        {
+            count = (first < width - x) ? first : width - x;
+            unsigned char even = grays[second >> 4];
+            unsigned char odd = grays[second & 15];
+            if(even == odd)
+            {
+                fillPixels(out + x, even, count);
+            }
+            else
+            {
+                for(int i = 0; i < count; ++i)
+                    out[x + i] = (i & 1) ? odd : even;
             }
+            x += count;
         }
-    }
+        else if(second == 0)        // end of scanline
+        {
+            ++line;
+            x = 0;
+        }
+        else if(second == 1)        // reached the end of bitmap
+        {
+            break;
+        }
+        else if(second == 2)        // delta, move the cursor right and up
+        {
+            if(encEnd - encData < 2)
+                break;
+            x = (encData[0] < width - x) ? x + encData[0] : width;
+            line += encData[1];
+            encData += 2;
+        }
+        else                        // unencoded run mode (second >= 3)
+        {
+            int size = (second + 1) / 2;
+            if(encEnd - encData < size)
+                break;
+            count = (second < width - x) ? second : width - x;
+            for(int i = 0; i < count; ++i)
+            {
+                unsigned char pair = encData[i >> 1];
+                out[x + i] = grays[(i & 1) ? (pair & 15) : (pair >> 4)];
+            }
+            x += count;
 
-    return true;
+            size += size & 1;       // padded to 2 bytes, may be missing at the end
+            encData += (size < encEnd - encData) ? size : encEnd - encData;
+        }
+    }
 }
 
 
 
 ///////////////////////////////////////////////////////////////////////////////
-// BMP is bottom-to-top orientation. Flip the image vertically, so the image
-// can be rendered from top to bottom orientation
+// find the start position of each scanline in 8-bit or 4-bit RLE data
+// It walks the codes without decoding, so the scanlines can be decoded in
+// parallel. A scanline skipped by a delta has offset -1. The horizontal
+// position stops at width, same as the decoders.
 ///////////////////////////////////////////////////////////////////////////////
-void Bmp::flipImage(unsigned char *data, int width, int height, int channelCount)
+void Bmp::scanRLE(const unsigned char *encData, const unsigned char *encEnd, int bitCount, int width,
+                  int lineCount, std::vector<RleLine>& lines)
 {
-    if(!data) return;
+    RleLine none = {-1, 0};
+    lines.assign(lineCount, none);
+    if(lineCount <= 0)
+        return;
 
-    int lineSize = width * channelCount;
-    unsigned char* tmp = new unsigned char [lineSize];
-    int half = height / 2;
+    const unsigned char* p = encData;
+    int line = 0, x = 0;
+    lines[0].offset = 0;
 
-    int line1 = 0;                          // first line
-    int line2 = (height - 1) * lineSize;    // last line
-
-    // scan only half of height
-    for(int i = 0; i < half; ++i)
+    while(encEnd - p >= 2)
     {
-        // copy line by line
-        memcpy(tmp, &data[line1], lineSize);
-        memcpy(&data[line1], &data[line2], lineSize);
-        memcpy(&data[line2], tmp, lineSize);
-
-        // move to next line
-        line1 += lineSize;
-        line2 -= lineSize;
+        unsigned char first = p[0];
+        unsigned char second = p[1];
+        p += 2;
+
+        if(first)                   // encoded run
+        {
+            x = (first < width - x) ? x + first : width;
+        }
+        else if(second == 0)        // end of scanline
+        {
+            if(++line >= lineCount)
+                break;
+            x = 0;
+            lines[line].offset = (int)(p - encData);
+            lines[line].x = 0;
+        }
+        else if(second == 1)        // end of bitmap
+        {
+            break;
+        }
+        else if(second == 2)        // delta
+        {
+            if(encEnd - p < 2)
+                break;
+            x = (p[0] < width - x) ? x + p[0] : width;
+            int dy = p[1];
+            p += 2;
+            if(dy > 0)
+            {
+                line += dy;
+                if(line >= lineCount)
+                    break;
+                lines[line].offset = (int)(p - encData);
+                lines[line].x = x;
+            }
+        }
+        else                        // literal run, padded to 2 bytes
+        {
+            int size = (bitCount == 4) ? (second + 1) / 2 : second;
+            size += size & 1;
+            x = (second < width - x) ? x + second : width;
+            p += (size < encEnd - p) ? size : encEnd - p;
+        }
     }
+}
+
+
 
-    // deallocate temp arrays
-    delete [] tmp;
+///////////////////////////////////////////////////////////////////////////////
+// map palette entries (BGRA) to gray values with BT.601 luma
+// The entries missing in the file or beyond the color count use the gray
+// ramp of count levels, same as a grayscale palette.
+///////////////////////////////////////////////////////////////////////////////
+void Bmp::buildGrayTable(const unsigned char *fileData, std::size_t fileSize, const BmpHeader& header,
+                         unsigned char *grays, int count)
+{
+    int colorCount = (header.colorCount > 0 && header.colorCount < count) ? header.colorCount : count;
+    for(int i = 0; i < count; ++i)
+    {
+        std::size_t offset = (std::size_t)header.paletteOffset + i * 4;
+        if(i < colorCount && header.paletteOffset >= 14 && offset + 4 <= fileSize)
+        {
+            const unsigned char* entry = fileData + offset;
+            grays[i] = (unsigned char)((entry[2] * 77 + entry[1] * 150 + entry[0] * 29 + 128) >> 8);
+        }
+        else
+        {
+            grays[i] = (unsigned char)(i * 255 / (count - 1));
+        }
+    }
 }
 
 
@@ -702,16 +910,11 @@ void Bmp::swapRedBlue(unsigned char *data, int dataSize, int channelCount)
     if(channelCount < 3) return;            // must be 3 or 4
     if(dataSize % channelCount) return;     // must be divisible by the number of channels
 
-    unsigned char tmp;
-    int i;
-
-    // swap the position of red and blue components
-    for(i=0; i < dataSize; i+=channelCount)
-    {
-        tmp = data[i];
-        data[i] = data[i+2];
-        data[i+2] = tmp;
-    }
+    // swap the position of red and blue components in place
+    if(channelCount == 3)
+        swapRedBlue24(data, data, dataSize / 3);
+    else
+        swapRedBlue32(data, data, dataSize / 4);
 }
 
 
@@ -748,26 +951,6 @@ int Bmp::getColorCount(const unsigned char* data, int dataSize)
 
 
 
-///////////////////////////////////////////////////////////////////////////////
-// build palette for 8-bit grayscale image
-// Each component(B,G,R,A) of palette will have the same value as data value
-// because it is grayscale.
-///////////////////////////////////////////////////////////////////////////////
-void Bmp::buildGrayScalePalette(unsigned char* palette, int paletteSize)
-{
-    if(!palette) return;
-
-    // fill B, G, R, with same value and A is 0
-    int i, j;
-    for(i = 0, j = 0; i < paletteSize; i+=4, j++)
-    {
-        palette[i] = palette[i+1] = palette[i+2] = (unsigned char)j;
-        palette[i+3] = (unsigned char)0;
-    }
-}
-
-
-
 ///////////////////////////////////////////////////////////////////////////////
 // sort 4 bit masks in descending order then return 4-char string ordering
 // R,G,B,A channels using sorting network,
@@ -1,8 +1,19 @@
 // Bmp.h
 // =====
 // BMP image loader
-// It reads only 8/24/32-bit uncompressed and 8-bit RLE compression format.
+// It reads only 8/24/32-bit uncompressed and 8-bit/4-bit RLE compression format.
+// 4-bit RLE is decoded as 8-bit grayscale with the luma of its palette.
 //
+// 2026-10-19: Fixed overflow of row sizes in parseHeader() with large widths.
+// 2026-10-19: Added decode() to decode into a caller's buffer with a stride.
+// 2026-10-19: Added RLE4 decoding and RLE8 encoding in save().
+// 2026-10-19: save() writes packed header and bands with single system calls.
+// 2026-10-19: Added BmpReader/BmpWriter for streaming, save() writes by bands.
+// 2026-10-19: Decode row bands in parallel with ThreadPool, including RLE8.
+// 2026-10-19: Use PixelConvert for channel swizzles.
+// 2026-10-19: Decode rows in one pass with padding strip, flip and swizzle.
+// 2026-10-19: Create RGB copy lazily in getDataRGB(), added move ctor/assignment.
+// 2026-10-19: Read with memory mapped file and parse header from memory.
 // 2022-09-28: Added BITFIELDS=3 compression mode (RGBA with bit masks)
 // 2019-07-20: Fixed clearing memory in getColorCount()
 // 2018-08-10: Fixed dealloc memory in save()
@@ -15,44 +26,108 @@
 //
 //  AUTHOR: Song Ho Ahn (song.ahn@gmail.com)
 // CREATED: 2006-05-08
-// UPDATED: 2022-09-30
+// UPDATED: 2026-10-19
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifndef IMAGE_BMP_H
 #define IMAGE_BMP_H
 
 #include <string>
+#include <vector>
+#include <cstddef>
+
+class ThreadPool;
 
 namespace Image
 {
+    // header fields needed to decode BMP pixel data
+    struct BmpHeader
+    {
+        int dataOffset;                             // starting offset of bitmap data
+        int width;                                  // image width in pixels
+        int height;                                 // negative if top-to-bottom orientation
+        int bitCount;                               // bits per pixel, 4 (RLE4 only), 8, 24 or 32
+        int compression;                            // 0=uncompressed, 1=RLE8, 2=RLE4, 3=BITFIELDS
+        int paddings;                               // paddings at the end of each row in bytes
+        int paletteOffset;                          // palette starts right after info header
+        int colorCount;                             // palette entries, 0 means 2^bitCount
+        unsigned int redMask;                       // channel bit masks for BITFIELDS
+        unsigned int greenMask;
+        unsigned int blueMask;
+        unsigned int alphaMask;
+    };
+
+
+
     class Bmp
     {
     public:
+        // channel order of decoded image data
+        // ORDER_RGBA adds opaque alpha to 24-bit images. 8-bit grayscale is
+        // always decoded as is.
+        enum ChannelOrder
+        {
+            ORDER_BGR = 0,                          // as stored in BMP (BGR or BGRA)
+            ORDER_RGB,                              // RGB or RGBA
+            ORDER_RGBA                              // always RGBA for color images
+        };
+
+        // read() splits the rows into bands for the thread pool if the decoded
+        // image is at least PARALLEL_THRESHOLD bytes
+        static const int PARALLEL_THRESHOLD = 1 << 20;
+
         // ctor/dtor
         Bmp();
         Bmp(const Bmp &rhs);
+        Bmp(Bmp &&rhs);                             // move ctor, takes over the buffer
         ~Bmp();
 
         Bmp& operator=(const Bmp &rhs);             // assignment operator
+        Bmp& operator=(Bmp &&rhs);                  // move assignment
 
         // load image header and data from a bmp file
-        bool read(const char* fileName);
+        // The rows are top-to-bottom and packed (no paddings) in the given order.
+        // If pool is given, the bands of rows are decoded by its threads.
+        bool read(const char* fileName, ChannelOrder order=ORDER_BGR, ThreadPool* pool=0);
 
         // save an image as BMP format
         // It assumes the color order of input image is RGB, so it will convert to BGR order before save
-        bool save(const char* fileName, int width, int height, int channelCount, const unsigned char* data);
+        // If rle is true, 8-bit grayscale is compressed with RLE8 (ignored for color images).
+        bool save(const char* fileName, int width, int height, int channelCount, const unsigned char* data, bool rle=false);
 
         // getters
         int getWidth() const;                       // return width of image in pixel
         int getHeight() const;                      // return height of image in pixel
         int getBitCount() const;                    // return the number of bits per pixel (8, 24, or 32)
         int getDataSize() const;                    // return data size in bytes
-        const unsigned char* getData() const;       // return the pointer to image data
-        const unsigned char* getDataRGB() const;    // return image data as RGB order
+        const unsigned char* getData() const;       // return the pointer to image data (BGR order unless isRGB())
+        const unsigned char* getDataRGB() const;    // return image data as RGB order, see below
+        bool isRGB() const;                         // true if getData() is already RGB order
+
+        // swap red and blue of image data in place, so getData() returns RGB
+        // order without an extra copy. It does nothing for 8-bit grayscale.
+        void convertToRGB();
 
         void printSelf() const;                     // print itself for debug purpose
         const char* getError() const;               // return last error message
 
+        // parse and validate the header from the beginning of a BMP file in memory
+        // For uncompressed formats, it also checks all rows are in the buffer.
+        // Only the first 70 bytes are read, so size can be the file size if the
+        // buffer has the first 70 bytes (or the whole file if it is smaller).
+        static bool parseHeader(const unsigned char* buffer, std::size_t size, BmpHeader& header, std::string& error);
+
+        // decode the pixels of a whole BMP file in memory, after parseHeader(),
+        // to dst with the rows top-to-bottom and stride bytes apart (at least
+        // width * getChannelCount()), so it can decode into any buffer
+        static void decode(const unsigned char* fileData, std::size_t fileSize, const BmpHeader& header, ChannelOrder order,
+                           unsigned char* dst, std::ptrdiff_t stride, ThreadPool* pool=0);
+
+        // convert a row of uncompressed BMP pixels (BGR, BGRA or gray) to the
+        // given order, the number of output channels is getChannelCount()
+        static int  getChannelCount(int bitCount, ChannelOrder order);
+        static void convertRow(const unsigned char* src, unsigned char* dst, int width, int bitCount, ChannelOrder order);
+
     protected:
 
 
@@ -61,11 +136,17 @@ namespace Image
         void init();                                // clear the existing values
 
         // shared functions (only 1 copy of the function, even if there are multiple instances of this class)
-        static bool decodeRLE8(const unsigned char *encData, unsigned char *data);              // decode BMP 8-bit RLE to uncompressed
-        static void flipImage(unsigned char *data, int width, int height, int channelCount);    // flip the vertical orientation
+        struct RleLine { int offset; int x; };      // where a scanline starts in RLE data, offset=-1 if none
+        static void scanRLE(const unsigned char *encData, const unsigned char *encEnd, int bitCount, int width,
+                            int lineCount, std::vector<RleLine>& lines);
+        static void decodeRLE8(const unsigned char *encData, const unsigned char *encEnd, int x, int line, int lastLine,
+                               int width, unsigned char *data, std::ptrdiff_t stride);                  // decode scanlines until lastLine
+        static void decodeRLE4(const unsigned char *encData, const unsigned char *encEnd, int x, int line, int lastLine,
+                               int width, unsigned char *data, std::ptrdiff_t stride, const unsigned char *grays);
+        static void buildGrayTable(const unsigned char *fileData, std::size_t fileSize, const BmpHeader& header,
+                                   unsigned char *grays, int count);                                    // palette to luma
         static void swapRedBlue(unsigned char *data, int dataSize, int channelCount);           // swap the position of red and blue components
         static int  getColorCount(const unsigned char *data, int dataSize);                     // get the number of colors used in 8-bit grayscale image
-        static void buildGrayScalePalette(unsigned char *palette, int paletteSize);
         static std::string orderBitMasks(unsigned int r, unsigned int g, unsigned int b, unsigned int a);
 
         // member variables
@@ -74,7 +155,8 @@ namespace Image
         int bitCount;
         int dataSize;
         unsigned char *data;                        // data with default BGR order
-        unsigned char *dataRGB;                     // extra copy of image data with RGB order
+        mutable unsigned char *dataRGB;             // RGB copy, created on the first getDataRGB() call
+        bool rgb;                                   // true if data is RGB order
         std::string errorMessage;
     };
 
@@ -91,7 +173,7 @@ namespace Image
 
     inline int Bmp::getDataSize() const { return dataSize; }
     inline const unsigned char* Bmp::getData() const { return data; }
-    inline const unsigned char* Bmp::getDataRGB() const { return dataRGB; }
+    inline bool Bmp::isRGB() const { return rgb; }
 
     inline const char* Bmp::getError() const { return errorMessage.c_str(); }
 }
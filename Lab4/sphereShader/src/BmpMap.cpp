@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+// BmpMap.cpp
+// ==========
+// zero-copy view of an uncompressed BMP file
+//
+// Dependencies: Bmp, MappedFile
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include "BmpMap.h"
+#include "Bmp.h"
+using namespace Image;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ctor
+///////////////////////////////////////////////////////////////////////////////
+BmpMap::BmpMap() : width(0), height(0), bitCount(0), stride(0), top(0), errorMessage("No error.")
+{
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// map a BMP file and locate the top row
+///////////////////////////////////////////////////////////////////////////////
+bool BmpMap::open(const char* fileName)
+{
+    close();
+
+    if(!file.open(fileName))
+    {
+        errorMessage = file.getError();
+        return false;
+    }
+
+    BmpHeader header;
+    if(!Bmp::parseHeader(file.getData(), file.getSize(), header, errorMessage))
+    {
+        file.close();
+        return false;
+    }
+
+    if(header.compression == 1 || header.compression == 2)
+    {
+        file.close();
+        errorMessage = "Compressed BMP cannot be mapped, use Bmp::read().";
+        return false;
+    }
+
+    width = header.width;
+    height = abs(header.height);
+    bitCount = header.bitCount;
+
+    // bottom-to-top file starts from the bottom row, so walk backward
+    int lineSize = width * bitCount / 8 + header.paddings;
+    const unsigned char* pixels = file.getData() + header.dataOffset;
+    if(header.height > 0)
+    {
+        top = pixels + (std::ptrdiff_t)(height - 1) * lineSize;
+        stride = -lineSize;
+    }
+    else
+    {
+        top = pixels;
+        stride = lineSize;
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// unmap the file, the row pointers are invalid after this
+///////////////////////////////////////////////////////////////////////////////
+void BmpMap::close()
+{
+    file.close();
+    width = height = bitCount = stride = 0;
+    top = 0;
+    errorMessage = "No error.";
+}
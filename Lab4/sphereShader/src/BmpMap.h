@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+// BmpMap.h
+// ========
+// zero-copy view of an uncompressed BMP file
+// The file is memory mapped and the pixel rows are accessed in place, so
+// nothing is allocated or copied for the pixel data. The rows are in file
+// order (BGR or BGRA, or 8-bit grayscale) with the paddings, so use getRow()
+// or getData() with getStride() instead of assuming a packed image.
+// getRow(0) is always the top row; if the file is bottom-to-top (height > 0
+// in the header), the stride is negative.
+//
+// RLE8/RLE4 compressed BMP cannot be viewed in place, so open() fails on it.
+// Use Bmp::read() to decode it.
+//
+// Dependencies: Bmp, MappedFile
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef IMAGE_BMP_MAP_H
+#define IMAGE_BMP_MAP_H
+
+#include <string>
+#include <cstddef>
+#include "MappedFile.h"
+
+namespace Image
+{
+    class BmpMap
+    {
+    public:
+        BmpMap();
+
+        bool open(const char* fileName);            // map file and parse header
+        void close();
+
+        bool isOpen() const                         { return file.isOpen(); }
+        int  getWidth() const                       { return width; }
+        int  getHeight() const                      { return height; }
+        int  getBitCount() const                    { return bitCount; }        // 8, 24 or 32
+        int  getRowSize() const                     { return width * bitCount / 8; } // without paddings
+        int  getStride() const                      { return stride; }          // bytes from a row to the row below
+        const unsigned char* getData() const        { return top; }             // the top row
+        const unsigned char* getRow(int y) const    { return top + (std::ptrdiff_t)y * stride; }
+        const char* getError() const                { return errorMessage.c_str(); }
+
+    private:
+        MappedFile file;
+        int width;
+        int height;
+        int bitCount;
+        int stride;
+        const unsigned char* top;
+        std::string errorMessage;
+    };
+}
+
+#endif // IMAGE_BMP_MAP_H
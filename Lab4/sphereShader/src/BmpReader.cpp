@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+// BmpReader.cpp
+// =============
+// streaming reader of uncompressed BMP files
+//
+// Dependencies: Bmp
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include "BmpReader.h"
+using namespace Image;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ctor
+///////////////////////////////////////////////////////////////////////////////
+BmpReader::BmpReader() : order(Bmp::ORDER_BGR), width(0), height(0), bitCount(0), srcBitCount(0),
+                         srcStride(0), dataOffset(0), bottomUp(false), nextRow(0),
+                         errorMessage("No error.")
+{
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// open a BMP file and read the header only
+// Bmp::parseHeader() needs the first 70 bytes and the file size to check the
+// rows are all in the file.
+///////////////////////////////////////////////////////////////////////////////
+bool BmpReader::open(const char* fileName, Bmp::ChannelOrder order)
+{
+    close();
+    errorMessage = "No error.";
+
+    if(!fileName)
+    {
+        errorMessage = "File name is not defined (NULL pointer).";
+        return false;
+    }
+
+    file.open(fileName, std::ios::binary);
+    if(!file.is_open())
+    {
+        errorMessage = "Failed to open a BMP file to read.";
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    std::streamoff fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    unsigned char buffer[70];
+    std::streamoff headerSize = (fileSize < (std::streamoff)sizeof(buffer)) ? fileSize : sizeof(buffer);
+    BmpHeader header;
+    if(fileSize <= 0 || !file.read((char*)buffer, headerSize) ||
+       !Bmp::parseHeader(buffer, (std::size_t)fileSize, header, errorMessage))
+    {
+        if(fileSize <= 0)
+            errorMessage = "File is too small for BMP header.";
+        file.close();
+        return false;
+    }
+
+    if(header.compression == 1 || header.compression == 2)
+    {
+        file.close();
+        errorMessage = "Compressed BMP cannot be streamed, use Bmp::read().";
+        return false;
+    }
+
+    // grayscale has no channel order
+    this->order = (header.bitCount == 8) ? Bmp::ORDER_BGR : order;
+    width = header.width;
+    height = abs(header.height);
+    bitCount = Bmp::getChannelCount(header.bitCount, order) * 8;
+    srcBitCount = header.bitCount;
+    srcStride = width * srcBitCount / 8 + header.paddings;
+    dataOffset = header.dataOffset;
+    bottomUp = header.height > 0;
+    nextRow = 0;
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// close the file and release the band buffer
+///////////////////////////////////////////////////////////////////////////////
+void BmpReader::close()
+{
+    if(file.is_open())
+        file.close();
+    file.clear();
+    std::vector<unsigned char>().swap(band);
+    width = height = bitCount = srcBitCount = srcStride = dataOffset = nextRow = 0;
+    bottomUp = false;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// read the next band of rows with a single seek and read
+// In a bottom-to-top file, the image rows [nextRow, nextRow+n) are the file
+// rows [height-nextRow-n, height-nextRow), so the band is converted backward.
+///////////////////////////////////////////////////////////////////////////////
+int BmpReader::readRows(unsigned char* rows, int rowCount)
+{
+    if(!file.is_open() || !rows || rowCount <= 0 || nextRow >= height)
+        return 0;
+
+    int count = (height - nextRow < rowCount) ? height - nextRow : rowCount;
+    int fileRow = bottomUp ? height - nextRow - count : nextRow;
+    int srcRowSize = width * srcBitCount / 8;
+
+    // the last row of file may not have the paddings
+    std::size_t bandSize = (std::size_t)(count - 1) * srcStride + srcRowSize;
+    if(band.size() < bandSize)
+        band.resize(bandSize);
+
+    file.seekg(dataOffset + (std::streamoff)fileRow * srcStride, std::ios::beg);
+    if(!file.read((char*)&band[0], bandSize))
+    {
+        errorMessage = "Failed to read image data.";
+        file.close();
+        return 0;
+    }
+
+    int rowSize = getRowSize();
+    for(int i = 0; i < count; ++i)
+    {
+        int src = bottomUp ? count - 1 - i : i;
+        Bmp::convertRow(&band[(std::size_t)src * srcStride], rows + (std::size_t)i * rowSize, width, srcBitCount, order);
+    }
+
+    nextRow += count;
+    return count;
+}
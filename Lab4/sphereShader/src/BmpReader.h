@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// BmpReader.h
+// ===========
+// streaming reader of uncompressed BMP files
+// The rows are read from the file by bands, so only one band is in memory at a
+// time, no matter how large the image is. readRows() returns the rows
+// top-to-bottom and packed (no paddings) in the given channel order, the same
+// as Bmp::read().
+// RLE8/RLE4 compressed BMP is not supported, use Bmp::read() to decode it.
+//
+// Dependencies: Bmp
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef IMAGE_BMP_READER_H
+#define IMAGE_BMP_READER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Bmp.h"
+
+namespace Image
+{
+    class BmpReader
+    {
+    public:
+        BmpReader();
+
+        // open a file and parse header, close the previous one
+        bool open(const char* fileName, Bmp::ChannelOrder order=Bmp::ORDER_BGR);
+        void close();
+
+        // read the next rowCount rows into rows (rowCount * getRowSize() bytes)
+        // It returns the number of rows read, less than rowCount at the end of
+        // image, and 0 after the last row or on error.
+        int  readRows(unsigned char* rows, int rowCount);
+
+        bool isOpen() const                         { return file.is_open(); }
+        int  getWidth() const                       { return width; }
+        int  getHeight() const                      { return height; }
+        int  getBitCount() const                    { return bitCount; }        // of output rows
+        int  getRowSize() const                     { return width * bitCount / 8; }
+        int  getNextRow() const                     { return nextRow; }         // rows read so far
+        const char* getError() const                { return errorMessage.c_str(); }
+
+    private:
+        std::ifstream file;
+        std::vector<unsigned char> band;            // file rows of a band with paddings
+        Bmp::ChannelOrder order;
+        int width;
+        int height;
+        int bitCount;
+        int srcBitCount;                            // bits per pixel in file
+        int srcStride;                              // file row size with paddings
+        int dataOffset;
+        bool bottomUp;                              // true if height > 0 in header
+        int nextRow;
+        std::string errorMessage;
+    };
+}
+
+#endif // IMAGE_BMP_READER_H
@@ -0,0 +1,469 @@
+///////////////////////////////////////////////////////////////////////////////
+// BmpWriter.cpp
+// =============
+// streaming writer of uncompressed or RLE8 compressed BMP files
+//
+// Dependencies: Bmp, PixelConvert
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(WIN32) || defined(_WIN32)
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include "BmpWriter.h"
+#include "PixelConvert.h"
+using namespace Image;
+
+// write little-endian values to unaligned memory
+static inline void writeInt16(unsigned char* p, int x)
+{
+    p[0] = (unsigned char)x;
+    p[1] = (unsigned char)(x >> 8);
+}
+
+static inline void writeInt32(unsigned char* p, unsigned int x)
+{
+    p[0] = (unsigned char)x;
+    p[1] = (unsigned char)(x >> 8);
+    p[2] = (unsigned char)(x >> 16);
+    p[3] = (unsigned char)(x >> 24);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ctor/dtor
+///////////////////////////////////////////////////////////////////////////////
+BmpWriter::BmpWriter() : file(-1), headerSize(0), inputOrder(Bmp::ORDER_RGB), width(0), height(0),
+                         channelCount(0), paddings(0), rle(false), dataSize(0), nextRow(0),
+                         errorMessage("No error.")
+{
+}
+
+BmpWriter::~BmpWriter()
+{
+    closeFile();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// create a BMP file and build the header (and palette for grayscale)
+// The header is written with the first band, or at close() if no rows.
+///////////////////////////////////////////////////////////////////////////////
+bool BmpWriter::open(const char* fileName, int width, int height, int channelCount,
+                     Bmp::ChannelOrder inputOrder, bool rle)
+{
+    closeFile();
+    errorMessage = "No error.";
+    nextRow = 0;
+    dataSize = 0;
+
+    if(!fileName)
+    {
+        errorMessage = "File name is not specified (NULL pointer).";
+        return false;
+    }
+
+    if(width <= 0 || height == 0)
+    {
+        errorMessage = "Zero width or height.";
+        return false;
+    }
+
+    if(channelCount != 1 && channelCount != 3 && channelCount != 4)
+    {
+        errorMessage = "Unsupported number of channels.";
+        return false;
+    }
+
+    if(rle && (channelCount != 1 || height < 0))
+    {
+        errorMessage = "RLE8 needs 8-bit grayscale with bottom-to-top rows (height > 0).";
+        return false;
+    }
+
+    // In BMP, each scanline must be divisible evenly by 4
+    // The sizes are computed in 64-bit because the file size in the header is
+    // 32-bit. RLE8 data size is checked while writing rows.
+    unsigned long long rowSize = (unsigned long long)width * channelCount;
+    unsigned long long lineSize = (rowSize + 3) & ~3ULL;
+    unsigned long long lineCount = (height < 0) ? 0ULL - (unsigned long long)height : (unsigned long long)height;
+    unsigned long long dataOffset = HEADER_SIZE + (channelCount == 1 ? PALETTE_SIZE : 0);
+    if(lineSize > INT_MAX || (!rle && dataOffset + lineSize * lineCount > UINT_MAX))
+    {
+        errorMessage = "Image is too large for BMP.";
+        return false;
+    }
+
+    this->inputOrder = inputOrder;
+    this->rle = rle;
+    this->width = width;
+    this->height = height;
+    this->channelCount = channelCount;
+    this->paddings = (int)(lineSize - rowSize);
+
+#if defined(WIN32) || defined(_WIN32)
+    file = _open(fileName, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    file = ::open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    if(file < 0)
+    {
+        errorMessage = "Failed to open an optput file.";
+        return false;
+    }
+
+    buildHeader(0);
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// convert the rows to BGR order with paddings (or encode them with RLE8), then
+// write them by bands
+///////////////////////////////////////////////////////////////////////////////
+int BmpWriter::writeRows(const unsigned char* rows, int rowCount, std::ptrdiff_t rowStride)
+{
+    int lineCount = abs(height);
+    if(file < 0 || !rows || rowCount <= 0 || nextRow >= lineCount)
+        return 0;
+
+    if(rowCount > lineCount - nextRow)
+        rowCount = lineCount - nextRow;
+
+    int rowSize = getRowSize();
+    if(rowStride == 0)
+        rowStride = rowSize;
+
+    // the most bytes of a row in the band, RLE8 can take 2 bytes per pixel
+    // plus end of scanline
+    std::size_t stride = rle ? (std::size_t)width * 2 + 2 : (std::size_t)rowSize + paddings;
+    int bandLines = (int)(BAND_SIZE / stride);
+    if(bandLines < 1)
+        bandLines = 1;
+    if(bandLines > rowCount)
+        bandLines = rowCount;
+    if(band.size() < (std::size_t)bandLines * stride)
+        band.resize((std::size_t)bandLines * stride);
+
+    bool swap = (channelCount > 1 && inputOrder != Bmp::ORDER_BGR);
+    for(int i = 0; i < rowCount; i += bandLines)
+    {
+        int count = (rowCount - i < bandLines) ? rowCount - i : bandLines;
+        std::size_t size = 0;
+        for(int j = 0; j < count; ++j)
+        {
+            const unsigned char* src = rows + (std::ptrdiff_t)(i + j) * rowStride;
+            unsigned char* dst = &band[size];
+            if(rle)
+            {
+                size += encodeRLE8(src, width, dst);
+
+                // end of scanline, or end of bitmap after the last row
+                band[size++] = 0;
+                band[size++] = (nextRow + j + 1 == lineCount) ? 1 : 0;
+                continue;
+            }
+
+            if(!swap)
+                memcpy(dst, src, rowSize);
+            else if(channelCount == 3)
+                swapRedBlue24(src, dst, width);
+            else
+                swapRedBlue32(src, dst, width);
+            memset(dst + rowSize, 0, paddings);
+            size += stride;
+        }
+
+        // RLE8 data can grow past the 32-bit size in the header
+        if(rle && HEADER_SIZE + PALETTE_SIZE + dataSize + size > UINT_MAX)
+        {
+            errorMessage = "Image is too large for BMP.";
+            closeFile();
+            return i;
+        }
+
+        // the header goes out with the first band
+        if(!writeBlocks(header, headerSize, &band[0], size))
+        {
+            errorMessage = "Failed to write image data.";
+            closeFile();
+            return i;
+        }
+        headerSize = 0;
+        dataSize += size;
+        nextRow += count;
+    }
+    return rowCount;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// close the file and check all rows are written
+///////////////////////////////////////////////////////////////////////////////
+bool BmpWriter::close()
+{
+    if(file < 0)
+        return false;   // error message is already set
+
+    std::vector<unsigned char>().swap(band);
+
+    // the compressed size is known now, so rebuild the header, and write it
+    // again at the beginning if it went out with the first band
+    bool written = true;
+    if(rle)
+    {
+        bool sent = (headerSize == 0);
+        buildHeader(dataSize);
+        if(sent)
+        {
+#if defined(WIN32) || defined(_WIN32)
+            written = _lseek(file, 0, SEEK_SET) == 0 && writeBlocks(header, HEADER_SIZE, 0, 0);
+#else
+            written = ::lseek(file, 0, SEEK_SET) == 0 && writeBlocks(header, HEADER_SIZE, 0, 0);
+#endif
+            headerSize = 0;
+        }
+    }
+
+    written = writeBlocks(header, headerSize, 0, 0) && written;
+    headerSize = 0;
+#if defined(WIN32) || defined(_WIN32)
+    written = (_close(file) == 0) && written;
+#else
+    written = (::close(file) == 0) && written;
+#endif
+    file = -1;
+
+    if(!written)
+    {
+        errorMessage = "Failed to write image data.";
+        return false;
+    }
+    if(nextRow < abs(height))
+    {
+        errorMessage = "Not all rows are written.";
+        return false;
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// close the file without checking, used on errors
+///////////////////////////////////////////////////////////////////////////////
+void BmpWriter::closeFile()
+{
+    if(file >= 0)
+    {
+#if defined(WIN32) || defined(_WIN32)
+        _close(file);
+#else
+        ::close(file);
+#endif
+    }
+    file = -1;
+    headerSize = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// write 2 blocks back to back, either can be empty
+// On Unix, both go out with a single writev() call unless it writes partially.
+///////////////////////////////////////////////////////////////////////////////
+bool BmpWriter::writeBlocks(const unsigned char* block1, std::size_t size1, const unsigned char* block2, std::size_t size2)
+{
+#if defined(WIN32) || defined(_WIN32)
+    const unsigned char* blocks[2] = { block1, block2 };
+    std::size_t sizes[2] = { size1, size2 };
+    for(int i = 0; i < 2; ++i)
+    {
+        while(sizes[i] > 0)
+        {
+            unsigned int size = (sizes[i] < (1u << 30)) ? (unsigned int)sizes[i] : (1u << 30);
+            int n = _write(file, blocks[i], size);
+            if(n <= 0)
+                return false;
+            blocks[i] += n;
+            sizes[i] -= n;
+        }
+    }
+    return true;
+#else
+    iovec blocks[2];
+    blocks[0].iov_base = (void*)block1;
+    blocks[0].iov_len = size1;
+    blocks[1].iov_base = (void*)block2;
+    blocks[1].iov_len = size2;
+
+    int first = 0;
+    while(first < 2)
+    {
+        if(blocks[first].iov_len == 0)
+        {
+            ++first;
+            continue;
+        }
+
+        ssize_t n = ::writev(file, blocks + first, 2 - first);
+        if(n < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            return false;
+        }
+
+        // skip the written bytes after a partial write
+        for(int i = first; i < 2 && n > 0; ++i)
+        {
+            std::size_t size = ((std::size_t)n < blocks[i].iov_len) ? (std::size_t)n : blocks[i].iov_len;
+            blocks[i].iov_base = (char*)blocks[i].iov_base + size;
+            blocks[i].iov_len -= size;
+            n -= size;
+        }
+    }
+    return true;
+#endif
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// pack BMP file header and info header as little-endian, and the palette for
+// 8-bit grayscale right after them
+// The data size is given for RLE8, it is computed for uncompressed data.
+//   0: "BM", 2: file size, 6: reserved(2+2), 10: data offset,
+//  14: info header size, 18: width, 22: height, 26: planes, 28: bit count,
+//  30: compression, 34: data size, 38: x/y resolution, 46: colors used,
+//  50: important colors
+///////////////////////////////////////////////////////////////////////////////
+void BmpWriter::buildHeader(unsigned long long dataSize)
+{
+    // open() checked it fits in 32-bit
+    unsigned long long dataSizeWithPaddings = rle ? dataSize : ((unsigned long long)width * channelCount + paddings) * abs(height);
+    int colorCount = 0;
+    int paletteSize = 0;
+
+    // 8-bit grayscale image need palette
+    if(channelCount == 1)
+    {
+        colorCount = 256;                   // always use max number of colors for 8-bit gray scale
+        paletteSize = colorCount * 4;       // BGRA for each
+    }
+    int dataOffset = HEADER_SIZE + paletteSize;
+
+    memset(header, 0, HEADER_SIZE);
+    header[0] = 'B';
+    header[1] = 'M';
+    writeInt32(header + 2, (unsigned int)(dataSizeWithPaddings + dataOffset));  // file size
+    writeInt32(header + 10, dataOffset);
+    writeInt32(header + 14, 40);                                // info header size
+    writeInt32(header + 18, width);
+    writeInt32(header + 22, height);                            // negative if top-to-bottom
+    writeInt16(header + 26, 1);                                 // planes
+    writeInt16(header + 28, channelCount * 8);                  // bits per pixel
+    writeInt32(header + 30, rle ? 1 : 0);                       // uncompressed or RLE8
+    writeInt32(header + 34, (unsigned int)dataSizeWithPaddings);
+    writeInt32(header + 38, 2835);      // 72 pixels/inch = 2835 pixels/m
+    writeInt32(header + 42, 2835);
+    writeInt32(header + 46, colorCount);
+    writeInt32(header + 50, 0);
+
+    if(paletteSize > 0)
+        buildGrayScalePalette(header + HEADER_SIZE, paletteSize);
+    headerSize = dataOffset;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// build palette for 8-bit grayscale
+///////////////////////////////////////////////////////////////////////////////
+void BmpWriter::buildGrayScalePalette(unsigned char* palette, int paletteSize)
+{
+    if(!palette) return;
+
+    // fill B, G, R, with same value and A is 0
+    int i, j;
+    for(i = 0, j = 0; i < paletteSize; i+=4, j++)
+    {
+        palette[i] = palette[i+1] = palette[i+2] = (unsigned char)j;
+        palette[i+3] = (unsigned char)0;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// encode a row of 8-bit pixels with RLE8, without end of scanline
+// Runs of 3 or more same pixels are encoded runs (count, value). The others
+// are grouped into unencoded runs (0, count, values, padding to 2 bytes), but
+// a group of 1 or 2 pixels is written as encoded runs because an unencoded run
+// needs at least 3 pixels. See Bmp::decodeRLE8() for the codes.
+// The encoded row is at most width * 2 bytes.
+///////////////////////////////////////////////////////////////////////////////
+int BmpWriter::encodeRLE8(const unsigned char* row, int width, unsigned char* encData)
+{
+    unsigned char* out = encData;
+    int i = 0;
+    while(i < width)
+    {
+        // encoded run
+        int run = 1;
+        while(i + run < width && run < 255 && row[i + run] == row[i])
+            ++run;
+        if(run >= 3)
+        {
+            *out++ = (unsigned char)run;
+            *out++ = row[i];
+            i += run;
+            continue;
+        }
+
+        // pixels until a run of 3 starts
+        int end = i + run;
+        while(end < width && end - i < 255 &&
+              !(end + 2 < width && row[end] == row[end + 1] && row[end] == row[end + 2]))
+            ++end;
+        int count = end - i;
+
+        if(count < 3)
+        {
+            while(i < end)
+            {
+                run = (i + 1 < end && row[i + 1] == row[i]) ? 2 : 1;
+                *out++ = (unsigned char)run;
+                *out++ = row[i];
+                i += run;
+            }
+        }
+        else
+        {
+            *out++ = 0;
+            *out++ = (unsigned char)count;
+            memcpy(out, row + i, count);
+            out += count;
+            if(count & 1)
+                *out++ = 0;
+            i = end;
+        }
+    }
+    return (int)(out - encData);
+}
@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////////////
+// BmpWriter.h
+// ===========
+// streaming writer of uncompressed or RLE8 compressed BMP files
+// The header is built at open() and written together with the first band.
+// writeRows() converts the rows to BGR order with the paddings in a band
+// buffer and writes the band at once, so the whole image never needs to be in
+// memory. The file is written with the OS calls (writev on Unix) instead of a
+// stream, so each band is a single system call without an extra copy.
+// The rows are stored in the order they are given. If height > 0, the first
+// row is the bottom of image, and if height < 0, it is the top (same as
+// Bmp::save()). 1 channel is written as 8-bit grayscale with a gray palette.
+// 8-bit grayscale can be compressed with RLE8. RLE8 must be bottom-to-top,
+// and the compressed size is written in the header at close().
+//
+// Dependencies: Bmp
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef IMAGE_BMP_WRITER_H
+#define IMAGE_BMP_WRITER_H
+
+#include <string>
+#include <vector>
+#include "Bmp.h"
+
+namespace Image
+{
+    class BmpWriter
+    {
+    public:
+        BmpWriter();
+        ~BmpWriter();
+
+        static const int HEADER_SIZE = 54;          // fileHeader(14) + infoHeader(40)
+        static const int PALETTE_SIZE = 1024;       // 256 BGRA entries for 8-bit grayscale
+        static const int BAND_SIZE = 1 << 18;       // bytes per write, at least one row
+
+        // create a file and write header, channelCount is 1, 3 or 4
+        // inputOrder is the channel order of rows to write, ORDER_RGB or ORDER_BGR
+        // rle requires 1 channel and height > 0
+        // It fails if the file would be larger than 4GB, the limit of BMP.
+        bool open(const char* fileName, int width, int height, int channelCount,
+                  Bmp::ChannelOrder inputOrder=Bmp::ORDER_RGB, bool rle=false);
+
+        // write the next rowCount rows, rowStride bytes apart (0 means packed,
+        // getRowSize()). A negative stride walks the rows backward.
+        // It returns the number of rows written, the rows after the last row
+        // of image are ignored.
+        int  writeRows(const unsigned char* rows, int rowCount, std::ptrdiff_t rowStride=0);
+
+        // close the file, false if not all rows are written or writing failed
+        bool close();
+
+        bool isOpen() const                         { return file >= 0; }
+        int  getRowSize() const                     { return width * channelCount; }
+        int  getNextRow() const                     { return nextRow; }         // rows written so far
+        const char* getError() const                { return errorMessage.c_str(); }
+
+    private:
+        BmpWriter(const BmpWriter&);                // not copyable
+        BmpWriter& operator=(const BmpWriter&);
+
+        void buildHeader(unsigned long long dataSize);
+        bool writeBlocks(const unsigned char* block1, std::size_t size1, const unsigned char* block2, std::size_t size2);
+        void closeFile();
+        static void buildGrayScalePalette(unsigned char *palette, int paletteSize);
+        static int  encodeRLE8(const unsigned char *row, int width, unsigned char *encData);     // returns encoded bytes
+
+        int file;                                   // file descriptor, -1 if closed
+        unsigned char header[HEADER_SIZE + PALETTE_SIZE];
+        int headerSize;                             // bytes of header not written yet
+        std::vector<unsigned char> band;            // converted rows with paddings, or encoded rows
+        Bmp::ChannelOrder inputOrder;
+        int width;
+        int height;                                 // as given, negative if top-to-bottom
+        int channelCount;
+        int paddings;
+        bool rle;
+        unsigned long long dataSize;                // bytes of pixel data written
+        int nextRow;
+        std::string errorMessage;
+    };
+}
+
+#endif // IMAGE_BMP_WRITER_H
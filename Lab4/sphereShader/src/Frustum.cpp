@@ -0,0 +1,323 @@
+///////////////////////////////////////////////////////////////////////////////
+// Frustum.cpp
+// ===========
+// View frustum with 6 planes and visibility tests of bounding volumes
+//
+// Dependencies: Vector3, Matrix4, Plane
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Frustum.h"
+#include "Simd.h"
+
+// number of 1 bits in 4-bit value
+static const int BIT_COUNTS[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// extract 6 planes from the matrix (Gribb-Hartmann method)
+// A clip-space point (x,y,z,w) = M * p is inside if -w <= x,y,z <= w, so each
+// plane is the 4th row of M plus or minus one of the other rows.
+///////////////////////////////////////////////////////////////////////////////
+void Frustum::set(const Matrix4& m)
+{
+    Vector4 row0 = m.getRow(0);
+    Vector4 row1 = m.getRow(1);
+    Vector4 row2 = m.getRow(2);
+    Vector4 row3 = m.getRow(3);
+
+    Vector4 coeffs[PLANE_COUNT] = { row3 + row0,    // left
+                                    row3 - row0,    // right
+                                    row3 + row1,    // bottom
+                                    row3 - row1,    // top
+                                    row3 + row2,    // near
+                                    row3 - row2 };  // far
+    for(int i = 0; i < PLANE_COUNT; ++i)
+    {
+        planes[i].set(coeffs[i].x, coeffs[i].y, coeffs[i].z, coeffs[i].w);
+        planes[i].normalize();
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// test a point, sphere or axis-aligned box
+// The box is tested with the corner furthest along the plane normal.
+///////////////////////////////////////////////////////////////////////////////
+bool Frustum::containsPoint(const Vector3& point) const
+{
+    for(int i = 0; i < PLANE_COUNT; ++i)
+    {
+        if(planes[i].getDistance(point) < 0)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::intersectsSphere(const Vector3& center, float radius) const
+{
+    for(int i = 0; i < PLANE_COUNT; ++i)
+    {
+        if(planes[i].getDistance(center) < -radius)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::intersectsBox(const Vector3& boxMin, const Vector3& boxMax) const
+{
+    for(int i = 0; i < PLANE_COUNT; ++i)
+    {
+        const Vector3& n = planes[i].normal;
+        Vector3 p(n.x >= 0 ? boxMax.x : boxMin.x,
+                  n.y >= 0 ? boxMax.y : boxMin.y,
+                  n.z >= 0 ? boxMax.z : boxMin.z);
+        if(planes[i].getDistance(p) < 0)
+            return false;
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// batch tests of bounding spheres
+///////////////////////////////////////////////////////////////////////////////
+std::size_t Frustum::cullSpheres(const float* x, const float* y, const float* z, const float* radius,
+                                 std::size_t count, unsigned int* bits) const
+{
+    CullInput input;
+    getSphereInput(x, y, z, radius, input);
+    return cull(input, count, bits, 0);
+}
+
+std::size_t Frustum::cullSpheresToIndices(const float* x, const float* y, const float* z, const float* radius,
+                                          std::size_t count, int* indices) const
+{
+    CullInput input;
+    getSphereInput(x, y, z, radius, input);
+    return cull(input, count, 0, indices);
+}
+
+std::size_t Frustum::cullSpheres(const BoundingSpheres& spheres, std::vector<unsigned int>& bits) const
+{
+    bits.resize((spheres.size() + 31) / 32);
+    return cullSpheres(spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.radius.data(),
+                       spheres.size(), bits.data());
+}
+
+std::size_t Frustum::cullSpheresToIndices(const BoundingSpheres& spheres, std::vector<int>& indices) const
+{
+    indices.resize(spheres.size());
+    std::size_t count = cullSpheresToIndices(spheres.x.data(), spheres.y.data(), spheres.z.data(),
+                                             spheres.radius.data(), spheres.size(), indices.data());
+    indices.resize(count);
+    return count;
+}
+
+std::size_t Frustum::cullSpheresScalar(const float* x, const float* y, const float* z, const float* radius,
+                                       std::size_t count, unsigned int* bits) const
+{
+    CullInput input;
+    getSphereInput(x, y, z, radius, input);
+    for(std::size_t i = 0; i < (count + 31) / 32; ++i)
+        bits[i] = 0;
+    return cullScalar(input, 0, count, bits, 0);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// batch tests of axis-aligned bounding boxes
+///////////////////////////////////////////////////////////////////////////////
+std::size_t Frustum::cullBoxes(const float* minX, const float* minY, const float* minZ,
+                               const float* maxX, const float* maxY, const float* maxZ,
+                               std::size_t count, unsigned int* bits) const
+{
+    CullInput input;
+    getBoxInput(minX, minY, minZ, maxX, maxY, maxZ, input);
+    return cull(input, count, bits, 0);
+}
+
+std::size_t Frustum::cullBoxesToIndices(const float* minX, const float* minY, const float* minZ,
+                                        const float* maxX, const float* maxY, const float* maxZ,
+                                        std::size_t count, int* indices) const
+{
+    CullInput input;
+    getBoxInput(minX, minY, minZ, maxX, maxY, maxZ, input);
+    return cull(input, count, 0, indices);
+}
+
+std::size_t Frustum::cullBoxes(const BoundingBoxes& boxes, std::vector<unsigned int>& bits) const
+{
+    bits.resize((boxes.size() + 31) / 32);
+    return cullBoxes(boxes.minX.data(), boxes.minY.data(), boxes.minZ.data(),
+                     boxes.maxX.data(), boxes.maxY.data(), boxes.maxZ.data(), boxes.size(), bits.data());
+}
+
+std::size_t Frustum::cullBoxesToIndices(const BoundingBoxes& boxes, std::vector<int>& indices) const
+{
+    indices.resize(boxes.size());
+    std::size_t count = cullBoxesToIndices(boxes.minX.data(), boxes.minY.data(), boxes.minZ.data(),
+                                           boxes.maxX.data(), boxes.maxY.data(), boxes.maxZ.data(),
+                                           boxes.size(), indices.data());
+    indices.resize(count);
+    return count;
+}
+
+std::size_t Frustum::cullBoxesScalar(const float* minX, const float* minY, const float* minZ,
+                                     const float* maxX, const float* maxY, const float* maxZ,
+                                     std::size_t count, unsigned int* bits) const
+{
+    CullInput input;
+    getBoxInput(minX, minY, minZ, maxX, maxY, maxZ, input);
+    for(std::size_t i = 0; i < (count + 31) / 32; ++i)
+        bits[i] = 0;
+    return cullScalar(input, 0, count, bits, 0);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// spheres use the centers against all planes and add the radius
+///////////////////////////////////////////////////////////////////////////////
+void Frustum::getSphereInput(const float* x, const float* y, const float* z, const float* radius,
+                             CullInput& input) const
+{
+    for(int i = 0; i < PLANE_COUNT; ++i)
+    {
+        input.x[i] = x;
+        input.y[i] = y;
+        input.z[i] = z;
+    }
+    input.radius = radius;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// boxes use the corner furthest along each plane normal (positive vertex)
+// The corner depends on the signs of the plane normal only, so it is chosen
+// once per plane by selecting min or max array, not per box.
+///////////////////////////////////////////////////////////////////////////////
+void Frustum::getBoxInput(const float* minX, const float* minY, const float* minZ,
+                          const float* maxX, const float* maxY, const float* maxZ,
+                          CullInput& input) const
+{
+    for(int i = 0; i < PLANE_COUNT; ++i)
+    {
+        const Vector3& n = planes[i].normal;
+        input.x[i] = (n.x >= 0) ? maxX : minX;
+        input.y[i] = (n.y >= 0) ? maxY : minY;
+        input.z[i] = (n.z >= 0) ? maxZ : minZ;
+    }
+    input.radius = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// test 8 objects per iteration, then the rest with scalar loop
+// distance = nx*x + (ny*y + (nz*z + d)) + radius, visible if >= 0 for all
+// planes. The scalar loop computes in the same order, so both give the same
+// result where multiply-add is not fused.
+// Either bits or indices is written, the other must be NULL.
+///////////////////////////////////////////////////////////////////////////////
+std::size_t Frustum::cull(const CullInput& input, std::size_t count, unsigned int* bits, int* indices) const
+{
+    if(bits)
+    {
+        for(std::size_t i = 0; i < (count + 31) / 32; ++i)
+            bits[i] = 0;
+    }
+
+    std::size_t visibleCount = 0;
+    std::size_t i = 0;
+
+#if defined(SIMD_FLOAT4)
+    simd4f nx[PLANE_COUNT], ny[PLANE_COUNT], nz[PLANE_COUNT], nd[PLANE_COUNT];
+    for(int p = 0; p < PLANE_COUNT; ++p)
+    {
+        nx[p] = simdSet1(planes[p].normal.x);
+        ny[p] = simdSet1(planes[p].normal.y);
+        nz[p] = simdSet1(planes[p].normal.z);
+        nd[p] = simdSet1(planes[p].d);
+    }
+    const simd4f zero = simdSet1(0);
+    const simd4f allTrue = simdCmpGe(zero, zero);
+
+    for(; i + 8 <= count; i += 8)
+    {
+        simd4f r0 = input.radius ? simdLoad(input.radius + i)     : zero;
+        simd4f r1 = input.radius ? simdLoad(input.radius + i + 4) : zero;
+        simd4f in0 = allTrue;
+        simd4f in1 = allTrue;
+        for(int p = 0; p < PLANE_COUNT; ++p)
+        {
+            const float* x = input.x[p] + i;
+            const float* y = input.y[p] + i;
+            const float* z = input.z[p] + i;
+            simd4f d0 = simdMadd(nx[p], simdLoad(x),     simdMadd(ny[p], simdLoad(y),     simdMadd(nz[p], simdLoad(z),     nd[p])));
+            simd4f d1 = simdMadd(nx[p], simdLoad(x + 4), simdMadd(ny[p], simdLoad(y + 4), simdMadd(nz[p], simdLoad(z + 4), nd[p])));
+            in0 = simdAnd(in0, simdCmpGe(simdAdd(d0, r0), zero));
+            in1 = simdAnd(in1, simdCmpGe(simdAdd(d1, r1), zero));
+        }
+
+        int mask = simdMoveMask(in0) | (simdMoveMask(in1) << 4);
+        if(bits)
+        {
+            bits[i >> 5] |= (unsigned int)mask << (i & 31);
+            visibleCount += BIT_COUNTS[mask & 15] + BIT_COUNTS[mask >> 4];
+        }
+        else
+        {
+            // write all 8 indices, but advance only for visible ones
+            for(int k = 0; k < 8; ++k)
+            {
+                indices[visibleCount] = (int)(i + k);
+                visibleCount += (mask >> k) & 1;
+            }
+        }
+    }
+#endif
+
+    visibleCount += cullScalar(input, i, count, bits, indices ? indices + visibleCount : 0);
+    return visibleCount;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// scalar version of cull() for [first, last)
+// bits must be cleared by the caller
+///////////////////////////////////////////////////////////////////////////////
+std::size_t Frustum::cullScalar(const CullInput& input, std::size_t first, std::size_t last,
+                                unsigned int* bits, int* indices) const
+{
+    std::size_t visibleCount = 0;
+    for(std::size_t i = first; i < last; ++i)
+    {
+        float r = input.radius ? input.radius[i] : 0.0f;
+        bool visible = true;
+        for(int p = 0; p < PLANE_COUNT && visible; ++p)
+        {
+            const Plane& plane = planes[p];
+            float d = plane.normal.x * input.x[p][i] + (plane.normal.y * input.y[p][i] + (plane.normal.z * input.z[p][i] + plane.d));
+            visible = (d + r >= 0);
+        }
+
+        if(visible)
+        {
+            if(bits)
+                bits[i >> 5] |= 1u << (i & 31);
+            else
+                indices[visibleCount] = (int)i;
+            ++visibleCount;
+        }
+    }
+    return visibleCount;
+}
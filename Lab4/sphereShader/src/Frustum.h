@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////
+// Frustum.h
+// =========
+// View frustum with 6 planes and visibility tests of bounding volumes
+//
+// The planes are extracted from a projection matrix (view space frustum), or
+// from projection * view (world space) or projection * view * model (object
+// space) matrix. The normals of the planes point inside of the frustum.
+//
+// The batch tests take the bounding volumes as separate arrays (structure of
+// arrays) and test 8 objects per iteration with SIMD. The result is either a
+// bitmask (bit i%32 of word i/32 for object i) or a compacted list of visible
+// indices. The scalar versions give the same result and are the reference of
+// the SIMD kernels. The tests are conservative; an object near a corner of the
+// frustum may be reported visible although it is outside.
+//
+// Dependencies: Vector3, Matrix4, Plane
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef GEOMETRY_FRUSTUM_H
+#define GEOMETRY_FRUSTUM_H
+
+#include <vector>
+#include <cstddef>
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Plane.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// SoA arrays of bounding spheres and axis-aligned bounding boxes
+///////////////////////////////////////////////////////////////////////////////
+struct BoundingSpheres
+{
+    std::vector<float> x, y, z;     // centers
+    std::vector<float> radius;
+
+    void add(const Vector3& center, float r)    { x.push_back(center.x); y.push_back(center.y); z.push_back(center.z); radius.push_back(r); }
+    void clear()                                { x.clear(); y.clear(); z.clear(); radius.clear(); }
+    std::size_t size() const                    { return x.size(); }
+};
+
+struct BoundingBoxes
+{
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    void add(const Vector3& boxMin, const Vector3& boxMax)
+    {
+        minX.push_back(boxMin.x); minY.push_back(boxMin.y); minZ.push_back(boxMin.z);
+        maxX.push_back(boxMax.x); maxY.push_back(boxMax.y); maxZ.push_back(boxMax.z);
+    }
+    void clear()                                { minX.clear(); minY.clear(); minZ.clear(); maxX.clear(); maxY.clear(); maxZ.clear(); }
+    std::size_t size() const                    { return minX.size(); }
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// frustum
+///////////////////////////////////////////////////////////////////////////////
+class Frustum
+{
+public:
+    enum PlaneIndex
+    {
+        PLANE_LEFT = 0,
+        PLANE_RIGHT,
+        PLANE_BOTTOM,
+        PLANE_TOP,
+        PLANE_NEAR,
+        PLANE_FAR,
+        PLANE_COUNT
+    };
+
+    Frustum() {}
+    explicit Frustum(const Matrix4& m)          { set(m); }
+    ~Frustum() {}
+
+    void        set(const Matrix4& m);          // extract normalized planes from (view-)projection matrix
+    const Plane& getPlane(int index) const      { return planes[index]; }
+
+    // test single object
+    bool        containsPoint(const Vector3& point) const;
+    bool        intersectsSphere(const Vector3& center, float radius) const;
+    bool        intersectsBox(const Vector3& boxMin, const Vector3& boxMax) const;
+
+    // batch tests with SIMD, return the number of visible objects
+    // bits must have (count+31)/32 words, indices must have room for count
+    std::size_t cullSpheres(const float* x, const float* y, const float* z, const float* radius,
+                            std::size_t count, unsigned int* bits) const;
+    std::size_t cullSpheresToIndices(const float* x, const float* y, const float* z, const float* radius,
+                                     std::size_t count, int* indices) const;
+    std::size_t cullBoxes(const float* minX, const float* minY, const float* minZ,
+                          const float* maxX, const float* maxY, const float* maxZ,
+                          std::size_t count, unsigned int* bits) const;
+    std::size_t cullBoxesToIndices(const float* minX, const float* minY, const float* minZ,
+                                   const float* maxX, const float* maxY, const float* maxZ,
+                                   std::size_t count, int* indices) const;
+
+    // same with SoA containers, the output vector is resized
+    std::size_t cullSpheres(const BoundingSpheres& spheres, std::vector<unsigned int>& bits) const;
+    std::size_t cullSpheresToIndices(const BoundingSpheres& spheres, std::vector<int>& indices) const;
+    std::size_t cullBoxes(const BoundingBoxes& boxes, std::vector<unsigned int>& bits) const;
+    std::size_t cullBoxesToIndices(const BoundingBoxes& boxes, std::vector<int>& indices) const;
+
+    // scalar reference of cullSpheres() and cullBoxes()
+    std::size_t cullSpheresScalar(const float* x, const float* y, const float* z, const float* radius,
+                                  std::size_t count, unsigned int* bits) const;
+    std::size_t cullBoxesScalar(const float* minX, const float* minY, const float* minZ,
+                                const float* maxX, const float* maxY, const float* maxZ,
+                                std::size_t count, unsigned int* bits) const;
+
+protected:
+
+private:
+    // x, y, z arrays to test against each plane, and optional radius array
+    struct CullInput
+    {
+        const float* x[PLANE_COUNT];
+        const float* y[PLANE_COUNT];
+        const float* z[PLANE_COUNT];
+        const float* radius;
+    };
+
+    void        getSphereInput(const float* x, const float* y, const float* z, const float* radius, CullInput& input) const;
+    void        getBoxInput(const float* minX, const float* minY, const float* minZ,
+                            const float* maxX, const float* maxY, const float* maxZ, CullInput& input) const;
+    std::size_t cull(const CullInput& input, std::size_t count, unsigned int* bits, int* indices) const;
+    std::size_t cullScalar(const CullInput& input, std::size_t first, std::size_t last, unsigned int* bits, int* indices) const;
+
+    Plane planes[PLANE_COUNT];
+};
+
+#endif
@@ -0,0 +1,1033 @@
+///////////////////////////////////////////////////////////////////////////////
+// ImageBench.cpp
+// ==============
+// micro benchmark of PixelConvert kernels and BMP saving
+// Each conversion is compared with a plain per-pixel loop, and the outputs of
+// both must be identical. Throughput is in GB/s of source data.
+// The image is 512x512 (1MB as RGBA), so it mostly stays in the L2 cache and
+// the kernels are measured rather than the memory bandwidth.
+// Bmp::save() is measured in MB/s of image data for a screenshot and a frame
+// dump (a sequence of frames), and compared with a stream writer that copies,
+// swizzles and pads the whole image first and writes the header field by
+// field. The files go to the current directory and are removed after.
+// RLE8 is compared with uncompressed 8-bit BMP by the file size and the decode
+// speed of Bmp::read() in MB/s of decoded image, on a mask, a UI texture and
+// noise (worst case).
+// MipChain is compared with a plain 2x2 average loop building the same chain
+// (box filter of even sizes must be identical), then with the other filters,
+// in MB/s of level 0.
+// The block encoders are measured in MB/s of source image for each quality
+// preset on a smooth generated image, with the PSNR of the decoded image and
+// the compression ratio. The output with a thread pool must be identical.
+// Filling level 0 of a MipChain is compared between Bmp::read() and a copy
+// (as MipChain::build() does) and ImageLoader decoding into it directly, in
+// MB/s of decoded image.
+// MipChain::resample() is measured in MB/s of source image for each filter
+// with one thread and with a thread pool (the output must be identical), then
+// a texture downscaled to a quarter before its mipmaps and BC1 is compared
+// with the full size by the time and the bytes to upload.
+// TexturePacker is compared with a shelf packer (rows of images, tallest
+// first) by the atlas pages and the occupancy for random small images, with
+// gutters and alignment for the mipmaps.
+// Crafted BMP headers with overflowing sizes must be rejected by Bmp,
+// BmpMap, BmpReader and ImageLoader before anything is allocated or read.
+// TextureCache compares the time to get the levels of a texture on the first
+// run (decode BMP, build mipmaps, compress) and on the next run (map the cache
+// file, then read all levels as an upload would).
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "PixelConvert.h"
+#include "Bmp.h"
+#include "BmpMap.h"
+#include "BmpReader.h"
+#include "MipChain.h"
+#include "BlockCompress.h"
+#include "ImageLoader.h"
+#include "TextureCache.h"
+#include "TexturePacker.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+
+// constants
+const int PIXEL_COUNT = 512 * 512;
+const int REPEAT_COUNT = 200;
+const char* SAVE_FILE_NAME = "imageBench.bmp";
+
+// function prototypes
+void swapRedBlue24Loop(const unsigned char* src, unsigned char* dst, std::size_t count);
+void swapRedBlue32Loop(const unsigned char* src, unsigned char* dst, std::size_t count);
+void convertRGBToRGBALoop(const unsigned char* src, unsigned char* dst, std::size_t count);
+void convertRGBToGrayLoop(const unsigned char* src, unsigned char* dst, std::size_t count);
+void convertRGBAToGrayLoop(const unsigned char* src, unsigned char* dst, std::size_t count);
+void premultiplyAlphaLoop(const unsigned char* src, unsigned char* dst, std::size_t count);
+void convertBytesToFloatsLoop(const unsigned char* src, float* dst, std::size_t count);
+void convertFloatsToBytesLoop(const float* src, unsigned char* dst, std::size_t count);
+
+template<typename S, typename D>
+void benchConvert(const char* name, void (*loop)(const S*, D*, std::size_t), void (*kernel)(const S*, D*, std::size_t),
+                  const std::vector<S>& src, std::size_t count, std::size_t srcSize, std::size_t dstSize);
+void printResult(const char* name, double elapsedUsec, std::size_t bytes, double speedup, bool same, bool mega=false);
+bool saveWithStream(const char* fileName, int width, int height, int channelCount, const unsigned char* data);
+void benchSave(const char* name, int width, int height, int channelCount, int frameCount);
+bool compareFiles(const char* fileName1, const char* fileName2);
+void benchRLE(const char* name, int width, int height, const std::vector<unsigned char>& image);
+long getFileSize(const char* fileName);
+void buildMask(std::vector<unsigned char>& image, int width, int height);
+void buildUITexture(std::vector<unsigned char>& image, int width, int height);
+void benchMips(const char* name, int width, int height, int channelCount, const std::vector<unsigned char>& pixels);
+void buildMipsLoop(const unsigned char* src, int width, int height, int channelCount, std::vector<unsigned char>& chain);
+void benchBlocks(const char* name, int width, int height, int channelCount);
+void buildSmoothImage(std::vector<unsigned char>& image, int width, int height, int channelCount);
+void benchCache(const char* name, int width, int height, bool compress);
+void benchLoad(const char* name, int width, int height, int channelCount);
+void benchResample(const char* name, int width, int height, int channelCount, int dstWidth, int dstHeight);
+void benchPack(const char* name, int imageCount, int minSize, int maxSize, int pageSize);
+int packShelves(const std::vector<int>& widths, const std::vector<int>& heights, int pageSize, int gutter, int alignment);
+bool checkHeader(const char* name, int width, int height, int bitCount, int compression);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+    // random pixels with all alpha values
+    std::vector<unsigned char> pixels(PIXEL_COUNT * 4);
+    unsigned int seed = 2468;
+    for(std::size_t i = 0; i < pixels.size(); ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        pixels[i] = (unsigned char)(seed >> 24);
+    }
+
+    // floats slightly out of 0~1 to exercise clamping
+    std::vector<float> floats(PIXEL_COUNT * 4);
+    for(std::size_t i = 0; i < floats.size(); ++i)
+        floats[i] = pixels[i] / 250.0f - 0.01f;
+
+    // name, plain loop, kernel, source, pixel (or value) count, source size, destination size
+    const std::size_t n = PIXEL_COUNT;
+    benchConvert("swapRedBlue24", swapRedBlue24Loop, Image::swapRedBlue24, pixels, n, n * 3, n * 3);
+    benchConvert("swapRedBlue32", swapRedBlue32Loop, Image::swapRedBlue32, pixels, n, n * 4, n * 4);
+    benchConvert("convertRGBToRGBA", convertRGBToRGBALoop, Image::convertRGBToRGBA, pixels, n, n * 3, n * 4);
+    benchConvert("convertRGBToGray", convertRGBToGrayLoop, Image::convertRGBToGray, pixels, n, n * 3, n);
+    benchConvert("convertRGBAToGray", convertRGBAToGrayLoop, Image::convertRGBAToGray, pixels, n, n * 4, n);
+    benchConvert("premultiplyAlpha", premultiplyAlphaLoop, Image::premultiplyAlpha, pixels, n, n * 4, n * 4);
+    benchConvert("convertBytesToFloats", convertBytesToFloatsLoop, Image::convertBytesToFloats, pixels, n * 4, n * 4, n * 4);
+    benchConvert("convertFloatsToBytes", convertFloatsToBytesLoop, Image::convertFloatsToBytes, floats, n * 4, n * 4, n * 4);
+
+    // name, width, height, channels, frames
+    std::cout << std::endl;
+    benchSave("screenshot 1920x1080x3", 1920, 1080, 3, 10);
+    benchSave("screenshot 1920x1080x4", 1920, 1080, 4, 10);
+    benchSave("frame dump 1278x720x3", 1278, 720, 3, 60);     // width with paddings
+
+    // 8-bit images for RLE8
+    const int size = 1024;
+    std::vector<unsigned char> image;
+    std::cout << std::endl;
+    buildMask(image, size, size);
+    benchRLE("mask 1024x1024", size, size, image);
+    buildUITexture(image, size, size);
+    benchRLE("UI 1024x1024", size, size, image);
+    for(std::size_t i = 0; i < image.size(); ++i)
+        image[i] = pixels[i];
+    benchRLE("noise 1024x1024", size, size, image);
+
+    // name, width, height, channels, source pixels
+    std::cout << std::endl;
+    benchMips("mips 1024x1024x1", 1024, 1024, 1, pixels);
+    benchMips("mips 1024x1024x3", 1024, 1024, 3, pixels);
+    benchMips("mips 1024x1024x4", 1024, 1024, 4, pixels);
+    benchMips("mips 1000x600x3", 1000, 600, 3, pixels);     // odd sizes from 125x75
+
+    // name, width, height, channels
+    std::cout << std::endl;
+    benchBlocks("BC4 1024x1024x1", 1024, 1024, 1);
+    benchBlocks("BC1 1024x1024x3", 1024, 1024, 3);
+    benchBlocks("BC3 1024x1024x4", 1024, 1024, 4);
+
+    // name, width, height, channels
+    std::cout << std::endl;
+    benchLoad("load 2048x1024x3", 2048, 1024, 3);
+    benchLoad("load 2048x1024x4", 2048, 1024, 4);
+
+    // name, width, height, channels, downscaled width and height
+    std::cout << std::endl;
+    benchResample("resize 4096x2048x3", 4096, 2048, 3, 1024, 512);
+    benchResample("resize 4096x2048x4", 4096, 2048, 4, 1365, 683);
+
+    // name, image count, min and max size, page size
+    std::cout << std::endl;
+    benchPack("pack 2000 of 16~128", 2000, 16, 128, 1024);
+    benchPack("pack 5000 of 8~64", 5000, 8, 64, 1024);
+    benchPack("pack 1000 of 32~256", 1000, 32, 256, 2048);
+
+    // name, width, height, bit count, compression
+    std::cout << std::endl;
+    checkHeader("width 0x08000000 x 32 bits", 0x08000000, 1, 32, 0);
+    checkHeader("width 0x7fffffff x 8 bits", 0x7fffffff, 1, 8, 0);
+    checkHeader("height INT_MIN", 16, (int)0x80000000, 24, 0);
+    checkHeader("RLE8 60000x60000", 60000, 60000, 8, 1);
+
+    // name, width, height, compress
+    std::cout << std::endl;
+    benchCache("cache 2048x1024x3", 2048, 1024, false);
+    benchCache("cache 2048x1024x3 BC1", 2048, 1024, true);
+
+    return 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// run a plain loop and a PixelConvert kernel over the same source, and
+// compare the speed and the outputs
+///////////////////////////////////////////////////////////////////////////////
+template<typename S, typename D>
+void benchConvert(const char* name, void (*loop)(const S*, D*, std::size_t), void (*kernel)(const S*, D*, std::size_t),
+                  const std::vector<S>& src, std::size_t count, std::size_t srcSize, std::size_t dstSize)
+{
+    std::vector<D> dstLoop(dstSize), dstKernel(dstSize);
+    std::size_t srcBytes = srcSize * sizeof(S);
+    Timer timer;
+
+    // warm up
+    loop(src.data(), dstLoop.data(), count);
+    kernel(src.data(), dstKernel.data(), count);
+    bool same = memcmp(dstLoop.data(), dstKernel.data(), dstSize * sizeof(D)) == 0;
+
+    timer.start();
+    for(int i = 0; i < REPEAT_COUNT; ++i)
+        loop(src.data(), dstLoop.data(), count);
+    timer.stop();
+    double loopTime = timer.getElapsedTimeInMicroSec();
+
+    timer.start();
+    for(int i = 0; i < REPEAT_COUNT; ++i)
+        kernel(src.data(), dstKernel.data(), count);
+    timer.stop();
+    double kernelTime = timer.getElapsedTimeInMicroSec();
+
+    std::string loopName = std::string(name) + " loop";
+    printResult(loopName.c_str(), loopTime, srcBytes * REPEAT_COUNT, 1.0, true);
+    printResult(name, kernelTime, srcBytes * REPEAT_COUNT, loopTime / kernelTime, same);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// plain loops, same results as PixelConvert
+///////////////////////////////////////////////////////////////////////////////
+void swapRedBlue24Loop(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    for(std::size_t i = 0; i < count * 3; i += 3)
+    {
+        dst[i] = src[i+2];
+        dst[i+1] = src[i+1];
+        dst[i+2] = src[i];
+    }
+}
+
+void swapRedBlue32Loop(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    for(std::size_t i = 0; i < count * 4; i += 4)
+    {
+        dst[i] = src[i+2];
+        dst[i+1] = src[i+1];
+        dst[i+2] = src[i];
+        dst[i+3] = src[i+3];
+    }
+}
+
+void convertRGBToRGBALoop(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        dst[i*4] = src[i*3];
+        dst[i*4+1] = src[i*3+1];
+        dst[i*4+2] = src[i*3+2];
+        dst[i*4+3] = 255;
+    }
+}
+
+void convertRGBToGrayLoop(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    for(std::size_t i = 0; i < count; ++i)
+        dst[i] = (unsigned char)((src[i*3] * 77 + src[i*3+1] * 150 + src[i*3+2] * 29 + 128) >> 8);
+}
+
+void convertRGBAToGrayLoop(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    for(std::size_t i = 0; i < count; ++i)
+        dst[i] = (unsigned char)((src[i*4] * 77 + src[i*4+1] * 150 + src[i*4+2] * 29 + 128) >> 8);
+}
+
+void premultiplyAlphaLoop(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    for(std::size_t i = 0; i < count * 4; i += 4)
+    {
+        int a = src[i+3];
+        dst[i] = (unsigned char)((src[i] * a + 127) / 255);
+        dst[i+1] = (unsigned char)((src[i+1] * a + 127) / 255);
+        dst[i+2] = (unsigned char)((src[i+2] * a + 127) / 255);
+        dst[i+3] = (unsigned char)a;
+    }
+}
+
+void convertBytesToFloatsLoop(const unsigned char* src, float* dst, std::size_t count)
+{
+    for(std::size_t i = 0; i < count; ++i)
+        dst[i] = src[i] * (1.0f / 255.0f);
+}
+
+void convertFloatsToBytesLoop(const float* src, unsigned char* dst, std::size_t count)
+{
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        float x = src[i] < 0.0f ? 0.0f : (src[i] > 1.0f ? 1.0f : src[i]);
+        dst[i] = (unsigned char)(x * 255.0f + 0.5f);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// save frames with the stream writer and Bmp::save(), each frame overwrites
+// the same file, and the files of both must be identical
+///////////////////////////////////////////////////////////////////////////////
+void benchSave(const char* name, int width, int height, int channelCount, int frameCount)
+{
+    std::size_t frameSize = (std::size_t)width * height * channelCount;
+    std::vector<unsigned char> frame(frameSize);
+    for(std::size_t i = 0; i < frameSize; ++i)
+        frame[i] = (unsigned char)(i * 7 + i / 4093);
+
+    Image::Bmp bmp;
+    Timer timer;
+
+    // both overwrite the same file, the file system costs depend on it
+    timer.start();
+    for(int i = 0; i < frameCount; ++i)
+        saveWithStream(SAVE_FILE_NAME, width, height, channelCount, frame.data());
+    timer.stop();
+    double streamTime = timer.getElapsedTimeInMicroSec();
+
+    timer.start();
+    for(int i = 0; i < frameCount; ++i)
+        bmp.save(SAVE_FILE_NAME, width, height, channelCount, frame.data());
+    timer.stop();
+    double saveTime = timer.getElapsedTimeInMicroSec();
+
+    std::string streamFileName = std::string("stream_") + SAVE_FILE_NAME;
+    saveWithStream(streamFileName.c_str(), width, height, channelCount, frame.data());
+    bool same = compareFiles(streamFileName.c_str(), SAVE_FILE_NAME);
+    std::remove(streamFileName.c_str());
+    std::remove(SAVE_FILE_NAME);
+
+    std::size_t bytes = frameSize * frameCount;
+    std::string streamName = std::string(name) + " stream";
+    printResult(streamName.c_str(), streamTime, bytes, 1.0, true, true);
+    printResult(name, saveTime, bytes, streamTime / saveTime, same, true);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// save BMP with a copy of the whole image and std::ofstream, the way
+// Bmp::save() did before BmpWriter
+///////////////////////////////////////////////////////////////////////////////
+bool saveWithStream(const char* fileName, int width, int height, int channelCount, const unsigned char* data)
+{
+    int lineWidth = width * channelCount;
+    int paddings = (4 - (lineWidth % 4)) % 4;
+    int dataSize = lineWidth * height;
+    int dataSizeWithPaddings = (lineWidth + paddings) * height;
+    int paletteSize = (channelCount == 1) ? 1024 : 0;
+    int dataOffset = 54 + paletteSize;
+    int fileSize = dataSizeWithPaddings + dataOffset;
+    int infoHeaderSize = 40, compression = 0, resolution = 2835;
+    int colorCount = (channelCount == 1) ? 256 : 0, importantColorCount = 0;
+    short reserved = 0, planeCount = 1, bitCount = (short)(channelCount * 8);
+
+    // swizzled copy, then padded copy
+    std::vector<unsigned char> tmpData(data, data + dataSize);
+    for(int i = 0; channelCount > 1 && i < dataSize; i += channelCount)
+        std::swap(tmpData[i], tmpData[i+2]);
+    std::vector<unsigned char> dataWithPaddings(dataSizeWithPaddings);
+    for(int i = 0; i < height; ++i)
+    {
+        memcpy(&dataWithPaddings[i*(lineWidth+paddings)], &tmpData[i*lineWidth], lineWidth);
+        for(int j = 1; j <= paddings; ++j)
+            dataWithPaddings[(i+1)*(lineWidth+paddings) - j] = 0;
+    }
+
+    std::ofstream outFile(fileName, std::ios::binary);
+    outFile.put('B');
+    outFile.put('M');
+    outFile.write((char*)&fileSize, 4);
+    outFile.write((char*)&reserved, 2);
+    outFile.write((char*)&reserved, 2);
+    outFile.write((char*)&dataOffset, 4);
+    outFile.write((char*)&infoHeaderSize, 4);
+    outFile.write((char*)&width, 4);
+    outFile.write((char*)&height, 4);
+    outFile.write((char*)&planeCount, 2);
+    outFile.write((char*)&bitCount, 2);
+    outFile.write((char*)&compression, 4);
+    outFile.write((char*)&dataSizeWithPaddings, 4);
+    outFile.write((char*)&resolution, 4);
+    outFile.write((char*)&resolution, 4);
+    outFile.write((char*)&colorCount, 4);
+    outFile.write((char*)&importantColorCount, 4);
+    for(int i = 0; i < paletteSize / 4; ++i)
+    {
+        unsigned char entry[4] = { (unsigned char)i, (unsigned char)i, (unsigned char)i, 0 };
+        outFile.write((char*)entry, 4);
+    }
+    outFile.write((char*)dataWithPaddings.data(), dataSizeWithPaddings);
+    return outFile.good();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// save an 8-bit image uncompressed and with RLE8, then compare the file sizes
+// and the decode speed of both
+///////////////////////////////////////////////////////////////////////////////
+void benchRLE(const char* name, int width, int height, const std::vector<unsigned char>& image)
+{
+    const int READ_COUNT = 20;
+    std::string rleFileName = std::string("rle_") + SAVE_FILE_NAME;
+    Image::Bmp raw, rle;
+    raw.save(SAVE_FILE_NAME, width, height, 1, image.data());
+    raw.save(rleFileName.c_str(), width, height, 1, image.data(), true);
+    long rawSize = getFileSize(SAVE_FILE_NAME);
+    long rleSize = getFileSize(rleFileName.c_str());
+
+    Timer timer;
+    timer.start();
+    for(int i = 0; i < READ_COUNT; ++i)
+        raw.read(SAVE_FILE_NAME);
+    timer.stop();
+    double rawTime = timer.getElapsedTimeInMicroSec();
+
+    timer.start();
+    for(int i = 0; i < READ_COUNT; ++i)
+        rle.read(rleFileName.c_str());
+    timer.stop();
+    double rleTime = timer.getElapsedTimeInMicroSec();
+
+    bool same = raw.getDataSize() == rle.getDataSize() &&
+                memcmp(raw.getData(), rle.getData(), raw.getDataSize()) == 0;
+    std::remove(SAVE_FILE_NAME);
+    std::remove(rleFileName.c_str());
+
+    std::size_t bytes = (std::size_t)width * height * READ_COUNT;
+    std::ostringstream rawName, rleName;
+    rawName << name << " raw " << rawSize / 1024 << "KB";
+    rleName << name << " rle8 " << rleSize / 1024 << "KB";
+    printResult(rawName.str().c_str(), rawTime, bytes, 1.0, true, true);
+    printResult(rleName.str().c_str(), rleTime, bytes, rawTime / rleTime, same, true);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// build the full mip chain with a plain loop and MipChain, then MipChain with
+// the slower filters
+///////////////////////////////////////////////////////////////////////////////
+void benchMips(const char* name, int width, int height, int channelCount, const std::vector<unsigned char>& pixels)
+{
+    const int BUILD_COUNT = 10;
+    std::vector<unsigned char> image((std::size_t)width * height * channelCount);
+    for(std::size_t i = 0; i < image.size(); ++i)
+        image[i] = pixels[i % pixels.size()];
+
+    std::vector<unsigned char> chain;
+    Image::MipChain mips;
+    Timer timer;
+
+    timer.start();
+    for(int i = 0; i < BUILD_COUNT; ++i)
+        buildMipsLoop(image.data(), width, height, channelCount, chain);
+    timer.stop();
+    double loopTime = timer.getElapsedTimeInMicroSec();
+
+    std::size_t bytes = image.size() * BUILD_COUNT;
+    std::string loopName = std::string(name) + " loop";
+    printResult(loopName.c_str(), loopTime, bytes, 1.0, true, true);
+
+    const char* filterNames[4] = { " box", " box linear", " kaiser", " kaiser linear" };
+    for(int i = 0; i < 4; ++i)
+    {
+        Image::MipChain::Filter filter = (i < 2) ? Image::MipChain::FILTER_BOX : Image::MipChain::FILTER_KAISER;
+        bool linear = (i % 2) == 1;
+
+        timer.start();
+        for(int j = 0; j < BUILD_COUNT; ++j)
+            mips.build(image.data(), width, height, channelCount, filter, linear);
+        timer.stop();
+        double time = timer.getElapsedTimeInMicroSec();
+
+        // only the box filter in gamma space of power of 2 sizes is the same
+        // as the plain loop
+        bool powerOf2 = (width & (width - 1)) == 0 && (height & (height - 1)) == 0;
+        bool same = (i > 0) || !powerOf2 || (chain.size() == mips.getBufferSize() &&
+                                memcmp(chain.data(), mips.getBuffer(), chain.size()) == 0);
+        std::string mipName = std::string(name) + filterNames[i];
+        printResult(mipName.c_str(), time, bytes, loopTime / time, same, true);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// mip chain with 2x2 averages, valid only while both sizes are even (or 1)
+///////////////////////////////////////////////////////////////////////////////
+void buildMipsLoop(const unsigned char* src, int width, int height, int channelCount, std::vector<unsigned char>& chain)
+{
+    const int c = channelCount;
+    std::size_t size = (std::size_t)width * height * c;
+    chain.assign(src, src + size);
+
+    std::size_t offset = 0;
+    while(width > 1 || height > 1)
+    {
+        int w = (width > 1) ? width / 2 : 1;
+        int h = (height > 1) ? height / 2 : 1;
+        int dx = (width > 1) ? c : 0;               // offset to the right pixel
+        std::size_t dy = (height > 1) ? (std::size_t)width * c : 0;
+        chain.resize(offset + size + (std::size_t)w * h * c);
+
+        const unsigned char* s = &chain[offset];
+        unsigned char* d = &chain[offset + size];
+        for(int y = 0; y < h; ++y)
+        {
+            for(int x = 0; x < w; ++x)
+            {
+                const unsigned char* p = s + ((std::size_t)y * 2 * width + x * 2) * c;
+                for(int i = 0; i < c; ++i)
+                    d[((std::size_t)y * w + x) * c + i] = (unsigned char)((p[i] + p[i + dx] + p[i + dy] + p[i + dx + dy] + 2) >> 2);
+            }
+        }
+
+        offset += size;
+        size = (std::size_t)w * h * c;
+        width = w;
+        height = h;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// encode an image with each quality preset, then decode it to measure PSNR
+///////////////////////////////////////////////////////////////////////////////
+void benchBlocks(const char* name, int width, int height, int channelCount)
+{
+    const int ENCODE_COUNT = 3;
+    std::vector<unsigned char> image;
+    buildSmoothImage(image, width, height, channelCount);
+
+    Image::BlockFormat format = Image::getBlockFormat(channelCount);
+    std::vector<unsigned char> blocks(Image::getBlockDataSize(format, width, height));
+    std::vector<unsigned char> poolBlocks(blocks.size());
+    std::vector<unsigned char> decoded(image.size());
+    ThreadPool pool;
+    Timer timer;
+
+    const char* qualityNames[3] = { " fast", " normal", " high" };
+    for(int i = 0; i < 3; ++i)
+    {
+        Image::BlockQuality quality = (Image::BlockQuality)i;
+        timer.start();
+        for(int j = 0; j < ENCODE_COUNT; ++j)
+            Image::encodeBlocks(image.data(), width, height, channelCount, format, blocks.data(), quality);
+        timer.stop();
+        double time = timer.getElapsedTimeInMicroSec();
+
+        Image::encodeBlocks(image.data(), width, height, channelCount, format, poolBlocks.data(), quality, &pool);
+        bool same = poolBlocks == blocks;
+
+        Image::decodeBlocks(blocks.data(), width, height, format, decoded.data(), channelCount);
+        double psnr = Image::computePSNR(image.data(), decoded.data(), image.size());
+
+        std::string blockName = std::string(name) + qualityNames[i];
+        std::cout << std::left << std::setw(32) << blockName << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(8)
+                  << image.size() * ENCODE_COUNT / time << " MB/s"
+                  << std::setw(8) << psnr << " dB"
+                  << std::setw(6) << (double)image.size() / blocks.size() << ":1"
+                  << (same ? "" : "  (MISMATCH)") << std::endl;
+        std::cout << std::resetiosflags(std::ios_base::fixed | std::ios_base::floatfield);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// fill level 0 of mipmaps by Bmp::read() and a copy, then by ImageLoader
+///////////////////////////////////////////////////////////////////////////////
+void benchLoad(const char* name, int width, int height, int channelCount)
+{
+    const int LOAD_COUNT = 20;
+    const char* BMP_FILE_NAME = "loadBench.bmp";
+    std::vector<unsigned char> image;
+    buildSmoothImage(image, width, height, channelCount);
+    Image::Bmp writer;
+    writer.save(BMP_FILE_NAME, width, height, channelCount, image.data());
+
+    Timer timer;
+    Image::MipChain mips;
+    timer.start();
+    for(int i = 0; i < LOAD_COUNT; ++i)
+    {
+        Image::Bmp bmp;
+        bmp.read(BMP_FILE_NAME, Image::Bmp::ORDER_RGB);
+        unsigned char* level0 = mips.allocate(width, height, channelCount);
+        memcpy(level0, bmp.getData(), bmp.getDataSize());
+    }
+    timer.stop();
+    double readTime = timer.getElapsedTimeInMicroSec();
+    std::vector<unsigned char> expected(mips.getData(0), mips.getData(0) + mips.getDataSize(0));
+
+    timer.start();
+    for(int i = 0; i < LOAD_COUNT; ++i)
+    {
+        Image::ImageLoader loader;
+        loader.open(BMP_FILE_NAME, Image::Bmp::ORDER_RGB);
+        unsigned char* level0 = mips.allocate(loader.getWidth(), loader.getHeight(), loader.getChannelCount());
+        loader.decode(level0, mips.getDataSize(0));
+    }
+    timer.stop();
+    double loadTime = timer.getElapsedTimeInMicroSec();
+
+    std::size_t bytes = image.size() * LOAD_COUNT;
+    bool same = memcmp(expected.data(), mips.getData(0), expected.size()) == 0;
+    std::string readName = std::string(name) + " Bmp+copy";
+    std::string loadName = std::string(name) + " ImageLoader";
+    printResult(readName.c_str(), readTime, bytes, 1.0, true, true);
+    printResult(loadName.c_str(), loadTime, bytes, readTime / loadTime, same, true);
+    std::remove(BMP_FILE_NAME);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// downscale with each filter, then mipmaps and BC1 of the full and the
+// downscaled image
+///////////////////////////////////////////////////////////////////////////////
+void benchResample(const char* name, int width, int height, int channelCount, int dstWidth, int dstHeight)
+{
+    std::vector<unsigned char> image;
+    buildSmoothImage(image, width, height, channelCount);
+    std::vector<unsigned char> resampled((std::size_t)dstWidth * dstHeight * channelCount);
+    std::vector<unsigned char> poolResampled(resampled.size());
+    ThreadPool pool;
+    Timer timer;
+
+    const Image::MipChain::Filter filters[3] = { Image::MipChain::FILTER_BOX, Image::MipChain::FILTER_MITCHELL,
+                                                 Image::MipChain::FILTER_LANCZOS3 };
+    const char* filterNames[3] = { " box", " Mitchell", " Lanczos3" };
+    for(int i = 0; i < 3; ++i)
+    {
+        timer.start();
+        Image::MipChain::resample(image.data(), width, height, channelCount, resampled.data(),
+                                  dstWidth, dstHeight, filters[i], true);
+        timer.stop();
+        double time = timer.getElapsedTimeInMicroSec();
+
+        timer.start();
+        Image::MipChain::resample(image.data(), width, height, channelCount, poolResampled.data(),
+                                  dstWidth, dstHeight, filters[i], true, &pool);
+        timer.stop();
+        double poolTime = timer.getElapsedTimeInMicroSec();
+
+        std::string filterName = std::string(name) + filterNames[i];
+        std::string poolName = filterName + " pool";
+        bool same = poolResampled == resampled;
+        printResult(filterName.c_str(), time, image.size(), 1.0, true, true);
+        printResult(poolName.c_str(), poolTime, image.size(), time / poolTime, same, true);
+    }
+    if(channelCount != 3)
+        return;
+
+    // the texture of a loader at the full size and downscaled (by Lanczos3)
+    Image::MipChain mips;
+    Image::CompressedChain blocks;
+    timer.start();
+    mips.build(image.data(), width, height, channelCount, Image::MipChain::FILTER_BOX, true, &pool);
+    blocks.build(mips, Image::BLOCK_BC1, Image::QUALITY_NORMAL, &pool);
+    timer.stop();
+    double fullTime = timer.getElapsedTimeInMicroSec();
+    std::size_t fullSize = blocks.getBufferSize();
+
+    timer.start();
+    unsigned char* level0 = mips.allocate(dstWidth, dstHeight, channelCount);
+    Image::MipChain::resample(image.data(), width, height, channelCount, level0, dstWidth, dstHeight,
+                              Image::MipChain::FILTER_LANCZOS3, true, &pool);
+    mips.buildLevels(Image::MipChain::FILTER_BOX, true, &pool);
+    blocks.build(mips, Image::BLOCK_BC1, Image::QUALITY_NORMAL, &pool);
+    timer.stop();
+    double limitTime = timer.getElapsedTimeInMicroSec();
+
+    std::string fullName = std::string(name) + " BC1 full";
+    std::string limitName = std::string(name) + " BC1 limited";
+    std::cout << std::left << std::setw(32) << fullName << std::right
+              << std::fixed << std::setprecision(2) << std::setw(8) << fullTime / 1000 << " ms"
+              << std::setw(8) << fullSize / (1024.0 * 1024) << " MB" << std::endl;
+    std::cout << std::left << std::setw(32) << limitName << std::right
+              << std::setw(8) << limitTime / 1000 << " ms"
+              << std::setw(8) << blocks.getBufferSize() / (1024.0 * 1024) << " MB"
+              << std::setw(8) << fullTime / limitTime << "x" << std::endl;
+    std::cout << std::resetiosflags(std::ios_base::fixed | std::ios_base::floatfield);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// pack random sizes into atlas pages by shelves and by TexturePacker
+///////////////////////////////////////////////////////////////////////////////
+void benchPack(const char* name, int imageCount, int minSize, int maxSize, int pageSize)
+{
+    const int GUTTER = 2;
+    const int ALIGNMENT = 4;
+    std::vector<int> widths(imageCount), heights(imageCount);
+    unsigned int seed = 1357;
+    double area = 0;
+    for(int i = 0; i < imageCount; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        widths[i] = minSize + (seed >> 8) % (maxSize - minSize + 1);
+        seed = seed * 1664525u + 1013904223u;
+        heights[i] = minSize + (seed >> 8) % (maxSize - minSize + 1);
+        area += (double)widths[i] * heights[i];
+    }
+    double pageArea = (double)pageSize * pageSize;
+
+    Timer timer;
+    timer.start();
+    int shelfPages = packShelves(widths, heights, pageSize, GUTTER, ALIGNMENT);
+    timer.stop();
+    double shelfTime = timer.getElapsedTimeInMicroSec();
+
+    Image::TexturePacker packer;
+    for(int i = 0; i < imageCount; ++i)
+        packer.add(widths[i], heights[i]);
+    timer.start();
+    bool packed = packer.packAtlas(pageSize, pageSize, GUTTER, ALIGNMENT);
+    timer.stop();
+    double packTime = timer.getElapsedTimeInMicroSec();
+
+    std::string shelfName = std::string(name) + " shelf";
+    std::string packName = std::string(name) + " skyline";
+    std::cout << std::left << std::setw(32) << shelfName << std::right
+              << std::fixed << std::setprecision(2) << std::setw(4) << shelfPages << " pages"
+              << std::setw(8) << area / (pageArea * shelfPages) * 100 << "%"
+              << std::setw(10) << shelfTime / 1000 << " ms" << std::endl;
+    std::cout << std::left << std::setw(32) << packName << std::right
+              << std::setw(4) << packer.getPageCount() << " pages"
+              << std::setw(8) << packer.getOccupancy() * 100 << "%"
+              << std::setw(10) << packTime / 1000 << " ms"
+              << (packed ? "" : "  (FAILED)") << std::endl;
+    std::cout << std::resetiosflags(std::ios_base::fixed | std::ios_base::floatfield);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// pack slots in rows from the tallest, a new row when the width is full and
+// a new page when the height is full, return the number of pages
+///////////////////////////////////////////////////////////////////////////////
+int packShelves(const std::vector<int>& widths, const std::vector<int>& heights, int pageSize, int gutter, int alignment)
+{
+    std::vector<int> order(widths.size());
+    for(std::size_t i = 0; i < order.size(); ++i)
+        order[i] = (int)i;
+    std::stable_sort(order.begin(), order.end(), [&heights](int a, int b) { return heights[a] > heights[b]; });
+
+    int pageCount = 1, x = 0, y = 0, shelfHeight = 0;
+    for(std::size_t i = 0; i < order.size(); ++i)
+    {
+        int width = (widths[order[i]] + gutter * 2 + alignment - 1) / alignment * alignment;
+        int height = (heights[order[i]] + gutter * 2 + alignment - 1) / alignment * alignment;
+        if(x + width > pageSize)
+        {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        if(y + height > pageSize)
+        {
+            ++pageCount;
+            x = y = 0;
+            shelfHeight = 0;
+        }
+        x += width;
+        shelfHeight = std::max(shelfHeight, height);
+    }
+    return pageCount;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// decode a BMP to mipmaps (and BC1) and write it to the cache in the current
+// directory, then find it with a new cache as on the next run
+///////////////////////////////////////////////////////////////////////////////
+void benchCache(const char* name, int width, int height, bool compress)
+{
+    const char* BMP_FILE_NAME = "cacheBench.bmp";
+    std::vector<unsigned char> image;
+    buildSmoothImage(image, width, height, 3);
+    Image::Bmp writer;
+    writer.save(BMP_FILE_NAME, width, height, 3, image.data());
+
+    Image::TextureCache::Key key;
+    Image::TextureCache::getKey(BMP_FILE_NAME, compress ? 1 : 0, 0, 0, key);
+    Timer timer;
+
+    // first run: decode, then write the cache file
+    timer.start();
+    Image::Bmp bmp;
+    bmp.read(BMP_FILE_NAME, Image::Bmp::ORDER_RGB);
+    Image::MipChain mips;
+    mips.build(bmp.getData(), width, height, 3, Image::MipChain::FILTER_BOX, true);
+    std::shared_ptr<Image::TextureBlob> blob(new Image::TextureBlob);
+    if(compress)
+    {
+        Image::CompressedChain blocks;
+        blocks.build(mips, Image::BLOCK_BC1);
+        blob->set(blocks);
+    }
+    else
+    {
+        blob->set(mips);
+    }
+    timer.stop();
+    double decodeTime = timer.getElapsedTimeInMilliSec();
+
+    Image::TextureCache cache;
+    cache.setDirectory(".");
+    timer.start();
+    cache.insert(key, blob);
+    timer.stop();
+    double writeTime = timer.getElapsedTimeInMilliSec();
+
+    // next run: map the file and touch all levels
+    Image::TextureCache nextCache;
+    nextCache.setDirectory(".");
+    timer.start();
+    std::shared_ptr<const Image::TextureBlob> found = nextCache.find(key);
+    volatile unsigned int sum = 0;                  // not optimized out
+    for(int i = 0; found && i < found->getLevelCount(); ++i)
+    {
+        const unsigned char* data = found->getData(i);
+        for(std::size_t j = 0; j < found->getDataSize(i); j += 64)
+            sum += data[j];
+    }
+    timer.stop();
+    double findTime = timer.getElapsedTimeInMilliSec();
+
+    bool same = found && found->getSize() == blob->getSize() &&
+                memcmp(found->getData(0), blob->getData(0), blob->getSize()) == 0;
+    std::cout << std::left << std::setw(32) << name << std::right
+              << std::fixed << std::setprecision(2)
+              << "decode " << std::setw(7) << decodeTime << " ms, write " << std::setw(6) << writeTime
+              << " ms, cached " << std::setw(6) << findTime << " ms" << std::setw(8) << decodeTime / findTime << "x"
+              << (same ? "" : "  (MISMATCH)") << std::endl;
+    std::cout << std::resetiosflags(std::ios_base::fixed | std::ios_base::floatfield);
+
+    found.reset();
+    nextCache.remove(key);
+    std::remove(BMP_FILE_NAME);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// smooth gradients and waves like a photo texture, alpha with hard edges
+///////////////////////////////////////////////////////////////////////////////
+void buildSmoothImage(std::vector<unsigned char>& image, int width, int height, int channelCount)
+{
+    image.resize((std::size_t)width * height * channelCount);
+    for(int y = 0; y < height; ++y)
+    {
+        for(int x = 0; x < width; ++x)
+        {
+            unsigned char* p = &image[((std::size_t)y * width + x) * channelCount];
+            float wave = sinf(x * 0.031f + sinf(y * 0.017f) * 3) * cosf(y * 0.023f);
+            int r = (int)(x * 255.0f / width * 0.6f + 60 * wave + 50);
+            int g = (int)(y * 255.0f / height * 0.5f + 40 * wave + 70);
+            int b = (int)(120 + 100 * wave);
+            p[0] = (unsigned char)(r < 0 ? 0 : (r > 255 ? 255 : r));
+            if(channelCount >= 3)
+            {
+                p[1] = (unsigned char)(g < 0 ? 0 : (g > 255 ? 255 : g));
+                p[2] = (unsigned char)(b < 0 ? 0 : (b > 255 ? 255 : b));
+            }
+            if(channelCount == 4)
+                p[3] = (wave > 0.3f) ? 255 : (wave < -0.3f ? 0 : (unsigned char)((wave + 0.3f) * 425));
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// alpha mask: discs and rectangles with antialiased edges on 0
+///////////////////////////////////////////////////////////////////////////////
+void buildMask(std::vector<unsigned char>& image, int width, int height)
+{
+    image.assign((std::size_t)width * height, 0);
+    for(int y = 0; y < height; ++y)
+    {
+        for(int x = 0; x < width; ++x)
+        {
+            // disc at the center, the edge is 2 pixels wide
+            float dx = x - width * 0.5f, dy = y - height * 0.5f;
+            float d = width * 0.3f - std::sqrt(dx * dx + dy * dy);
+            int a = (d >= 1.0f) ? 255 : (d <= -1.0f ? 0 : (int)((d + 1.0f) * 127.5f));
+
+            // rounded off corners are not needed for the run lengths
+            if(x > width / 16 && x < width / 4 && y > height / 16 && y < height / 3)
+                a = 255;
+            image[(std::size_t)y * width + x] = (unsigned char)a;
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// UI texture: flat panels with borders and rows of glyph-like dots
+///////////////////////////////////////////////////////////////////////////////
+void buildUITexture(std::vector<unsigned char>& image, int width, int height)
+{
+    image.assign((std::size_t)width * height, 40);
+    unsigned int seed = 1357;
+    for(int y = 0; y < height; ++y)
+    {
+        for(int x = 0; x < width; ++x)
+        {
+            int px = x % 256, py = y % 128;
+            unsigned char c = 40;                           // background
+            if(px >= 8 && px < 248 && py >= 8 && py < 120)
+            {
+                c = 70;                                     // panel
+                if(px == 8 || px == 247 || py == 8 || py == 119)
+                    c = 160;                                // border
+                else if(py >= 24 && py < 36 && px >= 20 && px < 200)
+                {
+                    // a line of text, random dots in 6x12 cells
+                    seed = seed * 1664525u + 1013904223u;
+                    if((px / 6) % 4 != 3 && (seed >> 28) < 6)
+                        c = 230;
+                }
+            }
+            image[(std::size_t)y * width + x] = c;
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// file size in bytes, -1 if it cannot be opened
+///////////////////////////////////////////////////////////////////////////////
+long getFileSize(const char* fileName)
+{
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    return file ? (long)file.tellg() : -1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// true if 2 files have the same contents
+///////////////////////////////////////////////////////////////////////////////
+bool compareFiles(const char* fileName1, const char* fileName2)
+{
+    std::ifstream file1(fileName1, std::ios::binary), file2(fileName2, std::ios::binary);
+    std::string data1((std::istreambuf_iterator<char>(file1)), std::istreambuf_iterator<char>());
+    std::string data2((std::istreambuf_iterator<char>(file2)), std::istreambuf_iterator<char>());
+    return !data1.empty() && data1 == data2;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// print GB/s (or MB/s) of source data and the speedup over the plain loop
+///////////////////////////////////////////////////////////////////////////////
+void printResult(const char* name, double elapsedUsec, std::size_t bytes, double speedup, bool same, bool mega)
+{
+    std::cout << std::left << std::setw(32) << name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(8)
+              << (mega ? bytes / elapsedUsec : bytes / (elapsedUsec * 1000.0))
+              << (mega ? " MB/s" : " GB/s")
+              << std::setw(8) << speedup << "x"
+              << (same ? "" : "  (MISMATCH)") << std::endl;
+    std::cout << std::resetiosflags(std::ios_base::fixed | std::ios_base::floatfield);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// write a 64-byte BMP with the given header fields, then all readers must
+// fail to open it without crashing
+///////////////////////////////////////////////////////////////////////////////
+bool checkHeader(const char* name, int width, int height, int bitCount, int compression)
+{
+    unsigned char file[64] = {};
+    const unsigned int fields[][2] = { {2, 64}, {10, 54}, {14, 40}, {18, (unsigned int)width},
+                                       {22, (unsigned int)height}, {30, (unsigned int)compression} };
+    file[0] = 'B';
+    file[1] = 'M';
+    for(std::size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); ++i)
+    {
+        for(int j = 0; j < 4; ++j)
+            file[fields[i][0] + j] = (unsigned char)(fields[i][1] >> (j * 8));
+    }
+    file[26] = 1;                                   // planes
+    file[28] = (unsigned char)bitCount;
+
+    const char* fileName = "imageBench_header.bmp";
+    std::ofstream out(fileName, std::ios::binary);
+    out.write((const char*)file, sizeof(file));
+    out.close();
+
+    Image::BmpHeader header;
+    std::string error;
+    Image::Bmp bmp;
+    Image::BmpMap map;
+    Image::BmpReader reader;
+    Image::ImageLoader loader;
+    bool parsed = Image::Bmp::parseHeader(file, sizeof(file), header, error);
+    bool read = bmp.read(fileName);
+    bool mapped = map.open(fileName);
+    bool opened = reader.open(fileName);
+    bool loaded = loader.open(file, sizeof(file));
+    map.close();
+    reader.close();
+    remove(fileName);
+
+    // RLE has no size limit from the file, so only read() sees the overflow
+    bool passed = !read && !mapped && !opened && (compression != 0 || (!parsed && !loaded));
+    std::cout << std::left << std::setw(28) << name << std::right
+              << (passed ? "rejected" : "ACCEPTED")
+              << "  (" << bmp.getError() << ")" << std::endl;
+    return passed;
+}
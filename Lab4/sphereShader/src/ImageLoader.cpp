@@ -0,0 +1,269 @@
+///////////////////////////////////////////////////////////////////////////////
+// ImageLoader.cpp
+// ===============
+// image file loader that decodes into a buffer given by the caller
+//
+// Dependencies: Bmp, MappedFile, PixelConvert, stb_image (optional)
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <climits>
+#include "ImageLoader.h"
+#include "PixelConvert.h"
+
+#if defined(IMAGE_LOADER_STB)
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_NO_STDIO                   // decoded from the mapped file
+#include "stb_image.h"
+#endif
+
+namespace Image
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// ctor
+///////////////////////////////////////////////////////////////////////////////
+ImageLoader::ImageLoader() : data(0), size(0), format(FILE_UNKNOWN), order(Bmp::ORDER_RGB),
+                             width(0), height(0), channelCount(0), errorMessage("No error.")
+{
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// map a file and read the header
+///////////////////////////////////////////////////////////////////////////////
+bool ImageLoader::open(const char* fileName, Bmp::ChannelOrder order)
+{
+    close();
+    errorMessage = "No error.";
+    if(!fileName)
+    {
+        errorMessage = "File name is not defined (NULL pointer).";
+        return false;
+    }
+    if(!file.open(fileName))
+    {
+        errorMessage = file.getError();
+        return false;
+    }
+
+    data = file.getData();
+    size = file.getSize();
+    this->order = order;
+    if(!readHeader())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// read the header of a file in memory
+///////////////////////////////////////////////////////////////////////////////
+bool ImageLoader::open(const unsigned char* data, std::size_t size, Bmp::ChannelOrder order)
+{
+    close();
+    errorMessage = "No error.";
+    if(!data || size == 0)
+    {
+        errorMessage = "Image data is not defined (NULL pointer or empty).";
+        return false;
+    }
+
+    this->data = data;
+    this->size = size;
+    this->order = order;
+    if(!readHeader())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// unmap the file, the error message is kept
+///////////////////////////////////////////////////////////////////////////////
+void ImageLoader::close()
+{
+    file.close();
+    data = 0;
+    size = 0;
+    format = FILE_UNKNOWN;
+    width = height = channelCount = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// detect the format and read the size and channels of the image
+///////////////////////////////////////////////////////////////////////////////
+bool ImageLoader::readHeader()
+{
+    format = detectFormat(data, size);
+    if(format == FILE_UNKNOWN)
+    {
+        errorMessage = "Unknown image file format.";
+        return false;
+    }
+    if(!isSupported(format))
+    {
+        errorMessage = "The image file format is not supported in this build (define IMAGE_LOADER_STB).";
+        return false;
+    }
+
+    if(format == FILE_BMP)
+    {
+        if(!Bmp::parseHeader(data, size, bmpHeader, errorMessage))
+            return false;
+        width = bmpHeader.width;
+        height = (bmpHeader.height < 0) ? -bmpHeader.height : bmpHeader.height;
+        channelCount = Bmp::getChannelCount(bmpHeader.bitCount < 8 ? 8 : bmpHeader.bitCount, order);
+        return true;
+    }
+
+#if defined(IMAGE_LOADER_STB)
+    int components;
+    if(size > INT_MAX || !stbi_info_from_memory(data, (int)size, &width, &height, &components))
+    {
+        errorMessage = "Failed to read the image header.";
+        return false;
+    }
+
+    // gray stays gray, gray with alpha is expanded to RGBA
+    if(components == 1)
+        channelCount = 1;
+    else if(components == 3 && order != Bmp::ORDER_RGBA)
+        channelCount = 3;
+    else
+        channelCount = 4;
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// size of dst for decode() with the stride, the last row is not padded
+///////////////////////////////////////////////////////////////////////////////
+std::size_t ImageLoader::getDataSize(std::size_t stride) const
+{
+    if(height == 0)
+        return 0;
+    if(stride == 0)
+        stride = getRowSize();
+    return stride * (height - 1) + getRowSize();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// decode the image to dst
+///////////////////////////////////////////////////////////////////////////////
+bool ImageLoader::decode(unsigned char* dst, std::size_t dstSize, std::size_t stride, ThreadPool* pool)
+{
+    if(!data)
+    {
+        errorMessage = "No image is open.";
+        return false;
+    }
+    if(stride == 0)
+        stride = getRowSize();
+    if(!dst || stride < getRowSize() || dstSize < getDataSize(stride))
+    {
+        errorMessage = "The destination buffer is too small.";
+        return false;
+    }
+
+    if(format == FILE_BMP)
+    {
+        Bmp::decode(data, size, bmpHeader, order, dst, (std::ptrdiff_t)stride, pool);
+        return true;
+    }
+    return decodeStb(dst, stride);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// decode with stb_image, then copy the rows to dst in the channel order
+///////////////////////////////////////////////////////////////////////////////
+bool ImageLoader::decodeStb(unsigned char* dst, std::size_t stride)
+{
+#if defined(IMAGE_LOADER_STB)
+    int w, h, components;
+    unsigned char* pixels = stbi_load_from_memory(data, (int)size, &w, &h, &components, channelCount);
+    if(!pixels || w != width || h != height)
+    {
+        stbi_image_free(pixels);
+        errorMessage = std::string("Failed to decode the image: ") + stbi_failure_reason();
+        return false;
+    }
+
+    const std::size_t rowSize = getRowSize();
+    bool swap = (order == Bmp::ORDER_BGR) && channelCount > 1;
+    for(int y = 0; y < height; ++y)
+    {
+        const unsigned char* src = pixels + y * rowSize;
+        unsigned char* row = dst + y * stride;
+        if(!swap)
+            memcpy(row, src, rowSize);
+        else if(channelCount == 3)
+            swapRedBlue24(src, row, width);
+        else
+            swapRedBlue32(src, row, width);
+    }
+    stbi_image_free(pixels);
+    return true;
+#else
+    (void)dst;
+    (void)stride;
+    errorMessage = "The image file format is not supported in this build (define IMAGE_LOADER_STB).";
+    return false;
+#endif
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// file format from the magic bytes
+///////////////////////////////////////////////////////////////////////////////
+FileFormat ImageLoader::detectFormat(const unsigned char* data, std::size_t size)
+{
+    static const unsigned char PNG_MAGIC[8] = { 0x89, 'P', 'N', 'G', 0x0d, 0x0a, 0x1a, 0x0a };
+    if(!data)
+        return FILE_UNKNOWN;
+    if(size >= 2 && data[0] == 'B' && data[1] == 'M')
+        return FILE_BMP;
+    if(size >= 8 && memcmp(data, PNG_MAGIC, 8) == 0)
+        return FILE_PNG;
+    if(size >= 3 && data[0] == 0xff && data[1] == 0xd8 && data[2] == 0xff)
+        return FILE_JPEG;
+    if(size >= 6 && (memcmp(data, "GIF87a", 6) == 0 || memcmp(data, "GIF89a", 6) == 0))
+        return FILE_GIF;
+    if(size >= 4 && memcmp(data, "8BPS", 4) == 0)
+        return FILE_PSD;
+    return FILE_UNKNOWN;
+}
+
+bool ImageLoader::isSupported(FileFormat format)
+{
+#if defined(IMAGE_LOADER_STB)
+    return format != FILE_UNKNOWN;
+#else
+    return format == FILE_BMP;
+#endif
+}
+
+} // namespace Image
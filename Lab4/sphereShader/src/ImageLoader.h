@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// ImageLoader.h
+// =============
+// image file loader that decodes into a buffer given by the caller
+// open() maps the file, detects the format by its magic bytes and reads the
+// header, so the size, channels and getDataSize() are known before decoding.
+// Then decode() writes the rows top-to-bottom straight into the destination,
+// e.g. level 0 of a MipChain, a mapped pixel unpack buffer or a memory mapped
+// file, with any row stride. There is no intermediate image buffer for BMP.
+//
+// BMP is decoded by Bmp. PNG, JPEG, GIF and PSD are decoded by stb_image if
+// this file is compiled with IMAGE_LOADER_STB defined and stb_image.h in the
+// include path (e.g. -DIMAGE_LOADER_STB -I../..), otherwise open() fails on
+// them. stb_image always returns its own buffer, so it is copied (and
+// swizzled if needed) into the destination once and freed.
+//
+// Dependencies: Bmp, MappedFile, PixelConvert, stb_image (optional)
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef IMAGE_IMAGE_LOADER_H
+#define IMAGE_IMAGE_LOADER_H
+
+#include <string>
+#include <cstddef>
+#include "Bmp.h"
+#include "MappedFile.h"
+
+class ThreadPool;
+
+namespace Image
+{
+    enum FileFormat
+    {
+        FILE_UNKNOWN = 0,
+        FILE_BMP,
+        FILE_PNG,
+        FILE_JPEG,
+        FILE_GIF,
+        FILE_PSD
+    };
+
+    class ImageLoader
+    {
+    public:
+        ImageLoader();
+
+        // open a file or a file in memory and read the header
+        // The output channels follow Bmp::ChannelOrder: ORDER_BGR and ORDER_RGB
+        // keep 1, 3 or 4 channels (gray with alpha becomes 4), ORDER_RGBA
+        // always gives 4 channels for color images. The memory of open(data)
+        // is not copied, so it must be valid until close().
+        bool open(const char* fileName, Bmp::ChannelOrder order=Bmp::ORDER_RGB);
+        bool open(const unsigned char* data, std::size_t size, Bmp::ChannelOrder order=Bmp::ORDER_RGB);
+        void close();
+
+        // decode the image to dst, rows top-to-bottom and stride bytes apart
+        // (0 = getRowSize(), packed rows). dstSize must be at least
+        // getDataSize(stride). If pool is given, BMP rows are decoded by its
+        // threads. It can be called more than once until close().
+        bool decode(unsigned char* dst, std::size_t dstSize, std::size_t stride=0, ThreadPool* pool=0);
+
+        FileFormat getFormat() const                { return format; }
+        int  getWidth() const                       { return width; }
+        int  getHeight() const                      { return height; }
+        int  getChannelCount() const                { return channelCount; }    // of decoded pixels
+        std::size_t getRowSize() const              { return (std::size_t)width * channelCount; }
+        std::size_t getDataSize(std::size_t stride=0) const;  // bytes decode() writes into
+        const char* getError() const                { return errorMessage.c_str(); }
+
+        // format from the first bytes of a file, FILE_UNKNOWN if not known
+        static FileFormat detectFormat(const unsigned char* data, std::size_t size);
+        static bool isSupported(FileFormat format); // decodable in this build
+
+    private:
+        ImageLoader(const ImageLoader&);            // not copyable
+        ImageLoader& operator=(const ImageLoader&);
+
+        bool readHeader();
+        bool decodeStb(unsigned char* dst, std::size_t stride);
+
+        MappedFile file;                            // if opened by file name
+        const unsigned char* data;
+        std::size_t size;
+        FileFormat format;
+        Bmp::ChannelOrder order;
+        BmpHeader bmpHeader;
+        int width;
+        int height;
+        int channelCount;
+        std::string errorMessage;
+    };
+}
+
+#endif // IMAGE_IMAGE_LOADER_H
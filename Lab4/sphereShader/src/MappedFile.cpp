@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile.cpp
+// ==============
+// read-only memory mapped file (mmap on Unix, file mapping on Windows)
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(WIN32) || defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "MappedFile.h"
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ctors/dtor
+///////////////////////////////////////////////////////////////////////////////
+MappedFile::MappedFile() : data(0), size(0), errorMessage("No error.")
+{
+}
+
+MappedFile::MappedFile(MappedFile&& rhs) : data(rhs.data), size(rhs.size), errorMessage(rhs.errorMessage)
+{
+    rhs.data = 0;
+    rhs.size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// move assignment, unmap the current file first
+///////////////////////////////////////////////////////////////////////////////
+MappedFile& MappedFile::operator=(MappedFile&& rhs)
+{
+    if(this != &rhs)
+    {
+        close();
+        data = rhs.data;
+        size = rhs.size;
+        errorMessage = rhs.errorMessage;
+        rhs.data = 0;
+        rhs.size = 0;
+    }
+    return *this;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// map the whole file as read-only
+// The file handle is closed right after mapping; the mapping keeps the file
+// contents accessible until close().
+///////////////////////////////////////////////////////////////////////////////
+bool MappedFile::open(const char* fileName)
+{
+    close();
+    errorMessage = "No error.";
+
+    if(!fileName)
+    {
+        errorMessage = "File name is not defined (NULL pointer).";
+        return false;
+    }
+
+#if defined(WIN32) || defined(_WIN32)
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        errorMessage = "Failed to open a file to map.";
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        errorMessage = "Empty file or failed to get the file size.";
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if(!mapping)
+    {
+        errorMessage = "Failed to map a file.";
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if(!view)
+    {
+        errorMessage = "Failed to map a file.";
+        return false;
+    }
+    size = (std::size_t)fileSize.QuadPart;
+
+#else
+    int fd = ::open(fileName, O_RDONLY);
+    if(fd < 0)
+    {
+        errorMessage = "Failed to open a file to map.";
+        return false;
+    }
+
+    struct stat status;
+    if(fstat(fd, &status) != 0 || status.st_size == 0)
+    {
+        ::close(fd);
+        errorMessage = "Empty file or failed to get the file size.";
+        return false;
+    }
+
+    void* view = mmap(0, (std::size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(view == MAP_FAILED)
+    {
+        errorMessage = "Failed to map a file.";
+        return false;
+    }
+    size = (std::size_t)status.st_size;
+
+    // the file is usually read front to back once
+    madvise(view, size, MADV_SEQUENTIAL);
+#endif
+
+    data = (const unsigned char*)view;
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// unmap the file, the pointer from getData() is invalid after this
+///////////////////////////////////////////////////////////////////////////////
+void MappedFile::close()
+{
+    if(!data)
+        return;
+
+#if defined(WIN32) || defined(_WIN32)
+    UnmapViewOfFile(data);
+#else
+    munmap((void*)data, size);
+#endif
+    data = 0;
+    size = 0;
+}
@@ -0,0 +1,46 @@
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile.h
+// ============
+// read-only memory mapped file (mmap on Unix, file mapping on Windows)
+// The whole file is mapped at open() and the contents can be accessed with
+// getData() without reading into a buffer. The pages are loaded by the OS on
+// first access. An empty file cannot be mapped, so open() fails on it.
+// It cannot be copied, but it can be moved.
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+class MappedFile
+{
+public:
+    MappedFile();
+    MappedFile(MappedFile&& rhs);
+    ~MappedFile();
+
+    MappedFile& operator=(MappedFile&& rhs);
+
+    bool open(const char* fileName);            // map whole file, close the previous one
+    void close();                               // unmap
+
+    bool isOpen() const                         { return data != 0; }
+    const unsigned char* getData() const        { return data; }
+    std::size_t getSize() const                 { return size; }
+    const char* getError() const                { return errorMessage.c_str(); }
+
+private:
+    MappedFile(const MappedFile&);              // not copyable
+    MappedFile& operator=(const MappedFile&);
+
+    const unsigned char* data;
+    std::size_t size;
+    std::string errorMessage;
+};
+
+#endif
@@ -0,0 +1,493 @@
+///////////////////////////////////////////////////////////////////////////////
+// MathBench.cpp
+// =============
+// micro benchmark of Matrices and Vectors
+// It measures per-object CPU cost of building modelview, MVP and normal
+// matrices for many objects, with chained operators and fused functions.
+// Vector3 operations are compared with Vector3Array bulk operations.
+// The hierarchy update is measured in 1 thread, new threads for each update,
+// and the workers of a ThreadPool.
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include "Matrices.h"
+#include "Transform.h"
+#include "TransformHierarchy.h"
+#include "Frustum.h"
+#include "VectorArrays.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+
+// constants
+const int OBJECT_COUNT = 100000;
+const int REPEAT_COUNT = 20;
+const int ROOT_COUNT   = 1000;          // hierarchy: 1000 trees of 100 nodes
+const int DIRTY_COUNT  = OBJECT_COUNT / 100;
+
+// function prototypes
+void initObjects(std::vector<Matrix4>& models, unsigned int seed);
+void initHierarchy(TransformHierarchy& hierarchy, const std::vector<Matrix4>& locals, unsigned int seed);
+void benchHierarchy(const char* name, TransformHierarchy& hierarchy, const std::vector<Matrix4>& locals,
+                    int dirtyCount, int threadCount, ThreadPool* pool=0);
+float randomFloat(unsigned int& seed, float min, float max);
+void benchCulling();
+void benchVectorArrays();
+void reportInvSqrtFast();
+void printResult(const char* name, double elapsedUsec, int count, float checksum);
+void printThroughput(const char* name, double elapsedUsec, int count, std::size_t visibleCount);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+    std::vector<Matrix4> models(OBJECT_COUNT);
+    std::vector<Matrix4> outMV(OBJECT_COUNT);
+    std::vector<Matrix4> outMVP(OBJECT_COUNT);
+    std::vector<Matrix4> outN(OBJECT_COUNT);
+    initObjects(models, 1234);
+
+    Matrix4 view;
+    view.rotateY(30).rotateX(20).translate(0, 0, -10);
+    Matrix4 projection(1.5f, 0, 0, 0,  0, 2.0f, 0, 0,  0, 0, -1.002f, -1,  0, 0, -0.2002f, 0);
+
+    Timer timer;
+    float checksum;
+    int i, j;
+
+    // chained operators with temporaries (same as frame() before fused API)
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(i = 0; i < OBJECT_COUNT; ++i)
+        {
+            outMV[i] = view * models[i];
+            outMVP[i] = projection * outMV[i];
+            outN[i] = outMV[i];
+            outN[i].setColumn(3, Vector4(0,0,0,1));
+        }
+        checksum += outMVP[j][0] + outN[j][5];
+    }
+    timer.stop();
+    printResult("MV/MVP/normal with operators", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    // fused
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(i = 0; i < OBJECT_COUNT; ++i)
+            Matrix4::computeMVPandNormal(projection, view, models[i], outMV[i], outMVP[i], outN[i]);
+        checksum += outMVP[j][0] + outN[j][5];
+    }
+    timer.stop();
+    printResult("MV/MVP/normal fused", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    // single product
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(i = 0; i < OBJECT_COUNT; ++i)
+            outMV[i] = view * models[i];
+        checksum += outMV[j][0];
+    }
+    timer.stop();
+    printResult("M1 * M2 operator", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(i = 0; i < OBJECT_COUNT; ++i)
+            Matrix4::multiply(view, models[i], outMV[i]);
+        checksum += outMV[j][0];
+    }
+    timer.stop();
+    printResult("Matrix4::multiply()", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    // inverse of rigid transforms: probing in Matrix4::invert() vs dispatch by type
+    std::vector<Transform> transforms(OBJECT_COUNT);
+    for(i = 0; i < OBJECT_COUNT; ++i)
+        transforms[i].set(models[i]);        // classified as EUCLIDEAN
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(i = 0; i < OBJECT_COUNT; ++i)
+            models[i].invert();
+        checksum += models[j][0];
+    }
+    timer.stop();
+    printResult("Matrix4::invert()", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(i = 0; i < OBJECT_COUNT; ++i)
+            transforms[i].invert();
+        checksum += transforms[j].getMatrix()[0];
+    }
+    timer.stop();
+    printResult("Transform::invert() Euclidean", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    // hierarchy update per frame, time is per node in the hierarchy
+    initObjects(models, 1234);
+    TransformHierarchy hierarchy;
+    initHierarchy(hierarchy, models, 5678);
+    benchHierarchy("hierarchy all dirty, 1 thread", hierarchy, models, OBJECT_COUNT, 1);
+    benchHierarchy("hierarchy all dirty, threads", hierarchy, models, OBJECT_COUNT, 0);
+    benchHierarchy("hierarchy 1% dirty, 1 thread", hierarchy, models, DIRTY_COUNT, 1);
+    benchHierarchy("hierarchy 1% dirty, threads", hierarchy, models, DIRTY_COUNT, 0);
+    ThreadPool pool;
+    benchHierarchy("hierarchy all dirty, pool", hierarchy, models, OBJECT_COUNT, 0, &pool);
+    benchHierarchy("hierarchy 1% dirty, pool", hierarchy, models, DIRTY_COUNT, 0, &pool);
+
+    benchCulling();
+    benchVectorArrays();
+    reportInvSqrtFast();
+
+    return 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// fill model matrices with random rigid transforms (deterministic with seed)
+///////////////////////////////////////////////////////////////////////////////
+void initObjects(std::vector<Matrix4>& models, unsigned int seed)
+{
+    for(std::size_t i = 0; i < models.size(); ++i)
+    {
+        Vector3 axis(randomFloat(seed, -1, 1), randomFloat(seed, -1, 1), randomFloat(seed, -1, 1));
+        models[i].identity();
+        models[i].rotate(randomFloat(seed, -180, 180), axis.normalize());
+        models[i].translate(randomFloat(seed, -100, 100), randomFloat(seed, -100, 100), randomFloat(seed, -100, 100));
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// build ROOT_COUNT trees, each node is attached to a random earlier node of
+// the same tree, so the depth varies
+///////////////////////////////////////////////////////////////////////////////
+void initHierarchy(TransformHierarchy& hierarchy, const std::vector<Matrix4>& locals, unsigned int seed)
+{
+    int treeSize = (int)locals.size() / ROOT_COUNT;
+    hierarchy.clear();
+    hierarchy.reserve(locals.size());
+    for(int i = 0; i < ROOT_COUNT; ++i)
+    {
+        int root = hierarchy.addNode(TransformHierarchy::NONE, locals[i * treeSize]);
+        for(int j = 1; j < treeSize; ++j)
+        {
+            int parent = root + (int)randomFloat(seed, 0, (float)j);
+            hierarchy.addNode(parent, locals[i * treeSize + j]);
+        }
+    }
+    hierarchy.update();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// mark dirtyCount random nodes and update the hierarchy, REPEAT_COUNT frames
+///////////////////////////////////////////////////////////////////////////////
+void benchHierarchy(const char* name, TransformHierarchy& hierarchy, const std::vector<Matrix4>& locals,
+                    int dirtyCount, int threadCount, ThreadPool* pool)
+{
+    int count = (int)hierarchy.getNodeCount();
+    unsigned int seed = 4321;
+    std::vector<int> dirtyIds(dirtyCount * REPEAT_COUNT);
+    for(std::size_t i = 0; i < dirtyIds.size(); ++i)
+        dirtyIds[i] = (dirtyCount == count) ? (int)(i % count) : (int)randomFloat(seed, 0, (float)count);
+
+    Timer timer;
+    std::size_t updated = 0;
+    float checksum = 0;
+    timer.start();
+    for(int j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(int i = 0; i < dirtyCount; ++i)
+        {
+            int id = dirtyIds[j * dirtyCount + i];
+            hierarchy.setLocal(id, locals[id]);
+        }
+        hierarchy.update(threadCount, pool);
+        updated += hierarchy.getUpdatedCount();
+        checksum += hierarchy.getWorld(j)[12];
+    }
+    timer.stop();
+    printResult(name, timer.getElapsedTimeInMicroSec(), count * REPEAT_COUNT, checksum);
+    std::cout << "    updated " << (updated / REPEAT_COUNT) << " of " << count << " nodes per frame" << std::endl;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// frustum culling of spheres and boxes scattered around the camera
+// SIMD results are compared with the scalar reference.
+///////////////////////////////////////////////////////////////////////////////
+void benchCulling()
+{
+    Matrix4 view;
+    view.rotateY(30).rotateX(20).translate(0, 0, -10);
+    Matrix4 projection(1.5f, 0, 0, 0,  0, 2.0f, 0, 0,  0, 0, -1.002f, -1,  0, 0, -0.2002f, 0);
+    Frustum frustum(projection * view);
+
+    unsigned int seed = 2468;
+    BoundingSpheres spheres;
+    BoundingBoxes boxes;
+    for(int i = 0; i < OBJECT_COUNT; ++i)
+    {
+        Vector3 center(randomFloat(seed, -100, 100), randomFloat(seed, -100, 100), randomFloat(seed, -100, 100));
+        float radius = randomFloat(seed, 0.1f, 5.0f);
+        spheres.add(center, radius);
+        boxes.add(center - Vector3(radius, radius, radius), center + Vector3(radius, radius, radius));
+    }
+
+    std::vector<unsigned int> bits((OBJECT_COUNT + 31) / 32);
+    std::vector<unsigned int> refBits((OBJECT_COUNT + 31) / 32);
+    std::vector<int> indices;
+    std::size_t visibleCount = 0;
+    Timer timer;
+    int j;
+
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+        visibleCount = frustum.cullSpheresScalar(spheres.x.data(), spheres.y.data(), spheres.z.data(),
+                                                 spheres.radius.data(), OBJECT_COUNT, refBits.data());
+    timer.stop();
+    printThroughput("cull spheres, scalar", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, visibleCount);
+
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+        visibleCount = frustum.cullSpheres(spheres, bits);
+    timer.stop();
+    printThroughput("cull spheres, bitmask", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, visibleCount);
+    std::cout << "    " << (bits == refBits ? "same as scalar" : "DIFFERENT FROM SCALAR") << std::endl;
+
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+        visibleCount = frustum.cullSpheresToIndices(spheres, indices);
+    timer.stop();
+    printThroughput("cull spheres, index list", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, visibleCount);
+
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+        visibleCount = frustum.cullBoxesScalar(boxes.minX.data(), boxes.minY.data(), boxes.minZ.data(),
+                                               boxes.maxX.data(), boxes.maxY.data(), boxes.maxZ.data(),
+                                               OBJECT_COUNT, refBits.data());
+    timer.stop();
+    printThroughput("cull boxes, scalar", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, visibleCount);
+
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+        visibleCount = frustum.cullBoxes(boxes, bits);
+    timer.stop();
+    printThroughput("cull boxes, bitmask", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, visibleCount);
+    std::cout << "    " << (bits == refBits ? "same as scalar" : "DIFFERENT FROM SCALAR") << std::endl;
+
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+        visibleCount = frustum.cullBoxesToIndices(boxes, indices);
+    timer.stop();
+    printThroughput("cull boxes, index list", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, visibleCount);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// normalize, dot and cross of many vectors
+// array of Vector3 (AoS) one at a time vs Vector3Array (SoA) bulk operations
+///////////////////////////////////////////////////////////////////////////////
+void benchVectorArrays()
+{
+    unsigned int seed = 1357;
+    std::vector<Vector3> vectors(OBJECT_COUNT), others(OBJECT_COUNT), outs(OBJECT_COUNT);
+    Vector3Array array(OBJECT_COUNT), otherArray(OBJECT_COUNT), outArray;
+    std::vector<float> dots(OBJECT_COUNT);
+    int i, j;
+    for(i = 0; i < OBJECT_COUNT; ++i)
+    {
+        vectors[i].set(randomFloat(seed, -10, 10), randomFloat(seed, -10, 10), randomFloat(seed, -10, 10));
+        others[i].set(randomFloat(seed, -10, 10), randomFloat(seed, -10, 10), randomFloat(seed, -10, 10));
+        array.set(i, vectors[i]);
+        otherArray.set(i, others[i]);
+    }
+
+    Timer timer;
+    float checksum;
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(i = 0; i < OBJECT_COUNT; ++i)
+            vectors[i].normalize();
+        checksum += vectors[j].x;
+    }
+    timer.stop();
+    printResult("Vector3::normalize() AoS", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(i = 0; i < OBJECT_COUNT; ++i)
+            vectors[i].normalizeFast();
+        checksum += vectors[j].x;
+    }
+    timer.stop();
+    printResult("Vector3::normalizeFast() AoS", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        array.normalize();
+        checksum += array.getX()[j];
+    }
+    timer.stop();
+    printResult("Vector3Array::normalize() SoA", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        array.normalizeFast();
+        checksum += array.getX()[j];
+    }
+    timer.stop();
+    printResult("Vector3Array::normalizeFast() SoA", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(i = 0; i < OBJECT_COUNT; ++i)
+            dots[i] = vectors[i].dot(others[i]);
+        checksum += dots[j];
+    }
+    timer.stop();
+    printResult("Vector3::dot() AoS", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        array.dot(otherArray, dots.data());
+        checksum += dots[j];
+    }
+    timer.stop();
+    printResult("Vector3Array::dot() SoA", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        for(i = 0; i < OBJECT_COUNT; ++i)
+            outs[i] = vectors[i].cross(others[i]);
+        checksum += outs[j].y;
+    }
+    timer.stop();
+    printResult("Vector3::cross() AoS", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    checksum = 0;
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        array.cross(otherArray, outArray);
+        checksum += outArray.getY()[j];
+    }
+    timer.stop();
+    printResult("Vector3Array::cross() SoA", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, checksum);
+
+    // interleaved round trip, e.g. normals of vertex data with 8 floats per vertex
+    std::vector<float> interleaved(OBJECT_COUNT * 8);
+    Vector3View view(&interleaved[3], 8 * sizeof(float), OBJECT_COUNT);
+    timer.start();
+    for(j = 0; j < REPEAT_COUNT; ++j)
+    {
+        array.store(view);
+        array.load(ConstVector3View(&interleaved[3], 8 * sizeof(float), OBJECT_COUNT));
+    }
+    timer.stop();
+    printResult("Vector3Array store/load view", timer.getElapsedTimeInMicroSec(), OBJECT_COUNT * REPEAT_COUNT, array.getX()[0]);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// max relative error of invSqrtFast() and 1/sqrtf() against double precision
+// All floats in [1, 4) are tested; the error pattern of the estimate repeats
+// every 2 octaves.
+///////////////////////////////////////////////////////////////////////////////
+void reportInvSqrtFast()
+{
+    double maxError = 0, maxErrorRef = 0;
+    for(float x = 1.0f; x < 4.0f; x = nextafterf(x, 4.0f))
+    {
+        double expected = 1.0 / sqrt((double)x);
+        double error = fabs(invSqrtFast(x) - expected) / expected;
+        double errorRef = fabs(1.0f / sqrtf(x) - expected) / expected;
+        if(error > maxError)
+            maxError = error;
+        if(errorRef > maxErrorRef)
+            maxErrorRef = errorRef;
+    }
+    std::cout << std::left << std::setw(32) << "invSqrtFast() max rel. error" << std::right
+              << std::scientific << std::setprecision(2) << std::setw(10) << maxError
+              << "  (1/sqrtf(): " << maxErrorRef << ")" << std::endl;
+    std::cout << std::resetiosflags(std::ios_base::scientific | std::ios_base::floatfield);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// linear congruential generator, same sequence on all platforms
+///////////////////////////////////////////////////////////////////////////////
+float randomFloat(unsigned int& seed, float min, float max)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return min + (max - min) * ((seed >> 8) / 16777216.0f);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// print ns per operation
+///////////////////////////////////////////////////////////////////////////////
+void printResult(const char* name, double elapsedUsec, int count, float checksum)
+{
+    std::cout << std::left << std::setw(32) << name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(10)
+              << (elapsedUsec * 1000.0 / count) << " ns/object"
+              << "  (checksum: " << checksum << ")" << std::endl;
+    std::cout << std::resetiosflags(std::ios_base::fixed | std::ios_base::floatfield);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// print objects per ns
+///////////////////////////////////////////////////////////////////////////////
+void printThroughput(const char* name, double elapsedUsec, int count, std::size_t visibleCount)
+{
+    std::cout << std::left << std::setw(32) << name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(10)
+              << (count / (elapsedUsec * 1000.0)) << " objects/ns"
+              << "  (visible: " << visibleCount << ")" << std::endl;
+    std::cout << std::resetiosflags(std::ios_base::fixed | std::ios_base::floatfield);
+}
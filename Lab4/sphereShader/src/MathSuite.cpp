@@ -0,0 +1,1124 @@
+///////////////////////////////////////////////////////////////////////////////
+// MathSuite.cpp
+// =============
+// benchmark and accuracy suite of Matrices, Vectors, Quaternion, Transform and
+// Frustum
+// Each public operation is measured for throughput (independent inputs) and
+// latency (each input depends on the previous result), and is compared with a
+// double precision reference where the result is not exact. The inputs are
+// random but deterministic, so the results of 2 builds are comparable.
+//
+// The result is printed as JSON to stdout, or written to the file given as
+// the first argument:
+//   mathSuite [result.json]
+//
+// Timing is the best of RUN_COUNT runs, and includes copying the input and
+// storing the result. The "copy" entries measure this overhead alone.
+// The compile-time rotations (rotateConst() etc.) are checked by static_assert
+// against known elements, so a wrong constexprSin/Cos fails the build.
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include "Matrices.h"
+#include "Vectors.h"
+#include "Quaternion.h"
+#include "Transform.h"
+#include "Frustum.h"
+#include "Timer.h"
+
+// constants
+const int INPUT_COUNT  = 1024;          // fits in L2 cache
+const int REPEAT_COUNT = 300;
+const int RUN_COUNT    = 3;
+const double DEG2RAD_D = 3.14159265358979323846 / 180.0;
+
+// compile-time rotations (constexprSin/Cos), checked against known elements
+constexpr bool isNear(float a, float b) { return (a > b ? a - b : b - a) < 1e-6f; }
+constexpr float SQRT3_INV = 0.577350269f;
+constexpr Matrix4 ROTATE_Y_90 = Matrix4().rotateYConst(90);
+constexpr Matrix4 ROTATE_AXIS_120 = Matrix4().rotateConst(120, SQRT3_INV, SQRT3_INV, SQRT3_INV); // x->y->z
+static_assert(isNear(constexprSin(0.52359878f), 0.5f) && isNear(constexprCos(1.04719755f), 0.5f) &&
+              isNear(constexprSin(-7.85398163f), -1.0f), "constexprSin/Cos");
+static_assert(isNear(ROTATE_Y_90[0], 0) && isNear(ROTATE_Y_90[2], -1) && isNear(ROTATE_Y_90[5], 1) &&
+              isNear(ROTATE_Y_90[8], 1) && isNear(ROTATE_Y_90[10], 0), "rotateYConst(90)");
+static_assert(isNear(ROTATE_AXIS_120[0], 0) && isNear(ROTATE_AXIS_120[1], 1) && isNear(ROTATE_AXIS_120[2], 0) &&
+              isNear(ROTATE_AXIS_120[4], 0) && isNear(ROTATE_AXIS_120[6], 1) &&
+              isNear(ROTATE_AXIS_120[8], 1) && isNear(ROTATE_AXIS_120[10], 0), "rotateConst(120, (1,1,1))");
+
+// result of an operation, errorMetric is NULL if accuracy is not checked
+struct Result
+{
+    std::string name;
+    double throughput;                  // ns per op
+    double latency;                     // ns per op
+    const char* errorMetric;
+    double maxError;
+    double meanError;
+};
+
+// inputs, random but deterministic
+struct Inputs
+{
+    std::vector<Matrix4> general;       // well-conditioned general matrices
+    std::vector<Matrix4> affine;        // rotation, scale and translation
+    std::vector<Matrix4> euclidean;     // rotation and translation
+    std::vector<Matrix4> projective;    // perspective * euclidean
+    std::vector<Matrix3> matrix3s;
+    std::vector<Matrix2> matrix2s;
+    std::vector<Vector4> vector4s;
+    std::vector<Vector3> vector3s;
+    std::vector<Vector3> others;        // 2nd operands of binary vector ops
+    std::vector<Vector3> axes;          // unit vectors
+    std::vector<Vector2> vector2s;
+    std::vector<float>   angles;        // degree
+    std::vector<Quaternion> quaternions;            // angles about axes
+    std::vector<DualQuaternion> dualQuaternions;    // same as euclidean
+    Matrix4 projection;                 // perspective, fovy 53 degree
+    std::vector<Vector3> points;        // in front of projection, z is -40~-20
+    std::vector<float>   radii;         // bounding spheres and boxes at points
+};
+
+// function prototypes
+void initInputs(Inputs& in, unsigned int seed);
+float randomFloat(unsigned int& seed, float min, float max);
+template<class Op> void measure(const char* name, Op op, Result& result);
+template<class Op, class Err> void addResult(std::vector<Result>& results, const char* name, Op op,
+                                             const char* errorMetric, Err err);
+template<class Op> void addResult(std::vector<Result>& results, const char* name, Op op);
+double getResidual(const float* a, const float* inv, int n);
+double getProductError(const float* a, const float* b, const float* c, int n, int columns);
+double getDeterminant(const float* a, int n);
+void   getRotation(double angle, const Vector3& axis, double r[9]);
+double getRotationError(const float* m, int stride, double angle, const Vector3& axis);
+double getPointError(const Matrix4& m, const Vector3& v, const Vector3& r);
+double getDotError(const float* a, const float* b, int n, float dot);
+double getLengthError(const float* a, int n, float length);
+void   multiply(const Quaternion& a, const Quaternion& b, double q[4]);
+void   slerp(const Quaternion& from, const Quaternion& to, double alpha, double q[4]);
+void   getFrustumPlanes(const Matrix4& m, double planes[6][4]);
+bool   intersectsSphere(const double planes[6][4], const Vector3& center, double radius);
+bool   intersectsBox(const double planes[6][4], const Vector3& boxMin, const Vector3& boxMax);
+void   writeJson(std::ostream& os, const std::vector<Result>& results);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+    Inputs in;
+    initInputs(in, 4321);
+
+    // outputs, the full result is stored so the compiler cannot drop any part
+    std::vector<Matrix4> m4(INPUT_COUNT);
+    std::vector<Matrix4> mv(INPUT_COUNT);
+    std::vector<Matrix4> normals(INPUT_COUNT);
+    std::vector<Matrix3> m3(INPUT_COUNT);
+    std::vector<Matrix2> m2(INPUT_COUNT);
+    std::vector<Vector4> v4(INPUT_COUNT);
+    std::vector<Vector3> v3(INPUT_COUNT);
+    std::vector<Vector2> v2(INPUT_COUNT);
+    std::vector<float>   f(INPUT_COUNT);
+    std::vector<Quaternion> q(INPUT_COUNT);
+    std::vector<DualQuaternion> dq(INPUT_COUNT);
+    std::vector<Frustum> frustums(INPUT_COUNT);
+    std::vector<Result> results;
+
+    const char* RESIDUAL = "max |A*inv(A)-I|";
+    const char* PRODUCT  = "max |C-A*B| / (|A|*|B|)";
+    const char* ELEMENT  = "max abs difference";
+    const char* RELATIVE = "relative";
+
+    // Matrix4 ////////////////////////////////////////////////////////////////
+    addResult(results, "Matrix4 copy", [&](int i, float dep) {
+        Matrix4 a = in.general[i]; a[0] += dep; m4[i] = a; return m4[i][0];
+    });
+    addResult(results, "Matrix4 * Matrix4", [&](int i, float dep) {
+        Matrix4 a = in.general[i]; a[0] += dep; m4[i] = a * in.affine[i]; return m4[i][0];
+    }, PRODUCT, [&](int i) {
+        Matrix4 c = in.general[i] * in.affine[i];
+        return getProductError(in.general[i].get(), in.affine[i].get(), c.get(), 4, 4);
+    });
+    addResult(results, "Matrix4::multiply()", [&](int i, float dep) {
+        Matrix4 a = in.general[i]; a[0] += dep; Matrix4::multiply(a, in.affine[i], m4[i]); return m4[i][0];
+    }, PRODUCT, [&](int i) {
+        Matrix4 c;
+        Matrix4::multiply(in.general[i], in.affine[i], c);
+        return getProductError(in.general[i].get(), in.affine[i].get(), c.get(), 4, 4);
+    });
+    addResult(results, "Matrix4 * Vector4", [&](int i, float dep) {
+        Vector4 v = in.vector4s[i]; v.x += dep; v4[i] = in.general[i] * v; return v4[i].x;
+    }, PRODUCT, [&](int i) {
+        Vector4 v = in.general[i] * in.vector4s[i];
+        return getProductError(in.general[i].get(), &in.vector4s[i].x, &v.x, 4, 1);
+    });
+    addResult(results, "Matrix4 * Vector3", [&](int i, float dep) {
+        Vector3 v = in.vector3s[i]; v.x += dep; v3[i] = in.affine[i] * v; return v3[i].x;
+    }, PRODUCT, [&](int i) {
+        return getPointError(in.affine[i], in.vector3s[i], in.affine[i] * in.vector3s[i]);
+    });
+    addResult(results, "Matrix4 + Matrix4", [&](int i, float dep) {
+        Matrix4 a = in.general[i]; a[0] += dep; m4[i] = a + in.affine[i]; return m4[i][0];
+    });
+    addResult(results, "Matrix4::transpose()", [&](int i, float dep) {
+        Matrix4 a = in.general[i]; a[0] += dep; m4[i] = a.transpose(); return m4[i][0];
+    });
+    addResult(results, "Matrix4::getDeterminant()", [&](int i, float dep) {
+        Matrix4 a = in.general[i]; a[0] += dep; f[i] = a.getDeterminant(); return f[i];
+    }, RELATIVE, [&](int i) {
+        double expected = getDeterminant(in.general[i].get(), 4);
+        return fabs(in.general[i].getDeterminant() - expected) / fabs(expected);
+    });
+    addResult(results, "Matrix4::invert() general", [&](int i, float dep) {
+        Matrix4 a = in.general[i]; a[0] += dep; m4[i] = a.invert(); return m4[i][0];
+    }, RESIDUAL, [&](int i) {
+        Matrix4 inv = in.general[i]; inv.invert();
+        return getResidual(in.general[i].get(), inv.get(), 4);
+    });
+    addResult(results, "Matrix4::invertGeneral()", [&](int i, float dep) {
+        Matrix4 a = in.general[i]; a[0] += dep; m4[i] = a.invertGeneral(); return m4[i][0];
+    }, RESIDUAL, [&](int i) {
+        Matrix4 inv = in.general[i]; inv.invertGeneral();
+        return getResidual(in.general[i].get(), inv.get(), 4);
+    });
+    // inputs include small det of the upper-left 2x2 block, which is the weak
+    // case of the partitioning (see invertProjective())
+    addResult(results, "Matrix4::invertProjective()", [&](int i, float dep) {
+        Matrix4 a = in.projective[i]; a[0] += dep; m4[i] = a.invertProjective(); return m4[i][0];
+    }, RESIDUAL, [&](int i) {
+        Matrix4 inv = in.projective[i]; inv.invertProjective();
+        return getResidual(in.projective[i].get(), inv.get(), 4);
+    });
+    addResult(results, "Matrix4::invertAffine()", [&](int i, float dep) {
+        Matrix4 a = in.affine[i]; a[0] += dep; m4[i] = a.invertAffine(); return m4[i][0];
+    }, RESIDUAL, [&](int i) {
+        Matrix4 inv = in.affine[i]; inv.invertAffine();
+        return getResidual(in.affine[i].get(), inv.get(), 4);
+    });
+    addResult(results, "Matrix4::invertEuclidean()", [&](int i, float dep) {
+        Matrix4 a = in.euclidean[i]; a[0] += dep; m4[i] = a.invertEuclidean(); return m4[i][0];
+    }, RESIDUAL, [&](int i) {
+        Matrix4 inv = in.euclidean[i]; inv.invertEuclidean();
+        return getResidual(in.euclidean[i].get(), inv.get(), 4);
+    });
+    // T * A and S * A
+    addResult(results, "Matrix4::translate()", [&](int i, float dep) {
+        Matrix4 a = in.affine[i]; a[0] += dep; m4[i] = a.translate(in.vector3s[i]); return m4[i][0];
+    }, PRODUCT, [&](int i) {
+        Matrix4 a = in.affine[i];
+        a.translate(in.vector3s[i]);
+        Matrix4 t;
+        t.setColumn(3, Vector4(in.vector3s[i].x, in.vector3s[i].y, in.vector3s[i].z, 1));
+        return getProductError(t.get(), in.affine[i].get(), a.get(), 4, 4);
+    });
+    addResult(results, "Matrix4::scale()", [&](int i, float dep) {
+        Matrix4 a = in.affine[i]; a[0] += dep; m4[i] = a.scale(1.5f, 0.5f, 2.0f); return m4[i][0];
+    }, PRODUCT, [&](int i) {
+        Matrix4 a = in.affine[i];
+        a.scale(1.5f, 0.5f, 2.0f);
+        const Matrix4 s(1.5f, 0, 0, 0,  0, 0.5f, 0, 0,  0, 0, 2.0f, 0,  0, 0, 0, 1);
+        return getProductError(s.get(), in.affine[i].get(), a.get(), 4, 4);
+    });
+    addResult(results, "Matrix4::rotate(angle, axis)", [&](int i, float dep) {
+        Matrix4 a = in.affine[i]; a[0] += dep; m4[i] = a.rotate(in.angles[i], in.axes[i]); return m4[i][0];
+    }, ELEMENT, [&](int i) {
+        Matrix4 a;
+        a.rotate(in.angles[i], in.axes[i]);
+        return getRotationError(a.get(), 4, in.angles[i] * DEG2RAD_D, in.axes[i]);
+    });
+    addResult(results, "Matrix4::rotateX()", [&](int i, float dep) {
+        Matrix4 a = in.affine[i]; a[0] += dep; m4[i] = a.rotateX(in.angles[i]); return m4[i][0];
+    }, ELEMENT, [&](int i) {
+        Matrix4 a;
+        a.rotateX(in.angles[i]);
+        return getRotationError(a.get(), 4, in.angles[i] * DEG2RAD_D, Vector3(1, 0, 0));
+    });
+    addResult(results, "Matrix4::rotateY()", [&](int i, float dep) {
+        Matrix4 a = in.affine[i]; a[0] += dep; m4[i] = a.rotateY(in.angles[i]); return m4[i][0];
+    }, ELEMENT, [&](int i) {
+        Matrix4 a;
+        a.rotateY(in.angles[i]);
+        return getRotationError(a.get(), 4, in.angles[i] * DEG2RAD_D, Vector3(0, 1, 0));
+    });
+    addResult(results, "Matrix4::rotateZ()", [&](int i, float dep) {
+        Matrix4 a = in.affine[i]; a[0] += dep; m4[i] = a.rotateZ(in.angles[i]); return m4[i][0];
+    }, ELEMENT, [&](int i) {
+        Matrix4 a;
+        a.rotateZ(in.angles[i]);
+        return getRotationError(a.get(), 4, in.angles[i] * DEG2RAD_D, Vector3(0, 0, 1));
+    });
+    addResult(results, "Matrix4::lookAt(target)", [&](int i, float dep) {
+        Matrix4 a = in.euclidean[i]; a[0] += dep; m4[i] = a.lookAt(in.vector3s[i]); return m4[i][0];
+    }, ELEMENT, [&](int i) {
+        // same construction in double: forward, left = up x forward, up = forward x left
+        Matrix4 a = in.euclidean[i];
+        a.lookAt(in.vector3s[i]);
+        double fx = in.vector3s[i].x - a[12], fy = in.vector3s[i].y - a[13], fz = in.vector3s[i].z - a[14];
+        double len = sqrt(fx * fx + fy * fy + fz * fz);
+        fx /= len; fy /= len; fz /= len;
+        double lx = fz, ly = 0, lz = -fx;       // (0,1,0) x forward
+        len = sqrt(lx * lx + lz * lz);
+        lx /= len; lz /= len;
+        double ux = fy * lz - fz * ly, uy = fz * lx - fx * lz, uz = fx * ly - fy * lx;
+        const double expected[9] = {lx, ly, lz, ux, uy, uz, fx, fy, fz};
+        double maxError = 0;
+        for(int c = 0; c < 3; ++c)
+            for(int k = 0; k < 3; ++k)
+                maxError = std::max(maxError, fabs(a[c * 4 + k] - expected[c * 3 + k]));
+        return maxError;
+    });
+    addResult(results, "Matrix4::lookAt(target, up)", [&](int i, float dep) {
+        Matrix4 a = in.euclidean[i]; a[0] += dep; m4[i] = a.lookAt(in.vector3s[i], in.axes[i]); return m4[i][0];
+    }, ELEMENT, [&](int i) {
+        // left = up x forward, up = forward x left, both normalized
+        Matrix4 a = in.euclidean[i];
+        a.lookAt(in.vector3s[i], in.axes[i]);
+        const Vector3& u = in.axes[i];
+        double fx = in.vector3s[i].x - a[12], fy = in.vector3s[i].y - a[13], fz = in.vector3s[i].z - a[14];
+        double len = sqrt(fx * fx + fy * fy + fz * fz);
+        fx /= len; fy /= len; fz /= len;
+        double lx = u.y * fz - u.z * fy, ly = u.z * fx - u.x * fz, lz = u.x * fy - u.y * fx;
+        len = sqrt(lx * lx + ly * ly + lz * lz);
+        lx /= len; ly /= len; lz /= len;
+        double ux = fy * lz - fz * ly, uy = fz * lx - fx * lz, uz = fx * ly - fy * lx;
+        const double expected[9] = {lx, ly, lz, ux, uy, uz, fx, fy, fz};
+        double maxError = 0;
+        for(int c = 0; c < 3; ++c)
+            for(int k = 0; k < 3; ++k)
+                maxError = std::max(maxError, fabs(a[c * 4 + k] - expected[c * 3 + k]));
+        return maxError;
+    });
+    addResult(results, "Matrix4::getAngle()", [&](int i, float dep) {
+        Matrix4 a = in.euclidean[i]; a[0] += dep; v3[i] = a.getAngle(); return v3[i].x;
+    }, "max abs difference (degree)", [&](int i) {
+        // same formulas in double, yaw is corrected to -180~180 with m[10]
+        const Matrix4& a = in.euclidean[i];
+        Vector3 angle = a.getAngle();
+        double yaw = asin((double)a[8]) / DEG2RAD_D;
+        if(a[10] < 0)
+            yaw = (yaw >= 0) ? 180 - yaw : -180 - yaw;
+        double pitch, roll;
+        if(a[0] > -0.00001f && a[0] < 0.00001f)
+        {
+            roll = 0;
+            pitch = atan2((double)a[1], (double)a[5]) / DEG2RAD_D;
+        }
+        else
+        {
+            roll = atan2(-(double)a[4], (double)a[0]) / DEG2RAD_D;
+            pitch = atan2(-(double)a[9], (double)a[10]) / DEG2RAD_D;
+        }
+        return std::max(fabs(angle.x - pitch), std::max(fabs(angle.y - yaw), fabs(angle.z - roll)));
+    });
+    addResult(results, "Matrix4::transformPoints() per point", [&](int i, float dep) {
+        Vector3 v = in.vector3s[i]; v.x += dep; in.affine[i].transformPoints(&v, &v3[i], 1); return v3[i].x;
+    }, PRODUCT, [&](int i) {
+        Vector3 r;
+        in.affine[i].transformPoints(&in.vector3s[i], &r, 1);
+        return getPointError(in.affine[i], in.vector3s[i], r);
+    });
+    addResult(results, "Matrix4::transformVectors() per vector", [&](int i, float dep) {
+        Vector3 v = in.vector3s[i]; v.x += dep; in.affine[i].transformVectors(&v, &v3[i], 1); return v3[i].x;
+    }, PRODUCT, [&](int i) {
+        Vector3 r;
+        in.affine[i].transformVectors(&in.vector3s[i], &r, 1);
+        const Vector4 v(in.vector3s[i].x, in.vector3s[i].y, in.vector3s[i].z, 0);
+        const Vector4 c(r.x, r.y, r.z, 0);
+        return getProductError(in.affine[i].get(), &v.x, &c.x, 4, 1);
+    });
+    addResult(results, "Matrix4::transformPointsProjective() per point", [&](int i, float dep) {
+        Vector3 v = in.points[i]; v.x += dep; in.projection.transformPointsProjective(&v, &v3[i], 1); return v3[i].x;
+    }, ELEMENT, [&](int i) {
+        Vector3 r;
+        in.projection.transformPointsProjective(&in.points[i], &r, 1);
+        const float* m = in.projection.get();
+        const Vector3& v = in.points[i];
+        double clip[4];
+        for(int k = 0; k < 4; ++k)
+            clip[k] = (double)m[k] * v.x + (double)m[4 + k] * v.y + (double)m[8 + k] * v.z + m[12 + k];
+        return std::max(fabs(r.x - clip[0] / clip[3]),
+                        std::max(fabs(r.y - clip[1] / clip[3]), fabs(r.z - clip[2] / clip[3])));
+    });
+    // p * v * m, the error is of both products, v*m and p*(v*m)
+    addResult(results, "Matrix4::computeMVP()", [&](int i, float dep) {
+        Matrix4 a = in.affine[i]; a[0] += dep;
+        Matrix4::computeMVP(in.projection, in.euclidean[i], a, mv[i], m4[i]); return m4[i][0];
+    }, PRODUCT, [&](int i) {
+        Matrix4 outMV, outMVP;
+        Matrix4::computeMVP(in.projection, in.euclidean[i], in.affine[i], outMV, outMVP);
+        return std::max(getProductError(in.euclidean[i].get(), in.affine[i].get(), outMV.get(), 4, 4),
+                        getProductError(in.projection.get(), outMV.get(), outMVP.get(), 4, 4));
+    });
+    // the normal matrix must be the modelview without translation
+    addResult(results, "Matrix4::computeMVPandNormal()", [&](int i, float dep) {
+        Matrix4 a = in.affine[i]; a[0] += dep;
+        Matrix4::computeMVPandNormal(in.projection, in.euclidean[i], a, mv[i], m4[i], normals[i]); return m4[i][0];
+    }, PRODUCT, [&](int i) {
+        Matrix4 outMV, outMVP, outN;
+        Matrix4::computeMVPandNormal(in.projection, in.euclidean[i], in.affine[i], outMV, outMVP, outN);
+        double maxError = std::max(getProductError(in.euclidean[i].get(), in.affine[i].get(), outMV.get(), 4, 4),
+                                   getProductError(in.projection.get(), outMV.get(), outMVP.get(), 4, 4));
+        for(int k = 0; k < 12; ++k)
+            maxError = std::max(maxError, (double)fabs(outN[k] - outMV[k]));
+        return maxError;
+    });
+
+    // Matrix3 ////////////////////////////////////////////////////////////////
+    addResult(results, "Matrix3 * Matrix3", [&](int i, float dep) {
+        Matrix3 a = in.matrix3s[i]; a[0] += dep; m3[i] = a * in.matrix3s[INPUT_COUNT - 1 - i]; return m3[i][0];
+    }, PRODUCT, [&](int i) {
+        const Matrix3& b = in.matrix3s[INPUT_COUNT - 1 - i];
+        Matrix3 c = in.matrix3s[i] * b;
+        return getProductError(in.matrix3s[i].get(), b.get(), c.get(), 3, 3);
+    });
+    addResult(results, "Matrix3 * Vector3", [&](int i, float dep) {
+        Vector3 v = in.vector3s[i]; v.x += dep; v3[i] = in.matrix3s[i] * v; return v3[i].x;
+    }, PRODUCT, [&](int i) {
+        Vector3 v = in.matrix3s[i] * in.vector3s[i];
+        return getProductError(in.matrix3s[i].get(), &in.vector3s[i].x, &v.x, 3, 1);
+    });
+    addResult(results, "Matrix3::getDeterminant()", [&](int i, float dep) {
+        Matrix3 a = in.matrix3s[i]; a[0] += dep; f[i] = a.getDeterminant(); return f[i];
+    }, RELATIVE, [&](int i) {
+        double expected = getDeterminant(in.matrix3s[i].get(), 3);
+        return fabs(in.matrix3s[i].getDeterminant() - expected) / fabs(expected);
+    });
+    addResult(results, "Matrix3::invert()", [&](int i, float dep) {
+        Matrix3 a = in.matrix3s[i]; a[0] += dep; m3[i] = a.invert(); return m3[i][0];
+    }, RESIDUAL, [&](int i) {
+        Matrix3 inv = in.matrix3s[i]; inv.invert();
+        return getResidual(in.matrix3s[i].get(), inv.get(), 3);
+    });
+    addResult(results, "Matrix3::transpose()", [&](int i, float dep) {
+        Matrix3 a = in.matrix3s[i]; a[0] += dep; m3[i] = a.transpose(); return m3[i][0];
+    });
+
+    // Matrix2 ////////////////////////////////////////////////////////////////
+    addResult(results, "Matrix2 * Matrix2", [&](int i, float dep) {
+        Matrix2 a = in.matrix2s[i]; a[0] += dep; m2[i] = a * in.matrix2s[INPUT_COUNT - 1 - i]; return m2[i][0];
+    }, PRODUCT, [&](int i) {
+        const Matrix2& b = in.matrix2s[INPUT_COUNT - 1 - i];
+        Matrix2 c = in.matrix2s[i] * b;
+        return getProductError(in.matrix2s[i].get(), b.get(), c.get(), 2, 2);
+    });
+    addResult(results, "Matrix2::getDeterminant()", [&](int i, float dep) {
+        Matrix2 a = in.matrix2s[i]; a[0] += dep; f[i] = a.getDeterminant(); return f[i];
+    }, RELATIVE, [&](int i) {
+        double expected = getDeterminant(in.matrix2s[i].get(), 2);
+        return fabs(in.matrix2s[i].getDeterminant() - expected) / fabs(expected);
+    });
+    addResult(results, "Matrix2::invert()", [&](int i, float dep) {
+        Matrix2 a = in.matrix2s[i]; a[0] += dep; m2[i] = a.invert(); return m2[i][0];
+    }, RESIDUAL, [&](int i) {
+        Matrix2 inv = in.matrix2s[i]; inv.invert();
+        return getResidual(in.matrix2s[i].get(), inv.get(), 2);
+    });
+
+    // Vector3 ////////////////////////////////////////////////////////////////
+    addResult(results, "Vector3 copy", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; v3[i] = a; return v3[i].x;
+    });
+    addResult(results, "Vector3 + Vector3", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; v3[i] = a + in.others[i]; return v3[i].x;
+    });
+    addResult(results, "Vector3 * float", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; v3[i] = a * in.angles[i]; return v3[i].x;
+    });
+    addResult(results, "Vector3::dot()", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; f[i] = a.dot(in.others[i]); return f[i];
+    }, PRODUCT, [&](int i) {
+        const Vector3& a = in.vector3s[i];
+        const Vector3& b = in.others[i];
+        double expected = (double)a.x * b.x + (double)a.y * b.y + (double)a.z * b.z;
+        double scale = fabs(a.x * b.x) + fabs(a.y * b.y) + fabs(a.z * b.z);
+        return fabs(a.dot(b) - expected) / scale;
+    });
+    addResult(results, "Vector3::cross()", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; v3[i] = a.cross(in.others[i]); return v3[i].x;
+    }, PRODUCT, [&](int i) {
+        const Vector3& a = in.vector3s[i];
+        const Vector3& b = in.others[i];
+        Vector3 c = a.cross(b);
+        double x = (double)a.y * b.z - (double)a.z * b.y;
+        double y = (double)a.z * b.x - (double)a.x * b.z;
+        double z = (double)a.x * b.y - (double)a.y * b.x;
+        double scale = a.length() * b.length();
+        return std::max(fabs(c.x - x), std::max(fabs(c.y - y), fabs(c.z - z))) / scale;
+    });
+    addResult(results, "Vector3::length()", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; f[i] = a.length(); return f[i];
+    }, RELATIVE, [&](int i) {
+        const Vector3& a = in.vector3s[i];
+        double expected = sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z);
+        return fabs(a.length() - expected) / expected;
+    });
+    addResult(results, "Vector3::distance()", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; f[i] = a.distance(in.others[i]); return f[i];
+    }, RELATIVE, [&](int i) {
+        const Vector3& a = in.vector3s[i];
+        const Vector3& b = in.others[i];
+        double dx = (double)b.x - a.x, dy = (double)b.y - a.y, dz = (double)b.z - a.z;
+        double expected = sqrt(dx * dx + dy * dy + dz * dz);
+        return fabs(a.distance(b) - expected) / expected;
+    });
+    addResult(results, "Vector3::angle()", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; f[i] = a.angle(in.others[i]); return f[i];
+    }, "max abs difference (degree)", [&](int i) {
+        const Vector3& a = in.vector3s[i];
+        const Vector3& b = in.others[i];
+        double d = (double)a.x * b.x + (double)a.y * b.y + (double)a.z * b.z;
+        double la = sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z);
+        double lb = sqrt((double)b.x * b.x + (double)b.y * b.y + (double)b.z * b.z);
+        double expected = acos(d / (la * lb)) / DEG2RAD_D;
+        return fabs(a.angle(b) - expected);
+    });
+    addResult(results, "Vector3::normalize()", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; v3[i] = a.normalize(); return v3[i].x;
+    }, "max ||v|-1|", [&](int i) {
+        Vector3 a = in.vector3s[i];
+        a.normalize();
+        return fabs(sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z) - 1.0);
+    });
+    addResult(results, "Vector3::normalizeFast()", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; v3[i] = a.normalizeFast(); return v3[i].x;
+    }, "max ||v|-1|", [&](int i) {
+        Vector3 a = in.vector3s[i];
+        a.normalizeFast();
+        return fabs(sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z) - 1.0);
+    });
+    addResult(results, "Vector3::invLengthFast()", [&](int i, float dep) {
+        Vector3 a = in.vector3s[i]; a.x += dep; f[i] = a.invLengthFast(); return f[i];
+    }, RELATIVE, [&](int i) {
+        const Vector3& a = in.vector3s[i];
+        double expected = 1.0 / sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z);
+        return fabs(a.invLengthFast() - expected) / expected;
+    });
+    // every 4th input is 0, which must give inf as 1/sqrtf() (not NaN)
+    addResult(results, "invSqrtFast() with zeros", [&](int i, float dep) {
+        float x = (i % 4) ? in.angles[i] * in.angles[i] : 0.0f; f[i] = invSqrtFast(x + dep); return f[i];
+    }, "relative, 1 if not inf at 0", [&](int i) {
+        float x = (i % 4) ? in.angles[i] * in.angles[i] : 0.0f;
+        float y = invSqrtFast(x);
+        if(x == 0)
+            return (std::isinf(y) && y > 0) ? 0.0 : 1.0;
+        double expected = 1.0 / sqrt((double)x);
+        return fabs(y - expected) / expected;
+    });
+
+    // Vector4, Vector2 ///////////////////////////////////////////////////////
+    addResult(results, "Vector4::dot()", [&](int i, float dep) {
+        Vector4 a = in.vector4s[i]; a.x += dep; f[i] = a.dot(in.vector4s[INPUT_COUNT - 1 - i]); return f[i];
+    }, PRODUCT, [&](int i) {
+        return getDotError(&in.vector4s[i].x, &in.vector4s[INPUT_COUNT - 1 - i].x, 4,
+                           in.vector4s[i].dot(in.vector4s[INPUT_COUNT - 1 - i]));
+    });
+    addResult(results, "Vector4::length()", [&](int i, float dep) {
+        Vector4 a = in.vector4s[i]; a.x += dep; f[i] = a.length(); return f[i];
+    }, RELATIVE, [&](int i) {
+        return getLengthError(&in.vector4s[i].x, 4, in.vector4s[i].length());
+    });
+    // xyz only, w is untouched
+    addResult(results, "Vector4::normalize()", [&](int i, float dep) {
+        Vector4 a = in.vector4s[i]; a.x += dep; v4[i] = a.normalize(); return v4[i].x;
+    }, "max ||xyz|-1|", [&](int i) {
+        Vector4 a = in.vector4s[i];
+        a.normalize();
+        return fabs(sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z) - 1.0);
+    });
+    addResult(results, "Vector4::normalizeFast()", [&](int i, float dep) {
+        Vector4 a = in.vector4s[i]; a.x += dep; v4[i] = a.normalizeFast(); return v4[i].x;
+    }, "max ||xyz|-1|", [&](int i) {
+        Vector4 a = in.vector4s[i];
+        a.normalizeFast();
+        return fabs(sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z) - 1.0);
+    });
+    addResult(results, "Vector2::dot()", [&](int i, float dep) {
+        Vector2 a = in.vector2s[i]; a.x += dep; f[i] = a.dot(in.vector2s[INPUT_COUNT - 1 - i]); return f[i];
+    }, PRODUCT, [&](int i) {
+        return getDotError(&in.vector2s[i].x, &in.vector2s[INPUT_COUNT - 1 - i].x, 2,
+                           in.vector2s[i].dot(in.vector2s[INPUT_COUNT - 1 - i]));
+    });
+    addResult(results, "Vector2::length()", [&](int i, float dep) {
+        Vector2 a = in.vector2s[i]; a.x += dep; f[i] = a.length(); return f[i];
+    }, RELATIVE, [&](int i) {
+        return getLengthError(&in.vector2s[i].x, 2, in.vector2s[i].length());
+    });
+    addResult(results, "Vector2::normalize()", [&](int i, float dep) {
+        Vector2 a = in.vector2s[i]; a.x += dep; v2[i] = a.normalize(); return v2[i].x;
+    }, "max ||v|-1|", [&](int i) {
+        Vector2 a = in.vector2s[i];
+        a.normalize();
+        return fabs(sqrt((double)a.x * a.x + (double)a.y * a.y) - 1.0);
+    });
+
+    // Quaternion, DualQuaternion /////////////////////////////////////////////
+    addResult(results, "Quaternion * Quaternion", [&](int i, float dep) {
+        Quaternion a = in.quaternions[i]; a.s += dep; q[i] = a * in.quaternions[INPUT_COUNT - 1 - i]; return q[i].s;
+    }, ELEMENT, [&](int i) {
+        const Quaternion& b = in.quaternions[INPUT_COUNT - 1 - i];
+        Quaternion r = in.quaternions[i] * b;
+        double expected[4];
+        multiply(in.quaternions[i], b, expected);
+        double maxError = 0;
+        for(int k = 0; k < 4; ++k)
+            maxError = std::max(maxError, fabs(r[k] - expected[k]));
+        return maxError;
+    });
+    addResult(results, "Quaternion::slerp()", [&](int i, float dep) {
+        Quaternion a = in.quaternions[i]; a.s += dep;
+        q[i] = Quaternion::slerp(a, in.quaternions[INPUT_COUNT - 1 - i], (i % 16) / 15.0f); return q[i].s;
+    }, ELEMENT, [&](int i) {
+        const Quaternion& to = in.quaternions[INPUT_COUNT - 1 - i];
+        Quaternion r = Quaternion::slerp(in.quaternions[i], to, (i % 16) / 15.0f);
+        double expected[4];
+        slerp(in.quaternions[i], to, (i % 16) / 15.0f, expected);
+        double maxError = 0;
+        for(int k = 0; k < 4; ++k)
+            maxError = std::max(maxError, fabs(r[k] - expected[k]));
+        return maxError;
+    });
+    addResult(results, "Quaternion::getMatrix()", [&](int i, float dep) {
+        Quaternion a = in.quaternions[i]; a.s += dep; m4[i] = a.getMatrix(); return m4[i][0];
+    }, ELEMENT, [&](int i) {
+        Matrix4 a = in.quaternions[i].getMatrix();
+        return getRotationError(a.get(), 4, in.angles[i] * DEG2RAD_D, in.axes[i]);
+    });
+    // round trip, getMatrix() of the result against the reference rotation
+    addResult(results, "Quaternion::getQuaternion()", [&](int i, float dep) {
+        Matrix4 a = in.euclidean[i]; a[0] += dep; q[i] = Quaternion::getQuaternion(a); return q[i].s;
+    }, ELEMENT, [&](int i) {
+        Matrix4 a = Quaternion::getQuaternion(in.euclidean[i]).getMatrix();
+        return getRotationError(a.get(), 4, in.angles[i] * DEG2RAD_D, in.axes[i]);
+    });
+    addResult(results, "DualQuaternion * DualQuaternion", [&](int i, float dep) {
+        DualQuaternion a = in.dualQuaternions[i]; a.real.s += dep;
+        dq[i] = a * in.dualQuaternions[INPUT_COUNT - 1 - i]; return dq[i].real.s;
+    }, ELEMENT, [&](int i) {
+        // real = r1 * r2, dual = r1 * d2 + d1 * r2
+        const DualQuaternion& a = in.dualQuaternions[i];
+        const DualQuaternion& b = in.dualQuaternions[INPUT_COUNT - 1 - i];
+        DualQuaternion r = a * b;
+        double real[4], dual1[4], dual2[4];
+        multiply(a.real, b.real, real);
+        multiply(a.real, b.dual, dual1);
+        multiply(a.dual, b.real, dual2);
+        double maxError = 0;
+        for(int k = 0; k < 4; ++k)
+        {
+            maxError = std::max(maxError, fabs(r.real[k] - real[k]));
+            maxError = std::max(maxError, fabs(r.dual[k] - (dual1[k] + dual2[k])));
+        }
+        return maxError;
+    });
+    addResult(results, "DualQuaternion::transformPoint()", [&](int i, float dep) {
+        Vector3 v = in.vector3s[i]; v.x += dep; v3[i] = in.dualQuaternions[i].transformPoint(v); return v3[i].x;
+    }, ELEMENT, [&](int i) {
+        Vector3 v = in.dualQuaternions[i].transformPoint(in.vector3s[i]);
+        double r[9];
+        getRotation(in.angles[i] * DEG2RAD_D, in.axes[i], r);
+        const Vector3& p = in.vector3s[i];
+        const float* t = &in.euclidean[i][12];
+        double maxError = 0;
+        for(int k = 0; k < 3; ++k)
+            maxError = std::max(maxError, fabs(v[k] - (r[k] * p.x + r[3 + k] * p.y + r[6 + k] * p.z + t[k])));
+        return maxError;
+    });
+    // round trip of euclidean, getDualQuaternion() then getMatrix()
+    addResult(results, "DualQuaternion::getMatrix()", [&](int i, float dep) {
+        DualQuaternion a = in.dualQuaternions[i]; a.real.s += dep; m4[i] = a.getMatrix(); return m4[i][0];
+    }, ELEMENT, [&](int i) {
+        Matrix4 a = DualQuaternion::getDualQuaternion(in.euclidean[i]).getMatrix();
+        double maxError = getRotationError(a.get(), 4, in.angles[i] * DEG2RAD_D, in.axes[i]);
+        for(int k = 12; k < 15; ++k)
+            maxError = std::max(maxError, (double)fabs(a[k] - in.euclidean[i][k]));
+        return maxError;
+    });
+
+    // Transform //////////////////////////////////////////////////////////////
+    // invert() dispatches by the type given at construction
+    addResult(results, "Transform::invert() euclidean", [&](int i, float dep) {
+        Matrix4 a = in.euclidean[i]; a[0] += dep;
+        Transform t(a, Transform::EUCLIDEAN); m4[i] = t.invert().getMatrix(); return m4[i][0];
+    }, RESIDUAL, [&](int i) {
+        Transform t(in.euclidean[i], Transform::EUCLIDEAN);
+        return getResidual(in.euclidean[i].get(), t.invert().get(), 4);
+    });
+    addResult(results, "Transform::invert() affine", [&](int i, float dep) {
+        Matrix4 a = in.affine[i]; a[0] += dep;
+        Transform t(a, Transform::AFFINE); m4[i] = t.invert().getMatrix(); return m4[i][0];
+    }, RESIDUAL, [&](int i) {
+        Transform t(in.affine[i], Transform::AFFINE);
+        return getResidual(in.affine[i].get(), t.invert().get(), 4);
+    });
+    addResult(results, "Transform::invert() general", [&](int i, float dep) {
+        Matrix4 a = in.projective[i]; a[0] += dep;
+        Transform t(a, Transform::GENERAL); m4[i] = t.invert().getMatrix(); return m4[i][0];
+    }, RESIDUAL, [&](int i) {
+        Transform t(in.projective[i], Transform::GENERAL);
+        return getResidual(in.projective[i].get(), t.invert().get(), 4);
+    });
+
+    // Frustum ////////////////////////////////////////////////////////////////
+    // culling is compared with the same test on planes extracted in double,
+    // the error is the rate of different results (objects on a plane)
+    const char* MISMATCH = "rate of mismatch with double";
+    double planes[6][4];
+    getFrustumPlanes(in.projection, planes);
+    const Frustum frustum(in.projection);
+    addResult(results, "Frustum::set()", [&](int i, float dep) {
+        Matrix4 a = in.projective[i]; a[0] += dep; frustums[i].set(a); return frustums[i].getPlane(0).d;
+    }, "max abs difference of planes", [&](int i) {
+        Frustum a(in.projective[i]);
+        double expected[6][4];
+        getFrustumPlanes(in.projective[i], expected);
+        double maxError = 0;
+        for(int k = 0; k < Frustum::PLANE_COUNT; ++k)
+        {
+            Vector4 p = a.getPlane(k).getCoefficients();
+            for(int j = 0; j < 4; ++j)
+                maxError = std::max(maxError, fabs((&p.x)[j] - expected[k][j]));
+        }
+        return maxError;
+    });
+    addResult(results, "Frustum::intersectsSphere()", [&](int i, float dep) {
+        Vector3 c = in.points[i]; c.x += dep; f[i] = frustum.intersectsSphere(c, in.radii[i]) ? 1.0f : 0.0f; return f[i];
+    }, MISMATCH, [&](int i) {
+        bool expected = intersectsSphere(planes, in.points[i], in.radii[i]);
+        return (frustum.intersectsSphere(in.points[i], in.radii[i]) != expected) ? 1.0 : 0.0;
+    });
+    addResult(results, "Frustum::intersectsBox()", [&](int i, float dep) {
+        Vector3 r(in.radii[i], in.radii[i], in.radii[i]);
+        Vector3 c = in.points[i]; c.x += dep; f[i] = frustum.intersectsBox(c - r, c + r) ? 1.0f : 0.0f; return f[i];
+    }, MISMATCH, [&](int i) {
+        Vector3 r(in.radii[i], in.radii[i], in.radii[i]);
+        bool expected = intersectsBox(planes, in.points[i] - r, in.points[i] + r);
+        return (frustum.intersectsBox(in.points[i] - r, in.points[i] + r) != expected) ? 1.0 : 0.0;
+    });
+    // batch of 64 spheres from i (wrapping), the time is per call
+    BoundingSpheres spheres;
+    for(int i = 0; i < INPUT_COUNT + 64; ++i)
+        spheres.add(in.points[i % INPUT_COUNT], in.radii[i % INPUT_COUNT]);
+    std::vector<unsigned int> bits(2 * INPUT_COUNT);
+    addResult(results, "Frustum::cullSpheres() per 64 spheres", [&](int i, float dep) {
+        int k = i + (int)dep;
+        frustum.cullSpheres(&spheres.x[k], &spheres.y[k], &spheres.z[k], &spheres.radius[k], 64, &bits[k * 2]);
+        return (float)(bits[k * 2] & 1);
+    }, MISMATCH, [&](int i) {
+        unsigned int word[2];
+        frustum.cullSpheres(&spheres.x[i], &spheres.y[i], &spheres.z[i], &spheres.radius[i], 64, word);
+        bool expected = intersectsSphere(planes, in.points[i], in.radii[i]);
+        return (((word[0] & 1) != 0) != expected) ? 1.0 : 0.0;
+    });
+
+    if(argc > 1)
+    {
+        std::ofstream file(argv[1]);
+        if(!file)
+        {
+            std::cerr << "[ERROR] Failed to open " << argv[1] << std::endl;
+            return 1;
+        }
+        writeJson(file, results);
+    }
+    else
+    {
+        writeJson(std::cout, results);
+    }
+
+    return 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// measure op(i, dep) over all inputs, best of RUN_COUNT runs
+// throughput: dep is 0, so the calls are independent
+// latency:    dep is (previous result * 0), so each call waits for the
+//             previous one. It is the latency to the returned element.
+///////////////////////////////////////////////////////////////////////////////
+template<class Op>
+void measure(const char* name, Op op, Result& result)
+{
+    Timer timer;
+    const int count = INPUT_COUNT * REPEAT_COUNT;
+    const float zero = 0.0f;
+    result.name = name;
+    result.throughput = result.latency = 1e30;
+
+    for(int run = 0; run < RUN_COUNT; ++run)
+    {
+        timer.start();
+        for(int j = 0; j < REPEAT_COUNT; ++j)
+        {
+            for(int i = 0; i < INPUT_COUNT; ++i)
+                op(i, zero);
+        }
+        timer.stop();
+        result.throughput = std::min(result.throughput, timer.getElapsedTimeInMicroSec() * 1000.0 / count);
+
+        float dep = 0;
+        timer.start();
+        for(int j = 0; j < REPEAT_COUNT; ++j)
+        {
+            for(int i = 0; i < INPUT_COUNT; ++i)
+                dep = op(i, dep * zero);
+        }
+        timer.stop();
+        result.latency = std::min(result.latency, timer.getElapsedTimeInMicroSec() * 1000.0 / count);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// measure an op and append the result, with or without accuracy check
+// err(i) returns the error of input i against the double precision reference
+///////////////////////////////////////////////////////////////////////////////
+template<class Op, class Err>
+void addResult(std::vector<Result>& results, const char* name, Op op, const char* errorMetric, Err err)
+{
+    Result result;
+    measure(name, op, result);
+    result.errorMetric = errorMetric;
+    result.maxError = result.meanError = 0;
+    for(int i = 0; i < INPUT_COUNT; ++i)
+    {
+        double error = err(i);
+        result.maxError = std::max(result.maxError, error);
+        result.meanError += error;
+    }
+    result.meanError /= INPUT_COUNT;
+    results.push_back(result);
+}
+
+template<class Op>
+void addResult(std::vector<Result>& results, const char* name, Op op)
+{
+    Result result;
+    measure(name, op, result);
+    result.errorMetric = 0;
+    result.maxError = result.meanError = 0;
+    results.push_back(result);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// fill inputs (deterministic with seed)
+///////////////////////////////////////////////////////////////////////////////
+void initInputs(Inputs& in, unsigned int seed)
+{
+    Matrix4 projection(1.5f, 0, 0, 0,  0, 2.0f, 0, 0,  0, 0, -1.002f, -1,  0, 0, -0.2002f, 0);
+    in.projection = projection;
+
+    for(int i = 0; i < INPUT_COUNT; ++i)
+    {
+        Vector3 axis(randomFloat(seed, -1, 1), randomFloat(seed, -1, 1), randomFloat(seed, -1, 1));
+        axis.normalize();
+        float angle = randomFloat(seed, -180, 180);
+        Vector3 position(randomFloat(seed, -10, 10), randomFloat(seed, -10, 10), randomFloat(seed, -10, 10));
+
+        Matrix4 m;
+        m.rotate(angle, axis).translate(position);
+        in.euclidean.push_back(m);
+        in.projective.push_back(projection * m);
+
+        m.identity();
+        m.scale(randomFloat(seed, 0.5f, 2), randomFloat(seed, 0.5f, 2), randomFloat(seed, 0.5f, 2));
+        m.rotate(angle, axis).translate(position);
+        in.affine.push_back(m);
+
+        // diagonally dominant, so the condition number is small
+        for(int k = 0; k < 16; ++k)
+            m[k] = randomFloat(seed, -1, 1) + ((k % 5 == 0) ? 4.0f : 0.0f);
+        in.general.push_back(m);
+
+        Matrix3 m3;
+        for(int k = 0; k < 9; ++k)
+            m3[k] = randomFloat(seed, -1, 1) + ((k % 4 == 0) ? 3.0f : 0.0f);
+        in.matrix3s.push_back(m3);
+        in.matrix2s.push_back(Matrix2(randomFloat(seed, 1, 3), randomFloat(seed, -1, 1),
+                                      randomFloat(seed, -1, 1), randomFloat(seed, 1, 3)));
+
+        in.vector4s.push_back(Vector4(randomFloat(seed, -10, 10), randomFloat(seed, -10, 10),
+                                      randomFloat(seed, -10, 10), randomFloat(seed, -10, 10)));
+        in.vector3s.push_back(Vector3(randomFloat(seed, -10, 10), randomFloat(seed, -10, 10), randomFloat(seed, -10, 10)));
+        in.others.push_back(Vector3(randomFloat(seed, -10, 10), randomFloat(seed, -10, 10), randomFloat(seed, -10, 10)));
+        in.axes.push_back(axis);
+        in.vector2s.push_back(Vector2(randomFloat(seed, -10, 10), randomFloat(seed, -10, 10)));
+        in.angles.push_back(angle);
+    }
+
+    // after the others, so adding them does not change the inputs above
+    for(int i = 0; i < INPUT_COUNT; ++i)
+    {
+        Quaternion q(in.axes[i], in.angles[i]);
+        in.quaternions.push_back(q);
+        in.dualQuaternions.push_back(DualQuaternion(q, Vector3(in.euclidean[i][12], in.euclidean[i][13], in.euclidean[i][14])));
+        in.points.push_back(Vector3(randomFloat(seed, -30, 30), randomFloat(seed, -30, 30), randomFloat(seed, -40, -20)));
+        in.radii.push_back(randomFloat(seed, 0.5f, 5));
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// linear congruential generator, same sequence on all platforms
+///////////////////////////////////////////////////////////////////////////////
+float randomFloat(unsigned int& seed, float min, float max)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return min + (max - min) * ((seed >> 8) / 16777216.0f);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// double precision references of column-major NxN matrices
+///////////////////////////////////////////////////////////////////////////////
+// max element of |A * inv - I|
+double getResidual(const float* a, const float* inv, int n)
+{
+    double maxError = 0;
+    for(int c = 0; c < n; ++c)
+    {
+        for(int r = 0; r < n; ++r)
+        {
+            double sum = 0;
+            for(int k = 0; k < n; ++k)
+                sum += (double)a[k * n + r] * inv[c * n + k];
+            maxError = std::max(maxError, fabs(sum - (r == c ? 1.0 : 0.0)));
+        }
+    }
+    return maxError;
+}
+
+// max of |C - A*B| / (|A|*|B|) per element, A is NxN, B and C are N x columns
+double getProductError(const float* a, const float* b, const float* c, int n, int columns)
+{
+    double maxError = 0;
+    for(int col = 0; col < columns; ++col)
+    {
+        for(int r = 0; r < n; ++r)
+        {
+            double sum = 0, scale = 0;
+            for(int k = 0; k < n; ++k)
+            {
+                sum += (double)a[k * n + r] * b[col * n + k];
+                scale += fabs((double)a[k * n + r] * b[col * n + k]);
+            }
+            if(scale > 0)
+                maxError = std::max(maxError, fabs(c[col * n + r] - sum) / scale);
+        }
+    }
+    return maxError;
+}
+
+// determinant with Gaussian elimination and partial pivoting
+double getDeterminant(const float* a, int n)
+{
+    double m[16];
+    for(int i = 0; i < n * n; ++i)
+        m[i] = a[i];
+
+    double det = 1;
+    for(int c = 0; c < n; ++c)
+    {
+        int pivot = c;
+        for(int r = c + 1; r < n; ++r)
+        {
+            if(fabs(m[c * n + r]) > fabs(m[c * n + pivot]))
+                pivot = r;
+        }
+        if(m[c * n + pivot] == 0)
+            return 0;
+        if(pivot != c)
+        {
+            for(int k = 0; k < n; ++k)
+                std::swap(m[k * n + c], m[k * n + pivot]);
+            det = -det;
+        }
+        det *= m[c * n + c];
+        for(int r = c + 1; r < n; ++r)
+        {
+            double factor = m[c * n + r] / m[c * n + c];
+            for(int k = c; k < n; ++k)
+                m[k * n + r] -= factor * m[k * n + c];
+        }
+    }
+    return det;
+}
+
+// 3x3 rotation matrix (column-major) about unit axis, angle in radian
+void getRotation(double angle, const Vector3& axis, double r[9])
+{
+    double c = cos(angle), s = sin(angle), c1 = 1 - c;
+    double x = axis.x, y = axis.y, z = axis.z;
+    r[0] = x * x * c1 + c;      r[3] = x * y * c1 - z * s;  r[6] = x * z * c1 + y * s;
+    r[1] = x * y * c1 + z * s;  r[4] = y * y * c1 + c;      r[7] = y * z * c1 - x * s;
+    r[2] = x * z * c1 - y * s;  r[5] = y * z * c1 + x * s;  r[8] = z * z * c1 + c;
+}
+
+// max element of |M - R| of the upper-left 3x3, stride is the column size of m
+double getRotationError(const float* m, int stride, double angle, const Vector3& axis)
+{
+    double r[9];
+    getRotation(angle, axis, r);
+    double maxError = 0;
+    for(int c = 0; c < 3; ++c)
+        for(int k = 0; k < 3; ++k)
+            maxError = std::max(maxError, fabs(m[c * stride + k] - r[c * 3 + k]));
+    return maxError;
+}
+
+// error of r = M * (v, 1), same metric as getProductError()
+double getPointError(const Matrix4& m, const Vector3& v, const Vector3& r)
+{
+    const Vector4 v4(v.x, v.y, v.z, 1);
+    const Vector4 r4(r.x, r.y, r.z, m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15]);
+    return getProductError(m.get(), &v4.x, &r4.x, 4, 1);
+}
+
+// |dot - a.b| / sum of |a_k * b_k|
+double getDotError(const float* a, const float* b, int n, float dot)
+{
+    double expected = 0, scale = 0;
+    for(int k = 0; k < n; ++k)
+    {
+        expected += (double)a[k] * b[k];
+        scale += fabs((double)a[k] * b[k]);
+    }
+    return fabs(dot - expected) / scale;
+}
+
+// relative error of length of n elements
+double getLengthError(const float* a, int n, float length)
+{
+    double sum = 0;
+    for(int k = 0; k < n; ++k)
+        sum += (double)a[k] * a[k];
+    double expected = sqrt(sum);
+    return fabs(length - expected) / expected;
+}
+
+// Hamilton product a * b, q is (s, x, y, z)
+void multiply(const Quaternion& a, const Quaternion& b, double q[4])
+{
+    q[0] = (double)a.s * b.s - (double)a.x * b.x - (double)a.y * b.y - (double)a.z * b.z;
+    q[1] = (double)a.s * b.x + (double)a.x * b.s + (double)a.y * b.z - (double)a.z * b.y;
+    q[2] = (double)a.s * b.y - (double)a.x * b.z + (double)a.y * b.s + (double)a.z * b.x;
+    q[3] = (double)a.s * b.z + (double)a.x * b.y - (double)a.y * b.x + (double)a.z * b.s;
+}
+
+// spherical interpolation along the shorter arc, q is (s, x, y, z)
+void slerp(const Quaternion& from, const Quaternion& to, double alpha, double q[4])
+{
+    double a[4] = {from.s, from.x, from.y, from.z};
+    double b[4] = {to.s, to.x, to.y, to.z};
+    double cosine = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    double sign = (cosine < 0) ? -1 : 1;
+    cosine = std::min(fabs(cosine), 1.0);
+    double angle = acos(cosine);
+    double a1 = 1 - alpha, a2 = alpha;
+    if(angle > 1e-9)
+    {
+        a1 = sin((1 - alpha) * angle) / sin(angle);
+        a2 = sin(alpha * angle) / sin(angle);
+    }
+    for(int k = 0; k < 4; ++k)
+        q[k] = a[k] * a1 + b[k] * a2 * sign;
+}
+
+// normalized planes (a, b, c, d) of the frustum of a (view-)projection matrix
+// in the order of Frustum::PlaneIndex
+void getFrustumPlanes(const Matrix4& m, double planes[6][4])
+{
+    for(int k = 0; k < 4; ++k)
+    {
+        double row0 = m[k * 4], row1 = m[k * 4 + 1], row2 = m[k * 4 + 2], row3 = m[k * 4 + 3];
+        planes[0][k] = row3 + row0;
+        planes[1][k] = row3 - row0;
+        planes[2][k] = row3 + row1;
+        planes[3][k] = row3 - row1;
+        planes[4][k] = row3 + row2;
+        planes[5][k] = row3 - row2;
+    }
+    for(int i = 0; i < 6; ++i)
+    {
+        double length = sqrt(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+        for(int k = 0; k < 4; ++k)
+            planes[i][k] /= length;
+    }
+}
+
+// same tests as Frustum, outside if behind any plane
+bool intersectsSphere(const double planes[6][4], const Vector3& center, double radius)
+{
+    for(int i = 0; i < 6; ++i)
+    {
+        if(planes[i][0] * center.x + planes[i][1] * center.y + planes[i][2] * center.z + planes[i][3] < -radius)
+            return false;
+    }
+    return true;
+}
+
+bool intersectsBox(const double planes[6][4], const Vector3& boxMin, const Vector3& boxMax)
+{
+    for(int i = 0; i < 6; ++i)
+    {
+        double x = (planes[i][0] >= 0) ? boxMax.x : boxMin.x;
+        double y = (planes[i][1] >= 0) ? boxMax.y : boxMin.y;
+        double z = (planes[i][2] >= 0) ? boxMax.z : boxMin.z;
+        if(planes[i][0] * x + planes[i][1] * y + planes[i][2] * z + planes[i][3] < 0)
+            return false;
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// write results as JSON
+///////////////////////////////////////////////////////////////////////////////
+void writeJson(std::ostream& os, const std::vector<Result>& results)
+{
+#if defined(SIMD_SSE2)
+    const char* simd = "sse2";
+#elif defined(SIMD_NEON)
+    const char* simd = "neon";
+#else
+    const char* simd = "none";
+#endif
+
+    os << "{\n"
+       << "  \"suite\": \"mathSuite\",\n"
+       << "  \"simd\": \"" << simd << "\",\n"
+       << "  \"inputCount\": " << INPUT_COUNT << ",\n"
+       << "  \"repeatCount\": " << REPEAT_COUNT << ",\n"
+       << "  \"results\": [\n";
+    for(std::size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        os << "    {\"name\": \"" << r.name << "\""
+           << std::fixed << std::setprecision(3)
+           << ", \"throughputNs\": " << r.throughput
+           << ", \"latencyNs\": " << r.latency
+           << std::scientific << std::setprecision(3);
+        if(r.errorMetric)
+            os << ", \"error\": {\"metric\": \"" << r.errorMetric << "\", \"max\": " << r.maxError
+               << ", \"mean\": " << r.meanError << "}";
+        else
+            os << ", \"error\": null";
+        os << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+    os << std::resetiosflags(std::ios_base::floatfield);
+}
@@ -20,11 +20,31 @@
 
 #include <cmath>
 #include <algorithm>
+#include <vector>
+#include <thread>
 #include "Matrices.h"
+#include "Quaternion.h"
+#include "ThreadPool.h"
+#include "Simd.h"
 
 const float DEG2RAD = 3.141593f / 180.0f;
 const float RAD2DEG = 180.0f / 3.141593f;
 const float EPSILON = 0.00001f;
+const std::size_t PARALLEL_BLOCK = 1024;    // elements per index of ThreadPool::parallelFor()
+
+// types of batch transform
+enum TransformMode
+{
+    TRANSFORM_POINT = 0,        // (x,y,z,1)
+    TRANSFORM_VECTOR,           // (x,y,z,0)
+    TRANSFORM_PROJECTIVE        // (x,y,z,1), then divide by w
+};
+
+// batch kernels, defined at the end of this file
+static void transformStrided(const float* m, int mode, const float* src, int srcStride, float* dst, int dstStride, std::size_t count);
+static void transformSoA(const float* m, int mode, const float* srcX, const float* srcY, const float* srcZ,
+                         float* dstX, float* dstY, float* dstZ, std::size_t count);
+template<class Func> static void runParallel(std::size_t count, int threadCount, ThreadPool* pool, Func func);
 
 
 
@@ -511,43 +531,6 @@ float Matrix4::getCofactor(float m0, float m1, float m2,
 
 
 
-///////////////////////////////////////////////////////////////////////////////
-// translate this matrix by (x, y, z)
-///////////////////////////////////////////////////////////////////////////////
-Matrix4& Matrix4::translate(const Vector3& v)
-{
-    return translate(v.x, v.y, v.z);
-}
-
-Matrix4& Matrix4::translate(float x, float y, float z)
-{
-    m[0] += m[3] * x;   m[4] += m[7] * x;   m[8] += m[11]* x;   m[12]+= m[15]* x;
-    m[1] += m[3] * y;   m[5] += m[7] * y;   m[9] += m[11]* y;   m[13]+= m[15]* y;
-    m[2] += m[3] * z;   m[6] += m[7] * z;   m[10]+= m[11]* z;   m[14]+= m[15]* z;
-
-    return *this;
-}
-
-
-
-///////////////////////////////////////////////////////////////////////////////
-// uniform scale
-///////////////////////////////////////////////////////////////////////////////
-Matrix4& Matrix4::scale(float s)
-{
-    return scale(s, s, s);
-}
-
-Matrix4& Matrix4::scale(float x, float y, float z)
-{
-    m[0] *= x;   m[4] *= x;   m[8] *= x;   m[12] *= x;
-    m[1] *= y;   m[5] *= y;   m[9] *= y;   m[13] *= y;
-    m[2] *= z;   m[6] *= z;   m[10]*= z;   m[14] *= z;
-    return *this;
-}
-
-
-
 ///////////////////////////////////////////////////////////////////////////////
 // build a rotation matrix with given angle(degree) and rotation axis, then
 // multiply it with this object
@@ -559,102 +542,35 @@ Matrix4& Matrix4::rotate(float angle, const Vector3& axis)
 
 Matrix4& Matrix4::rotate(float angle, float x, float y, float z)
 {
-    float c = cosf(angle * DEG2RAD);    // cosine
-    float s = sinf(angle * DEG2RAD);    // sine
-    float c1 = 1.0f - c;                // 1 - c
-    float m0 = m[0],  m4 = m[4],  m8 = m[8],  m12= m[12],
-          m1 = m[1],  m5 = m[5],  m9 = m[9],  m13= m[13],
-          m2 = m[2],  m6 = m[6],  m10= m[10], m14= m[14];
-
-    // build rotation matrix
-    float r0 = x * x * c1 + c;
-    float r1 = x * y * c1 + z * s;
-    float r2 = x * z * c1 - y * s;
-    float r4 = x * y * c1 - z * s;
-    float r5 = y * y * c1 + c;
-    float r6 = y * z * c1 + x * s;
-    float r8 = x * z * c1 + y * s;
-    float r9 = y * z * c1 - x * s;
-    float r10= z * z * c1 + c;
-
-    // multiply rotation matrix
-    m[0] = r0 * m0 + r4 * m1 + r8 * m2;
-    m[1] = r1 * m0 + r5 * m1 + r9 * m2;
-    m[2] = r2 * m0 + r6 * m1 + r10* m2;
-    m[4] = r0 * m4 + r4 * m5 + r8 * m6;
-    m[5] = r1 * m4 + r5 * m5 + r9 * m6;
-    m[6] = r2 * m4 + r6 * m5 + r10* m6;
-    m[8] = r0 * m8 + r4 * m9 + r8 * m10;
-    m[9] = r1 * m8 + r5 * m9 + r9 * m10;
-    m[10]= r2 * m8 + r6 * m9 + r10* m10;
-    m[12]= r0 * m12+ r4 * m13+ r8 * m14;
-    m[13]= r1 * m12+ r5 * m13+ r9 * m14;
-    m[14]= r2 * m12+ r6 * m13+ r10* m14;
-
-    return *this;
+    return rotateCosSin(cosf(angle * DEG2RAD), sinf(angle * DEG2RAD), x, y, z);
 }
 
 Matrix4& Matrix4::rotateX(float angle)
 {
-    float c = cosf(angle * DEG2RAD);
-    float s = sinf(angle * DEG2RAD);
-    float m1 = m[1],  m2 = m[2],
-          m5 = m[5],  m6 = m[6],
-          m9 = m[9],  m10= m[10],
-          m13= m[13], m14= m[14];
-
-    m[1] = m1 * c + m2 *-s;
-    m[2] = m1 * s + m2 * c;
-    m[5] = m5 * c + m6 *-s;
-    m[6] = m5 * s + m6 * c;
-    m[9] = m9 * c + m10*-s;
-    m[10]= m9 * s + m10* c;
-    m[13]= m13* c + m14*-s;
-    m[14]= m13* s + m14* c;
-
-    return *this;
+    return rotateXCosSin(cosf(angle * DEG2RAD), sinf(angle * DEG2RAD));
 }
 
 Matrix4& Matrix4::rotateY(float angle)
 {
-    float c = cosf(angle * DEG2RAD);
-    float s = sinf(angle * DEG2RAD);
-    float m0 = m[0],  m2 = m[2],
-          m4 = m[4],  m6 = m[6],
-          m8 = m[8],  m10= m[10],
-          m12= m[12], m14= m[14];
-
-    m[0] = m0 * c + m2 * s;
-    m[2] = m0 *-s + m2 * c;
-    m[4] = m4 * c + m6 * s;
-    m[6] = m4 *-s + m6 * c;
-    m[8] = m8 * c + m10* s;
-    m[10]= m8 *-s + m10* c;
-    m[12]= m12* c + m14* s;
-    m[14]= m12*-s + m14* c;
-
-    return *this;
+    return rotateYCosSin(cosf(angle * DEG2RAD), sinf(angle * DEG2RAD));
 }
 
 Matrix4& Matrix4::rotateZ(float angle)
 {
-    float c = cosf(angle * DEG2RAD);
-    float s = sinf(angle * DEG2RAD);
-    float m0 = m[0],  m1 = m[1],
-          m4 = m[4],  m5 = m[5],
-          m8 = m[8],  m9 = m[9],
-          m12= m[12], m13= m[13];
-
-    m[0] = m0 * c + m1 *-s;
-    m[1] = m0 * s + m1 * c;
-    m[4] = m4 * c + m5 *-s;
-    m[5] = m4 * s + m5 * c;
-    m[8] = m8 * c + m9 *-s;
-    m[9] = m8 * s + m9 * c;
-    m[12]= m12* c + m13*-s;
-    m[13]= m12* s + m13* c;
+    return rotateZCosSin(cosf(angle * DEG2RAD), sinf(angle * DEG2RAD));
+}
 
-    return *this;
+Matrix4& Matrix4::rotate(const Quaternion& q)
+{
+    // 3x3 rotation part of Quaternion::getMatrix() without trig
+    float x2 = q.x + q.x, y2 = q.y + q.y, z2 = q.z + q.z;
+    float xx2 = q.x * x2, xy2 = q.x * y2, xz2 = q.x * z2;
+    float yy2 = q.y * y2, yz2 = q.y * z2, zz2 = q.z * z2;
+    float sx2 = q.s * x2, sy2 = q.s * y2, sz2 = q.s * z2;
+    const float r[9] = { 1 - (yy2 + zz2), xy2 + sz2,       xz2 - sy2,
+                         xy2 - sz2,       1 - (xx2 + zz2), yz2 + sx2,
+                         xz2 + sy2,       yz2 - sx2,       1 - (xx2 + yy2) };
+    return multiplyRotation(r);
 }
 
 
@@ -803,3 +719,357 @@ Vector3 Matrix4::getAngle() const
 
     return Vector3(pitch, yaw, roll);
 }
+
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// fused matrix products
+// Each column of the product is a linear combination of the columns of the
+// left matrix, so the columns of left matrices are kept in registers and the
+// results go straight to the outputs. Every column of the right matrix is read
+// before the same column is written, so the outputs can alias the inputs.
+///////////////////////////////////////////////////////////////////////////////
+#if defined(SIMD_FLOAT4)
+static inline simd4f combineColumns(simd4f a0, simd4f a1, simd4f a2, simd4f a3, const float* b)
+{
+    return simdMadd(a0, simdSet1(b[0]),
+           simdMadd(a1, simdSet1(b[1]),
+           simdMadd(a2, simdSet1(b[2]),
+           simdMul (a3, simdSet1(b[3])))));
+}
+#else
+static inline void combineColumns(const float* a, const float* b, float* out)
+{
+    out[0] = a[0]*b[0] + a[4]*b[1] + a[8]*b[2]  + a[12]*b[3];
+    out[1] = a[1]*b[0] + a[5]*b[1] + a[9]*b[2]  + a[13]*b[3];
+    out[2] = a[2]*b[0] + a[6]*b[1] + a[10]*b[2] + a[14]*b[3];
+    out[3] = a[3]*b[0] + a[7]*b[1] + a[11]*b[2] + a[15]*b[3];
+}
+#endif
+
+void Matrix4::multiply(const Matrix4& a, const Matrix4& b, Matrix4& out)
+{
+#if defined(SIMD_FLOAT4)
+    simd4f a0 = simdLoad(&a.m[0]);
+    simd4f a1 = simdLoad(&a.m[4]);
+    simd4f a2 = simdLoad(&a.m[8]);
+    simd4f a3 = simdLoad(&a.m[12]);
+    for(int i = 0; i < 16; i += 4)
+        simdStore(&out.m[i], combineColumns(a0, a1, a2, a3, &b.m[i]));
+#else
+    float tmp[16];
+    for(int i = 0; i < 16; i += 4)
+        combineColumns(a.m, &b.m[i], &tmp[i]);
+    out.set(tmp);
+#endif
+}
+
+void Matrix4::computeMVP(const Matrix4& p, const Matrix4& v, const Matrix4& m,
+                         Matrix4& outMV, Matrix4& outMVP)
+{
+#if defined(SIMD_FLOAT4)
+    simd4f v0 = simdLoad(&v.m[0]),  p0 = simdLoad(&p.m[0]);
+    simd4f v1 = simdLoad(&v.m[4]),  p1 = simdLoad(&p.m[4]);
+    simd4f v2 = simdLoad(&v.m[8]),  p2 = simdLoad(&p.m[8]);
+    simd4f v3 = simdLoad(&v.m[12]), p3 = simdLoad(&p.m[12]);
+    for(int i = 0; i < 16; i += 4)
+    {
+        simdStore(&outMV.m[i], combineColumns(v0, v1, v2, v3, &m.m[i]));
+        simdStore(&outMVP.m[i], combineColumns(p0, p1, p2, p3, &outMV.m[i]));
+    }
+#else
+    float mv[16], mvp[16];
+    for(int i = 0; i < 16; i += 4)
+    {
+        combineColumns(v.m, &m.m[i], &mv[i]);
+        combineColumns(p.m, &mv[i], &mvp[i]);
+    }
+    outMV.set(mv);
+    outMVP.set(mvp);
+#endif
+}
+
+void Matrix4::computeMVPandNormal(const Matrix4& p, const Matrix4& v, const Matrix4& m,
+                                  Matrix4& outMV, Matrix4& outMVP, Matrix4& outN)
+{
+    computeMVP(p, v, m, outMV, outMVP);
+
+    // normal matrix is the modelview matrix without translation
+    // NOTE: it is valid only for rigid body and uniform scale transforms
+    outN.set(outMV.m);
+    outN.m[12] = outN.m[13] = outN.m[14] = 0.0f;
+    outN.m[15] = 1.0f;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// batch transform of points (x,y,z,1)
+///////////////////////////////////////////////////////////////////////////////
+void Matrix4::transformPoints(const Vector3* src, Vector3* dst, std::size_t count) const
+{
+    transformStrided(m, TRANSFORM_POINT, &src->x, sizeof(Vector3), &dst->x, sizeof(Vector3), count);
+}
+
+void Matrix4::transformPoints(const float* src, int srcStride, float* dst, int dstStride, std::size_t count) const
+{
+    transformStrided(m, TRANSFORM_POINT, src, srcStride, dst, dstStride, count);
+}
+
+void Matrix4::transformPoints(const float* srcX, const float* srcY, const float* srcZ,
+                              float* dstX, float* dstY, float* dstZ, std::size_t count) const
+{
+    transformSoA(m, TRANSFORM_POINT, srcX, srcY, srcZ, dstX, dstY, dstZ, count);
+}
+
+void Matrix4::transformPoints(const Vector4* src, Vector4* dst, std::size_t count) const
+{
+#if defined(SIMD_FLOAT4)
+    simd4f c0 = simdLoad(&m[0]);
+    simd4f c1 = simdLoad(&m[4]);
+    simd4f c2 = simdLoad(&m[8]);
+    simd4f c3 = simdLoad(&m[12]);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const float* v = &src[i].x;
+        simd4f r = simdMadd(c0, simdSet1(v[0]),
+                   simdMadd(c1, simdSet1(v[1]),
+                   simdMadd(c2, simdSet1(v[2]),
+                   simdMul (c3, simdSet1(v[3])))));
+        simdStore(&dst[i].x, r);
+    }
+#else
+    for(std::size_t i = 0; i < count; ++i)
+        dst[i] = *this * src[i];
+#endif
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// batch transform of direction vectors (x,y,z,0), translation is ignored
+///////////////////////////////////////////////////////////////////////////////
+void Matrix4::transformVectors(const Vector3* src, Vector3* dst, std::size_t count) const
+{
+    transformStrided(m, TRANSFORM_VECTOR, &src->x, sizeof(Vector3), &dst->x, sizeof(Vector3), count);
+}
+
+void Matrix4::transformVectors(const float* src, int srcStride, float* dst, int dstStride, std::size_t count) const
+{
+    transformStrided(m, TRANSFORM_VECTOR, src, srcStride, dst, dstStride, count);
+}
+
+void Matrix4::transformVectors(const float* srcX, const float* srcY, const float* srcZ,
+                               float* dstX, float* dstY, float* dstZ, std::size_t count) const
+{
+    transformSoA(m, TRANSFORM_VECTOR, srcX, srcY, srcZ, dstX, dstY, dstZ, count);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// batch transform of points (x,y,z,1) followed by perspective division (w)
+///////////////////////////////////////////////////////////////////////////////
+void Matrix4::transformPointsProjective(const Vector3* src, Vector3* dst, std::size_t count) const
+{
+    transformStrided(m, TRANSFORM_PROJECTIVE, &src->x, sizeof(Vector3), &dst->x, sizeof(Vector3), count);
+}
+
+void Matrix4::transformPointsProjective(const float* src, int srcStride, float* dst, int dstStride, std::size_t count) const
+{
+    transformStrided(m, TRANSFORM_PROJECTIVE, src, srcStride, dst, dstStride, count);
+}
+
+void Matrix4::transformPointsProjective(const float* srcX, const float* srcY, const float* srcZ,
+                                        float* dstX, float* dstY, float* dstZ, std::size_t count) const
+{
+    transformSoA(m, TRANSFORM_PROJECTIVE, srcX, srcY, srcZ, dstX, dstY, dstZ, count);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// multi-threaded batch transforms
+///////////////////////////////////////////////////////////////////////////////
+void Matrix4::transformPointsParallel(const Vector3* src, Vector3* dst, std::size_t count, int threadCount, ThreadPool* pool) const
+{
+    runParallel(count, threadCount, pool, [=](std::size_t first, std::size_t last)
+    {
+        transformPoints(src + first, dst + first, last - first);
+    });
+}
+
+void Matrix4::transformPointsParallel(const float* src, int srcStride, float* dst, int dstStride, std::size_t count, int threadCount, ThreadPool* pool) const
+{
+    runParallel(count, threadCount, pool, [=](std::size_t first, std::size_t last)
+    {
+        transformPoints((const float*)((const char*)src + first * srcStride), srcStride,
+                        (float*)((char*)dst + first * dstStride), dstStride, last - first);
+    });
+}
+
+void Matrix4::transformVectorsParallel(const Vector3* src, Vector3* dst, std::size_t count, int threadCount, ThreadPool* pool) const
+{
+    runParallel(count, threadCount, pool, [=](std::size_t first, std::size_t last)
+    {
+        transformVectors(src + first, dst + first, last - first);
+    });
+}
+
+void Matrix4::transformVectorsParallel(const float* src, int srcStride, float* dst, int dstStride, std::size_t count, int threadCount, ThreadPool* pool) const
+{
+    runParallel(count, threadCount, pool, [=](std::size_t first, std::size_t last)
+    {
+        transformVectors((const float*)((const char*)src + first * srcStride), srcStride,
+                         (float*)((char*)dst + first * dstStride), dstStride, last - first);
+    });
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// transform strided xyz elements with column-major matrix m
+// Each element is loaded into registers before storing the result, so it is
+// safe to transform in place (src == dst).
+///////////////////////////////////////////////////////////////////////////////
+static void transformStrided(const float* m, int mode, const float* src, int srcStride, float* dst, int dstStride, std::size_t count)
+{
+    const char* s = (const char*)src;
+    char* d = (char*)dst;
+
+#if defined(SIMD_FLOAT4)
+    simd4f c0 = simdLoad(&m[0]);
+    simd4f c1 = simdLoad(&m[4]);
+    simd4f c2 = simdLoad(&m[8]);
+    simd4f c3 = (mode == TRANSFORM_VECTOR) ? simdSet1(0.0f) : simdLoad(&m[12]);
+    for(std::size_t i = 0; i < count; ++i, s += srcStride, d += dstStride)
+    {
+        const float* v = (const float*)s;
+        simd4f r = simdMadd(c0, simdSet1(v[0]),
+                   simdMadd(c1, simdSet1(v[1]),
+                   simdMadd(c2, simdSet1(v[2]), c3)));
+        if(mode == TRANSFORM_PROJECTIVE)
+            r = simdDiv(r, simdSplatW(r));
+        simdStore3((float*)d, r);
+    }
+#else
+    float t = (mode == TRANSFORM_VECTOR) ? 0.0f : 1.0f;
+    for(std::size_t i = 0; i < count; ++i, s += srcStride, d += dstStride)
+    {
+        const float* v = (const float*)s;
+        float x = v[0], y = v[1], z = v[2];
+        float* o = (float*)d;
+        o[0] = m[0]*x + m[4]*y + m[8]*z  + m[12]*t;
+        o[1] = m[1]*x + m[5]*y + m[9]*z  + m[13]*t;
+        o[2] = m[2]*x + m[6]*y + m[10]*z + m[14]*t;
+        if(mode == TRANSFORM_PROJECTIVE)
+        {
+            float invW = 1.0f / (m[3]*x + m[7]*y + m[11]*z + m[15]);
+            o[0] *= invW;
+            o[1] *= invW;
+            o[2] *= invW;
+        }
+    }
+#endif
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// transform SoA arrays, 4 elements per iteration with SIMD
+///////////////////////////////////////////////////////////////////////////////
+static void transformSoA(const float* m, int mode, const float* srcX, const float* srcY, const float* srcZ,
+                         float* dstX, float* dstY, float* dstZ, std::size_t count)
+{
+    float t = (mode == TRANSFORM_VECTOR) ? 0.0f : 1.0f;
+    std::size_t i = 0;
+
+#if defined(SIMD_FLOAT4)
+    simd4f m0 = simdSet1(m[0]),   m1 = simdSet1(m[1]),   m2 = simdSet1(m[2]),   m3 = simdSet1(m[3]);
+    simd4f m4 = simdSet1(m[4]),   m5 = simdSet1(m[5]),   m6 = simdSet1(m[6]),   m7 = simdSet1(m[7]);
+    simd4f m8 = simdSet1(m[8]),   m9 = simdSet1(m[9]),   m10= simdSet1(m[10]),  m11= simdSet1(m[11]);
+    simd4f m12= simdSet1(m[12]*t),m13= simdSet1(m[13]*t),m14= simdSet1(m[14]*t),m15= simdSet1(m[15]);
+    for(; i + 4 <= count; i += 4)
+    {
+        simd4f x = simdLoad(srcX + i);
+        simd4f y = simdLoad(srcY + i);
+        simd4f z = simdLoad(srcZ + i);
+        simd4f ox = simdMadd(m0, x, simdMadd(m4, y, simdMadd(m8,  z, m12)));
+        simd4f oy = simdMadd(m1, x, simdMadd(m5, y, simdMadd(m9,  z, m13)));
+        simd4f oz = simdMadd(m2, x, simdMadd(m6, y, simdMadd(m10, z, m14)));
+        if(mode == TRANSFORM_PROJECTIVE)
+        {
+            simd4f ow = simdMadd(m3, x, simdMadd(m7, y, simdMadd(m11, z, m15)));
+            ox = simdDiv(ox, ow);
+            oy = simdDiv(oy, ow);
+            oz = simdDiv(oz, ow);
+        }
+        simdStore(dstX + i, ox);
+        simdStore(dstY + i, oy);
+        simdStore(dstZ + i, oz);
+    }
+#endif
+
+    // remains
+    for(; i < count; ++i)
+    {
+        float x = srcX[i], y = srcY[i], z = srcZ[i];
+        dstX[i] = m[0]*x + m[4]*y + m[8]*z  + m[12]*t;
+        dstY[i] = m[1]*x + m[5]*y + m[9]*z  + m[13]*t;
+        dstZ[i] = m[2]*x + m[6]*y + m[10]*z + m[14]*t;
+        if(mode == TRANSFORM_PROJECTIVE)
+        {
+            float invW = 1.0f / (m[3]*x + m[7]*y + m[11]*z + m[15]);
+            dstX[i] *= invW;
+            dstY[i] *= invW;
+            dstZ[i] *= invW;
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// split [0, count) into contiguous chunks and call func(first, last) on each
+// chunk with a separate thread. The calling thread takes the last chunk.
+// With a pool, the chunks are bands of parallelFor() in its workers. It
+// splits an int range, so the range is in blocks of PARALLEL_BLOCK elements.
+///////////////////////////////////////////////////////////////////////////////
+template<class Func>
+static void runParallel(std::size_t count, int threadCount, ThreadPool* pool, Func func)
+{
+    if(pool)
+    {
+        if(count < Matrix4::PARALLEL_THRESHOLD)
+        {
+            func(0, count);
+            return;
+        }
+        int blockCount = (int)((count + PARALLEL_BLOCK - 1) / PARALLEL_BLOCK);
+        pool->parallelFor(blockCount, [&func, count](int first, int last)
+        {
+            func(first * PARALLEL_BLOCK, std::min(last * PARALLEL_BLOCK, count));
+        });
+        return;
+    }
+
+    if(threadCount <= 0)
+        threadCount = (int)std::thread::hardware_concurrency();
+    if(count < Matrix4::PARALLEL_THRESHOLD || threadCount <= 1)
+    {
+        func(0, count);
+        return;
+    }
+
+    std::size_t chunk = (count + threadCount - 1) / threadCount;
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    std::size_t first = 0;
+    for(int i = 0; i < threadCount - 1 && first + chunk < count; ++i, first += chunk)
+        threads.push_back(std::thread(func, first, first + chunk));
+    func(first, count);
+
+    for(std::size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+}
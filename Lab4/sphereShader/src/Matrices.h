@@ -23,8 +23,53 @@
 
 #include <iostream>
 #include <iomanip>
+#include <cstddef>
 #include "Vectors.h"
 
+struct Quaternion;                      // Quaternion.h
+class ThreadPool;                       // ThreadPool.h
+
+///////////////////////////////////////////////////////////////////////////
+// constexpr sine and cosine (radian) for compile-time transforms
+// The angle is reduced to [-PI/2, PI/2] and evaluated with Taylor series up
+// to 17th order in double precision, so the result is correctly rounded to
+// float in most cases. Use sinf()/cosf() at runtime; they are faster.
+///////////////////////////////////////////////////////////////////////////
+constexpr double constexprSinReduced(double x)  // |x| <= PI/2
+{
+    double x2 = x * x;
+    double term = x;
+    double sum = x;
+    for(int i = 1; i <= 8; ++i)
+    {
+        term *= -x2 / ((2 * i) * (2 * i + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double constexprSinDouble(double x)
+{
+    const double PI = 3.14159265358979323846;
+    long long k = (long long)(x / (2 * PI) + (x >= 0 ? 0.5 : -0.5));
+    x -= k * 2 * PI;                            // [-PI, PI]
+    if(x > PI / 2)       x = PI - x;            // sin(x) = sin(PI - x)
+    else if(x < -PI / 2) x = -PI - x;
+    return constexprSinReduced(x);
+}
+
+constexpr float constexprSin(float radian)
+{
+    return (float)constexprSinDouble(radian);
+}
+
+constexpr float constexprCos(float radian)
+{
+    return (float)constexprSinDouble(radian + 3.14159265358979323846 / 2);
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////
 // 2x2 matrix
 ///////////////////////////////////////////////////////////////////////////
@@ -32,45 +77,45 @@ class Matrix2
 {
 public:
     // constructors
-    Matrix2();  // init with identity
-    Matrix2(const float src[4]);
-    Matrix2(float m0, float m1, float m2, float m3);
-
-    void        set(const float src[4]);
-    void        set(float m0, float m1, float m2, float m3);
-    void        setRow(int index, const float row[2]);
-    void        setRow(int index, const Vector2& v);
-    void        setColumn(int index, const float col[2]);
-    void        setColumn(int index, const Vector2& v);
-
-    const float* get() const;
+    constexpr Matrix2();  // init with identity
+    constexpr Matrix2(const float src[4]);
+    constexpr Matrix2(float m0, float m1, float m2, float m3);
+
+    constexpr void        set(const float src[4]);
+    constexpr void        set(float m0, float m1, float m2, float m3);
+    constexpr void        setRow(int index, const float row[2]);
+    constexpr void        setRow(int index, const Vector2& v);
+    constexpr void        setColumn(int index, const float col[2]);
+    constexpr void        setColumn(int index, const Vector2& v);
+
+    constexpr const float* get() const;
     const float* getTranspose();
-    Vector2     getRow(int index) const;
-    Vector2     getColumn(int index) const;
+    constexpr Vector2     getRow(int index) const;
+    constexpr Vector2     getColumn(int index) const;
     float       getDeterminant() const;
     float       getAngle() const;                       // retrieve angle (degree) from matrix
 
-    Matrix2&    identity();
+    constexpr Matrix2&    identity();
     Matrix2&    transpose();                            // transpose itself and return reference
     Matrix2&    invert();
 
     // operators
-    Matrix2     operator+(const Matrix2& rhs) const;    // add rhs
-    Matrix2     operator-(const Matrix2& rhs) const;    // subtract rhs
-    Matrix2&    operator+=(const Matrix2& rhs);         // add rhs and update this object
-    Matrix2&    operator-=(const Matrix2& rhs);         // subtract rhs and update this object
-    Vector2     operator*(const Vector2& rhs) const;    // multiplication: v' = M * v
-    Matrix2     operator*(const Matrix2& rhs) const;    // multiplication: M3 = M1 * M2
-    Matrix2&    operator*=(const Matrix2& rhs);         // multiplication: M1' = M1 * M2
-    bool        operator==(const Matrix2& rhs) const;   // exact compare, no epsilon
-    bool        operator!=(const Matrix2& rhs) const;   // exact compare, no epsilon
-    float       operator[](int index) const;            // subscript operator v[0], v[1]
-    float&      operator[](int index);                  // subscript operator v[0], v[1]
+    constexpr Matrix2     operator+(const Matrix2& rhs) const;    // add rhs
+    constexpr Matrix2     operator-(const Matrix2& rhs) const;    // subtract rhs
+    constexpr Matrix2&    operator+=(const Matrix2& rhs);         // add rhs and update this object
+    constexpr Matrix2&    operator-=(const Matrix2& rhs);         // subtract rhs and update this object
+    constexpr Vector2     operator*(const Vector2& rhs) const;    // multiplication: v' = M * v
+    constexpr Matrix2     operator*(const Matrix2& rhs) const;    // multiplication: M3 = M1 * M2
+    constexpr Matrix2&    operator*=(const Matrix2& rhs);         // multiplication: M1' = M1 * M2
+    constexpr bool        operator==(const Matrix2& rhs) const;   // exact compare, no epsilon
+    constexpr bool        operator!=(const Matrix2& rhs) const;   // exact compare, no epsilon
+    constexpr float       operator[](int index) const;            // subscript operator v[0], v[1]
+    constexpr float&      operator[](int index);                  // subscript operator v[0], v[1]
 
     // friends functions
-    friend Matrix2 operator-(const Matrix2& m);                     // unary operator (-)
-    friend Matrix2 operator*(float scalar, const Matrix2& m);       // pre-multiplication
-    friend Vector2 operator*(const Vector2& vec, const Matrix2& m); // pre-multiplication
+    friend constexpr Matrix2 operator-(const Matrix2& m);                     // unary operator (-)
+    friend constexpr Matrix2 operator*(float scalar, const Matrix2& m);       // pre-multiplication
+    friend constexpr Vector2 operator*(const Vector2& vec, const Matrix2& m); // pre-multiplication
     friend std::ostream& operator<<(std::ostream& os, const Matrix2& m);
 
     // static functions
@@ -91,48 +136,48 @@ class Matrix3
 {
 public:
     // constructors
-    Matrix3();  // init with identity
-    Matrix3(const float src[9]);
-    Matrix3(float m0, float m1, float m2,           // 1st column
-            float m3, float m4, float m5,           // 2nd column
-            float m6, float m7, float m8);          // 3rd column
-
-    void        set(const float src[9]);
-    void        set(float m0, float m1, float m2,   // 1st column
-                    float m3, float m4, float m5,   // 2nd column
-                    float m6, float m7, float m8);  // 3rd column
-    void        setRow(int index, const float row[3]);
-    void        setRow(int index, const Vector3& v);
-    void        setColumn(int index, const float col[3]);
-    void        setColumn(int index, const Vector3& v);
-
-    const float* get() const;
+    constexpr Matrix3();  // init with identity
+    constexpr Matrix3(const float src[9]);
+    constexpr Matrix3(float m0, float m1, float m2,           // 1st column
+                      float m3, float m4, float m5,           // 2nd column
+                      float m6, float m7, float m8);          // 3rd column
+
+    constexpr void        set(const float src[9]);
+    constexpr void        set(float m0, float m1, float m2,   // 1st column
+                              float m3, float m4, float m5,   // 2nd column
+                              float m6, float m7, float m8);  // 3rd column
+    constexpr void        setRow(int index, const float row[3]);
+    constexpr void        setRow(int index, const Vector3& v);
+    constexpr void        setColumn(int index, const float col[3]);
+    constexpr void        setColumn(int index, const Vector3& v);
+
+    constexpr const float* get() const;
     const float* getTranspose();
-    Vector3     getRow(int index) const;
-    Vector3     getColumn(int index) const;
+    constexpr Vector3     getRow(int index) const;
+    constexpr Vector3     getColumn(int index) const;
     float       getDeterminant() const;
     Vector3     getAngle() const;                       // return (pitch, yaw, roll) in degree
-    Matrix3&    identity();
+    constexpr Matrix3&    identity();
     Matrix3&    transpose();                            // transpose itself and return reference
     Matrix3&    invert();
 
     // operators
-    Matrix3     operator+(const Matrix3& rhs) const;    // add rhs
-    Matrix3     operator-(const Matrix3& rhs) const;    // subtract rhs
-    Matrix3&    operator+=(const Matrix3& rhs);         // add rhs and update this object
-    Matrix3&    operator-=(const Matrix3& rhs);         // subtract rhs and update this object
-    Vector3     operator*(const Vector3& rhs) const;    // multiplication: v' = M * v
-    Matrix3     operator*(const Matrix3& rhs) const;    // multiplication: M3 = M1 * M2
-    Matrix3&    operator*=(const Matrix3& rhs);         // multiplication: M1' = M1 * M2
-    bool        operator==(const Matrix3& rhs) const;   // exact compare, no epsilon
-    bool        operator!=(const Matrix3& rhs) const;   // exact compare, no epsilon
-    float       operator[](int index) const;            // subscript operator v[0], v[1]
-    float&      operator[](int index);                  // subscript operator v[0], v[1]
+    constexpr Matrix3     operator+(const Matrix3& rhs) const;    // add rhs
+    constexpr Matrix3     operator-(const Matrix3& rhs) const;    // subtract rhs
+    constexpr Matrix3&    operator+=(const Matrix3& rhs);         // add rhs and update this object
+    constexpr Matrix3&    operator-=(const Matrix3& rhs);         // subtract rhs and update this object
+    constexpr Vector3     operator*(const Vector3& rhs) const;    // multiplication: v' = M * v
+    constexpr Matrix3     operator*(const Matrix3& rhs) const;    // multiplication: M3 = M1 * M2
+    constexpr Matrix3&    operator*=(const Matrix3& rhs);         // multiplication: M1' = M1 * M2
+    constexpr bool        operator==(const Matrix3& rhs) const;   // exact compare, no epsilon
+    constexpr bool        operator!=(const Matrix3& rhs) const;   // exact compare, no epsilon
+    constexpr float       operator[](int index) const;            // subscript operator v[0], v[1]
+    constexpr float&      operator[](int index);                  // subscript operator v[0], v[1]
 
     // friends functions
-    friend Matrix3 operator-(const Matrix3& m);                     // unary operator (-)
-    friend Matrix3 operator*(float scalar, const Matrix3& m);       // pre-multiplication
-    friend Vector3 operator*(const Vector3& vec, const Matrix3& m); // pre-multiplication
+    friend constexpr Matrix3 operator-(const Matrix3& m);                     // unary operator (-)
+    friend constexpr Matrix3 operator*(float scalar, const Matrix3& m);       // pre-multiplication
+    friend constexpr Vector3 operator*(const Vector3& vec, const Matrix3& m); // pre-multiplication
     friend std::ostream& operator<<(std::ostream& os, const Matrix3& m);
 
 protected:
@@ -151,36 +196,36 @@ class Matrix4
 {
 public:
     // constructors
-    Matrix4();  // init with identity
-    Matrix4(const float src[16]);
-    Matrix4(float m00, float m01, float m02, float m03, // 1st column
-            float m04, float m05, float m06, float m07, // 2nd column
-            float m08, float m09, float m10, float m11, // 3rd column
-            float m12, float m13, float m14, float m15);// 4th column
-
-    void        set(const float src[16]);
-    void        set(float m00, float m01, float m02, float m03, // 1st column
-                    float m04, float m05, float m06, float m07, // 2nd column
-                    float m08, float m09, float m10, float m11, // 3rd column
-                    float m12, float m13, float m14, float m15);// 4th column
-    void        setRow(int index, const float row[4]);
-    void        setRow(int index, const Vector4& v);
-    void        setRow(int index, const Vector3& v);
-    void        setColumn(int index, const float col[4]);
-    void        setColumn(int index, const Vector4& v);
-    void        setColumn(int index, const Vector3& v);
-
-    const float* get() const;
+    constexpr Matrix4();  // init with identity
+    constexpr Matrix4(const float src[16]);
+    constexpr Matrix4(float m00, float m01, float m02, float m03, // 1st column
+                      float m04, float m05, float m06, float m07, // 2nd column
+                      float m08, float m09, float m10, float m11, // 3rd column
+                      float m12, float m13, float m14, float m15);// 4th column
+
+    constexpr void        set(const float src[16]);
+    constexpr void        set(float m00, float m01, float m02, float m03, // 1st column
+                              float m04, float m05, float m06, float m07, // 2nd column
+                              float m08, float m09, float m10, float m11, // 3rd column
+                              float m12, float m13, float m14, float m15);// 4th column
+    constexpr void        setRow(int index, const float row[4]);
+    constexpr void        setRow(int index, const Vector4& v);
+    constexpr void        setRow(int index, const Vector3& v);
+    constexpr void        setColumn(int index, const float col[4]);
+    constexpr void        setColumn(int index, const Vector4& v);
+    constexpr void        setColumn(int index, const Vector3& v);
+
+    constexpr const float* get() const;
     const float* getTranspose();                        // return transposed matrix
-    Vector4     getRow(int index) const;                // return the selected row vector
-    Vector4     getColumn(int index) const;             // return the selected col vector
+    constexpr Vector4     getRow(int index) const;                // return the selected row vector
+    constexpr Vector4     getColumn(int index) const;             // return the selected col vector
     float       getDeterminant() const;
     Vector3     getAngle() const;                       // return (pitch, yaw, roll) in degree
-    Vector3     getLeftAxis() const;                    // return left vector
-    Vector3     getUpAxis() const;                      // return up vector
-    Vector3     getForwardAxis() const;                 // return forward vector
+    constexpr Vector3     getLeftAxis() const;                    // return left vector
+    constexpr Vector3     getUpAxis() const;                      // return up vector
+    constexpr Vector3     getForwardAxis() const;                 // return forward vector
 
-    Matrix4&    identity();
+    constexpr Matrix4&    identity();
     Matrix4&    transpose();                            // transpose itself and return reference
     Matrix4&    invert();                               // check best inverse method before inverse
     Matrix4&    invertEuclidean();                      // inverse of Euclidean transform matrix
@@ -189,40 +234,89 @@ public:
     Matrix4&    invertGeneral();                        // inverse of generic matrix
 
     // transform matrix
-    Matrix4&    translate(float x, float y, float z);   // translation by (x,y,z)
-    Matrix4&    translate(const Vector3& v);            //
+    constexpr Matrix4&    translate(float x, float y, float z);   // translation by (x,y,z)
+    constexpr Matrix4&    translate(const Vector3& v);            //
     Matrix4&    rotate(float angle, const Vector3& axis); // rotate angle(degree) along the given axix
     Matrix4&    rotate(float angle, float x, float y, float z);
     Matrix4&    rotateX(float angle);                   // rotate on X-axis with degree
     Matrix4&    rotateY(float angle);                   // rotate on Y-axis with degree
     Matrix4&    rotateZ(float angle);                   // rotate on Z-axis with degree
-    Matrix4&    scale(float scale);                     // uniform scale
-    Matrix4&    scale(float sx, float sy, float sz);    // scale by (sx, sy, sz) on each axis
+    Matrix4&    rotate(const Quaternion& q);            // rotate with unit quaternion
+    constexpr Matrix4&    scale(float scale);                     // uniform scale
+    constexpr Matrix4&    scale(float sx, float sy, float sz);    // scale by (sx, sy, sz) on each axis
     Matrix4&    lookAt(float tx, float ty, float tz);   // face object to the target direction
     Matrix4&    lookAt(float tx, float ty, float tz, float ux, float uy, float uz);
     Matrix4&    lookAt(const Vector3& target);
     Matrix4&    lookAt(const Vector3& target, const Vector3& up);
     //@@Matrix4&    skew(float angle, const Vector3& axis); //
 
+    // compile-time rotations with constexpr sine/cosine, for example,
+    // constexpr Matrix4 m = Matrix4().rotateYConst(45);
+    constexpr Matrix4&    rotateConst(float angle, const Vector3& axis);
+    constexpr Matrix4&    rotateConst(float angle, float x, float y, float z);
+    constexpr Matrix4&    rotateXConst(float angle);
+    constexpr Matrix4&    rotateYConst(float angle);
+    constexpr Matrix4&    rotateZConst(float angle);
+
+    // batch transform: dst[i] = M * src[i]
+    // points are (x,y,z,1), vectors are (x,y,z,0), and projective points are
+    // divided by w after multiplication. The strided versions take the distance
+    // in bytes between 2 consecutive elements, so they work directly on
+    // interleaved vertex streams (e.g. Sphere V/N/T, stride=32 bytes).
+    // The SoA versions take separate x, y, z arrays. src and dst may be same.
+    void        transformPoints(const Vector3* src, Vector3* dst, std::size_t count) const;
+    void        transformPoints(const Vector4* src, Vector4* dst, std::size_t count) const;   // use w of src
+    void        transformPoints(const float* src, int srcStride, float* dst, int dstStride, std::size_t count) const;
+    void        transformPoints(const float* srcX, const float* srcY, const float* srcZ,
+                                float* dstX, float* dstY, float* dstZ, std::size_t count) const;
+    void        transformVectors(const Vector3* src, Vector3* dst, std::size_t count) const;
+    void        transformVectors(const float* src, int srcStride, float* dst, int dstStride, std::size_t count) const;
+    void        transformVectors(const float* srcX, const float* srcY, const float* srcZ,
+                                 float* dstX, float* dstY, float* dstZ, std::size_t count) const;
+    void        transformPointsProjective(const Vector3* src, Vector3* dst, std::size_t count) const;
+    void        transformPointsProjective(const float* src, int srcStride, float* dst, int dstStride, std::size_t count) const;
+    void        transformPointsProjective(const float* srcX, const float* srcY, const float* srcZ,
+                                          float* dstX, float* dstY, float* dstZ, std::size_t count) const;
+
+    // multi-threaded batch transform, splits the array into chunks per thread
+    // if count >= PARALLEL_THRESHOLD, otherwise same as single-threaded one
+    // threadCount=0 uses the number of hardware threads. With a pool, the
+    // chunks run in its workers (threadCount is ignored), otherwise new
+    // threads are started for each call.
+    static const std::size_t PARALLEL_THRESHOLD = 65536;
+    void        transformPointsParallel(const Vector3* src, Vector3* dst, std::size_t count, int threadCount=0, ThreadPool* pool=0) const;
+    void        transformPointsParallel(const float* src, int srcStride, float* dst, int dstStride, std::size_t count, int threadCount=0, ThreadPool* pool=0) const;
+    void        transformVectorsParallel(const Vector3* src, Vector3* dst, std::size_t count, int threadCount=0, ThreadPool* pool=0) const;
+    void        transformVectorsParallel(const float* src, int srcStride, float* dst, int dstStride, std::size_t count, int threadCount=0, ThreadPool* pool=0) const;
+
     // operators
-    Matrix4     operator+(const Matrix4& rhs) const;    // add rhs
-    Matrix4     operator-(const Matrix4& rhs) const;    // subtract rhs
-    Matrix4&    operator+=(const Matrix4& rhs);         // add rhs and update this object
-    Matrix4&    operator-=(const Matrix4& rhs);         // subtract rhs and update this object
-    Vector4     operator*(const Vector4& rhs) const;    // multiplication: v' = M * v
-    Vector3     operator*(const Vector3& rhs) const;    // multiplication: v' = M * v
-    Matrix4     operator*(const Matrix4& rhs) const;    // multiplication: M3 = M1 * M2
-    Matrix4&    operator*=(const Matrix4& rhs);         // multiplication: M1' = M1 * M2
-    bool        operator==(const Matrix4& rhs) const;   // exact compare, no epsilon
-    bool        operator!=(const Matrix4& rhs) const;   // exact compare, no epsilon
-    float       operator[](int index) const;            // subscript operator v[0], v[1]
-    float&      operator[](int index);                  // subscript operator v[0], v[1]
+    constexpr Matrix4     operator+(const Matrix4& rhs) const;    // add rhs
+    constexpr Matrix4     operator-(const Matrix4& rhs) const;    // subtract rhs
+    constexpr Matrix4&    operator+=(const Matrix4& rhs);         // add rhs and update this object
+    constexpr Matrix4&    operator-=(const Matrix4& rhs);         // subtract rhs and update this object
+    constexpr Vector4     operator*(const Vector4& rhs) const;    // multiplication: v' = M * v
+    constexpr Vector3     operator*(const Vector3& rhs) const;    // multiplication: v' = M * v
+    constexpr Matrix4     operator*(const Matrix4& rhs) const;    // multiplication: M3 = M1 * M2
+    constexpr Matrix4&    operator*=(const Matrix4& rhs);         // multiplication: M1' = M1 * M2
+    constexpr bool        operator==(const Matrix4& rhs) const;   // exact compare, no epsilon
+    constexpr bool        operator!=(const Matrix4& rhs) const;   // exact compare, no epsilon
+    constexpr float       operator[](int index) const;            // subscript operator v[0], v[1]
+    constexpr float&      operator[](int index);                  // subscript operator v[0], v[1]
+
+    // fused products, written directly to the output without temporary
+    // matrices. The outputs may be the same object as the inputs.
+    // mv = v * m, mvp = p * v * m, normal = mv without translation
+    static void multiply(const Matrix4& a, const Matrix4& b, Matrix4& out);  // out = a * b
+    static void computeMVP(const Matrix4& p, const Matrix4& v, const Matrix4& m,
+                           Matrix4& outMV, Matrix4& outMVP);
+    static void computeMVPandNormal(const Matrix4& p, const Matrix4& v, const Matrix4& m,
+                                    Matrix4& outMV, Matrix4& outMVP, Matrix4& outN);
 
     // friends functions
-    friend Matrix4 operator-(const Matrix4& m);                     // unary operator (-)
-    friend Matrix4 operator*(float scalar, const Matrix4& m);       // pre-multiplication
-    friend Vector3 operator*(const Vector3& vec, const Matrix4& m); // pre-multiplication
-    friend Vector4 operator*(const Vector4& vec, const Matrix4& m); // pre-multiplication
+    friend constexpr Matrix4 operator-(const Matrix4& m);                     // unary operator (-)
+    friend constexpr Matrix4 operator*(float scalar, const Matrix4& m);       // pre-multiplication
+    friend constexpr Vector3 operator*(const Vector3& vec, const Matrix4& m); // pre-multiplication
+    friend constexpr Vector4 operator*(const Vector4& vec, const Matrix4& m); // pre-multiplication
     friend std::ostream& operator<<(std::ostream& os, const Matrix4& m);
 
 protected:
@@ -232,6 +326,13 @@ private:
                             float m3, float m4, float m5,
                             float m6, float m7, float m8) const;
 
+    // multiply rotation matrix with given cosine and sine of the angle
+    constexpr Matrix4&    rotateCosSin(float c, float s, float x, float y, float z);
+    constexpr Matrix4&    rotateXCosSin(float c, float s);
+    constexpr Matrix4&    rotateYCosSin(float c, float s);
+    constexpr Matrix4&    rotateZCosSin(float c, float s);
+    constexpr Matrix4&    multiplyRotation(const float r[9]);     // M = R * M, R is 3x3 column-major
+
     float m[16];
     float tm[16];                                       // transpose m
 
@@ -242,71 +343,69 @@ private:
 ///////////////////////////////////////////////////////////////////////////
 // inline functions for Matrix2
 ///////////////////////////////////////////////////////////////////////////
-inline Matrix2::Matrix2()
+// NOTE: all members must be initialized in constexpr ctors, including tm
+constexpr Matrix2::Matrix2() : m{1, 0, 0, 1}, tm{}
 {
     // initially identity matrix
-    identity();
 }
 
 
 
-inline Matrix2::Matrix2(const float src[4])
+constexpr Matrix2::Matrix2(const float src[4]) : m{src[0], src[1], src[2], src[3]}, tm{}
 {
-    set(src);
 }
 
 
 
-inline Matrix2::Matrix2(float m0, float m1, float m2, float m3)
+constexpr Matrix2::Matrix2(float m0, float m1, float m2, float m3) : m{m0, m1, m2, m3}, tm{}
 {
-    set(m0, m1, m2, m3);
 }
 
 
 
-inline void Matrix2::set(const float src[4])
+constexpr void Matrix2::set(const float src[4])
 {
     m[0] = src[0];  m[1] = src[1];  m[2] = src[2];  m[3] = src[3];
 }
 
 
 
-inline void Matrix2::set(float m0, float m1, float m2, float m3)
+constexpr void Matrix2::set(float m0, float m1, float m2, float m3)
 {
     m[0]= m0;  m[1] = m1;  m[2] = m2;  m[3]= m3;
 }
 
 
 
-inline void Matrix2::setRow(int index, const float row[2])
+constexpr void Matrix2::setRow(int index, const float row[2])
 {
     m[index] = row[0];  m[index + 2] = row[1];
 }
 
 
 
-inline void Matrix2::setRow(int index, const Vector2& v)
+constexpr void Matrix2::setRow(int index, const Vector2& v)
 {
     m[index] = v.x;  m[index + 2] = v.y;
 }
 
 
 
-inline void Matrix2::setColumn(int index, const float col[2])
+constexpr void Matrix2::setColumn(int index, const float col[2])
 {
     m[index*2] = col[0];  m[index*2 + 1] = col[1];
 }
 
 
 
-inline void Matrix2::setColumn(int index, const Vector2& v)
+constexpr void Matrix2::setColumn(int index, const Vector2& v)
 {
     m[index*2] = v.x;  m[index*2 + 1] = v.y;
 }
 
 
 
-inline const float* Matrix2::get() const
+constexpr const float* Matrix2::get() const
 {
     return m;
 }
@@ -322,21 +421,21 @@ inline const float* Matrix2::getTranspose()
 
 
 
-inline Vector2 Matrix2::getRow(int index) const
+constexpr Vector2 Matrix2::getRow(int index) const
 {
     return Vector2(m[index], m[index+2]);
 }
 
 
 
-inline Vector2 Matrix2::getColumn(int index) const
+constexpr Vector2 Matrix2::getColumn(int index) const
 {
     return Vector2(m[index*2], m[index*2+1]);
 }
 
 
 
-inline Matrix2& Matrix2::identity()
+constexpr Matrix2& Matrix2::identity()
 {
     m[0] = m[3] = 1.0f;
     m[1] = m[2] = 0.0f;
@@ -345,21 +444,21 @@ inline Matrix2& Matrix2::identity()
 
 
 
-inline Matrix2 Matrix2::operator+(const Matrix2& rhs) const
+constexpr Matrix2 Matrix2::operator+(const Matrix2& rhs) const
 {
     return Matrix2(m[0]+rhs[0], m[1]+rhs[1], m[2]+rhs[2], m[3]+rhs[3]);
 }
 
 
 
-inline Matrix2 Matrix2::operator-(const Matrix2& rhs) const
+constexpr Matrix2 Matrix2::operator-(const Matrix2& rhs) const
 {
     return Matrix2(m[0]-rhs[0], m[1]-rhs[1], m[2]-rhs[2], m[3]-rhs[3]);
 }
 
 
 
-inline Matrix2& Matrix2::operator+=(const Matrix2& rhs)
+constexpr Matrix2& Matrix2::operator+=(const Matrix2& rhs)
 {
     m[0] += rhs[0];  m[1] += rhs[1];  m[2] += rhs[2];  m[3] += rhs[3];
     return *this;
@@ -367,7 +466,7 @@ inline Matrix2& Matrix2::operator+=(const Matrix2& rhs)
 
 
 
-inline Matrix2& Matrix2::operator-=(const Matrix2& rhs)
+constexpr Matrix2& Matrix2::operator-=(const Matrix2& rhs)
 {
     m[0] -= rhs[0];  m[1] -= rhs[1];  m[2] -= rhs[2];  m[3] -= rhs[3];
     return *this;
@@ -375,14 +474,14 @@ inline Matrix2& Matrix2::operator-=(const Matrix2& rhs)
 
 
 
-inline Vector2 Matrix2::operator*(const Vector2& rhs) const
+constexpr Vector2 Matrix2::operator*(const Vector2& rhs) const
 {
     return Vector2(m[0]*rhs.x + m[2]*rhs.y,  m[1]*rhs.x + m[3]*rhs.y);
 }
 
 
 
-inline Matrix2 Matrix2::operator*(const Matrix2& rhs) const
+constexpr Matrix2 Matrix2::operator*(const Matrix2& rhs) const
 {
     return Matrix2(m[0]*rhs[0] + m[2]*rhs[1],  m[1]*rhs[0] + m[3]*rhs[1],
                    m[0]*rhs[2] + m[2]*rhs[3],  m[1]*rhs[2] + m[3]*rhs[3]);
@@ -390,7 +489,7 @@ inline Matrix2 Matrix2::operator*(const Matrix2& rhs) const
 
 
 
-inline Matrix2& Matrix2::operator*=(const Matrix2& rhs)
+constexpr Matrix2& Matrix2::operator*=(const Matrix2& rhs)
 {
     *this = *this * rhs;
     return *this;
@@ -398,49 +497,49 @@ inline Matrix2& Matrix2::operator*=(const Matrix2& rhs)
 
 
 
-inline bool Matrix2::operator==(const Matrix2& rhs) const
+constexpr bool Matrix2::operator==(const Matrix2& rhs) const
 {
     return (m[0] == rhs[0]) && (m[1] == rhs[1]) && (m[2] == rhs[2]) && (m[3] == rhs[3]);
 }
 
 
 
-inline bool Matrix2::operator!=(const Matrix2& rhs) const
+constexpr bool Matrix2::operator!=(const Matrix2& rhs) const
 {
     return (m[0] != rhs[0]) || (m[1] != rhs[1]) || (m[2] != rhs[2]) || (m[3] != rhs[3]);
 }
 
 
 
-inline float Matrix2::operator[](int index) const
+constexpr float Matrix2::operator[](int index) const
 {
     return m[index];
 }
 
 
 
-inline float& Matrix2::operator[](int index)
+constexpr float& Matrix2::operator[](int index)
 {
     return m[index];
 }
 
 
 
-inline Matrix2 operator-(const Matrix2& rhs)
+constexpr Matrix2 operator-(const Matrix2& rhs)
 {
     return Matrix2(-rhs[0], -rhs[1], -rhs[2], -rhs[3]);
 }
 
 
 
-inline Matrix2 operator*(float s, const Matrix2& rhs)
+constexpr Matrix2 operator*(float s, const Matrix2& rhs)
 {
     return Matrix2(s*rhs[0], s*rhs[1], s*rhs[2], s*rhs[3]);
 }
 
 
 
-inline Vector2 operator*(const Vector2& v, const Matrix2& rhs)
+constexpr Vector2 operator*(const Vector2& v, const Matrix2& rhs)
 {
     return Vector2(v.x*rhs[0] + v.y*rhs[1],  v.x*rhs[2] + v.y*rhs[3]);
 }
@@ -463,31 +562,30 @@ inline std::ostream& operator<<(std::ostream& os, const Matrix2& m)
 ///////////////////////////////////////////////////////////////////////////
 // inline functions for Matrix3
 ///////////////////////////////////////////////////////////////////////////
-inline Matrix3::Matrix3()
+constexpr Matrix3::Matrix3() : m{1, 0, 0,  0, 1, 0,  0, 0, 1}, tm{}
 {
     // initially identity matrix
-    identity();
 }
 
 
 
-inline Matrix3::Matrix3(const float src[9])
+constexpr Matrix3::Matrix3(const float src[9]) : m{src[0], src[1], src[2],
+                                                   src[3], src[4], src[5],
+                                                   src[6], src[7], src[8]}, tm{}
 {
-    set(src);
 }
 
 
 
-inline Matrix3::Matrix3(float m0, float m1, float m2,
-                        float m3, float m4, float m5,
-                        float m6, float m7, float m8)
+constexpr Matrix3::Matrix3(float m0, float m1, float m2,
+                           float m3, float m4, float m5,
+                           float m6, float m7, float m8) : m{m0, m1, m2,  m3, m4, m5,  m6, m7, m8}, tm{}
 {
-    set(m0, m1, m2,  m3, m4, m5,  m6, m7, m8);
 }
 
 
 
-inline void Matrix3::set(const float src[9])
+constexpr void Matrix3::set(const float src[9])
 {
     m[0] = src[0];  m[1] = src[1];  m[2] = src[2];
     m[3] = src[3];  m[4] = src[4];  m[5] = src[5];
@@ -496,9 +594,9 @@ inline void Matrix3::set(const float src[9])
 
 
 
-inline void Matrix3::set(float m0, float m1, float m2,
-                         float m3, float m4, float m5,
-                         float m6, float m7, float m8)
+constexpr void Matrix3::set(float m0, float m1, float m2,
+                            float m3, float m4, float m5,
+                            float m6, float m7, float m8)
 {
     m[0] = m0;  m[1] = m1;  m[2] = m2;
     m[3] = m3;  m[4] = m4;  m[5] = m5;
@@ -507,35 +605,35 @@ inline void Matrix3::set(float m0, float m1, float m2,
 
 
 
-inline void Matrix3::setRow(int index, const float row[3])
+constexpr void Matrix3::setRow(int index, const float row[3])
 {
     m[index] = row[0];  m[index + 3] = row[1];  m[index + 6] = row[2];
 }
 
 
 
-inline void Matrix3::setRow(int index, const Vector3& v)
+constexpr void Matrix3::setRow(int index, const Vector3& v)
 {
     m[index] = v.x;  m[index + 3] = v.y;  m[index + 6] = v.z;
 }
 
 
 
-inline void Matrix3::setColumn(int index, const float col[3])
+constexpr void Matrix3::setColumn(int index, const float col[3])
 {
     m[index*3] = col[0];  m[index*3 + 1] = col[1];  m[index*3 + 2] = col[2];
 }
 
 
 
-inline void Matrix3::setColumn(int index, const Vector3& v)
+constexpr void Matrix3::setColumn(int index, const Vector3& v)
 {
     m[index*3] = v.x;  m[index*3 + 1] = v.y;  m[index*3 + 2] = v.z;
 }
 
 
 
-inline const float* Matrix3::get() const
+constexpr const float* Matrix3::get() const
 {
     return m;
 }
@@ -552,21 +650,21 @@ inline const float* Matrix3::getTranspose()
 
 
 
-inline Vector3 Matrix3::getRow(int index) const
+constexpr Vector3 Matrix3::getRow(int index) const
 {
     return Vector3(m[index], m[index+3], m[index+6]);
 }
 
 
 
-inline Vector3 Matrix3::getColumn(int index) const
+constexpr Vector3 Matrix3::getColumn(int index) const
 {
     return Vector3(m[index*3], m[index*3+1], m[index*3+2]);
 }
 
 
 
-inline Matrix3& Matrix3::identity()
+constexpr Matrix3& Matrix3::identity()
 {
     m[0] = m[4] = m[8] = 1.0f;
     m[1] = m[2] = m[3] = m[5] = m[6] = m[7] = 0.0f;
@@ -575,7 +673,7 @@ inline Matrix3& Matrix3::identity()
 
 
 
-inline Matrix3 Matrix3::operator+(const Matrix3& rhs) const
+constexpr Matrix3 Matrix3::operator+(const Matrix3& rhs) const
 {
     return Matrix3(m[0]+rhs[0], m[1]+rhs[1], m[2]+rhs[2],
                    m[3]+rhs[3], m[4]+rhs[4], m[5]+rhs[5],
@@ -584,7 +682,7 @@ inline Matrix3 Matrix3::operator+(const Matrix3& rhs) const
 
 
 
-inline Matrix3 Matrix3::operator-(const Matrix3& rhs) const
+constexpr Matrix3 Matrix3::operator-(const Matrix3& rhs) const
 {
     return Matrix3(m[0]-rhs[0], m[1]-rhs[1], m[2]-rhs[2],
                    m[3]-rhs[3], m[4]-rhs[4], m[5]-rhs[5],
@@ -593,7 +691,7 @@ inline Matrix3 Matrix3::operator-(const Matrix3& rhs) const
 
 
 
-inline Matrix3& Matrix3::operator+=(const Matrix3& rhs)
+constexpr Matrix3& Matrix3::operator+=(const Matrix3& rhs)
 {
     m[0] += rhs[0];  m[1] += rhs[1];  m[2] += rhs[2];
     m[3] += rhs[3];  m[4] += rhs[4];  m[5] += rhs[5];
@@ -603,7 +701,7 @@ inline Matrix3& Matrix3::operator+=(const Matrix3& rhs)
 
 
 
-inline Matrix3& Matrix3::operator-=(const Matrix3& rhs)
+constexpr Matrix3& Matrix3::operator-=(const Matrix3& rhs)
 {
     m[0] -= rhs[0];  m[1] -= rhs[1];  m[2] -= rhs[2];
     m[3] -= rhs[3];  m[4] -= rhs[4];  m[5] -= rhs[5];
@@ -613,7 +711,7 @@ inline Matrix3& Matrix3::operator-=(const Matrix3& rhs)
 
 
 
-inline Vector3 Matrix3::operator*(const Vector3& rhs) const
+constexpr Vector3 Matrix3::operator*(const Vector3& rhs) const
 {
     return Vector3(m[0]*rhs.x + m[3]*rhs.y + m[6]*rhs.z,
                    m[1]*rhs.x + m[4]*rhs.y + m[7]*rhs.z,
@@ -622,7 +720,7 @@ inline Vector3 Matrix3::operator*(const Vector3& rhs) const
 
 
 
-inline Matrix3 Matrix3::operator*(const Matrix3& rhs) const
+constexpr Matrix3 Matrix3::operator*(const Matrix3& rhs) const
 {
     return Matrix3(m[0]*rhs[0] + m[3]*rhs[1] + m[6]*rhs[2],  m[1]*rhs[0] + m[4]*rhs[1] + m[7]*rhs[2],  m[2]*rhs[0] + m[5]*rhs[1] + m[8]*rhs[2],
                    m[0]*rhs[3] + m[3]*rhs[4] + m[6]*rhs[5],  m[1]*rhs[3] + m[4]*rhs[4] + m[7]*rhs[5],  m[2]*rhs[3] + m[5]*rhs[4] + m[8]*rhs[5],
@@ -631,7 +729,7 @@ inline Matrix3 Matrix3::operator*(const Matrix3& rhs) const
 
 
 
-inline Matrix3& Matrix3::operator*=(const Matrix3& rhs)
+constexpr Matrix3& Matrix3::operator*=(const Matrix3& rhs)
 {
     *this = *this * rhs;
     return *this;
@@ -639,7 +737,7 @@ inline Matrix3& Matrix3::operator*=(const Matrix3& rhs)
 
 
 
-inline bool Matrix3::operator==(const Matrix3& rhs) const
+constexpr bool Matrix3::operator==(const Matrix3& rhs) const
 {
     return (m[0] == rhs[0]) && (m[1] == rhs[1]) && (m[2] == rhs[2]) &&
            (m[3] == rhs[3]) && (m[4] == rhs[4]) && (m[5] == rhs[5]) &&
@@ -648,7 +746,7 @@ inline bool Matrix3::operator==(const Matrix3& rhs) const
 
 
 
-inline bool Matrix3::operator!=(const Matrix3& rhs) const
+constexpr bool Matrix3::operator!=(const Matrix3& rhs) const
 {
     return (m[0] != rhs[0]) || (m[1] != rhs[1]) || (m[2] != rhs[2]) ||
            (m[3] != rhs[3]) || (m[4] != rhs[4]) || (m[5] != rhs[5]) ||
@@ -657,35 +755,35 @@ inline bool Matrix3::operator!=(const Matrix3& rhs) const
 
 
 
-inline float Matrix3::operator[](int index) const
+constexpr float Matrix3::operator[](int index) const
 {
     return m[index];
 }
 
 
 
-inline float& Matrix3::operator[](int index)
+constexpr float& Matrix3::operator[](int index)
 {
     return m[index];
 }
 
 
 
-inline Matrix3 operator-(const Matrix3& rhs)
+constexpr Matrix3 operator-(const Matrix3& rhs)
 {
     return Matrix3(-rhs[0], -rhs[1], -rhs[2], -rhs[3], -rhs[4], -rhs[5], -rhs[6], -rhs[7], -rhs[8]);
 }
 
 
 
-inline Matrix3 operator*(float s, const Matrix3& rhs)
+constexpr Matrix3 operator*(float s, const Matrix3& rhs)
 {
     return Matrix3(s*rhs[0], s*rhs[1], s*rhs[2], s*rhs[3], s*rhs[4], s*rhs[5], s*rhs[6], s*rhs[7], s*rhs[8]);
 }
 
 
 
-inline Vector3 operator*(const Vector3& v, const Matrix3& m)
+constexpr Vector3 operator*(const Vector3& v, const Matrix3& m)
 {
     return Vector3(v.x*m[0] + v.y*m[1] + v.z*m[2],  v.x*m[3] + v.y*m[4] + v.z*m[5],  v.x*m[6] + v.y*m[7] + v.z*m[8]);
 }
@@ -709,32 +807,33 @@ inline std::ostream& operator<<(std::ostream& os, const Matrix3& m)
 ///////////////////////////////////////////////////////////////////////////
 // inline functions for Matrix4
 ///////////////////////////////////////////////////////////////////////////
-inline Matrix4::Matrix4()
+constexpr Matrix4::Matrix4() : m{1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1}, tm{}
 {
     // initially identity matrix
-    identity();
 }
 
 
 
-inline Matrix4::Matrix4(const float src[16])
+constexpr Matrix4::Matrix4(const float src[16]) : m{src[0],  src[1],  src[2],  src[3],
+                                                    src[4],  src[5],  src[6],  src[7],
+                                                    src[8],  src[9],  src[10], src[11],
+                                                    src[12], src[13], src[14], src[15]}, tm{}
 {
-    set(src);
 }
 
 
 
-inline Matrix4::Matrix4(float m00, float m01, float m02, float m03,
-                        float m04, float m05, float m06, float m07,
-                        float m08, float m09, float m10, float m11,
-                        float m12, float m13, float m14, float m15)
+constexpr Matrix4::Matrix4(float m00, float m01, float m02, float m03,
+                           float m04, float m05, float m06, float m07,
+                           float m08, float m09, float m10, float m11,
+                           float m12, float m13, float m14, float m15) : m{m00, m01, m02, m03,  m04, m05, m06, m07,
+                                                                           m08, m09, m10, m11,  m12, m13, m14, m15}, tm{}
 {
-    set(m00, m01, m02, m03,  m04, m05, m06, m07,  m08, m09, m10, m11,  m12, m13, m14, m15);
 }
 
 
 
-inline void Matrix4::set(const float src[16])
+constexpr void Matrix4::set(const float src[16])
 {
     m[0] = src[0];  m[1] = src[1];  m[2] = src[2];  m[3] = src[3];
     m[4] = src[4];  m[5] = src[5];  m[6] = src[6];  m[7] = src[7];
@@ -744,10 +843,10 @@ inline void Matrix4::set(const float src[16])
 
 
 
-inline void Matrix4::set(float m00, float m01, float m02, float m03,
-                         float m04, float m05, float m06, float m07,
-                         float m08, float m09, float m10, float m11,
-                         float m12, float m13, float m14, float m15)
+constexpr void Matrix4::set(float m00, float m01, float m02, float m03,
+                            float m04, float m05, float m06, float m07,
+                            float m08, float m09, float m10, float m11,
+                            float m12, float m13, float m14, float m15)
 {
     m[0] = m00;  m[1] = m01;  m[2] = m02;  m[3] = m03;
     m[4] = m04;  m[5] = m05;  m[6] = m06;  m[7] = m07;
@@ -757,49 +856,49 @@ inline void Matrix4::set(float m00, float m01, float m02, float m03,
 
 
 
-inline void Matrix4::setRow(int index, const float row[4])
+constexpr void Matrix4::setRow(int index, const float row[4])
 {
     m[index] = row[0];  m[index + 4] = row[1];  m[index + 8] = row[2];  m[index + 12] = row[3];
 }
 
 
 
-inline void Matrix4::setRow(int index, const Vector4& v)
+constexpr void Matrix4::setRow(int index, const Vector4& v)
 {
     m[index] = v.x;  m[index + 4] = v.y;  m[index + 8] = v.z;  m[index + 12] = v.w;
 }
 
 
 
-inline void Matrix4::setRow(int index, const Vector3& v)
+constexpr void Matrix4::setRow(int index, const Vector3& v)
 {
     m[index] = v.x;  m[index + 4] = v.y;  m[index + 8] = v.z;
 }
 
 
 
-inline void Matrix4::setColumn(int index, const float col[4])
+constexpr void Matrix4::setColumn(int index, const float col[4])
 {
     m[index*4] = col[0];  m[index*4 + 1] = col[1];  m[index*4 + 2] = col[2];  m[index*4 + 3] = col[3];
 }
 
 
 
-inline void Matrix4::setColumn(int index, const Vector4& v)
+constexpr void Matrix4::setColumn(int index, const Vector4& v)
 {
     m[index*4] = v.x;  m[index*4 + 1] = v.y;  m[index*4 + 2] = v.z;  m[index*4 + 3] = v.w;
 }
 
 
 
-inline void Matrix4::setColumn(int index, const Vector3& v)
+constexpr void Matrix4::setColumn(int index, const Vector3& v)
 {
     m[index*4] = v.x;  m[index*4 + 1] = v.y;  m[index*4 + 2] = v.z;
 }
 
 
 
-inline const float* Matrix4::get() const
+constexpr const float* Matrix4::get() const
 {
     return m;
 }
@@ -817,42 +916,42 @@ inline const float* Matrix4::getTranspose()
 
 
 
-inline Vector4 Matrix4::getRow(int index) const
+constexpr Vector4 Matrix4::getRow(int index) const
 {
     return Vector4(m[index], m[index+4], m[index+8], m[index+12]);
 }
 
 
 
-inline Vector4 Matrix4::getColumn(int index) const
+constexpr Vector4 Matrix4::getColumn(int index) const
 {
     return Vector4(m[index*4], m[index*4+1], m[index*4+2], m[index*4+3]);
 }
 
 
 
-inline Vector3 Matrix4::getLeftAxis() const
+constexpr Vector3 Matrix4::getLeftAxis() const
 {
     return Vector3(m[0], m[1], m[2]);
 }
 
 
 
-inline Vector3 Matrix4::getUpAxis() const
+constexpr Vector3 Matrix4::getUpAxis() const
 {
     return Vector3(m[4], m[5], m[6]);
 }
 
 
 
-inline Vector3 Matrix4::getForwardAxis() const
+constexpr Vector3 Matrix4::getForwardAxis() const
 {
     return Vector3(m[8], m[9], m[10]);
 }
 
 
 
-inline Matrix4& Matrix4::identity()
+constexpr Matrix4& Matrix4::identity()
 {
     m[0] = m[5] = m[10] = m[15] = 1.0f;
     m[1] = m[2] = m[3] = m[4] = m[6] = m[7] = m[8] = m[9] = m[11] = m[12] = m[13] = m[14] = 0.0f;
@@ -861,7 +960,180 @@ inline Matrix4& Matrix4::identity()
 
 
 
-inline Matrix4 Matrix4::operator+(const Matrix4& rhs) const
+///////////////////////////////////////////////////////////////////////////////
+// translate this matrix by (x, y, z)
+///////////////////////////////////////////////////////////////////////////////
+constexpr Matrix4& Matrix4::translate(const Vector3& v)
+{
+    return translate(v.x, v.y, v.z);
+}
+
+constexpr Matrix4& Matrix4::translate(float x, float y, float z)
+{
+    m[0] += m[3] * x;   m[4] += m[7] * x;   m[8] += m[11]* x;   m[12]+= m[15]* x;
+    m[1] += m[3] * y;   m[5] += m[7] * y;   m[9] += m[11]* y;   m[13]+= m[15]* y;
+    m[2] += m[3] * z;   m[6] += m[7] * z;   m[10]+= m[11]* z;   m[14]+= m[15]* z;
+
+    return *this;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// uniform scale
+///////////////////////////////////////////////////////////////////////////////
+constexpr Matrix4& Matrix4::scale(float s)
+{
+    return scale(s, s, s);
+}
+
+constexpr Matrix4& Matrix4::scale(float x, float y, float z)
+{
+    m[0] *= x;   m[4] *= x;   m[8] *= x;   m[12] *= x;
+    m[1] *= y;   m[5] *= y;   m[9] *= y;   m[13] *= y;
+    m[2] *= z;   m[6] *= z;   m[10]*= z;   m[14] *= z;
+    return *this;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// build a rotation matrix with cosine and sine of the angle and rotation axis,
+// then multiply it with this object
+///////////////////////////////////////////////////////////////////////////////
+constexpr Matrix4& Matrix4::rotateCosSin(float c, float s, float x, float y, float z)
+{
+    float c1 = 1.0f - c;                // 1 - c
+
+    // build rotation matrix
+    const float r[9] = { x * x * c1 + c,        // 1st column
+                         x * y * c1 + z * s,
+                         x * z * c1 - y * s,
+                         x * y * c1 - z * s,    // 2nd column
+                         y * y * c1 + c,
+                         y * z * c1 + x * s,
+                         x * z * c1 + y * s,    // 3rd column
+                         y * z * c1 - x * s,
+                         z * z * c1 + c };
+    return multiplyRotation(r);
+}
+
+constexpr Matrix4& Matrix4::multiplyRotation(const float r[9])
+{
+    float m0 = m[0],  m4 = m[4],  m8 = m[8],  m12= m[12],
+          m1 = m[1],  m5 = m[5],  m9 = m[9],  m13= m[13],
+          m2 = m[2],  m6 = m[6],  m10= m[10], m14= m[14];
+
+    m[0] = r[0] * m0 + r[3] * m1 + r[6] * m2;
+    m[1] = r[1] * m0 + r[4] * m1 + r[7] * m2;
+    m[2] = r[2] * m0 + r[5] * m1 + r[8] * m2;
+    m[4] = r[0] * m4 + r[3] * m5 + r[6] * m6;
+    m[5] = r[1] * m4 + r[4] * m5 + r[7] * m6;
+    m[6] = r[2] * m4 + r[5] * m5 + r[8] * m6;
+    m[8] = r[0] * m8 + r[3] * m9 + r[6] * m10;
+    m[9] = r[1] * m8 + r[4] * m9 + r[7] * m10;
+    m[10]= r[2] * m8 + r[5] * m9 + r[8] * m10;
+    m[12]= r[0] * m12+ r[3] * m13+ r[6] * m14;
+    m[13]= r[1] * m12+ r[4] * m13+ r[7] * m14;
+    m[14]= r[2] * m12+ r[5] * m13+ r[8] * m14;
+
+    return *this;
+}
+
+constexpr Matrix4& Matrix4::rotateXCosSin(float c, float s)
+{
+    float m1 = m[1],  m2 = m[2],
+          m5 = m[5],  m6 = m[6],
+          m9 = m[9],  m10= m[10],
+          m13= m[13], m14= m[14];
+
+    m[1] = m1 * c + m2 *-s;
+    m[2] = m1 * s + m2 * c;
+    m[5] = m5 * c + m6 *-s;
+    m[6] = m5 * s + m6 * c;
+    m[9] = m9 * c + m10*-s;
+    m[10]= m9 * s + m10* c;
+    m[13]= m13* c + m14*-s;
+    m[14]= m13* s + m14* c;
+
+    return *this;
+}
+
+constexpr Matrix4& Matrix4::rotateYCosSin(float c, float s)
+{
+    float m0 = m[0],  m2 = m[2],
+          m4 = m[4],  m6 = m[6],
+          m8 = m[8],  m10= m[10],
+          m12= m[12], m14= m[14];
+
+    m[0] = m0 * c + m2 * s;
+    m[2] = m0 *-s + m2 * c;
+    m[4] = m4 * c + m6 * s;
+    m[6] = m4 *-s + m6 * c;
+    m[8] = m8 * c + m10* s;
+    m[10]= m8 *-s + m10* c;
+    m[12]= m12* c + m14* s;
+    m[14]= m12*-s + m14* c;
+
+    return *this;
+}
+
+constexpr Matrix4& Matrix4::rotateZCosSin(float c, float s)
+{
+    float m0 = m[0],  m1 = m[1],
+          m4 = m[4],  m5 = m[5],
+          m8 = m[8],  m9 = m[9],
+          m12= m[12], m13= m[13];
+
+    m[0] = m0 * c + m1 *-s;
+    m[1] = m0 * s + m1 * c;
+    m[4] = m4 * c + m5 *-s;
+    m[5] = m4 * s + m5 * c;
+    m[8] = m8 * c + m9 *-s;
+    m[9] = m8 * s + m9 * c;
+    m[12]= m12* c + m13*-s;
+    m[13]= m12* s + m13* c;
+
+    return *this;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// compile-time rotations, angle in degree
+///////////////////////////////////////////////////////////////////////////////
+constexpr Matrix4& Matrix4::rotateConst(float angle, const Vector3& axis)
+{
+    return rotateConst(angle, axis.x, axis.y, axis.z);
+}
+
+constexpr Matrix4& Matrix4::rotateConst(float angle, float x, float y, float z)
+{
+    float radian = angle * (3.14159265f / 180.0f);
+    return rotateCosSin(constexprCos(radian), constexprSin(radian), x, y, z);
+}
+
+constexpr Matrix4& Matrix4::rotateXConst(float angle)
+{
+    float radian = angle * (3.14159265f / 180.0f);
+    return rotateXCosSin(constexprCos(radian), constexprSin(radian));
+}
+
+constexpr Matrix4& Matrix4::rotateYConst(float angle)
+{
+    float radian = angle * (3.14159265f / 180.0f);
+    return rotateYCosSin(constexprCos(radian), constexprSin(radian));
+}
+
+constexpr Matrix4& Matrix4::rotateZConst(float angle)
+{
+    float radian = angle * (3.14159265f / 180.0f);
+    return rotateZCosSin(constexprCos(radian), constexprSin(radian));
+}
+
+
+
+constexpr Matrix4 Matrix4::operator+(const Matrix4& rhs) const
 {
     return Matrix4(m[0]+rhs[0],   m[1]+rhs[1],   m[2]+rhs[2],   m[3]+rhs[3],
                    m[4]+rhs[4],   m[5]+rhs[5],   m[6]+rhs[6],   m[7]+rhs[7],
@@ -871,7 +1143,7 @@ inline Matrix4 Matrix4::operator+(const Matrix4& rhs) const
 
 
 
-inline Matrix4 Matrix4::operator-(const Matrix4& rhs) const
+constexpr Matrix4 Matrix4::operator-(const Matrix4& rhs) const
 {
     return Matrix4(m[0]-rhs[0],   m[1]-rhs[1],   m[2]-rhs[2],   m[3]-rhs[3],
                    m[4]-rhs[4],   m[5]-rhs[5],   m[6]-rhs[6],   m[7]-rhs[7],
@@ -881,7 +1153,7 @@ inline Matrix4 Matrix4::operator-(const Matrix4& rhs) const
 
 
 
-inline Matrix4& Matrix4::operator+=(const Matrix4& rhs)
+constexpr Matrix4& Matrix4::operator+=(const Matrix4& rhs)
 {
     m[0] += rhs[0];   m[1] += rhs[1];   m[2] += rhs[2];   m[3] += rhs[3];
     m[4] += rhs[4];   m[5] += rhs[5];   m[6] += rhs[6];   m[7] += rhs[7];
@@ -892,7 +1164,7 @@ inline Matrix4& Matrix4::operator+=(const Matrix4& rhs)
 
 
 
-inline Matrix4& Matrix4::operator-=(const Matrix4& rhs)
+constexpr Matrix4& Matrix4::operator-=(const Matrix4& rhs)
 {
     m[0] -= rhs[0];   m[1] -= rhs[1];   m[2] -= rhs[2];   m[3] -= rhs[3];
     m[4] -= rhs[4];   m[5] -= rhs[5];   m[6] -= rhs[6];   m[7] -= rhs[7];
@@ -903,7 +1175,7 @@ inline Matrix4& Matrix4::operator-=(const Matrix4& rhs)
 
 
 
-inline Vector4 Matrix4::operator*(const Vector4& rhs) const
+constexpr Vector4 Matrix4::operator*(const Vector4& rhs) const
 {
     return Vector4(m[0]*rhs.x + m[4]*rhs.y + m[8]*rhs.z  + m[12]*rhs.w,
                    m[1]*rhs.x + m[5]*rhs.y + m[9]*rhs.z  + m[13]*rhs.w,
@@ -913,7 +1185,7 @@ inline Vector4 Matrix4::operator*(const Vector4& rhs) const
 
 
 
-inline Vector3 Matrix4::operator*(const Vector3& rhs) const
+constexpr Vector3 Matrix4::operator*(const Vector3& rhs) const
 {
     return Vector3(m[0]*rhs.x + m[4]*rhs.y + m[8]*rhs.z + m[12],
                    m[1]*rhs.x + m[5]*rhs.y + m[9]*rhs.z + m[13],
@@ -922,7 +1194,7 @@ inline Vector3 Matrix4::operator*(const Vector3& rhs) const
 
 
 
-inline Matrix4 Matrix4::operator*(const Matrix4& n) const
+constexpr Matrix4 Matrix4::operator*(const Matrix4& n) const
 {
     return Matrix4(m[0]*n[0]  + m[4]*n[1]  + m[8]*n[2]  + m[12]*n[3],   m[1]*n[0]  + m[5]*n[1]  + m[9]*n[2]  + m[13]*n[3],   m[2]*n[0]  + m[6]*n[1]  + m[10]*n[2]  + m[14]*n[3],   m[3]*n[0]  + m[7]*n[1]  + m[11]*n[2]  + m[15]*n[3],
                    m[0]*n[4]  + m[4]*n[5]  + m[8]*n[6]  + m[12]*n[7],   m[1]*n[4]  + m[5]*n[5]  + m[9]*n[6]  + m[13]*n[7],   m[2]*n[4]  + m[6]*n[5]  + m[10]*n[6]  + m[14]*n[7],   m[3]*n[4]  + m[7]*n[5]  + m[11]*n[6]  + m[15]*n[7],
@@ -932,7 +1204,7 @@ inline Matrix4 Matrix4::operator*(const Matrix4& n) const
 
 
 
-inline Matrix4& Matrix4::operator*=(const Matrix4& rhs)
+constexpr Matrix4& Matrix4::operator*=(const Matrix4& rhs)
 {
     *this = *this * rhs;
     return *this;
@@ -940,7 +1212,7 @@ inline Matrix4& Matrix4::operator*=(const Matrix4& rhs)
 
 
 
-inline bool Matrix4::operator==(const Matrix4& n) const
+constexpr bool Matrix4::operator==(const Matrix4& n) const
 {
     return (m[0] == n[0])  && (m[1] == n[1])  && (m[2] == n[2])  && (m[3] == n[3])  &&
            (m[4] == n[4])  && (m[5] == n[5])  && (m[6] == n[6])  && (m[7] == n[7])  &&
@@ -950,7 +1222,7 @@ inline bool Matrix4::operator==(const Matrix4& n) const
 
 
 
-inline bool Matrix4::operator!=(const Matrix4& n) const
+constexpr bool Matrix4::operator!=(const Matrix4& n) const
 {
     return (m[0] != n[0])  || (m[1] != n[1])  || (m[2] != n[2])  || (m[3] != n[3])  ||
            (m[4] != n[4])  || (m[5] != n[5])  || (m[6] != n[6])  || (m[7] != n[7])  ||
@@ -960,42 +1232,42 @@ inline bool Matrix4::operator!=(const Matrix4& n) const
 
 
 
-inline float Matrix4::operator[](int index) const
+constexpr float Matrix4::operator[](int index) const
 {
     return m[index];
 }
 
 
 
-inline float& Matrix4::operator[](int index)
+constexpr float& Matrix4::operator[](int index)
 {
     return m[index];
 }
 
 
 
-inline Matrix4 operator-(const Matrix4& rhs)
+constexpr Matrix4 operator-(const Matrix4& rhs)
 {
     return Matrix4(-rhs[0], -rhs[1], -rhs[2], -rhs[3], -rhs[4], -rhs[5], -rhs[6], -rhs[7], -rhs[8], -rhs[9], -rhs[10], -rhs[11], -rhs[12], -rhs[13], -rhs[14], -rhs[15]);
 }
 
 
 
-inline Matrix4 operator*(float s, const Matrix4& rhs)
+constexpr Matrix4 operator*(float s, const Matrix4& rhs)
 {
     return Matrix4(s*rhs[0], s*rhs[1], s*rhs[2], s*rhs[3], s*rhs[4], s*rhs[5], s*rhs[6], s*rhs[7], s*rhs[8], s*rhs[9], s*rhs[10], s*rhs[11], s*rhs[12], s*rhs[13], s*rhs[14], s*rhs[15]);
 }
 
 
 
-inline Vector4 operator*(const Vector4& v, const Matrix4& m)
+constexpr Vector4 operator*(const Vector4& v, const Matrix4& m)
 {
     return Vector4(v.x*m[0] + v.y*m[1] + v.z*m[2] + v.w*m[3],  v.x*m[4] + v.y*m[5] + v.z*m[6] + v.w*m[7],  v.x*m[8] + v.y*m[9] + v.z*m[10] + v.w*m[11], v.x*m[12] + v.y*m[13] + v.z*m[14] + v.w*m[15]);
 }
 
 
 
-inline Vector3 operator*(const Vector3& v, const Matrix4& m)
+constexpr Vector3 operator*(const Vector3& v, const Matrix4& m)
 {
     return Vector3(v.x*m[0] + v.y*m[1] + v.z*m[2],  v.x*m[4] + v.y*m[5] + v.z*m[6],  v.x*m[8] + v.y*m[9] + v.z*m[10]);
 }
@@ -0,0 +1,697 @@
+///////////////////////////////////////////////////////////////////////////////
+// MipChain.cpp
+// ============
+// full mipmap chain of an 8-bit gray, RGB or RGBA image, built on CPU
+// The general filter runs in 2 passes: each source row is converted to floats
+// (0~1, or linear through a table) and filtered horizontally, then the float
+// rows are filtered vertically with SIMD and converted back to bytes. The
+// filter taps of each output row and column are computed once per level, with
+// the indices clamped to the edges.
+// The output rows are done in bands, each filtering only the source rows its
+// taps cover, so the float rows of a band are all that is kept. The bands of
+// the thread pool overlap by the filter width, and those rows are filtered
+// twice.
+//
+// Dependencies: PixelConvert, ThreadPool
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "MipChain.h"
+#include "PixelConvert.h"
+#include "ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_SSE2    1
+#include <emmintrin.h>
+#endif
+
+namespace Image
+{
+
+// Kaiser window, half width in pixels of the smaller level and alpha (shape)
+const float KAISER_WIDTH = 3.0f;
+const float KAISER_ALPHA = 4.0f;
+
+// half widths of Mitchell and Lanczos, and B and C of Mitchell-Netravali
+const float MITCHELL_WIDTH = 2.0f;
+const float MITCHELL_B = 1.0f / 3;
+const float MITCHELL_C = 1.0f / 3;
+const float LANCZOS_WIDTH = 3.0f;
+
+// linear to sRGB table, fine enough to round the dark end correctly
+const int SRGB_TABLE_SIZE = 1 << 14;
+
+// minimum rows per band for the thread pool
+const int MIN_BAND_ROWS = 16;
+
+// output rows filtered at once by the general filter
+const int FILTER_BAND_ROWS = 64;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// filter taps of one axis: count source indices and weights per output pixel
+///////////////////////////////////////////////////////////////////////////////
+struct Taps
+{
+    int count;
+    std::vector<int> indices;
+    std::vector<float> weights;
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// sRGB to linear (0~1) and linear to sRGB tables
+// built once at first use
+///////////////////////////////////////////////////////////////////////////////
+struct ColorTables
+{
+    float toLinear[256];
+    unsigned char toSRGB[SRGB_TABLE_SIZE];
+
+    ColorTables()
+    {
+        for(int i = 0; i < 256; ++i)
+        {
+            float s = i / 255.0f;
+            toLinear[i] = (s <= 0.04045f) ? s / 12.92f : powf((s + 0.055f) / 1.055f, 2.4f);
+        }
+        for(int i = 0; i < SRGB_TABLE_SIZE; ++i)
+        {
+            float l = (float)i / (SRGB_TABLE_SIZE - 1);
+            float s = (l <= 0.0031308f) ? l * 12.92f : 1.055f * powf(l, 1 / 2.4f) - 0.055f;
+            toSRGB[i] = (unsigned char)(s * 255 + 0.5f);
+        }
+    }
+};
+
+static const ColorTables& getColorTables()
+{
+    static const ColorTables tables;
+    return tables;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Kaiser windowed sinc, x in pixels of the smaller level
+///////////////////////////////////////////////////////////////////////////////
+static float besselI0(float x)
+{
+    // power series, converges quickly for the small alpha
+    float sum = 1.0f;
+    float term = 1.0f;
+    float y = x * x / 4.0f;
+    for(int k = 1; k < 32 && term > sum * 1e-8f; ++k)
+    {
+        term *= y / (float)(k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+static float kaiser(float x)
+{
+    const float PI = 3.14159265f;
+    float t = x / KAISER_WIDTH;
+    if(t <= -1.0f || t >= 1.0f)
+        return 0;
+
+    float sinc = (x == 0) ? 1.0f : sinf(PI * x) / (PI * x);
+    return sinc * besselI0(KAISER_ALPHA * sqrtf(1 - t * t)) / besselI0(KAISER_ALPHA);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Mitchell-Netravali cubic and Lanczos windowed sinc
+///////////////////////////////////////////////////////////////////////////////
+static float mitchell(float x)
+{
+    const float B = MITCHELL_B;
+    const float C = MITCHELL_C;
+    x = fabsf(x);
+    if(x < 1.0f)
+        return ((12 - 9*B - 6*C) * x*x*x + (-18 + 12*B + 6*C) * x*x + (6 - 2*B)) / 6;
+    if(x < 2.0f)
+        return ((-B - 6*C) * x*x*x + (6*B + 30*C) * x*x + (-12*B - 48*C) * x + (8*B + 24*C)) / 6;
+    return 0;
+}
+
+static float lanczos(float x)
+{
+    const float PI = 3.14159265f;
+    if(x <= -LANCZOS_WIDTH || x >= LANCZOS_WIDTH)
+        return 0;
+    if(x == 0)
+        return 1.0f;
+    float px = PI * x;
+    return LANCZOS_WIDTH * sinf(px) * sinf(px / LANCZOS_WIDTH) / (px * px);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// compute the taps from srcSize to dstSize pixels
+// For box to the next level, an even size takes 2 pixels, and an odd size
+// takes 3 pixels with the weights of the area each covers, e.g. 1/3, 1/3, 1/3
+// for 3 to 1 and 3/7, 3/7, 1/7 ... 1/7, 3/7, 3/7 from left to right for 7 to 3.
+// Other sizes take the area of the pixels covered by the output pixel.
+///////////////////////////////////////////////////////////////////////////////
+static void buildTaps(int srcSize, int dstSize, MipChain::Filter filter, Taps& taps)
+{
+    if(srcSize == dstSize)
+    {
+        taps.count = 1;
+        taps.indices.resize(dstSize);
+        taps.weights.assign(dstSize, 1.0f);
+        for(int i = 0; i < dstSize; ++i)
+            taps.indices[i] = i;
+        return;
+    }
+
+    if(filter == MipChain::FILTER_BOX && dstSize == srcSize / 2)
+    {
+        taps.count = (srcSize % 2 == 0) ? 2 : 3;
+        taps.indices.resize(dstSize * taps.count);
+        taps.weights.resize(dstSize * taps.count);
+        for(int i = 0; i < dstSize; ++i)
+        {
+            int* index = &taps.indices[i * taps.count];
+            float* weight = &taps.weights[i * taps.count];
+            for(int t = 0; t < taps.count; ++t)
+                index[t] = i * 2 + t;
+            if(taps.count == 2)
+            {
+                weight[0] = weight[1] = 0.5f;
+            }
+            else
+            {
+                weight[0] = (float)(dstSize - i) / srcSize;
+                weight[1] = (float)dstSize / srcSize;
+                weight[2] = (float)(i + 1) / srcSize;
+            }
+        }
+        return;
+    }
+
+    // the filter is stretched by the scale to cover the same area of the
+    // source when downscaling, and samples it as is when upscaling
+    float ratio = (float)srcSize / dstSize;
+    float scale = (ratio > 1.0f) ? ratio : 1.0f;
+    float width;
+    float (*kernel)(float) = 0;
+    if(filter == MipChain::FILTER_BOX)
+        width = 0.5f;
+    else if(filter == MipChain::FILTER_MITCHELL)
+        width = MITCHELL_WIDTH, kernel = mitchell;
+    else if(filter == MipChain::FILTER_LANCZOS3)
+        width = LANCZOS_WIDTH, kernel = lanczos;
+    else
+        width = KAISER_WIDTH, kernel = kaiser;
+
+    float radius = width * scale;
+    taps.count = (int)ceilf(radius * 2) + 1;
+    taps.indices.resize(dstSize * taps.count);
+    taps.weights.resize(dstSize * taps.count);
+    for(int i = 0; i < dstSize; ++i)
+    {
+        int* index = &taps.indices[i * taps.count];
+        float* weight = &taps.weights[i * taps.count];
+        float center = (i + 0.5f) * ratio;
+        int first = (int)floorf(center - radius);
+        float sum = 0;
+        for(int t = 0; t < taps.count; ++t)
+        {
+            int j = first + t;
+            if(kernel)
+            {
+                weight[t] = kernel((j + 0.5f - center) / scale);
+            }
+            else
+            {
+                // overlap of source pixel j with the output pixel
+                float left = (j > center - radius) ? (float)j : center - radius;
+                float right = (j + 1 < center + radius) ? (float)(j + 1) : center + radius;
+                weight[t] = (right > left) ? right - left : 0;
+            }
+            index[t] = (j < 0) ? 0 : (j >= srcSize ? srcSize - 1 : j);
+            sum += weight[t];
+        }
+        for(int t = 0; t < taps.count; ++t)
+            weight[t] /= sum;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// 2x2 box of 2 source rows to a row of dstWidth pixels, rounded half up
+///////////////////////////////////////////////////////////////////////////////
+static void boxRow(const unsigned char* row0, const unsigned char* row1, unsigned char* dst,
+                   int dstWidth, int channelCount)
+{
+    int x = 0;
+#if defined(MIP_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    if(channelCount == 4)
+    {
+        // 8 source pixels to 4, the vertical sums hold 2 pixels per register
+        for(; x + 4 <= dstWidth; x += 4)
+        {
+            __m128i a0 = _mm_loadu_si128((const __m128i*)(row0 + x*8));
+            __m128i a1 = _mm_loadu_si128((const __m128i*)(row0 + x*8 + 16));
+            __m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + x*8));
+            __m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + x*8 + 16));
+            __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+            __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+            __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+            __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+            s0 = _mm_add_epi16(s0, _mm_srli_si128(s0, 8));
+            s1 = _mm_add_epi16(s1, _mm_srli_si128(s1, 8));
+            s2 = _mm_add_epi16(s2, _mm_srli_si128(s2, 8));
+            s3 = _mm_add_epi16(s3, _mm_srli_si128(s3, 8));
+            __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s0, s1), two), 2);
+            __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s2, s3), two), 2);
+            _mm_storeu_si128((__m128i*)(dst + x*4), _mm_packus_epi16(lo, hi));
+        }
+    }
+    else if(channelCount == 1)
+    {
+        // 16 source pixels to 8, pairs of 16-bit sums are added by madd
+        const __m128i ones = _mm_set1_epi16(1);
+        for(; x + 8 <= dstWidth; x += 8)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)(row0 + x*2));
+            __m128i b = _mm_loadu_si128((const __m128i*)(row1 + x*2));
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            __m128i s = _mm_packs_epi32(_mm_madd_epi16(lo, ones), _mm_madd_epi16(hi, ones));
+            s = _mm_srli_epi16(_mm_add_epi16(s, two), 2);
+            _mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(s, s));
+        }
+    }
+    else
+    {
+        // 1 pixel per step from 8 bytes (2 pixels and 2 bytes of the next),
+        // it writes 4 bytes and the 4th is written again by the next step
+        for(; x + 2 <= dstWidth; ++x)
+        {
+            __m128i a = _mm_loadl_epi64((const __m128i*)(row0 + x*6));
+            __m128i b = _mm_loadl_epi64((const __m128i*)(row1 + x*6));
+            __m128i s = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            s = _mm_add_epi16(s, _mm_srli_si128(s, 6));
+            s = _mm_srli_epi16(_mm_add_epi16(s, two), 2);
+            int pixel = _mm_cvtsi128_si32(_mm_packus_epi16(s, s));
+            memcpy(dst + x*3, &pixel, 4);
+        }
+    }
+#endif
+    const int c = channelCount;
+    for(; x < dstWidth; ++x)
+    {
+        for(int i = 0; i < c; ++i)
+        {
+            int sum = row0[x*2*c + i] + row0[(x*2+1)*c + i] + row1[x*2*c + i] + row1[(x*2+1)*c + i];
+            dst[x*c + i] = (unsigned char)((sum + 2) >> 2);
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// 2x2 box in linear space, the alpha of 4 channels is averaged as is
+///////////////////////////////////////////////////////////////////////////////
+static void boxRowLinear(const unsigned char* row0, const unsigned char* row1, unsigned char* dst,
+                         int dstWidth, int channelCount)
+{
+    const ColorTables& tables = getColorTables();
+    const float scale = (SRGB_TABLE_SIZE - 1) * 0.25f;
+    const int c = channelCount;
+    const int colorCount = (c == 4) ? 3 : c;
+    for(int x = 0; x < dstWidth; ++x)
+    {
+        const unsigned char* p0 = row0 + x*2*c;
+        const unsigned char* p1 = row1 + x*2*c;
+        for(int i = 0; i < colorCount; ++i)
+        {
+            float sum = tables.toLinear[p0[i]] + tables.toLinear[p0[i + c]] +
+                        tables.toLinear[p1[i]] + tables.toLinear[p1[i + c]];
+            dst[x*c + i] = tables.toSRGB[(int)(sum * scale + 0.5f)];
+        }
+        if(c == 4)
+            dst[x*4 + 3] = (unsigned char)((p0[3] + p0[7] + p1[3] + p1[7] + 2) >> 2);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// sRGB bytes to linear floats, the alpha (every 4th if hasAlpha) is 0~1
+///////////////////////////////////////////////////////////////////////////////
+static void decodeSRGB(const unsigned char* src, float* dst, std::size_t count, bool hasAlpha)
+{
+    const float* toLinear = getColorTables().toLinear;
+    for(std::size_t i = 0; i < count; ++i)
+        dst[i] = toLinear[src[i]];
+    if(hasAlpha)
+    {
+        for(std::size_t i = 3; i < count; i += 4)
+            dst[i] = src[i] * (1 / 255.0f);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// horizontal pass: filter a float row to the smaller width
+// The channel count is a template parameter, so the channel loops unroll.
+///////////////////////////////////////////////////////////////////////////////
+template<int C>
+static void filterRow(const float* src, float* dst, int dstWidth, const Taps& taps)
+{
+    for(int x = 0; x < dstWidth; ++x)
+    {
+        const int* index = &taps.indices[x * taps.count];
+        const float* weight = &taps.weights[x * taps.count];
+        float sum[C] = {};
+        for(int t = 0; t < taps.count; ++t)
+        {
+            const float* pixel = src + index[t] * C;
+            for(int i = 0; i < C; ++i)
+                sum[i] += weight[t] * pixel[i];
+        }
+        for(int i = 0; i < C; ++i)
+            dst[x*C + i] = sum[i];
+    }
+}
+
+#if defined(MIP_SSE2)
+// 4 channels fit in a register
+template<>
+void filterRow<4>(const float* src, float* dst, int dstWidth, const Taps& taps)
+{
+    for(int x = 0; x < dstWidth; ++x)
+    {
+        const int* index = &taps.indices[x * taps.count];
+        const float* weight = &taps.weights[x * taps.count];
+        __m128 sum = _mm_setzero_ps();
+        for(int t = 0; t < taps.count; ++t)
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[t]), _mm_loadu_ps(src + index[t] * 4)));
+        _mm_storeu_ps(dst + x*4, sum);
+    }
+}
+
+// 3 channels are done as 4, the 4th is the next pixel and is discarded, so
+// src and dst must have 1 float after the row
+template<>
+void filterRow<3>(const float* src, float* dst, int dstWidth, const Taps& taps)
+{
+    for(int x = 0; x < dstWidth; ++x)
+    {
+        const int* index = &taps.indices[x * taps.count];
+        const float* weight = &taps.weights[x * taps.count];
+        __m128 sum = _mm_setzero_ps();
+        for(int t = 0; t < taps.count; ++t)
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[t]), _mm_loadu_ps(src + index[t] * 3)));
+        _mm_storeu_ps(dst + x*3, sum);
+    }
+}
+#endif
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// vertical pass: weighted sum of float rows, count values per row
+// rows starts at the source row firstRow.
+///////////////////////////////////////////////////////////////////////////////
+static void sumRows(const float* rows, int firstRow, std::size_t count, const int* index, const float* weight,
+                    int tapCount, float* dst)
+{
+    memset(dst, 0, count * sizeof(float));
+    for(int t = 0; t < tapCount; ++t)
+    {
+        const float* row = rows + (index[t] - firstRow) * count;
+        std::size_t i = 0;
+#if defined(MIP_SSE2)
+        const __m128 w = _mm_set1_ps(weight[t]);
+        for(; i + 8 <= count; i += 8)
+        {
+            __m128 s0 = _mm_add_ps(_mm_loadu_ps(dst + i),     _mm_mul_ps(w, _mm_loadu_ps(row + i)));
+            __m128 s1 = _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(w, _mm_loadu_ps(row + i + 4)));
+            _mm_storeu_ps(dst + i, s0);
+            _mm_storeu_ps(dst + i + 4, s1);
+        }
+#endif
+        for(; i < count; ++i)
+            dst[i] += weight[t] * row[i];
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// linear floats to sRGB bytes, the alpha (every 4th if hasAlpha) is 0~1
+///////////////////////////////////////////////////////////////////////////////
+static void encodeSRGB(const float* src, unsigned char* dst, std::size_t count, bool hasAlpha)
+{
+    const unsigned char* toSRGB = getColorTables().toSRGB;
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        float v = src[i];
+        v = (v < 0) ? 0 : (v > 1 ? 1 : v);
+        if(hasAlpha && (i & 3) == 3)
+            dst[i] = (unsigned char)(v * 255 + 0.5f);
+        else
+            dst[i] = toSRGB[(int)(v * (SRGB_TABLE_SIZE - 1) + 0.5f)];
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ctor
+///////////////////////////////////////////////////////////////////////////////
+MipChain::MipChain() : channelCount(0)
+{
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// build all levels down to 1x1, level 0 is a copy of data
+///////////////////////////////////////////////////////////////////////////////
+bool MipChain::build(const unsigned char* data, int width, int height, int channelCount,
+                     Filter filter, bool linear, ThreadPool* pool)
+{
+    if(!data)
+    {
+        clear();
+        errorMessage = "Invalid image data or size.";
+        return false;
+    }
+
+    unsigned char* level0 = allocate(width, height, channelCount);
+    if(!level0)
+        return false;
+    memcpy(level0, data, getDataSize(0));
+    return buildLevels(filter, linear, pool);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// allocate all levels and return level 0 to be filled by the caller, so an
+// image can be decoded into it without a copy
+///////////////////////////////////////////////////////////////////////////////
+unsigned char* MipChain::allocate(int width, int height, int channelCount)
+{
+    clear();
+    if(width <= 0 || height <= 0)
+    {
+        errorMessage = "Invalid image data or size.";
+        return 0;
+    }
+    if(channelCount != 1 && channelCount != 3 && channelCount != 4)
+    {
+        errorMessage = "Only 1, 3 or 4 channels are supported.";
+        return 0;
+    }
+    this->channelCount = channelCount;
+
+    // sizes and offsets of all levels
+    std::size_t size = 0;
+    int w = width;
+    int h = height;
+    while(true)
+    {
+        Level level = { w, h, size };
+        levels.push_back(level);
+        size += (std::size_t)w * h * channelCount;
+        if(w == 1 && h == 1)
+            break;
+        w = (w > 1) ? w / 2 : 1;
+        h = (h > 1) ? h / 2 : 1;
+    }
+
+    buffer.resize(size);
+    return &buffer[0];
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// build levels 1 to the last from level 0, after allocate()
+///////////////////////////////////////////////////////////////////////////////
+bool MipChain::buildLevels(Filter filter, bool linear, ThreadPool* pool)
+{
+    if(levels.empty())
+    {
+        errorMessage = "Level 0 is not allocated.";
+        return false;
+    }
+
+    for(std::size_t i = 1; i < levels.size(); ++i)
+    {
+        const Level& prev = levels[i - 1];
+        downsample(&buffer[prev.offset], prev.width, prev.height, channelCount,
+                   &buffer[levels[i].offset], filter, linear, pool);
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// release all levels
+///////////////////////////////////////////////////////////////////////////////
+void MipChain::clear()
+{
+    levels.clear();
+    std::vector<unsigned char>().swap(buffer);
+    channelCount = 0;
+    errorMessage.clear();
+}
+
+
+
+std::size_t MipChain::getDataSize(int level) const
+{
+    return (std::size_t)levels[level].width * levels[level].height * channelCount;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// build the next level from src
+// The box filter of even sizes averages 2x2 pixels directly (with SIMD in
+// gamma space), the others filter in 2 passes through floats.
+///////////////////////////////////////////////////////////////////////////////
+void MipChain::downsample(const unsigned char* src, int width, int height, int channelCount,
+                          unsigned char* dst, Filter filter, bool linear, ThreadPool* pool)
+{
+    const int dstWidth = (width > 1) ? width / 2 : 1;
+    const int dstHeight = (height > 1) ? height / 2 : 1;
+    const std::size_t srcRowSize = (std::size_t)width * channelCount;
+    const std::size_t dstRowSize = (std::size_t)dstWidth * channelCount;
+
+    if(filter == FILTER_BOX && width % 2 == 0 && height % 2 == 0)
+    {
+        auto boxRows = [=](int first, int last)
+        {
+            for(int y = first; y < last; ++y)
+            {
+                const unsigned char* row0 = src + (std::size_t)y * 2 * srcRowSize;
+                if(linear)
+                    boxRowLinear(row0, row0 + srcRowSize, dst + y * dstRowSize, dstWidth, channelCount);
+                else
+                    boxRow(row0, row0 + srcRowSize, dst + y * dstRowSize, dstWidth, channelCount);
+            }
+        };
+        if(pool)
+            pool->parallelFor(dstHeight, boxRows, MIN_BAND_ROWS);
+        else
+            boxRows(0, dstHeight);
+        return;
+    }
+
+    resample(src, width, height, channelCount, dst, dstWidth, dstHeight, filter, linear, pool);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// scale src to dstWidth x dstHeight in 2 passes through floats
+///////////////////////////////////////////////////////////////////////////////
+void MipChain::resample(const unsigned char* src, int width, int height, int channelCount,
+                        unsigned char* dst, int dstWidth, int dstHeight,
+                        Filter filter, bool linear, ThreadPool* pool)
+{
+    const std::size_t srcRowSize = (std::size_t)width * channelCount;
+    const std::size_t dstRowSize = (std::size_t)dstWidth * channelCount;
+
+    Taps tapsX, tapsY;
+    buildTaps(width, dstWidth, filter, tapsX);
+    buildTaps(height, dstHeight, filter, tapsY);
+
+    // the output rows of each band are filtered from the source rows their
+    // taps cover, horizontally into float rows, then vertically and back to
+    // bytes. The buffers have 1 more float for filterRow<3>.
+    // alpha is not a color, so it is not converted to linear
+    auto filterBands = [&](int first, int last)
+    {
+        std::vector<float> row(srcRowSize + 1);
+        std::vector<float> rows;
+        std::vector<float> sum(dstRowSize);
+        for(int bandFirst = first; bandFirst < last; bandFirst += FILTER_BAND_ROWS)
+        {
+            int bandLast = (bandFirst + FILTER_BAND_ROWS < last) ? bandFirst + FILTER_BAND_ROWS : last;
+            const int* index = &tapsY.indices[bandFirst * tapsY.count];
+            const int* indexEnd = &tapsY.indices[0] + bandLast * tapsY.count;
+            int firstRow = *std::min_element(index, indexEnd);
+            int lastRow = *std::max_element(index, indexEnd);
+            rows.resize((lastRow - firstRow + 1) * dstRowSize + 1);
+
+            for(int y = firstRow; y <= lastRow; ++y)
+            {
+                if(linear)
+                    decodeSRGB(src + y * srcRowSize, &row[0], srcRowSize, channelCount == 4);
+                else
+                    convertBytesToFloats(src + y * srcRowSize, &row[0], srcRowSize);
+
+                float* dstRow = &rows[(y - firstRow) * dstRowSize];
+                if(channelCount == 1)
+                    filterRow<1>(&row[0], dstRow, dstWidth, tapsX);
+                else if(channelCount == 3)
+                    filterRow<3>(&row[0], dstRow, dstWidth, tapsX);
+                else
+                    filterRow<4>(&row[0], dstRow, dstWidth, tapsX);
+            }
+
+            for(int y = bandFirst; y < bandLast; ++y)
+            {
+                sumRows(&rows[0], firstRow, dstRowSize, &tapsY.indices[y * tapsY.count],
+                        &tapsY.weights[y * tapsY.count], tapsY.count, &sum[0]);
+                if(linear)
+                    encodeSRGB(&sum[0], dst + y * dstRowSize, dstRowSize, channelCount == 4);
+                else
+                    convertFloatsToBytes(&sum[0], dst + y * dstRowSize, dstRowSize);
+            }
+        }
+    };
+
+    if(pool)
+        pool->parallelFor(dstHeight, filterBands, MIN_BAND_ROWS);
+    else
+        filterBands(0, dstHeight);
+}
+
+} // namespace Image
@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+// MipChain.h
+// ==========
+// full mipmap chain of an 8-bit gray, RGB or RGBA image, built on CPU
+// Each level is half of the previous one (rounded down, at least 1) until
+// 1x1, the same sizes as OpenGL. An odd dimension is filtered with 3 taps of
+// weights from the covered areas, so no source pixel is skipped.
+// The box filter of even dimensions averages 2x2 pixels directly (with SSE2
+// in gamma space). Odd dimensions and the Kaiser filter (windowed sinc,
+// sharper than box) use a separable float filter. In linear space, colors are
+// decoded from sRGB before filtering and encoded after, but the alpha of RGBA
+// images is filtered as is.
+// All levels are packed rows (no paddings) in one buffer, level 0 first, so
+// they can be uploaded level by level or written to a file at once.
+// resample() scales an image to any size with the same filters, plus Mitchell
+// and Lanczos for a sharper level 0 when a large image is downscaled at load
+// time. It filters bands of rows, so the float buffers stay small.
+//
+// Dependencies: PixelConvert, ThreadPool
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef IMAGE_MIP_CHAIN_H
+#define IMAGE_MIP_CHAIN_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+class ThreadPool;
+
+namespace Image
+{
+    class MipChain
+    {
+    public:
+        enum Filter
+        {
+            FILTER_BOX = 0,                         // average of covered pixels
+            FILTER_KAISER,                          // Kaiser windowed sinc, 3 pixels wide
+            FILTER_MITCHELL,                        // Mitchell-Netravali cubic (B = C = 1/3), 2 pixels wide
+            FILTER_LANCZOS3                         // Lanczos windowed sinc, 3 pixels wide
+        };
+
+        MipChain();
+
+        // build all levels from an image with 1, 3 or 4 channels
+        // If pool is given, the rows of each level are filtered by its threads.
+        bool build(const unsigned char* data, int width, int height, int channelCount,
+                   Filter filter=FILTER_BOX, bool linear=false, ThreadPool* pool=0);
+        void clear();
+
+        // same as build() without copying level 0: allocate() returns level 0
+        // (null on error) to decode the image into, then buildLevels() builds
+        // the other levels from it
+        unsigned char* allocate(int width, int height, int channelCount);
+        bool buildLevels(Filter filter=FILTER_BOX, bool linear=false, ThreadPool* pool=0);
+
+        int  getLevelCount() const                  { return (int)levels.size(); }
+        int  getChannelCount() const                { return channelCount; }
+        int  getWidth(int level) const              { return levels[level].width; }
+        int  getHeight(int level) const             { return levels[level].height; }
+        const unsigned char* getData(int level) const { return &buffer[levels[level].offset]; }
+        std::size_t getDataSize(int level) const;
+
+        const unsigned char* getBuffer() const      { return buffer.empty() ? 0 : &buffer[0]; }   // all levels
+        std::size_t getBufferSize() const           { return buffer.size(); }
+        const char* getError() const                { return errorMessage.c_str(); }
+
+        // build the next level (half size) from src, the sizes of dst are
+        // max(1, width/2) x max(1, height/2)
+        static void downsample(const unsigned char* src, int width, int height, int channelCount,
+                               unsigned char* dst, Filter filter, bool linear, ThreadPool* pool=0);
+
+        // scale src to dstWidth x dstHeight, smaller or larger
+        // The filter is stretched by the scale when downscaling, so it covers
+        // all source pixels. Box takes the average of the covered area.
+        static void resample(const unsigned char* src, int width, int height, int channelCount,
+                             unsigned char* dst, int dstWidth, int dstHeight,
+                             Filter filter, bool linear, ThreadPool* pool=0);
+
+    private:
+        struct Level
+        {
+            int width;
+            int height;
+            std::size_t offset;                     // in buffer
+        };
+
+        std::vector<Level> levels;
+        std::vector<unsigned char> buffer;
+        int channelCount;
+        std::string errorMessage;
+    };
+}
+
+#endif // IMAGE_MIP_CHAIN_H
@@ -0,0 +1,495 @@
+///////////////////////////////////////////////////////////////////////////////
+// PixelConvert.cpp
+// ================
+// channel order and pixel format conversions of 8-bit image data
+// Each function runs the widest SIMD loop available first, then narrower ones
+// and the scalar loop finish the rest. The SIMD loops never read or write
+// outside of the given pixels.
+//
+// Dependencies: none
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PixelConvert.h"
+
+#if defined(__AVX2__)
+#define PIXEL_AVX2  1
+#include <immintrin.h>
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+#define PIXEL_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXEL_SSE2  1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define PIXEL_NEON  1
+#include <arm_neon.h>
+#endif
+
+namespace Image
+{
+
+// BT.601 luma weights in 8-bit fixed point, the sum is 256
+const int GRAY_R = 77;
+const int GRAY_G = 150;
+const int GRAY_B = 29;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RGB <-> BGR
+///////////////////////////////////////////////////////////////////////////////
+void swapRedBlue24(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(PIXEL_SSSE3)
+    // 5 pixels per 16 bytes, the 16th byte is written again by the next step
+    const __m128i mask = _mm_setr_epi8(2,1,0, 5,4,3, 8,7,6, 11,10,9, 14,13,12, 15);
+    for(; i + 6 <= count; i += 5)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i*3));
+        _mm_storeu_si128((__m128i*)(dst + i*3), _mm_shuffle_epi8(v, mask));
+    }
+#elif defined(PIXEL_NEON)
+    for(; i + 16 <= count; i += 16)
+    {
+        uint8x16x3_t v = vld3q_u8(src + i*3);
+        uint8x16_t t = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = t;
+        vst3q_u8(dst + i*3, v);
+    }
+#endif
+    // load the whole pixel before storing, so it works in place and the
+    // compiler can vectorize it
+    for(; i < count; ++i)
+    {
+        unsigned char r = src[i*3];
+        unsigned char g = src[i*3+1];
+        unsigned char b = src[i*3+2];
+        dst[i*3]   = b;
+        dst[i*3+1] = g;
+        dst[i*3+2] = r;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RGBA <-> BGRA
+///////////////////////////////////////////////////////////////////////////////
+void swapRedBlue32(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(PIXEL_AVX2)
+    const __m256i mask8 = _mm256_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15,
+                                           2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i*4));
+        _mm256_storeu_si256((__m256i*)(dst + i*4), _mm256_shuffle_epi8(v, mask8));
+    }
+#endif
+#if defined(PIXEL_SSSE3)
+    const __m128i mask = _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i*4));
+        _mm_storeu_si128((__m128i*)(dst + i*4), _mm_shuffle_epi8(v, mask));
+    }
+#elif defined(PIXEL_SSE2)
+    // swap 16-bit halves of B_R_ in each pixel, keep _G_A
+    const __m128i maskGA = _mm_set1_epi32((int)0xFF00FF00);
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i*4));
+        __m128i br = _mm_andnot_si128(maskGA, v);
+        br = _mm_shufflehi_epi16(_mm_shufflelo_epi16(br, 0xB1), 0xB1);
+        _mm_storeu_si128((__m128i*)(dst + i*4), _mm_or_si128(_mm_and_si128(v, maskGA), br));
+    }
+#elif defined(PIXEL_NEON)
+    for(; i + 16 <= count; i += 16)
+    {
+        uint8x16x4_t v = vld4q_u8(src + i*4);
+        uint8x16_t t = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = t;
+        vst4q_u8(dst + i*4, v);
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        unsigned char t = src[i*4];
+        dst[i*4]   = src[i*4+2];
+        dst[i*4+1] = src[i*4+1];
+        dst[i*4+2] = t;
+        dst[i*4+3] = src[i*4+3];
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// 3 to 4 channels with alpha=255, swap red and blue if swap is true
+///////////////////////////////////////////////////////////////////////////////
+static void expand24To32(const unsigned char* src, unsigned char* dst, std::size_t count, bool swap)
+{
+    const int r = swap ? 2 : 0;
+    const int b = swap ? 0 : 2;
+    std::size_t i = 0;
+#if defined(PIXEL_SSSE3)
+    // same byte shuffle for both lanes of AVX2, -1 clears the alpha byte
+    const __m128i mask = swap ? _mm_setr_epi8(2,1,0,-1, 5,4,3,-1, 8,7,6,-1, 11,10,9,-1)
+                              : _mm_setr_epi8(0,1,2,-1, 3,4,5,-1, 6,7,8,-1, 9,10,11,-1);
+#endif
+#if defined(PIXEL_AVX2)
+    // move pixels 4~7 (bytes 12~27) to the upper lane, then shuffle in lanes
+    // 32 bytes are loaded but 24 are used
+    const __m256i lanes = _mm256_setr_epi32(0,1,2,3, 3,4,5,6);
+    const __m256i mask8 = _mm256_broadcastsi128_si256(mask);
+    const __m256i alpha8 = _mm256_set1_epi32((int)0xFF000000);
+    for(; i + 11 <= count; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i*3));
+        v = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v, lanes), mask8);
+        _mm256_storeu_si256((__m256i*)(dst + i*4), _mm256_or_si256(v, alpha8));
+    }
+#endif
+#if defined(PIXEL_SSSE3)
+    // 4 pixels per step, reads 16 bytes but uses 12
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    for(; i + 6 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i*3));
+        _mm_storeu_si128((__m128i*)(dst + i*4), _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha));
+    }
+#elif defined(PIXEL_NEON)
+    for(; i + 16 <= count; i += 16)
+    {
+        uint8x16x3_t v = vld3q_u8(src + i*3);
+        uint8x16x4_t w;
+        w.val[0] = v.val[r];
+        w.val[1] = v.val[1];
+        w.val[2] = v.val[b];
+        w.val[3] = vdupq_n_u8(255);
+        vst4q_u8(dst + i*4, w);
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        dst[i*4]   = src[i*3+r];
+        dst[i*4+1] = src[i*3+1];
+        dst[i*4+2] = src[i*3+b];
+        dst[i*4+3] = 255;
+    }
+}
+
+void convertRGBToRGBA(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    expand24To32(src, dst, count, false);
+}
+
+void convertBGRToRGBA(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    expand24To32(src, dst, count, true);
+}
+
+
+
+#if defined(PIXEL_SSE2)
+///////////////////////////////////////////////////////////////////////////////
+// luma of 4 RGBA pixels as 4 ints
+// widen to 16 bits, then (r*77 + g*150) and (b*29 + a*0) per pixel with
+// pmaddwd, and add the pairs
+///////////////////////////////////////////////////////////////////////////////
+static inline __m128i grayOf4(__m128i v)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weights = _mm_setr_epi16(GRAY_R, GRAY_G, GRAY_B, 0, GRAY_R, GRAY_G, GRAY_B, 0);
+    __m128 lo = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(v, zero), weights));
+    __m128 hi = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(v, zero), weights));
+    __m128i even = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2,0,2,0)));
+    __m128i odd = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3,1,3,1)));
+    __m128i sum = _mm_add_epi32(_mm_add_epi32(even, odd), _mm_set1_epi32(128));
+    return _mm_srli_epi32(sum, 8);
+}
+
+// pack 16 ints (0~255) into 16 bytes
+static inline void storeGray16(unsigned char* dst, __m128i g0, __m128i g1, __m128i g2, __m128i g3)
+{
+    __m128i lo = _mm_packs_epi32(g0, g1);
+    __m128i hi = _mm_packs_epi32(g2, g3);
+    _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(lo, hi));
+}
+#endif
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RGB to grayscale
+///////////////////////////////////////////////////////////////////////////////
+void convertRGBToGray(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(PIXEL_SSSE3)
+    // spread 4 RGB pixels to RGBA first, 16 bytes are loaded but 12 are used
+    const __m128i mask = _mm_setr_epi8(0,1,2,-1, 3,4,5,-1, 6,7,8,-1, 9,10,11,-1);
+    for(; i + 18 <= count; i += 16)
+    {
+        const unsigned char* s = src + i*3;
+        __m128i g0 = grayOf4(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)s), mask));
+        __m128i g1 = grayOf4(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 12)), mask));
+        __m128i g2 = grayOf4(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 24)), mask));
+        __m128i g3 = grayOf4(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 36)), mask));
+        storeGray16(dst + i, g0, g1, g2, g3);
+    }
+#elif defined(PIXEL_NEON)
+    // the sum fits in 16 bits (255 * 256), vrshrn adds 128 before shifting
+    for(; i + 8 <= count; i += 8)
+    {
+        uint8x8x3_t v = vld3_u8(src + i*3);
+        uint16x8_t sum = vmull_u8(v.val[0], vdup_n_u8(GRAY_R));
+        sum = vmlal_u8(sum, v.val[1], vdup_n_u8(GRAY_G));
+        sum = vmlal_u8(sum, v.val[2], vdup_n_u8(GRAY_B));
+        vst1_u8(dst + i, vrshrn_n_u16(sum, 8));
+    }
+#endif
+    for(; i < count; ++i)
+        dst[i] = (unsigned char)((src[i*3] * GRAY_R + src[i*3+1] * GRAY_G + src[i*3+2] * GRAY_B + 128) >> 8);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RGBA to grayscale
+///////////////////////////////////////////////////////////////////////////////
+void convertRGBAToGray(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(PIXEL_SSE2)
+    for(; i + 16 <= count; i += 16)
+    {
+        const unsigned char* s = src + i*4;
+        __m128i g0 = grayOf4(_mm_loadu_si128((const __m128i*)s));
+        __m128i g1 = grayOf4(_mm_loadu_si128((const __m128i*)(s + 16)));
+        __m128i g2 = grayOf4(_mm_loadu_si128((const __m128i*)(s + 32)));
+        __m128i g3 = grayOf4(_mm_loadu_si128((const __m128i*)(s + 48)));
+        storeGray16(dst + i, g0, g1, g2, g3);
+    }
+#elif defined(PIXEL_NEON)
+    for(; i + 8 <= count; i += 8)
+    {
+        uint8x8x4_t v = vld4_u8(src + i*4);
+        uint16x8_t sum = vmull_u8(v.val[0], vdup_n_u8(GRAY_R));
+        sum = vmlal_u8(sum, v.val[1], vdup_n_u8(GRAY_G));
+        sum = vmlal_u8(sum, v.val[2], vdup_n_u8(GRAY_B));
+        vst1_u8(dst + i, vrshrn_n_u16(sum, 8));
+    }
+#endif
+    for(; i < count; ++i)
+        dst[i] = (unsigned char)((src[i*4] * GRAY_R + src[i*4+1] * GRAY_G + src[i*4+2] * GRAY_B + 128) >> 8);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// premultiplied alpha
+// c*a/255 is rounded exactly with t = c*a + 128, (t + (t >> 8)) >> 8
+// The alpha component is multiplied by 255, so it stays the same.
+///////////////////////////////////////////////////////////////////////////////
+void premultiplyAlpha(const unsigned char* src, unsigned char* dst, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(PIXEL_AVX2)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i half = _mm256_set1_epi16(128);
+        const __m256i alphaLanes = _mm256_set1_epi64x(0x00FF000000000000LL);    // (0,0,0,255) per pixel
+        const __m256i colorLanes = _mm256_set1_epi64x(0x0000FFFFFFFFFFFFLL);    // (-1,-1,-1,0)
+        for(; i + 8 <= count; i += 8)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(src + i*4));
+            __m256i c[2] = { _mm256_unpacklo_epi8(v, zero), _mm256_unpackhi_epi8(v, zero) };
+            for(int k = 0; k < 2; ++k)
+            {
+                __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c[k], 0xFF), 0xFF);
+                a = _mm256_or_si256(_mm256_and_si256(a, colorLanes), alphaLanes);
+                __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(c[k], a), half);
+                c[k] = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+            }
+            _mm256_storeu_si256((__m256i*)(dst + i*4), _mm256_packus_epi16(c[0], c[1]));
+        }
+    }
+#endif
+#if defined(PIXEL_SSE2)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i half = _mm_set1_epi16(128);
+        const __m128i alphaLanes = _mm_setr_epi16(0,0,0,255, 0,0,0,255);
+        const __m128i colorLanes = _mm_setr_epi16(-1,-1,-1,0, -1,-1,-1,0);
+        for(; i + 4 <= count; i += 4)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + i*4));
+            __m128i c[2] = { _mm_unpacklo_epi8(v, zero), _mm_unpackhi_epi8(v, zero) };
+            for(int k = 0; k < 2; ++k)
+            {
+                __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c[k], 0xFF), 0xFF);
+                a = _mm_or_si128(_mm_and_si128(a, colorLanes), alphaLanes);
+                __m128i t = _mm_add_epi16(_mm_mullo_epi16(c[k], a), half);
+                c[k] = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+            }
+            _mm_storeu_si128((__m128i*)(dst + i*4), _mm_packus_epi16(c[0], c[1]));
+        }
+    }
+#elif defined(PIXEL_NEON)
+    {
+        const uint16x8_t half = vdupq_n_u16(128);
+        for(; i + 8 <= count; i += 8)
+        {
+            uint8x8x4_t v = vld4_u8(src + i*4);
+            for(int k = 0; k < 3; ++k)
+            {
+                uint16x8_t t = vaddq_u16(vmull_u8(v.val[k], v.val[3]), half);
+                v.val[k] = vshrn_n_u16(vsraq_n_u16(t, t, 8), 8);
+            }
+            vst4_u8(dst + i*4, v);
+        }
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        int a = src[i*4+3];
+        for(int k = 0; k < 3; ++k)
+        {
+            int t = src[i*4+k] * a + 128;
+            dst[i*4+k] = (unsigned char)((t + (t >> 8)) >> 8);
+        }
+        dst[i*4+3] = (unsigned char)a;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// 0~255 to 0~1
+///////////////////////////////////////////////////////////////////////////////
+void convertBytesToFloats(const unsigned char* src, float* dst, std::size_t count)
+{
+    const float scale = 1.0f / 255.0f;
+    std::size_t i = 0;
+#if defined(PIXEL_AVX2)
+    {
+        const __m256 scale8 = _mm256_set1_ps(scale);
+        for(; i + 8 <= count; i += 8)
+        {
+            __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i)));
+            _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale8));
+        }
+    }
+#endif
+#if defined(PIXEL_SSE2)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 scale4 = _mm_set1_ps(scale);
+        for(; i + 16 <= count; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i lo = _mm_unpacklo_epi8(v, zero);
+            __m128i hi = _mm_unpackhi_epi8(v, zero);
+            _mm_storeu_ps(dst + i,      _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale4));
+            _mm_storeu_ps(dst + i + 4,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale4));
+            _mm_storeu_ps(dst + i + 8,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale4));
+            _mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale4));
+        }
+    }
+#elif defined(PIXEL_NEON)
+    {
+        const float32x4_t scale4 = vdupq_n_f32(scale);
+        for(; i + 8 <= count; i += 8)
+        {
+            uint16x8_t v = vmovl_u8(vld1_u8(src + i));
+            vst1q_f32(dst + i,     vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))), scale4));
+            vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))), scale4));
+        }
+    }
+#endif
+    for(; i < count; ++i)
+        dst[i] = src[i] * scale;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// 0~1 to 0~255, clamped and rounded half up (x * 255 + 0.5, truncated)
+///////////////////////////////////////////////////////////////////////////////
+void convertFloatsToBytes(const float* src, unsigned char* dst, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(PIXEL_AVX2)
+    {
+        const __m256 zero8 = _mm256_setzero_ps();
+        const __m256 one8 = _mm256_set1_ps(1.0f);
+        const __m256 scale8 = _mm256_set1_ps(255.0f);
+        const __m256 half8 = _mm256_set1_ps(0.5f);
+        const __m256i order = _mm256_setr_epi32(0,4,1,5, 2,6,3,7);
+        for(; i + 32 <= count; i += 32)
+        {
+            __m256i n[4];
+            for(int k = 0; k < 4; ++k)
+            {
+                __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i + k*8), zero8), one8);
+                n[k] = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(x, scale8), half8));
+            }
+            // packs work in 128-bit lanes, so put the 4-byte groups back in order
+            __m256i b = _mm256_packus_epi16(_mm256_packs_epi32(n[0], n[1]), _mm256_packs_epi32(n[2], n[3]));
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permutevar8x32_epi32(b, order));
+        }
+    }
+#endif
+#if defined(PIXEL_SSE2)
+    {
+        const __m128 zero4 = _mm_setzero_ps();
+        const __m128 one4 = _mm_set1_ps(1.0f);
+        const __m128 scale4 = _mm_set1_ps(255.0f);
+        const __m128 half4 = _mm_set1_ps(0.5f);
+        for(; i + 16 <= count; i += 16)
+        {
+            __m128i n[4];
+            for(int k = 0; k < 4; ++k)
+            {
+                __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + k*4), zero4), one4);
+                n[k] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(x, scale4), half4));
+            }
+            __m128i b = _mm_packus_epi16(_mm_packs_epi32(n[0], n[1]), _mm_packs_epi32(n[2], n[3]));
+            _mm_storeu_si128((__m128i*)(dst + i), b);
+        }
+    }
+#elif defined(PIXEL_NEON)
+    {
+        const float32x4_t zero4 = vdupq_n_f32(0.0f);
+        const float32x4_t one4 = vdupq_n_f32(1.0f);
+        const float32x4_t scale4 = vdupq_n_f32(255.0f);
+        const float32x4_t half4 = vdupq_n_f32(0.5f);
+        for(; i + 8 <= count; i += 8)
+        {
+            float32x4_t x0 = vminq_f32(vmaxq_f32(vld1q_f32(src + i), zero4), one4);
+            float32x4_t x1 = vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), zero4), one4);
+            uint32x4_t n0 = vcvtq_u32_f32(vmlaq_f32(half4, x0, scale4));
+            uint32x4_t n1 = vcvtq_u32_f32(vmlaq_f32(half4, x1, scale4));
+            vst1_u8(dst + i, vmovn_u16(vcombine_u16(vmovn_u32(n0), vmovn_u32(n1))));
+        }
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        float x = src[i];
+        x = (x < 0.0f) ? 0.0f : ((x > 1.0f) ? 1.0f : x);
+        dst[i] = (unsigned char)(x * 255.0f + 0.5f);
+    }
+}
+
+} // namespace Image
@@ -0,0 +1,44 @@
+///////////////////////////////////////////////////////////////////////////////
+// PixelConvert.h
+// ==============
+// channel order and pixel format conversions of 8-bit image data
+// The kernels use SSSE3/AVX2 (if the compiler targets them, e.g. -mssse3 or
+// -mavx2), SSE2 or NEON, and scalar loops for the rest of pixels.
+// The count is the number of pixels, except the byte/float conversions, which
+// take the number of values (components).
+// Functions marked "in place" accept the same pointer for src and dst.
+//
+// Dependencies: none
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef IMAGE_PIXEL_CONVERT_H
+#define IMAGE_PIXEL_CONVERT_H
+
+#include <cstddef>
+
+namespace Image
+{
+    // swap the 1st and 3rd components, RGB <-> BGR or RGBA <-> BGRA (in place)
+    void swapRedBlue24(const unsigned char* src, unsigned char* dst, std::size_t count);
+    void swapRedBlue32(const unsigned char* src, unsigned char* dst, std::size_t count);
+
+    // 3 to 4 channels with opaque alpha (255)
+    void convertRGBToRGBA(const unsigned char* src, unsigned char* dst, std::size_t count);
+    void convertBGRToRGBA(const unsigned char* src, unsigned char* dst, std::size_t count);
+
+    // luma with BT.601 weights (77, 150, 29)/256, alpha is ignored
+    void convertRGBToGray(const unsigned char* src, unsigned char* dst, std::size_t count);
+    void convertRGBAToGray(const unsigned char* src, unsigned char* dst, std::size_t count);
+
+    // multiply RGB by alpha, c = round(c * a / 255) (in place)
+    void premultiplyAlpha(const unsigned char* src, unsigned char* dst, std::size_t count);
+
+    // 0~255 <-> 0~1, floats are clamped and rounded to nearest
+    void convertBytesToFloats(const unsigned char* src, float* dst, std::size_t count);
+    void convertFloatsToBytes(const float* src, unsigned char* dst, std::size_t count);
+}
+
+#endif // IMAGE_PIXEL_CONVERT_H
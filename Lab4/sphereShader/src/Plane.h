@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// Plane.h
+// =======
+// 3D plane with equation: ax + by + cz + d = 0
+// The normal vector is (a, b, c), and the distance of a point from the plane
+// is positive on the side where the normal points to (if normalized).
+//
+// Dependencies: Vector3, Vector4
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef GEOMETRY_PLANE_H
+#define GEOMETRY_PLANE_H
+
+#include <cmath>
+#include <iostream>
+#include "Vectors.h"
+
+struct Plane
+{
+    Vector3 normal;     // (a, b, c)
+    float d;            // constant term
+
+    // ctors
+    constexpr Plane() : normal(0, 0, 1), d(0) {};
+    constexpr Plane(float a, float b, float c, float d) : normal(a, b, c), d(d) {};
+    constexpr Plane(const Vector3& normal, float d) : normal(normal), d(d) {};
+    Plane(const Vector3& normal, const Vector3& point);     // plane passing the point
+
+    // util functions
+    constexpr Plane& set(float a, float b, float c, float d);
+    constexpr Plane& set(const Vector3& normal, float d);
+    constexpr float getDistance(const Vector3& point) const;    // signed distance if normalized
+    Plane&      normalize();                                    // unit length normal
+    constexpr Vector4 getCoefficients() const                   { return Vector4(normal.x, normal.y, normal.z, d); }
+
+    friend std::ostream& operator<<(std::ostream& os, const Plane& p);
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inline functions for Plane
+///////////////////////////////////////////////////////////////////////////////
+inline Plane::Plane(const Vector3& normal, const Vector3& point) : normal(normal), d(-normal.dot(point))
+{
+}
+
+constexpr Plane& Plane::set(float a, float b, float c, float d) {
+    normal.set(a, b, c);
+    this->d = d;
+    return *this;
+}
+
+constexpr Plane& Plane::set(const Vector3& normal, float d) {
+    this->normal = normal;
+    this->d = d;
+    return *this;
+}
+
+constexpr float Plane::getDistance(const Vector3& point) const {
+    return normal.dot(point) + d;
+}
+
+inline Plane& Plane::normalize() {
+    float length = normal.length();
+    if(length > 0)
+    {
+        float invLength = 1.0f / length;
+        normal *= invLength;
+        d *= invLength;
+    }
+    return *this;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Plane& p) {
+    os << "(" << p.normal.x << ", " << p.normal.y << ", " << p.normal.z << ", " << p.d << ")";
+    return os;
+}
+// END OF PLANE ///////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+// Quaternion.cpp
+// ==============
+// Quaternion and dual quaternion for rotation and rigid transform
+//
+// Dependencies: Vector3, Matrix4
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include "Quaternion.h"
+
+const float EPSILON = 0.00001f;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// return rotation matrix of unit quaternion
+///////////////////////////////////////////////////////////////////////////////
+Matrix4 Quaternion::getMatrix() const
+{
+    float x2 = x + x;
+    float y2 = y + y;
+    float z2 = z + z;
+    float xx2 = x * x2, xy2 = x * y2, xz2 = x * z2;
+    float yy2 = y * y2, yz2 = y * z2, zz2 = z * z2;
+    float sx2 = s * x2, sy2 = s * y2, sz2 = s * z2;
+
+    return Matrix4(1 - (yy2 + zz2), xy2 + sz2,       xz2 - sy2,       0,  // 1st column
+                   xy2 - sz2,       1 - (xx2 + zz2), yz2 + sx2,       0,  // 2nd column
+                   xz2 + sy2,       yz2 - sx2,       1 - (xx2 + yy2), 0,  // 3rd column
+                   0,               0,               0,               1); // 4th column
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// return unit quaternion from the upper-left 3x3 rotation part of matrix
+// The largest of s, x, y, z is computed first to avoid dividing by small
+// number (Shepperd's method). The matrix must not have scale.
+///////////////////////////////////////////////////////////////////////////////
+Quaternion Quaternion::getQuaternion(const Matrix4& m)
+{
+    float trace = m[0] + m[5] + m[10];
+    float t;
+    Quaternion q;
+    if(trace > 0)
+    {
+        t = sqrtf(trace + 1.0f) * 2;            // 4 * s
+        q.set(0.25f * t, (m[6] - m[9]) / t, (m[8] - m[2]) / t, (m[1] - m[4]) / t);
+    }
+    else if(m[0] > m[5] && m[0] > m[10])
+    {
+        t = sqrtf(1.0f + m[0] - m[5] - m[10]) * 2;  // 4 * x
+        q.set((m[6] - m[9]) / t, 0.25f * t, (m[1] + m[4]) / t, (m[8] + m[2]) / t);
+    }
+    else if(m[5] > m[10])
+    {
+        t = sqrtf(1.0f + m[5] - m[0] - m[10]) * 2;  // 4 * y
+        q.set((m[8] - m[2]) / t, (m[1] + m[4]) / t, 0.25f * t, (m[6] + m[9]) / t);
+    }
+    else
+    {
+        t = sqrtf(1.0f + m[10] - m[0] - m[5]) * 2;  // 4 * z
+        q.set((m[1] - m[4]) / t, (m[8] + m[2]) / t, (m[6] + m[9]) / t, 0.25f * t);
+    }
+    return q.normalize();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// spherical linear interpolation of unit quaternions along the shortest arc
+// alpha = 0 returns from, alpha = 1 returns to
+// It falls back to nlerp if 2 quaternions are almost same.
+///////////////////////////////////////////////////////////////////////////////
+Quaternion Quaternion::slerp(const Quaternion& from, const Quaternion& to, float alpha)
+{
+    float cosine = from.dot(to);
+    Quaternion q2 = to;
+    if(cosine < 0)                  // q and -q are same rotation, use shorter arc
+    {
+        cosine = -cosine;
+        q2 = -q2;
+    }
+
+    if(cosine > 0.9995f)
+        return nlerp(from, q2, alpha);
+
+    float angle = acosf(cosine);
+    float invSine = 1.0f / sinf(angle);
+    float a1 = sinf((1 - alpha) * angle) * invSine;
+    float a2 = sinf(alpha * angle) * invSine;
+    return from * a1 + q2 * a2;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// normalized linear interpolation along the shortest arc
+// It is cheaper than slerp, but the angular speed is not constant.
+///////////////////////////////////////////////////////////////////////////////
+Quaternion Quaternion::nlerp(const Quaternion& from, const Quaternion& to, float alpha)
+{
+    float a2 = (from.dot(to) < 0) ? -alpha : alpha;
+    Quaternion q = from * (1 - alpha) + to * a2;
+    return q.normalize();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// normalize dual quaternion
+// The real part becomes unit length and the dual part is made orthogonal to
+// the real part, so it remains a rigid transform after many multiplications.
+///////////////////////////////////////////////////////////////////////////////
+DualQuaternion& DualQuaternion::normalize()
+{
+    float length = real.length();
+    if(length < EPSILON)
+        return *this;   // do nothing if it is zero
+
+    float invLength = 1.0f / length;
+    real *= invLength;
+    dual *= invLength;
+    dual -= real * real.dot(dual);
+    return *this;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inverse of unit dual quaternion is conjugate of both parts
+///////////////////////////////////////////////////////////////////////////////
+DualQuaternion& DualQuaternion::invert()
+{
+    real.conjugate();
+    dual.conjugate();
+    return *this;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// return rigid transform matrix (rotation and translation)
+///////////////////////////////////////////////////////////////////////////////
+Matrix4 DualQuaternion::getMatrix() const
+{
+    Matrix4 m = real.getMatrix();
+    m.setColumn(3, getTranslation());
+    return m;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// return dual quaternion from rigid transform matrix (no scale)
+///////////////////////////////////////////////////////////////////////////////
+DualQuaternion DualQuaternion::getDualQuaternion(const Matrix4& m)
+{
+    return DualQuaternion(Quaternion::getQuaternion(m), Vector3(m[12], m[13], m[14]));
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// linear blend of unit dual quaternions along the shortest arc, then normalize
+// It is used for skinning and blending rigid transforms without the scale
+// artifact of blending matrices.
+///////////////////////////////////////////////////////////////////////////////
+DualQuaternion DualQuaternion::nlerp(const DualQuaternion& from, const DualQuaternion& to, float alpha)
+{
+    float a2 = (from.real.dot(to.real) < 0) ? -alpha : alpha;
+    DualQuaternion dq(from.real * (1 - alpha) + to.real * a2,
+                      from.dual * (1 - alpha) + to.dual * a2);
+    return dq.normalize();
+}
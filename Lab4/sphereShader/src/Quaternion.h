@@ -0,0 +1,341 @@
+///////////////////////////////////////////////////////////////////////////////
+// Quaternion.h
+// ============
+// Quaternion and dual quaternion for rotation and rigid transform
+//
+// Quaternion is stored as (s, x, y, z), s is the scalar part and (x, y, z) is
+// the vector part. A unit quaternion represents a rotation with 4 floats
+// instead of 16 of Matrix4, and 2 rotations are composed with 16 multiplies:
+// q = q1 * q2 is the same rotation as q1.getMatrix() * q2.getMatrix().
+// The angles are in degree, same as Matrix4::rotate().
+//
+// DualQuaternion is a pair of quaternions (real, dual) for rotation and
+// translation (rigid transform without scale) in 8 floats.
+//
+// Dependencies: Vector3, Matrix4
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef MATH_QUATERNION_H
+#define MATH_QUATERNION_H
+
+#include <cmath>
+#include <iostream>
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Simd.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// quaternion
+///////////////////////////////////////////////////////////////////////////////
+struct Quaternion
+{
+    float s;    // scalar part, cos(angle/2)
+    float x;    // vector part, axis * sin(angle/2)
+    float y;
+    float z;
+
+    // ctors
+    constexpr Quaternion() : s(1), x(0), y(0), z(0) {};                 // init with identity
+    constexpr Quaternion(float s, float x, float y, float z) : s(s), x(x), y(y), z(z) {};
+    Quaternion(const Vector3& axis, float angle);                       // rotation axis & angle (degree)
+
+    // util functions
+    constexpr Quaternion& set(float s, float x, float y, float z);
+    Quaternion& set(const Vector3& axis, float angle);                  // axis must be unit length
+    constexpr Quaternion& identity();
+    float       length() const;
+    Quaternion& normalize();
+    constexpr Quaternion& conjugate();                                  // (s, -x, -y, -z)
+    Quaternion& invert();                                               // q^-1 = q* / |q|^2
+    constexpr float dot(const Quaternion& rhs) const;
+    Vector3     rotate(const Vector3& v) const;                         // rotate vector with unit quaternion
+    Matrix4     getMatrix() const;                                      // rotation matrix of unit quaternion
+    bool        equal(const Quaternion& rhs, float e) const;            // compare with epsilon
+
+    // static functions
+    static Quaternion getQuaternion(const Matrix4& m);                  // from rotation part of matrix (no scale)
+    static Quaternion slerp(const Quaternion& from, const Quaternion& to, float alpha);
+    static Quaternion nlerp(const Quaternion& from, const Quaternion& to, float alpha);
+
+    // operators
+    constexpr Quaternion  operator-() const;                            // unary operator (negate)
+    constexpr Quaternion  operator+(const Quaternion& rhs) const;       // add rhs
+    constexpr Quaternion  operator-(const Quaternion& rhs) const;       // subtract rhs
+    constexpr Quaternion& operator+=(const Quaternion& rhs);            // add rhs and update this object
+    constexpr Quaternion& operator-=(const Quaternion& rhs);            // subtract rhs and update this object
+    constexpr Quaternion  operator*(const float a) const;               // scale
+    Quaternion            operator*(const Quaternion& rhs) const;       // multiplication (rotation composition)
+    constexpr Quaternion& operator*=(const float a);                    // scale and update this object
+    Quaternion&           operator*=(const Quaternion& rhs);            // multiply and update this object
+    constexpr bool        operator==(const Quaternion& rhs) const;      // exact compare, no epsilon
+    constexpr bool        operator!=(const Quaternion& rhs) const;      // exact compare, no epsilon
+    float       operator[](int index) const;                            // 0:s, 1:x, 2:y, 3:z
+    float&      operator[](int index);
+
+    friend constexpr Quaternion operator*(const float a, const Quaternion& q);
+    friend std::ostream& operator<<(std::ostream& os, const Quaternion& q);
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// dual quaternion
+// q = real + e * dual, where real is the rotation and dual = 0.5 * t * real
+///////////////////////////////////////////////////////////////////////////////
+struct DualQuaternion
+{
+    Quaternion real;    // rotation
+    Quaternion dual;    // translation, 0.5 * (0, t) * real
+
+    // ctors
+    constexpr DualQuaternion() : real(1, 0, 0, 0), dual(0, 0, 0, 0) {};  // init with identity
+    constexpr DualQuaternion(const Quaternion& real, const Quaternion& dual) : real(real), dual(dual) {};
+    DualQuaternion(const Quaternion& rotation, const Vector3& translation);
+
+    // util functions
+    DualQuaternion& set(const Quaternion& rotation, const Vector3& translation);
+    DualQuaternion& identity();
+    DualQuaternion& normalize();                                        // unit real part, dual orthogonal to real
+    DualQuaternion& invert();                                           // inverse of unit dual quaternion
+    Quaternion      getRotation() const;
+    Vector3         getTranslation() const;
+    Vector3         transformPoint(const Vector3& p) const;             // rotate then translate
+    Vector3         transformVector(const Vector3& v) const;            // rotate only
+    Matrix4         getMatrix() const;
+
+    // static functions
+    static DualQuaternion getDualQuaternion(const Matrix4& m);          // from rigid transform matrix
+    static DualQuaternion nlerp(const DualQuaternion& from, const DualQuaternion& to, float alpha); // linear blend
+
+    // operators
+    DualQuaternion  operator*(const DualQuaternion& rhs) const;         // composition, same order as Matrix4
+    DualQuaternion& operator*=(const DualQuaternion& rhs);
+    constexpr bool  operator==(const DualQuaternion& rhs) const;
+    constexpr bool  operator!=(const DualQuaternion& rhs) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const DualQuaternion& dq);
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inline functions for Quaternion
+///////////////////////////////////////////////////////////////////////////////
+inline Quaternion::Quaternion(const Vector3& axis, float angle)
+{
+    set(axis, angle);
+}
+
+constexpr Quaternion Quaternion::operator-() const {
+    return Quaternion(-s, -x, -y, -z);
+}
+
+constexpr Quaternion Quaternion::operator+(const Quaternion& rhs) const {
+    return Quaternion(s+rhs.s, x+rhs.x, y+rhs.y, z+rhs.z);
+}
+
+constexpr Quaternion Quaternion::operator-(const Quaternion& rhs) const {
+    return Quaternion(s-rhs.s, x-rhs.x, y-rhs.y, z-rhs.z);
+}
+
+constexpr Quaternion& Quaternion::operator+=(const Quaternion& rhs) {
+    s += rhs.s; x += rhs.x; y += rhs.y; z += rhs.z; return *this;
+}
+
+constexpr Quaternion& Quaternion::operator-=(const Quaternion& rhs) {
+    s -= rhs.s; x -= rhs.x; y -= rhs.y; z -= rhs.z; return *this;
+}
+
+constexpr Quaternion Quaternion::operator*(const float a) const {
+    return Quaternion(s*a, x*a, y*a, z*a);
+}
+
+inline Quaternion Quaternion::operator*(const Quaternion& rhs) const {
+    // s = s1*s2 - x1*x2 - y1*y2 - z1*z2
+    // x = s1*x2 + x1*s2 + y1*z2 - z1*y2
+    // y = s1*y2 - x1*z2 + y1*s2 + z1*x2
+    // z = s1*z2 + x1*y2 - y1*x2 + z1*s2
+#if defined(SIMD_FLOAT4)
+    simd4f a = simdLoad(&s);
+    simd4f b = simdLoad(&rhs.s);
+    simd4f r = simdMul(simdSplatX(a), b);
+    r = simdMadd(simdSplatY(a), simdMul(simdSwapPairs(b),  simdSet(-1, 1,-1, 1)), r);
+    r = simdMadd(simdSplatZ(a), simdMul(simdSwapHalves(b), simdSet(-1, 1, 1,-1)), r);
+    r = simdMadd(simdSplatW(a), simdMul(simdReverse(b),    simdSet(-1,-1, 1, 1)), r);
+    Quaternion q;
+    simdStore(&q.s, r);
+    return q;
+#else
+    return Quaternion(s*rhs.s - x*rhs.x - y*rhs.y - z*rhs.z,
+                      s*rhs.x + x*rhs.s + y*rhs.z - z*rhs.y,
+                      s*rhs.y - x*rhs.z + y*rhs.s + z*rhs.x,
+                      s*rhs.z + x*rhs.y - y*rhs.x + z*rhs.s);
+#endif
+}
+
+constexpr Quaternion& Quaternion::operator*=(const float a) {
+    s *= a; x *= a; y *= a; z *= a; return *this;
+}
+
+inline Quaternion& Quaternion::operator*=(const Quaternion& rhs) {
+    *this = *this * rhs; return *this;
+}
+
+constexpr bool Quaternion::operator==(const Quaternion& rhs) const {
+    return (s == rhs.s) && (x == rhs.x) && (y == rhs.y) && (z == rhs.z);
+}
+
+constexpr bool Quaternion::operator!=(const Quaternion& rhs) const {
+    return (s != rhs.s) || (x != rhs.x) || (y != rhs.y) || (z != rhs.z);
+}
+
+inline float Quaternion::operator[](int index) const {
+    return (&s)[index];
+}
+
+inline float& Quaternion::operator[](int index) {
+    return (&s)[index];
+}
+
+constexpr Quaternion& Quaternion::set(float s, float x, float y, float z) {
+    this->s = s; this->x = x; this->y = y; this->z = z; return *this;
+}
+
+inline Quaternion& Quaternion::set(const Vector3& axis, float angle) {
+    const float HALF_DEG2RAD = 0.5f * 3.141593f / 180.0f;
+    float a = angle * HALF_DEG2RAD;
+    float sine = sinf(a);
+    s = cosf(a);
+    x = axis.x * sine;
+    y = axis.y * sine;
+    z = axis.z * sine;
+    return *this;
+}
+
+constexpr Quaternion& Quaternion::identity() {
+    s = 1; x = y = z = 0; return *this;
+}
+
+inline float Quaternion::length() const {
+    return sqrtf(s*s + x*x + y*y + z*z);
+}
+
+inline Quaternion& Quaternion::normalize() {
+    float invLength = 1.0f / sqrtf(s*s + x*x + y*y + z*z);
+    s *= invLength;
+    x *= invLength;
+    y *= invLength;
+    z *= invLength;
+    return *this;
+}
+
+constexpr Quaternion& Quaternion::conjugate() {
+    x = -x; y = -y; z = -z; return *this;
+}
+
+inline Quaternion& Quaternion::invert() {
+    const float EPSILON = 0.00001f;
+    float d = s*s + x*x + y*y + z*z;
+    if(d < EPSILON)
+        return *this; // do nothing if it is zero
+
+    float invD = 1.0f / d;
+    s *= invD;
+    x *= -invD;
+    y *= -invD;
+    z *= -invD;
+    return *this;
+}
+
+constexpr float Quaternion::dot(const Quaternion& rhs) const {
+    return s*rhs.s + x*rhs.x + y*rhs.y + z*rhs.z;
+}
+
+inline Vector3 Quaternion::rotate(const Vector3& v) const {
+    // v' = v + s * t + u x t, where u = (x,y,z) and t = 2 * (u x v)
+    Vector3 u(x, y, z);
+    Vector3 t = u.cross(v) * 2.0f;
+    return v + t * s + u.cross(t);
+}
+
+inline bool Quaternion::equal(const Quaternion& rhs, float epsilon) const {
+    return fabs(s - rhs.s) < epsilon && fabs(x - rhs.x) < epsilon &&
+           fabs(y - rhs.y) < epsilon && fabs(z - rhs.z) < epsilon;
+}
+
+constexpr Quaternion operator*(const float a, const Quaternion& q) {
+    return Quaternion(a*q.s, a*q.x, a*q.y, a*q.z);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Quaternion& q) {
+    os << "(" << q.s << ", " << q.x << ", " << q.y << ", " << q.z << ")";
+    return os;
+}
+// END OF QUATERNION //////////////////////////////////////////////////////////
+
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inline functions for DualQuaternion
+///////////////////////////////////////////////////////////////////////////////
+inline DualQuaternion::DualQuaternion(const Quaternion& rotation, const Vector3& translation)
+{
+    set(rotation, translation);
+}
+
+inline DualQuaternion& DualQuaternion::set(const Quaternion& rotation, const Vector3& translation) {
+    real = rotation;
+    dual = Quaternion(0, translation.x, translation.y, translation.z) * rotation * 0.5f;
+    return *this;
+}
+
+inline DualQuaternion& DualQuaternion::identity() {
+    real.set(1, 0, 0, 0);
+    dual.set(0, 0, 0, 0);
+    return *this;
+}
+
+inline Quaternion DualQuaternion::getRotation() const {
+    return real;
+}
+
+inline Vector3 DualQuaternion::getTranslation() const {
+    // t = 2 * dual * conjugate(real)
+    Quaternion t = dual * Quaternion(real.s, -real.x, -real.y, -real.z);
+    return Vector3(2 * t.x, 2 * t.y, 2 * t.z);
+}
+
+inline Vector3 DualQuaternion::transformPoint(const Vector3& p) const {
+    return real.rotate(p) + getTranslation();
+}
+
+inline Vector3 DualQuaternion::transformVector(const Vector3& v) const {
+    return real.rotate(v);
+}
+
+inline DualQuaternion DualQuaternion::operator*(const DualQuaternion& rhs) const {
+    return DualQuaternion(real * rhs.real, real * rhs.dual + dual * rhs.real);
+}
+
+inline DualQuaternion& DualQuaternion::operator*=(const DualQuaternion& rhs) {
+    *this = *this * rhs; return *this;
+}
+
+constexpr bool DualQuaternion::operator==(const DualQuaternion& rhs) const {
+    return (real == rhs.real) && (dual == rhs.dual);
+}
+
+constexpr bool DualQuaternion::operator!=(const DualQuaternion& rhs) const {
+    return (real != rhs.real) || (dual != rhs.dual);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const DualQuaternion& dq) {
+    os << "[" << dq.real << ", " << dq.dual << "]";
+    return os;
+}
+// END OF DUALQUATERNION //////////////////////////////////////////////////////
+#endif
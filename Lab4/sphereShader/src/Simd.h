@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simd.h
+// ======
+// Thin wrapper of 4-wide float SIMD registers (SSE2 on x86, NEON on ARM64)
+// shared by the batch kernels of math and image classes.
+// If neither is available, SIMD_FLOAT4 is not defined and the callers must use
+// their scalar loops.
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef SIMD_H_DEF
+#define SIMD_H_DEF
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2   1
+#define SIMD_FLOAT4 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define SIMD_NEON   1
+#define SIMD_FLOAT4 1
+#include <arm_neon.h>
+#endif
+
+
+
+#if defined(SIMD_SSE2)
+///////////////////////////////////////////////////////////////////////////////
+// SSE2
+///////////////////////////////////////////////////////////////////////////////
+typedef __m128 simd4f;
+
+inline simd4f simdLoad(const float* p)                  { return _mm_loadu_ps(p); }
+inline void   simdStore(float* p, simd4f a)             { _mm_storeu_ps(p, a); }
+inline simd4f simdSet1(float s)                         { return _mm_set1_ps(s); }
+inline simd4f simdSet(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline simd4f simdAdd(simd4f a, simd4f b)               { return _mm_add_ps(a, b); }
+inline simd4f simdSub(simd4f a, simd4f b)               { return _mm_sub_ps(a, b); }
+inline simd4f simdMul(simd4f a, simd4f b)               { return _mm_mul_ps(a, b); }
+inline simd4f simdDiv(simd4f a, simd4f b)               { return _mm_div_ps(a, b); }
+inline simd4f simdMadd(simd4f a, simd4f b, simd4f c)    { return _mm_add_ps(_mm_mul_ps(a, b), c); } // a*b+c
+inline simd4f simdMin(simd4f a, simd4f b)               { return _mm_min_ps(a, b); }
+inline simd4f simdMax(simd4f a, simd4f b)               { return _mm_max_ps(a, b); }
+inline simd4f simdSqrt(simd4f a)                        { return _mm_sqrt_ps(a); }
+inline simd4f simdSplatX(simd4f a)                      { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(0,0,0,0)); }
+inline simd4f simdSplatY(simd4f a)                      { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(1,1,1,1)); }
+inline simd4f simdSplatZ(simd4f a)                      { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2,2,2,2)); }
+inline simd4f simdSplatW(simd4f a)                      { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3,3,3,3)); }
+inline simd4f simdSwapPairs(simd4f a)                   { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2,3,0,1)); } // (y,x,w,z)
+inline simd4f simdSwapHalves(simd4f a)                  { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(1,0,3,2)); } // (z,w,x,y)
+inline simd4f simdReverse(simd4f a)                     { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(0,1,2,3)); } // (w,z,y,x)
+
+// approximate 1/sqrt(a): estimate (12 bits) refined by 1 Newton-Raphson step
+// y = y * (1.5 - 0.5 * a * y * y), max relative error is about 2.7e-7
+// Zero lanes keep the estimate (inf), the step would make them NaN (0 * inf).
+inline simd4f simdInvSqrtFast(simd4f a)
+{
+    simd4f y = _mm_rsqrt_ps(a);
+    simd4f ayy = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), a), y), y);
+    simd4f r = _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), ayy));
+    simd4f zero = _mm_cmpeq_ps(a, _mm_setzero_ps());
+    return _mm_or_ps(_mm_and_ps(zero, y), _mm_andnot_ps(zero, r));
+}
+
+// compare and mask, each lane of mask is all 1s (true) or all 0s (false)
+inline simd4f simdCmpGe(simd4f a, simd4f b)             { return _mm_cmpge_ps(a, b); }
+inline simd4f simdAnd(simd4f a, simd4f b)               { return _mm_and_ps(a, b); }
+inline int    simdMoveMask(simd4f mask)                 { return _mm_movemask_ps(mask); } // bit i = lane i
+
+// store x, y, z only (the 4th float in memory is untouched)
+inline void simdStore3(float* p, simd4f a)
+{
+    _mm_storel_pi((__m64*)p, a);
+    _mm_store_ss(p + 2, _mm_movehl_ps(a, a));
+}
+
+#elif defined(SIMD_NEON)
+///////////////////////////////////////////////////////////////////////////////
+// NEON (AArch64)
+///////////////////////////////////////////////////////////////////////////////
+typedef float32x4_t simd4f;
+
+inline simd4f simdLoad(const float* p)                  { return vld1q_f32(p); }
+inline void   simdStore(float* p, simd4f a)             { vst1q_f32(p, a); }
+inline simd4f simdSet1(float s)                         { return vdupq_n_f32(s); }
+inline simd4f simdSet(float x, float y, float z, float w) { float t[4] = {x, y, z, w}; return vld1q_f32(t); }
+inline simd4f simdAdd(simd4f a, simd4f b)               { return vaddq_f32(a, b); }
+inline simd4f simdSub(simd4f a, simd4f b)               { return vsubq_f32(a, b); }
+inline simd4f simdMul(simd4f a, simd4f b)               { return vmulq_f32(a, b); }
+inline simd4f simdDiv(simd4f a, simd4f b)               { return vdivq_f32(a, b); }
+inline simd4f simdMadd(simd4f a, simd4f b, simd4f c)    { return vmlaq_f32(c, a, b); }          // a*b+c
+inline simd4f simdMin(simd4f a, simd4f b)               { return vminq_f32(a, b); }
+inline simd4f simdMax(simd4f a, simd4f b)               { return vmaxq_f32(a, b); }
+inline simd4f simdSqrt(simd4f a)                        { return vsqrtq_f32(a); }
+inline simd4f simdSplatX(simd4f a)                      { return vdupq_laneq_f32(a, 0); }
+inline simd4f simdSplatY(simd4f a)                      { return vdupq_laneq_f32(a, 1); }
+inline simd4f simdSplatZ(simd4f a)                      { return vdupq_laneq_f32(a, 2); }
+inline simd4f simdSplatW(simd4f a)                      { return vdupq_laneq_f32(a, 3); }
+inline simd4f simdSwapPairs(simd4f a)                   { return vrev64q_f32(a); }                  // (y,x,w,z)
+inline simd4f simdSwapHalves(simd4f a)                  { return vextq_f32(a, a, 2); }              // (z,w,x,y)
+inline simd4f simdReverse(simd4f a)                     { return vrev64q_f32(vextq_f32(a, a, 2)); } // (w,z,y,x)
+
+// approximate 1/sqrt(a): the NEON estimate has only ~8 bits, so it needs 2
+// Newton-Raphson steps to reach the same accuracy as SSE with 1 step
+// Zero lanes keep the estimate (inf), the steps would make them NaN (0 * inf).
+inline simd4f simdInvSqrtFast(simd4f a)
+{
+    simd4f y0 = vrsqrteq_f32(a);
+    simd4f y = vmulq_f32(y0, vrsqrtsq_f32(vmulq_f32(a, y0), y0));  // y * (3 - a*y*y) / 2
+    y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a, y), y));
+    return vbslq_f32(vceqzq_f32(a), y0, y);
+}
+
+// compare and mask, each lane of mask is all 1s (true) or all 0s (false)
+inline simd4f simdCmpGe(simd4f a, simd4f b)             { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+inline simd4f simdAnd(simd4f a, simd4f b)               { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline int    simdMoveMask(simd4f mask)                                                 // bit i = lane i
+{
+    const int32_t shifts[4] = {0, 1, 2, 3};
+    uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(mask), 31);
+    return (int)vaddvq_u32(vshlq_u32(bits, vld1q_s32(shifts)));
+}
+
+// store x, y, z only (the 4th float in memory is untouched)
+inline void simdStore3(float* p, simd4f a)
+{
+    vst1_f32(p, vget_low_f32(a));
+    vst1q_lane_f32(p + 2, a, 2);
+}
+
+#endif
+
+#endif // SIMD_H_DEF
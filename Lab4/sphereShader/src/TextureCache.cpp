@@ -0,0 +1,478 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureCache.cpp
+// ================
+// cache of decoded textures in memory and on disk
+// A cache file is a header, the source file name, a table of levels, then the
+// data of all levels from a 16-byte aligned offset. It is written to a
+// temporary file first and renamed, so another run never maps a partial file.
+//
+// Dependencies: BlockCompress, MappedFile, MipChain
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(WIN32) || defined(_WIN32)
+#include <direct.h>
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include "TextureCache.h"
+#include "MipChain.h"
+
+namespace Image
+{
+
+// increase if the file layout changes
+const unsigned int CACHE_VERSION = 2;
+const char CACHE_MAGIC[4] = { 'T', 'X', 'C', 'H' };
+
+struct CacheHeader
+{
+    char magic[4];
+    unsigned int version;
+    unsigned int options;
+    int width;                                      // scaled size, 0 if not scaled
+    int height;
+    unsigned int nameLength;                        // source file name, not terminated
+    long long modifiedTime;
+    long long fileSize;
+    int channelCount;
+    int compressed;
+    int blockFormat;
+    int levelCount;
+};
+
+struct CacheLevel
+{
+    int width;
+    int height;
+    unsigned long long offset;                      // from the beginning of the file
+    unsigned long long size;
+};
+
+// offset of level data after the header, name and level table
+static std::size_t getDataOffset(std::size_t nameLength, int levelCount)
+{
+    std::size_t offset = sizeof(CacheHeader) + nameLength + sizeof(CacheLevel) * levelCount;
+    return (offset + 15) & ~(std::size_t)15;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TextureBlob
+///////////////////////////////////////////////////////////////////////////////
+TextureBlob::TextureBlob() : channelCount(0), compressed(false), blockFormat(BLOCK_BC1), data(0)
+{
+}
+
+void TextureBlob::set(const MipChain& mips)
+{
+    channelCount = mips.getChannelCount();
+    compressed = false;
+    levels.clear();
+    for(int i = 0; i < mips.getLevelCount(); ++i)
+    {
+        Level level = { mips.getWidth(i), mips.getHeight(i),
+                        (std::size_t)(mips.getData(i) - mips.getBuffer()), mips.getDataSize(i) };
+        levels.push_back(level);
+    }
+    file.close();
+    buffer.assign(mips.getBuffer(), mips.getBuffer() + mips.getBufferSize());
+    data = buffer.empty() ? 0 : &buffer[0];
+}
+
+void TextureBlob::set(const CompressedChain& chain)
+{
+    compressed = true;
+    blockFormat = chain.getFormat();
+    channelCount = (blockFormat == BLOCK_BC4) ? 1 : (blockFormat == BLOCK_BC3 ? 4 : 3);
+    levels.clear();
+    for(int i = 0; i < chain.getLevelCount(); ++i)
+    {
+        Level level = { chain.getWidth(i), chain.getHeight(i),
+                        (std::size_t)(chain.getData(i) - chain.getBuffer()), chain.getDataSize(i) };
+        levels.push_back(level);
+    }
+    file.close();
+    buffer.assign(chain.getBuffer(), chain.getBuffer() + chain.getBufferSize());
+    data = buffer.empty() ? 0 : &buffer[0];
+}
+
+std::size_t TextureBlob::getSize() const
+{
+    std::size_t size = 0;
+    for(std::size_t i = 0; i < levels.size(); ++i)
+        size += levels[i].size;
+    return size;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ctor
+///////////////////////////////////////////////////////////////////////////////
+TextureCache::TextureCache(std::size_t memoryBudget)
+    : memoryBudget(memoryBudget), memorySize(0), memoryHitCount(0), diskHitCount(0), missCount(0),
+      tempCount(0), errorMessage("No error.")
+{
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// set the directory of cache files, and create it if needed
+// Call it before find() and insert() are used by other threads.
+///////////////////////////////////////////////////////////////////////////////
+bool TextureCache::setDirectory(const char* directory)
+{
+    this->directory.clear();
+    errorMessage = "No error.";
+    if(!directory || directory[0] == '\0')
+        return true;
+
+#if defined(WIN32) || defined(_WIN32)
+    int result = _mkdir(directory);
+#else
+    int result = mkdir(directory, 0755);
+#endif
+    if(result != 0 && errno != EEXIST)
+    {
+        errorMessage = "Failed to create the cache directory.";
+        return false;
+    }
+
+    this->directory = directory;
+    char last = this->directory[this->directory.size() - 1];
+    if(last != '/' && last != '\\')
+        this->directory += '/';
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// key with the modified time and size of the file
+///////////////////////////////////////////////////////////////////////////////
+bool TextureCache::getKey(const char* fileName, unsigned int options, int width, int height, Key& key)
+{
+    struct stat status;
+    if(!fileName || stat(fileName, &status) != 0)
+        return false;
+
+    key.fileName = fileName;
+    key.options = options;
+    key.width = width;
+    key.height = height;
+    key.modifiedTime = (long long)status.st_mtime;
+    key.fileSize = (long long)status.st_size;
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// find the blob of the key in memory, then in the disk cache
+// A blob of an older version of the file is dropped.
+///////////////////////////////////////////////////////////////////////////////
+std::shared_ptr<const TextureBlob> TextureCache::find(const Key& key)
+{
+    std::string id = getId(key);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::string, EntryList::iterator>::iterator found = entryMap.find(id);
+        if(found != entryMap.end())
+        {
+            EntryList::iterator entry = found->second;
+            if(entry->key.modifiedTime == key.modifiedTime && entry->key.fileSize == key.fileSize)
+            {
+                entries.splice(entries.begin(), entries, entry);   // most recently used
+                ++memoryHitCount;
+                return entry->blob;
+            }
+            memorySize -= entry->blob->getSize();
+            entries.erase(entry);
+            entryMap.erase(found);
+        }
+    }
+
+    // map the cache file out of the lock, other threads may use the memory cache
+    std::shared_ptr<const TextureBlob> blob;
+    if(!directory.empty())
+        blob = readFile(key);
+    if(!blob)
+    {
+        ++missCount;
+        return blob;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    addEntry(id, key, blob);
+    ++diskHitCount;
+    return blob;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// add the blob to memory, then write it to the disk cache
+///////////////////////////////////////////////////////////////////////////////
+void TextureCache::insert(const Key& key, const std::shared_ptr<const TextureBlob>& blob)
+{
+    if(!blob)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        addEntry(getId(key), key, blob);
+    }
+
+    if(!directory.empty() && !blob->isMapped())
+        writeFile(key, *blob);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// remove the entry of the file and options, and its cache file
+///////////////////////////////////////////////////////////////////////////////
+void TextureCache::remove(const Key& key)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::string, EntryList::iterator>::iterator found = entryMap.find(getId(key));
+        if(found != entryMap.end())
+        {
+            memorySize -= found->second->blob->getSize();
+            entries.erase(found->second);
+            entryMap.erase(found);
+        }
+    }
+
+    if(!directory.empty())
+        std::remove(getCacheFileName(key).c_str());
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// drop all blobs in memory, the cache files are kept
+///////////////////////////////////////////////////////////////////////////////
+void TextureCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    entryMap.clear();
+    memorySize = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// set the max size of blobs in memory, and drop the LRU blobs over it
+///////////////////////////////////////////////////////////////////////////////
+void TextureCache::setMemoryBudget(std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    memoryBudget = bytes;
+    evict();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// id of an entry: the file name, options and size
+///////////////////////////////////////////////////////////////////////////////
+std::string TextureCache::getId(const Key& key)
+{
+    char options[48];
+    snprintf(options, sizeof(options), "|%08x|%dx%d", key.options, key.width, key.height);
+    return key.fileName + options;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// cache file name from 64-bit FNV-1a hash of the id
+///////////////////////////////////////////////////////////////////////////////
+std::string TextureCache::getCacheFileName(const Key& key) const
+{
+    std::string id = getId(key);
+    unsigned long long hash = 14695981039346656037ull;
+    for(std::size_t i = 0; i < id.size(); ++i)
+    {
+        hash ^= (unsigned char)id[i];
+        hash *= 1099511628211ull;
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.tex", hash);
+    return directory + name;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// map the cache file of the key, null if it does not exist, is outdated or
+// is broken
+///////////////////////////////////////////////////////////////////////////////
+std::shared_ptr<const TextureBlob> TextureCache::readFile(const Key& key)
+{
+    std::shared_ptr<TextureBlob> blob(new TextureBlob);
+    if(!blob->file.open(getCacheFileName(key).c_str()))
+        return std::shared_ptr<const TextureBlob>();
+
+    const unsigned char* data = blob->file.getData();
+    std::size_t size = blob->file.getSize();
+    if(size < sizeof(CacheHeader))
+        return std::shared_ptr<const TextureBlob>();
+
+    CacheHeader header;
+    memcpy(&header, data, sizeof(header));
+    if(memcmp(header.magic, CACHE_MAGIC, 4) != 0 || header.version != CACHE_VERSION ||
+       header.options != key.options || header.width != key.width || header.height != key.height ||
+       header.modifiedTime != key.modifiedTime ||
+       header.fileSize != key.fileSize || header.nameLength != key.fileName.size() ||
+       (header.channelCount != 1 && header.channelCount != 3 && header.channelCount != 4) ||
+       header.blockFormat < BLOCK_BC1 || header.blockFormat > BLOCK_BC4 ||
+       header.levelCount <= 0 || header.levelCount > 32 ||
+       size < getDataOffset(header.nameLength, header.levelCount) ||
+       memcmp(data + sizeof(header), key.fileName.data(), header.nameLength) != 0)
+    {
+        return std::shared_ptr<const TextureBlob>();    // hash collision or other version
+    }
+
+    blob->channelCount = header.channelCount;
+    blob->compressed = header.compressed != 0;
+    blob->blockFormat = (BlockFormat)header.blockFormat;
+    const unsigned char* table = data + sizeof(header) + header.nameLength;
+    for(int i = 0; i < header.levelCount; ++i)
+    {
+        CacheLevel cacheLevel;
+        memcpy(&cacheLevel, table + i * sizeof(CacheLevel), sizeof(CacheLevel));
+
+        // the level must be in the file and of the right size
+        std::size_t expected = blob->compressed ? getBlockDataSize(blob->blockFormat, cacheLevel.width, cacheLevel.height)
+                                                : (std::size_t)cacheLevel.width * cacheLevel.height * blob->channelCount;
+        if(cacheLevel.width <= 0 || cacheLevel.height <= 0 || cacheLevel.size != expected ||
+           cacheLevel.offset > size || cacheLevel.size > size - cacheLevel.offset)
+        {
+            return std::shared_ptr<const TextureBlob>();
+        }
+
+        TextureBlob::Level level = { cacheLevel.width, cacheLevel.height,
+                                     (std::size_t)cacheLevel.offset, (std::size_t)cacheLevel.size };
+        blob->levels.push_back(level);
+    }
+    blob->data = data;
+    return blob;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// write the blob to a temporary file, then rename it to the cache file
+///////////////////////////////////////////////////////////////////////////////
+bool TextureCache::writeFile(const Key& key, const TextureBlob& blob)
+{
+    std::string fileName = getCacheFileName(key);
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%d.tmp", ++tempCount);
+    std::string tempName = fileName + suffix;
+
+    FILE* file = fopen(tempName.c_str(), "wb");
+    if(!file)
+        return false;
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, 4);
+    header.version = CACHE_VERSION;
+    header.options = key.options;
+    header.width = key.width;
+    header.height = key.height;
+    header.nameLength = (unsigned int)key.fileName.size();
+    header.modifiedTime = key.modifiedTime;
+    header.fileSize = key.fileSize;
+    header.channelCount = blob.channelCount;
+    header.compressed = blob.compressed ? 1 : 0;
+    header.blockFormat = (int)blob.blockFormat;
+    header.levelCount = blob.getLevelCount();
+
+    // the levels are written in order right after the table
+    std::size_t dataOffset = getDataOffset(key.fileName.size(), blob.getLevelCount());
+    std::vector<CacheLevel> table(blob.getLevelCount());
+    std::size_t offset = dataOffset;
+    for(int i = 0; i < blob.getLevelCount(); ++i)
+    {
+        table[i].width = blob.getWidth(i);
+        table[i].height = blob.getHeight(i);
+        table[i].offset = offset;
+        table[i].size = blob.getDataSize(i);
+        offset += blob.getDataSize(i);
+    }
+
+    const char zeros[16] = {0};
+    std::size_t padding = dataOffset - (sizeof(header) + key.fileName.size() + sizeof(CacheLevel) * table.size());
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(key.fileName.data(), 1, key.fileName.size(), file) == key.fileName.size() &&
+                   fwrite(&table[0], sizeof(CacheLevel), table.size(), file) == table.size() &&
+                   fwrite(zeros, 1, padding, file) == padding;
+    for(int i = 0; i < blob.getLevelCount() && written; ++i)
+        written = fwrite(blob.getData(i), 1, blob.getDataSize(i), file) == blob.getDataSize(i);
+    written = (fclose(file) == 0) && written;
+
+#if defined(WIN32) || defined(_WIN32)
+    // rename() does not replace an existing file on Windows
+    if(written)
+        std::remove(fileName.c_str());
+#endif
+    if(!written || std::rename(tempName.c_str(), fileName.c_str()) != 0)
+    {
+        std::remove(tempName.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// add a blob as most recently used, then drop the LRU blobs over the budget
+// A blob larger than the budget is not kept. The mutex must be locked.
+///////////////////////////////////////////////////////////////////////////////
+void TextureCache::addEntry(const std::string& id, const Key& key, const std::shared_ptr<const TextureBlob>& blob)
+{
+    std::unordered_map<std::string, EntryList::iterator>::iterator found = entryMap.find(id);
+    if(found != entryMap.end())
+    {
+        memorySize -= found->second->blob->getSize();
+        entries.erase(found->second);
+        entryMap.erase(found);
+    }
+
+    std::size_t size = blob->getSize();
+    if(size > memoryBudget)
+        return;
+
+    Entry entry = { id, key, blob };
+    entries.push_front(entry);
+    entryMap[id] = entries.begin();
+    memorySize += size;
+    evict();
+}
+
+void TextureCache::evict()
+{
+    while(memorySize > memoryBudget && !entries.empty())
+    {
+        memorySize -= entries.back().blob->getSize();
+        entryMap.erase(entries.back().id);
+        entries.pop_back();
+    }
+}
+
+} // namespace Image
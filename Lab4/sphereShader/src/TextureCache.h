@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureCache.h
+// ==============
+// cache of decoded textures in memory and on disk, so the same image file is
+// decoded, mipmapped and compressed only once
+// An entry is found by Key: the file name, caller-defined options (how it was
+// decoded, e.g. channel order or compression) and the size it was scaled to,
+// and the modified time and size of the file, so an edited file is decoded
+// again.
+//
+// Memory: TextureBlobs are kept in LRU order, and the least recently used ones
+// are dropped when the total size is over getMemoryBudget(). The blobs are
+// shared, so a dropped blob stays valid while the caller holds it.
+// Disk: with setDirectory(), insert() also writes the blob to a file named by
+// the hash of the file name, options and size, and find() maps it on a later run
+// with MappedFile, so the levels are used in place without reading or decoding.
+// A file is replaced when the source file changes. Cache files are in native
+// byte order, not meant to be shared between machines.
+//
+// find() and insert() can be called from multiple threads.
+//
+// Dependencies: BlockCompress, MappedFile, MipChain
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef IMAGE_TEXTURE_CACHE_H
+#define IMAGE_TEXTURE_CACHE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include "BlockCompress.h"
+#include "MappedFile.h"
+
+namespace Image
+{
+    class MipChain;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // all levels of a texture, raw pixels or compressed blocks, in a buffer or
+    // in a mapped cache file
+    ///////////////////////////////////////////////////////////////////////////
+    class TextureBlob
+    {
+    public:
+        TextureBlob();
+
+        void set(const MipChain& mips);             // copy raw levels
+        void set(const CompressedChain& chain);     // copy compressed levels
+
+        int  getChannelCount() const                { return channelCount; }
+        bool isCompressed() const                   { return compressed; }
+        BlockFormat getBlockFormat() const          { return blockFormat; }
+        bool isMapped() const                       { return file.isOpen(); }
+
+        int  getLevelCount() const                  { return (int)levels.size(); }
+        int  getWidth(int level) const              { return levels[level].width; }
+        int  getHeight(int level) const             { return levels[level].height; }
+        const unsigned char* getData(int level) const { return data + levels[level].offset; }
+        std::size_t getDataSize(int level) const    { return levels[level].size; }
+        std::size_t getSize() const;                // all levels
+
+    private:
+        friend class TextureCache;
+
+        struct Level
+        {
+            int width;
+            int height;
+            std::size_t offset;                     // from data
+            std::size_t size;
+        };
+
+        int channelCount;
+        bool compressed;
+        BlockFormat blockFormat;
+        std::vector<Level> levels;
+        std::vector<unsigned char> buffer;          // empty if mapped
+        MappedFile file;
+        const unsigned char* data;                  // buffer or mapped file
+    };
+
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    class TextureCache
+    {
+    public:
+        struct Key
+        {
+            std::string fileName;
+            unsigned int options;                   // defined by the caller
+            int width;                              // scaled size, 0 if not scaled
+            int height;
+            long long modifiedTime;                 // of the file, in seconds
+            long long fileSize;
+        };
+
+        explicit TextureCache(std::size_t memoryBudget=128*1024*1024);
+
+        // directory of the cache files, created if it does not exist
+        // An empty string (default) disables the disk cache.
+        bool setDirectory(const char* directory);
+        const char* getDirectory() const            { return directory.c_str(); }
+
+        // key of the current file, false if the file does not exist
+        // width and height are the size the image is scaled to, 0 if not scaled.
+        static bool getKey(const char* fileName, unsigned int options, int width, int height, Key& key);
+
+        // blob from memory or the disk, null if not cached or outdated
+        std::shared_ptr<const TextureBlob> find(const Key& key);
+
+        // add a blob to memory and write it to the disk cache
+        // The blob must not be changed after this.
+        void insert(const Key& key, const std::shared_ptr<const TextureBlob>& blob);
+
+        void remove(const Key& key);                // from memory and disk
+        void clear();                               // memory only, keeps cache files
+
+        void setMemoryBudget(std::size_t bytes);
+        std::size_t getMemoryBudget() const         { return memoryBudget; }
+        std::size_t getMemorySize() const           { return memorySize; }    // of blobs in memory
+        int  getMemoryHitCount() const              { return memoryHitCount; }
+        int  getDiskHitCount() const                { return diskHitCount; }
+        int  getMissCount() const                   { return missCount; }
+        const char* getError() const                { return errorMessage.c_str(); }
+
+    private:
+        TextureCache(const TextureCache&);          // not copyable
+        TextureCache& operator=(const TextureCache&);
+
+        struct Entry
+        {
+            std::string id;                         // file name, options and size
+            Key key;
+            std::shared_ptr<const TextureBlob> blob;
+        };
+        typedef std::list<Entry> EntryList;
+
+        static std::string getId(const Key& key);
+        std::string getCacheFileName(const Key& key) const;
+        std::shared_ptr<const TextureBlob> readFile(const Key& key);
+        bool writeFile(const Key& key, const TextureBlob& blob);
+        void addEntry(const std::string& id, const Key& key, const std::shared_ptr<const TextureBlob>& blob);
+        void evict();
+
+        std::atomic<std::size_t> memoryBudget;
+        std::atomic<std::size_t> memorySize;
+        std::string directory;
+        EntryList entries;                          // most recently used first
+        std::unordered_map<std::string, EntryList::iterator> entryMap;
+        std::mutex mutex;
+        std::atomic<int> memoryHitCount;
+        std::atomic<int> diskHitCount;
+        std::atomic<int> missCount;
+        std::atomic<int> tempCount;                 // for unique temporary file names
+        std::string errorMessage;                   // of setDirectory()
+    };
+}
+
+#endif // IMAGE_TEXTURE_CACHE_H
@@ -0,0 +1,635 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureLoader.cpp
+// =================
+// asynchronous texture loader
+//
+// Dependencies: GLAD, BlockCompress, ImageLoader, MipChain, TextureCache, ThreadPool
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <thread>
+#include <cstring>
+#include <cmath>
+#include "TextureLoader.h"
+#include "ThreadPool.h"
+#include "ImageLoader.h"
+#include "MipChain.h"
+
+// GL_EXT_texture_compression_s3tc, not in the core profile of glad
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT     0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT    0x83F3
+#endif
+
+// OpenGL formats of 1, 3 and 4-channel BMP images decoded in BGR order
+static void getFormats(int channelCount, GLint& internalFormat, GLenum& format)
+{
+    if(channelCount == 1)
+    {
+        internalFormat = GL_R8;     // swizzled to gray in all channels
+        format = GL_RED;
+    }
+    else if(channelCount == 3)
+    {
+        internalFormat = GL_RGB8;
+        format = GL_BGR;
+    }
+    else
+    {
+        internalFormat = GL_RGBA8;
+        format = GL_BGRA;
+    }
+}
+
+// OpenGL format of compressed blocks
+static GLenum getCompressedFormat(Image::BlockFormat format)
+{
+    if(format == Image::BLOCK_BC4)
+        return GL_COMPRESSED_RED_RGTC1;
+    else if(format == Image::BLOCK_BC3)
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
+
+// video memory of all levels of a texture
+static std::size_t getChainSize(int width, int height, int channelCount, bool compressed)
+{
+    std::size_t size = 0;
+    while(true)
+    {
+        if(compressed)
+            size += Image::getBlockDataSize(Image::getBlockFormat(channelCount), width, height);
+        else
+            size += (std::size_t)width * height * channelCount;
+        if(width == 1 && height == 1)
+            break;
+        width = (width > 1) ? width / 2 : 1;
+        height = (height > 1) ? height / 2 : 1;
+    }
+    return size;
+}
+
+static bool hasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for(int i = 0; i < count; ++i)
+    {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if(extension && strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ctor/dtor
+///////////////////////////////////////////////////////////////////////////////
+TextureLoader::TextureLoader(int threadCount, int uploadBudget)
+    : pool(0), threadCount(threadCount), uploadBudget(uploadBudget), pendingCount(0),
+      compression(false), quality(Image::QUALITY_NORMAL), s3tcSupported(-1), maxSize(0), maxBytes(0),
+      cache(0), placeholder(0), loaded(0)
+{
+    // leave a core for the render thread
+    if(this->threadCount <= 0)
+        this->threadCount = (int)std::thread::hardware_concurrency() - 1;
+    if(this->threadCount > 4)
+        this->threadCount = 4;
+    if(this->threadCount < 1)
+        this->threadCount = 1;
+}
+
+TextureLoader::~TextureLoader()
+{
+    deleteJobs(false);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// create a handle and queue the file to decode
+// The texture is created later by update(), after the image is decoded.
+///////////////////////////////////////////////////////////////////////////////
+int TextureLoader::load(const char* fileName, bool wrap)
+{
+    if(!placeholder)
+        initPlaceholder();
+    if(!pool)
+        pool = new ThreadPool(threadCount);
+    if(compression && s3tcSupported < 0)
+        s3tcSupported = hasExtension("GL_EXT_texture_compression_s3tc") ? 1 : 0;
+
+    Entry entry;
+    entry.texture = 0;
+    entry.state = STATE_LOADING;
+    entries.push_back(entry);
+    ++pendingCount;
+
+    Job* job = new Job;
+    job->handle = (int)entries.size() - 1;
+    job->fileName = fileName;
+    job->wrap = wrap;
+    job->failed = false;
+    job->compressColor = compression && s3tcSupported == 1;
+    job->compressGray = compression;
+    job->quality = quality;
+    job->maxSize = maxSize;
+    job->maxBytes = maxBytes;
+    job->width = job->height = 0;
+    job->cache = cache;
+    job->texture = 0;
+    job->level = 0;
+    job->uploadedRows = 0;
+    job->next = 0;
+    pool->submit([this, job]() { decode(job); });
+
+    return job->handle;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// find the image in the cache, or decode it in a worker and add it to the
+// cache, then push the job to the loaded list
+// The cache options are the compression flags and quality of the job, which
+// decide the channel order and the format of the levels. The size after the
+// limits (0 if not downscaled) goes in the key as it is.
+///////////////////////////////////////////////////////////////////////////////
+void TextureLoader::decode(Job* job)
+{
+    if(job->maxSize > 0 || job->maxBytes > 0)
+        limitSize(job);
+
+    unsigned int options = (job->compressColor ? 1 : 0) | (job->compressGray ? 2 : 0) | (job->quality << 2);
+    Image::TextureCache::Key key;
+    bool cached = job->cache && Image::TextureCache::getKey(job->fileName.c_str(), options, job->width, job->height, key);
+    if(cached)
+        job->image = job->cache->find(key);
+
+    if(!job->image)
+    {
+        std::shared_ptr<Image::TextureBlob> image(new Image::TextureBlob);
+        if(decodeImage(job, *image))
+        {
+            job->image = image;
+            if(cached)
+                job->cache->insert(key, image);
+        }
+        else
+        {
+            job->failed = true;
+        }
+    }
+
+    Job* head = loaded.load(std::memory_order_relaxed);
+    do
+    {
+        job->next = head;
+    }
+    while(!loaded.compare_exchange_weak(head, job, std::memory_order_release, std::memory_order_relaxed));
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// read the header of the file and set the size of the job if the image is
+// over the limits
+// The scale fits the longer side to maxSize, then shrinks by the square root
+// of the bytes over maxBytes (at least 1%) until all levels fit. A file that
+// cannot be opened is left to decodeImage() to report.
+///////////////////////////////////////////////////////////////////////////////
+void TextureLoader::limitSize(Job* job)
+{
+    Image::ImageLoader loader;
+    if(!loader.open(job->fileName.c_str()))
+        return;
+    const int width = loader.getWidth();
+    const int height = loader.getHeight();
+    const int channelCount = loader.getChannelCount();
+    const bool compressed = (channelCount == 1) ? job->compressGray : job->compressColor;
+
+    double scale = 1.0;
+    int longer = (width > height) ? width : height;
+    if(job->maxSize > 0 && longer > job->maxSize)
+        scale = (double)job->maxSize / longer;
+
+    int w, h;
+    while(true)
+    {
+        w = (int)(width * scale + 0.5);
+        h = (int)(height * scale + 0.5);
+        w = (w < 1) ? 1 : (job->maxSize > 0 && w > job->maxSize ? job->maxSize : w);
+        h = (h < 1) ? 1 : (job->maxSize > 0 && h > job->maxSize ? job->maxSize : h);
+        if(job->maxBytes == 0 || (w == 1 && h == 1))
+            break;
+        std::size_t size = getChainSize(w, h, channelCount, compressed);
+        if(size <= job->maxBytes)
+            break;
+        double shrink = sqrt((double)job->maxBytes / size);
+        scale *= (shrink < 0.99) ? shrink : 0.99;
+    }
+
+    if(w != width || h != height)
+    {
+        job->width = w;
+        job->height = h;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// decode the file into level 0 of the mipmaps, then build the other levels
+// (and compress them)
+// Colors are filtered in linear space, but 8-bit gray is often a mask or a
+// height map, so it is filtered as is. The block encoders take RGB order, so
+// the image is read in RGB order if it will be compressed.
+// An image over the limits is decoded into a buffer first, and downscaled
+// into level 0 by the threads of the pool.
+///////////////////////////////////////////////////////////////////////////////
+bool TextureLoader::decodeImage(Job* job, Image::TextureBlob& image)
+{
+    Image::ImageLoader loader;
+    Image::Bmp::ChannelOrder order = job->compressColor ? Image::Bmp::ORDER_RGB : Image::Bmp::ORDER_BGR;
+    if(!loader.open(job->fileName.c_str(), order))
+    {
+        job->error = loader.getError();
+        return false;
+    }
+
+    // decode into level 0 of the mipmaps directly if it is not downscaled
+    int channelCount = loader.getChannelCount();
+    bool downscale = job->width > 0;
+    Image::MipChain mips;
+    unsigned char* level0 = mips.allocate(downscale ? job->width : loader.getWidth(),
+                                          downscale ? job->height : loader.getHeight(), channelCount);
+    if(!level0)
+    {
+        job->error = mips.getError();
+        return false;
+    }
+
+    std::vector<unsigned char> source;
+    if(downscale)
+        source.resize(loader.getDataSize());
+    if(!loader.decode(downscale ? &source[0] : level0, downscale ? source.size() : mips.getDataSize(0)))
+    {
+        job->error = loader.getError();
+        return false;
+    }
+    if(downscale)
+    {
+        Image::MipChain::resample(&source[0], loader.getWidth(), loader.getHeight(), channelCount,
+                                  level0, job->width, job->height,
+                                  Image::MipChain::FILTER_LANCZOS3, channelCount > 1, pool);
+    }
+    loader.close();
+    mips.buildLevels(Image::MipChain::FILTER_BOX, channelCount > 1);
+
+    if(channelCount == 1 ? job->compressGray : job->compressColor)
+    {
+        Image::CompressedChain blocks;
+        if(!blocks.build(mips, Image::getBlockFormat(channelCount), job->quality))
+        {
+            job->error = blocks.getError();
+            return false;
+        }
+        image.set(blocks);
+    }
+    else
+    {
+        image.set(mips);
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// upload the decoded images, call it once per frame
+// It uploads at most uploadBudget bytes, but at least one row per call, so a
+// texture larger than the budget is finished over several frames.
+///////////////////////////////////////////////////////////////////////////////
+int TextureLoader::update()
+{
+    collectLoaded();
+    if(uploads.empty())
+        return 0;
+
+    // BMP rows are packed, restore the alignment after upload
+    GLint alignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    int finishedCount = 0;
+    const int maxBudget = uploadBudget > 0 ? uploadBudget : 0x7fffffff;
+    int budget = maxBudget;
+    while(!uploads.empty() && budget > 0)
+    {
+        Job* job = uploads.front();
+        Entry& entry = entries[job->handle];
+
+        if(job->failed)
+        {
+            entry.state = STATE_FAILED;
+            entry.error = job->error;
+        }
+        else
+        {
+            entry.state = STATE_UPLOADING;
+            while(job->level < job->image->getLevelCount() && budget > 0)
+            {
+                int bytes = job->image->isCompressed() ? uploadBlocks(job, budget, budget == maxBudget)
+                                            : uploadRows(job, budget, budget == maxBudget);
+                if(bytes == 0)
+                    break;
+                budget -= bytes;
+            }
+            if(job->level < job->image->getLevelCount())
+                break;          // out of budget, continue next frame
+
+            entry.texture = job->texture;
+            entry.state = STATE_READY;
+        }
+
+        uploads.pop_front();
+        delete job;
+        --pendingCount;
+        ++finishedCount;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    return finishedCount;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// take all jobs pushed by the workers at once and append them to uploads
+// The list is LIFO, so it is reversed to upload in the order of completion.
+///////////////////////////////////////////////////////////////////////////////
+void TextureLoader::collectLoaded()
+{
+    Job* list = loaded.exchange(0, std::memory_order_acquire);
+    Job* reversed = 0;
+    while(list)
+    {
+        Job* next = list->next;
+        list->next = reversed;
+        reversed = list;
+        list = next;
+    }
+    for(; reversed; reversed = reversed->next)
+        uploads.push_back(reversed);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// create the texture and allocate the storage of all levels, then bind it
+///////////////////////////////////////////////////////////////////////////////
+void TextureLoader::initTexture(Job* job)
+{
+    glGenTextures(1, &job->texture);
+    glBindTexture(GL_TEXTURE_2D, job->texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, job->wrap ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, job->wrap ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+    const Image::TextureBlob& image = *job->image;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.getLevelCount() - 1);
+    if(image.getChannelCount() == 1)
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+    }
+
+    if(image.isCompressed())
+    {
+        GLenum format = getCompressedFormat(image.getBlockFormat());
+        for(int i = 0; i < image.getLevelCount(); ++i)
+        {
+            glCompressedTexImage2D(GL_TEXTURE_2D, i, format, image.getWidth(i), image.getHeight(i), 0,
+                                   (GLsizei)image.getDataSize(i), 0);
+        }
+    }
+    else
+    {
+        GLint internalFormat;
+        GLenum format;
+        getFormats(image.getChannelCount(), internalFormat, format);
+        for(int i = 0; i < image.getLevelCount(); ++i)
+        {
+            glTexImage2D(GL_TEXTURE_2D, i, internalFormat, image.getWidth(i), image.getHeight(i), 0,
+                         format, GL_UNSIGNED_BYTE, 0);
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// upload the next band of rows of the current level that fits in maxBytes
+// If no row fits, it uploads one row when forceRow is true, nothing otherwise.
+// The first call creates the texture and allocates the storage of all levels.
+///////////////////////////////////////////////////////////////////////////////
+int TextureLoader::uploadRows(Job* job, int maxBytes, bool forceRow)
+{
+    const Image::TextureBlob& image = *job->image;
+    int width = image.getWidth(job->level);
+    int height = image.getHeight(job->level);
+    int rowSize = width * image.getChannelCount();
+
+    GLint internalFormat;
+    GLenum format;
+    getFormats(image.getChannelCount(), internalFormat, format);
+
+    if(!job->texture)
+        initTexture(job);
+    else
+        glBindTexture(GL_TEXTURE_2D, job->texture);
+
+    int rowCount = maxBytes / rowSize;
+    if(rowCount < 1)
+    {
+        if(!forceRow)
+            return 0;
+        rowCount = 1;
+    }
+    if(rowCount > height - job->uploadedRows)
+        rowCount = height - job->uploadedRows;
+
+    const unsigned char* rows = image.getData(job->level) + (std::size_t)job->uploadedRows * rowSize;
+    glTexSubImage2D(GL_TEXTURE_2D, job->level, 0, job->uploadedRows, width, rowCount, format, GL_UNSIGNED_BYTE, rows);
+    job->uploadedRows += rowCount;
+    if(job->uploadedRows == height)
+    {
+        ++job->level;
+        job->uploadedRows = 0;
+    }
+
+    return rowCount * rowSize;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// upload the next band of compressed rows, same as uploadRows()
+// A row of blocks is 4 rows of pixels, so the bands start at multiples of 4.
+// Only the last band of a level may end at a height not multiple of 4.
+///////////////////////////////////////////////////////////////////////////////
+int TextureLoader::uploadBlocks(Job* job, int maxBytes, bool forceRow)
+{
+    const Image::TextureBlob& image = *job->image;
+    int width = image.getWidth(job->level);
+    int height = image.getHeight(job->level);
+    int blockRows = (height + 3) / 4;
+    int rowSize = (int)Image::getBlockDataSize(image.getBlockFormat(), width, 1);   // one row of blocks
+
+    if(!job->texture)
+        initTexture(job);
+    else
+        glBindTexture(GL_TEXTURE_2D, job->texture);
+
+    // uploadedRows counts rows of blocks for compressed levels
+    int rowCount = maxBytes / rowSize;
+    if(rowCount < 1)
+    {
+        if(!forceRow)
+            return 0;
+        rowCount = 1;
+    }
+    if(rowCount > blockRows - job->uploadedRows)
+        rowCount = blockRows - job->uploadedRows;
+
+    int y = job->uploadedRows * 4;
+    int bandHeight = (rowCount * 4 < height - y) ? rowCount * 4 : height - y;
+    const unsigned char* rows = image.getData(job->level) + (std::size_t)job->uploadedRows * rowSize;
+    glCompressedTexSubImage2D(GL_TEXTURE_2D, job->level, 0, y, width, bandHeight,
+                              getCompressedFormat(image.getBlockFormat()), rowCount * rowSize, rows);
+    job->uploadedRows += rowCount;
+    if(job->uploadedRows == blockRows)
+    {
+        ++job->level;
+        job->uploadedRows = 0;
+    }
+
+    return rowCount * rowSize;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// delete all textures and handles
+// It waits for the queued decodes first, so no worker touches the jobs.
+///////////////////////////////////////////////////////////////////////////////
+void TextureLoader::clear()
+{
+    deleteJobs(true);
+
+    for(std::size_t i = 0; i < entries.size(); ++i)
+    {
+        if(entries[i].texture)
+            glDeleteTextures(1, &entries[i].texture);
+    }
+    entries.clear();
+    pendingCount = 0;
+
+    if(placeholder)
+        glDeleteTextures(1, &placeholder);
+    placeholder = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// compress the textures of the next load() calls
+///////////////////////////////////////////////////////////////////////////////
+void TextureLoader::setCompression(bool flag, Image::BlockQuality quality)
+{
+    compression = flag;
+    this->quality = quality;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// limit the size of the textures of the next load() calls
+///////////////////////////////////////////////////////////////////////////////
+void TextureLoader::setSizeLimit(int maxSize, std::size_t maxBytes)
+{
+    this->maxSize = (maxSize > 0) ? maxSize : 0;
+    this->maxBytes = maxBytes;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// getters
+///////////////////////////////////////////////////////////////////////////////
+GLuint TextureLoader::getTexture(int handle) const
+{
+    if(handle < 0 || handle >= (int)entries.size() || entries[handle].state != STATE_READY)
+        return placeholder;
+    return entries[handle].texture;
+}
+
+TextureLoader::State TextureLoader::getState(int handle) const
+{
+    if(handle < 0 || handle >= (int)entries.size())
+        return STATE_FAILED;
+    return entries[handle].state;
+}
+
+const char* TextureLoader::getError(int handle) const
+{
+    if(handle < 0 || handle >= (int)entries.size())
+        return "Invalid texture handle.";
+    return entries[handle].error.c_str();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// 1x1 gray texture used until a texture is ready
+///////////////////////////////////////////////////////////////////////////////
+void TextureLoader::initPlaceholder()
+{
+    const unsigned char gray[4] = { 128, 128, 128, 255 };
+    glGenTextures(1, &placeholder);
+    glBindTexture(GL_TEXTURE_2D, placeholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, gray);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// finish the queued decodes by deleting the pool, then free all jobs
+// The destructor may run without GL context, so it does not delete the
+// textures of half uploaded jobs.
+///////////////////////////////////////////////////////////////////////////////
+void TextureLoader::deleteJobs(bool deleteTextures)
+{
+    delete pool;
+    pool = 0;
+
+    collectLoaded();
+    for(std::size_t i = 0; i < uploads.size(); ++i)
+    {
+        if(deleteTextures && uploads[i]->texture)
+            glDeleteTextures(1, &uploads[i]->texture);
+        delete uploads[i];
+    }
+    uploads.clear();
+}
@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureLoader.h
+// ===============
+// asynchronous texture loader of BMP (or PNG, JPEG with stb_image, see ImageLoader)
+// load() returns a handle immediately and queues reading, decoding and mipmap
+// generation (MipChain box filter, in linear space for color images) of the
+// file to a small thread pool. The decoded images come back through a
+// lock-free list, and update() uploads them to OpenGL level by level on the
+// render thread, at most getUploadBudget() bytes per call (per frame). A large
+// image is uploaded in bands of rows over several frames, into a texture that
+// is not used until the last band of the last level is done.
+// Until then, getTexture() returns a 1x1 gray placeholder texture, so the
+// handle can be bound every frame from the start.
+// With setCompression(true), the workers also compress all levels to BC1 (RGB),
+// BC3 (RGBA) or BC4 (gray), which take 4 to 8 times less video memory and
+// upload bandwidth. Color images stay uncompressed if the driver does not
+// support GL_EXT_texture_compression_s3tc (BC4 is core since OpenGL 3.0).
+// With setCache(), the workers look up the decoded (and compressed) levels in
+// a TextureCache first, and add them to it after decoding, so a file loaded
+// again, or on the next run with a cache directory, is not decoded.
+// With setSizeLimit(), an image larger than the limits is downscaled with the
+// Lanczos filter (in linear space for color images) before the mipmaps, e.g.
+// to GL_MAX_TEXTURE_SIZE, or lower on a device with little video memory. It
+// also makes decoding the levels, compressing and uploading cheaper.
+//
+// load(), update(), getTexture() and clear() use OpenGL, so call them on the
+// thread with the current GL context.
+//
+// Dependencies: GLAD, BlockCompress, ImageLoader, MipChain, TextureCache, ThreadPool
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include "TextureCache.h"
+
+class ThreadPool;
+
+class TextureLoader
+{
+public:
+    enum State
+    {
+        STATE_LOADING = 0,                      // queued or decoding in the pool
+        STATE_UPLOADING,                        // decoded, bands are uploaded by update()
+        STATE_READY,                            // getTexture() returns the texture
+        STATE_FAILED                            // see getError()
+    };
+
+    // threadCount is the number of decode threads (0 = hardware threads - 1, at most 4)
+    // uploadBudget is the max bytes uploaded by update(), 0 means no limit
+    explicit TextureLoader(int threadCount=0, int uploadBudget=4*1024*1024);
+    ~TextureLoader();                           // waits for the queued decodes, does not delete GL textures
+
+    int    load(const char* fileName, bool wrap=true);  // queue a file, return handle
+    int    update();                            // upload decoded images, return # of textures finished
+    void   clear();                             // delete all textures and handles (waits for decodes)
+
+    GLuint getTexture(int handle) const;        // texture if ready, placeholder otherwise
+    State  getState(int handle) const;
+    const char* getError(int handle) const;
+    int    getPendingCount() const              { return pendingCount; }    // loading or uploading
+
+    void   setUploadBudget(int bytes)           { uploadBudget = bytes; }
+    int    getUploadBudget() const              { return uploadBudget; }
+
+    // compress the textures loaded after this call
+    void   setCompression(bool flag, Image::BlockQuality quality=Image::QUALITY_NORMAL);
+    bool   getCompression() const               { return compression; }
+
+    // limit the textures loaded after this call to maxSize pixels on each side
+    // and maxBytes of video memory each (all levels, compressed if they will
+    // be), keeping the aspect ratio, 0 means no limit
+    // maxBytes is per texture, not a total. To fit a total budget, divide it
+    // among the textures before loading them.
+    void   setSizeLimit(int maxSize, std::size_t maxBytes=0);
+    int    getMaxSize() const                   { return maxSize; }
+    std::size_t getMaxBytes() const             { return maxBytes; }
+
+    // cache of decoded images for the textures loaded after this call, not
+    // owned (0 = no cache), it must live until the decodes are done
+    void   setCache(Image::TextureCache* cache) { this->cache = cache; }
+    Image::TextureCache* getCache() const       { return cache; }
+
+private:
+    TextureLoader(const TextureLoader&);        // not copyable
+    TextureLoader& operator=(const TextureLoader&);
+
+    // a texture requested by load(), owned by the render thread
+    struct Entry
+    {
+        GLuint texture;
+        State state;
+        std::string error;
+    };
+
+    // decode job, owned by a worker until it is pushed to the loaded list
+    struct Job
+    {
+        int handle;
+        std::string fileName;
+        bool wrap;
+        bool failed;
+        std::string error;
+        bool compressColor;                     // BC1/BC3, if S3TC is supported
+        bool compressGray;                      // BC4
+        Image::BlockQuality quality;
+        int maxSize;                            // limits of setSizeLimit()
+        std::size_t maxBytes;
+        int width;                              // size after the limits, 0 = size of the file
+        int height;
+        Image::TextureCache* cache;
+        std::shared_ptr<const Image::TextureBlob> image;    // levels to upload
+        GLuint texture;                         // texture being uploaded
+        int level;                              // level being uploaded
+        int uploadedRows;                       // rows of the level
+        Job* next;                              // link in the loaded list
+    };
+
+    void decode(Job* job);                      // runs in the pool
+    void limitSize(Job* job);                   // find the size after the limits
+    bool decodeImage(Job* job, Image::TextureBlob& image);
+    void collectLoaded();                       // move the loaded list to uploads in FIFO order
+    void initTexture(Job* job);                 // create texture and storage of all levels
+    int  uploadRows(Job* job, int maxBytes, bool forceRow); // upload the next band of a level
+    int  uploadBlocks(Job* job, int maxBytes, bool forceRow); // same with compressed levels
+    void initPlaceholder();
+    void deleteJobs(bool deleteTextures);
+
+    ThreadPool* pool;                           // created by first load()
+    int threadCount;
+    int uploadBudget;
+    int pendingCount;
+    bool compression;
+    Image::BlockQuality quality;
+    int s3tcSupported;                          // -1 until checked by load()
+    int maxSize;
+    std::size_t maxBytes;
+    Image::TextureCache* cache;
+    GLuint placeholder;
+    std::vector<Entry> entries;                 // indexed by handle
+    std::deque<Job*> uploads;                   // decoded jobs in load order, render thread only
+    std::atomic<Job*> loaded;                   // lock-free LIFO pushed by the workers
+};
+
+#endif
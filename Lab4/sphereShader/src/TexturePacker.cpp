@@ -0,0 +1,351 @@
+///////////////////////////////////////////////////////////////////////////////
+// TexturePacker.cpp
+// =================
+// packer of many small images into atlas pages or texture array layers
+//
+// Dependencies: none
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+#include "TexturePacker.h"
+
+namespace Image
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// ctor
+///////////////////////////////////////////////////////////////////////////////
+TexturePacker::TexturePacker() : pageCount(0), pageWidth(0), pageHeight(0), errorMessage("No error.")
+{
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// add an image to pack
+///////////////////////////////////////////////////////////////////////////////
+int TexturePacker::add(int width, int height, const unsigned char* data, std::size_t stride)
+{
+    Entry entry;
+    entry.width = width;
+    entry.height = height;
+    entry.data = data;
+    entry.stride = stride;
+    entry.rect.page = -1;
+    entry.rect.x = entry.rect.y = 0;
+    entry.rect.width = width;
+    entry.rect.height = height;
+    entry.slotX = entry.slotY = entry.slotWidth = entry.slotHeight = 0;
+    entries.push_back(entry);
+    return (int)entries.size() - 1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// remove all images and pages
+///////////////////////////////////////////////////////////////////////////////
+void TexturePacker::clear()
+{
+    std::vector<Entry>().swap(entries);
+    pageCount = pageWidth = pageHeight = 0;
+    errorMessage = "No error.";
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// place the images into atlas pages with the skyline bottom-left method
+// The images are placed from the tallest, each at the position of the lowest
+// top on the first page it fits in, and a new page is started if it fits in
+// none. Ties are broken by the least area wasted under the image.
+///////////////////////////////////////////////////////////////////////////////
+bool TexturePacker::packAtlas(int pageWidth, int pageHeight, int gutter, int alignment)
+{
+    pageCount = 0;
+    this->pageWidth = pageWidth;
+    this->pageHeight = pageHeight;
+    errorMessage = "No error.";
+    if(pageWidth <= 0 || pageHeight <= 0 || gutter < 0 || alignment <= 0)
+    {
+        errorMessage = "Invalid page size, gutter or alignment.";
+        return false;
+    }
+
+    // tallest first, then widest, then in the order added
+    std::vector<int> order(entries.size());
+    for(std::size_t i = 0; i < order.size(); ++i)
+        order[i] = (int)i;
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b)
+    {
+        if(entries[a].height != entries[b].height)
+            return entries[a].height > entries[b].height;
+        return entries[a].width > entries[b].width;
+    });
+
+    std::vector<Skyline> pages;
+    for(std::size_t i = 0; i < order.size(); ++i)
+    {
+        Entry& entry = entries[order[i]];
+        int slotWidth = (entry.width + gutter * 2 + alignment - 1) / alignment * alignment;
+        int slotHeight = (entry.height + gutter * 2 + alignment - 1) / alignment * alignment;
+        if(entry.width <= 0 || entry.height <= 0 || slotWidth > pageWidth || slotHeight > pageHeight)
+        {
+            std::ostringstream oss;
+            oss << "Image " << order[i] << " (" << entry.width << "x" << entry.height
+                << ") does not fit in a page of " << pageWidth << "x" << pageHeight << ".";
+            errorMessage = oss.str();
+            pages.clear();
+            return false;
+        }
+
+        int page, index = 0, y = 0, top, waste;
+        for(page = 0; page < (int)pages.size(); ++page)
+        {
+            if(findPosition(pages[page], slotWidth, slotHeight, index, y, top, waste))
+                break;
+        }
+        if(page == (int)pages.size())
+        {
+            SkylineNode node = { 0, 0, pageWidth };
+            pages.push_back(Skyline(1, node));
+            index = 0;
+            y = 0;
+        }
+
+        int x = pages[page][index].x;
+        addLevel(pages[page], index, x, y, slotWidth, slotHeight);
+        entry.slotX = x;
+        entry.slotY = y;
+        entry.slotWidth = slotWidth;
+        entry.slotHeight = slotHeight;
+        entry.rect.page = page;
+        entry.rect.x = x + gutter;
+        entry.rect.y = y + gutter;
+    }
+    pageCount = (int)pages.size();
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// put each image into its own array layer
+///////////////////////////////////////////////////////////////////////////////
+bool TexturePacker::packArray(int layerWidth, int layerHeight)
+{
+    pageCount = 0;
+    errorMessage = "No error.";
+
+    int maxWidth = 0, maxHeight = 0;
+    for(std::size_t i = 0; i < entries.size(); ++i)
+    {
+        maxWidth = std::max(maxWidth, entries[i].width);
+        maxHeight = std::max(maxHeight, entries[i].height);
+    }
+    pageWidth = (layerWidth > 0) ? layerWidth : maxWidth;
+    pageHeight = (layerHeight > 0) ? layerHeight : maxHeight;
+
+    for(std::size_t i = 0; i < entries.size(); ++i)
+    {
+        Entry& entry = entries[i];
+        if(entry.width <= 0 || entry.height <= 0 || entry.width > pageWidth || entry.height > pageHeight)
+        {
+            std::ostringstream oss;
+            oss << "Image " << i << " (" << entry.width << "x" << entry.height
+                << ") does not fit in a layer of " << pageWidth << "x" << pageHeight << ".";
+            errorMessage = oss.str();
+            return false;
+        }
+        entry.rect.page = (int)i;
+        entry.rect.x = entry.rect.y = 0;
+        entry.slotX = entry.slotY = 0;
+        entry.slotWidth = pageWidth;
+        entry.slotHeight = pageHeight;
+    }
+    pageCount = (int)entries.size();
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// copy the images of a page to dst, repeating the edges to fill their slots
+///////////////////////////////////////////////////////////////////////////////
+bool TexturePacker::buildPage(int page, int channelCount, unsigned char* dst, std::size_t stride) const
+{
+    if(page < 0 || page >= pageCount || !dst || channelCount < 1 || channelCount > 4)
+    {
+        errorMessage = "Invalid page, channel count or destination.";
+        return false;
+    }
+    const std::size_t pageRowSize = (std::size_t)pageWidth * channelCount;
+    if(stride == 0)
+        stride = pageRowSize;
+
+    for(int y = 0; y < pageHeight; ++y)
+        memset(dst + y * stride, 0, pageRowSize);
+
+    for(std::size_t i = 0; i < entries.size(); ++i)
+    {
+        const Entry& entry = entries[i];
+        if(entry.rect.page != page)
+            continue;
+        if(!entry.data)
+        {
+            std::ostringstream oss;
+            oss << "Image " << i << " has no pixels.";
+            errorMessage = oss.str();
+            return false;
+        }
+
+        const std::size_t rowSize = (std::size_t)entry.width * channelCount;
+        const std::size_t srcStride = entry.stride ? entry.stride : rowSize;
+        const int left = entry.rect.x - entry.slotX;
+        const int right = entry.slotX + entry.slotWidth - entry.rect.x - entry.width;
+        for(int y = entry.slotY; y < entry.slotY + entry.slotHeight; ++y)
+        {
+            // rows above and below the image repeat its first and last rows
+            int srcY = std::min(std::max(y - entry.rect.y, 0), entry.height - 1);
+            const unsigned char* src = entry.data + srcY * srcStride;
+            unsigned char* row = dst + y * stride + (std::size_t)entry.slotX * channelCount;
+
+            for(int x = 0; x < left; ++x, row += channelCount)
+                memcpy(row, src, channelCount);
+            memcpy(row, src, rowSize);
+            row += rowSize;
+            const unsigned char* last = src + rowSize - channelCount;
+            for(int x = 0; x < right; ++x, row += channelCount)
+                memcpy(row, last, channelCount);
+        }
+    }
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// image area / area of all pages
+///////////////////////////////////////////////////////////////////////////////
+float TexturePacker::getOccupancy() const
+{
+    if(pageCount == 0)
+        return 0;
+    double area = 0;
+    for(std::size_t i = 0; i < entries.size(); ++i)
+        area += (double)entries[i].width * entries[i].height;
+    return (float)(area / ((double)pageWidth * pageHeight * pageCount));
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// rectangle of an image in texture coordinates
+///////////////////////////////////////////////////////////////////////////////
+void TexturePacker::getUvRect(int id, float& u0, float& v0, float& u1, float& v1) const
+{
+    const Rect& rect = entries[id].rect;
+    u0 = (float)rect.x / pageWidth;
+    v0 = (float)rect.y / pageHeight;
+    u1 = (float)(rect.x + rect.width) / pageWidth;
+    v1 = (float)(rect.y + rect.height) / pageHeight;
+}
+
+void TexturePacker::remapUvs(int id, float* texCoords, int count, int stride) const
+{
+    float u0, v0, u1, v1;
+    getUvRect(id, u0, v0, u1, v1);
+    for(int i = 0; i < count; ++i, texCoords += stride)
+    {
+        texCoords[0] = u0 + texCoords[0] * (u1 - u0);
+        texCoords[1] = v0 + texCoords[1] * (v1 - v0);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// lowest position of a slot on the skyline of a page
+// index is the node where the slot starts, y is its bottom and top is y plus
+// the height. waste is the area left under the slot.
+///////////////////////////////////////////////////////////////////////////////
+bool TexturePacker::findPosition(const Skyline& skyline, int width, int height,
+                                 int& index, int& y, int& top, int& waste) const
+{
+    bool found = false;
+    for(std::size_t i = 0; i < skyline.size(); ++i)
+    {
+        int x = skyline[i].x;
+        if(x + width > pageWidth)
+            break;
+
+        // the slot rests on the highest node under it
+        int bottom = 0;
+        for(std::size_t j = i; j < skyline.size() && skyline[j].x < x + width; ++j)
+            bottom = std::max(bottom, skyline[j].y);
+        if(bottom + height > pageHeight)
+            continue;
+
+        int area = 0;
+        for(std::size_t j = i; j < skyline.size() && skyline[j].x < x + width; ++j)
+        {
+            int overlap = std::min(skyline[j].x + skyline[j].width, x + width) - skyline[j].x;
+            area += (bottom - skyline[j].y) * overlap;
+        }
+
+        if(!found || bottom + height < top || (bottom + height == top && area < waste))
+        {
+            found = true;
+            index = (int)i;
+            y = bottom;
+            top = bottom + height;
+            waste = area;
+        }
+    }
+    return found;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// raise the skyline under a placed slot, and merge the nodes of the same
+// height
+///////////////////////////////////////////////////////////////////////////////
+void TexturePacker::addLevel(Skyline& skyline, int index, int x, int y, int width, int height)
+{
+    SkylineNode node = { x, y + height, width };
+    skyline.insert(skyline.begin() + index, node);
+
+    // shrink or remove the nodes covered by the new one
+    for(std::size_t i = index + 1; i < skyline.size(); )
+    {
+        int shrink = x + width - skyline[i].x;
+        if(shrink <= 0)
+            break;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if(skyline[i].width > 0)
+            break;
+        skyline.erase(skyline.begin() + i);
+    }
+
+    for(std::size_t i = 0; i + 1 < skyline.size(); )
+    {
+        if(skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+} // namespace Image
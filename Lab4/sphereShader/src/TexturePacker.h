@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+// TexturePacker.h
+// ===============
+// packer of many small images into atlas pages or texture array layers, so a
+// mesh using all of them is drawn with one texture bind and one draw call
+// add() the sizes (and pixels) of the images, then:
+// packAtlas() places them into pages of a fixed size with the skyline
+// bottom-left method (tallest first). Each image gets a slot with gutter
+// pixels around it, and the slots start at multiples of alignment, so the
+// first log2(alignment) mipmap levels and 4x4 blocks of BlockCompress never
+// mix two images. buildPage() repeats the edge pixels of each image into its
+// gutter, so bilinear filtering and the mipmaps near an edge only see the
+// image itself.
+// packArray() puts each image into its own layer at (0, 0) for
+// GL_TEXTURE_2D_ARRAY. All layers are the size of the largest image, and
+// buildPage() repeats the edges of smaller ones to the end of the layer.
+//
+// The texture coordinates of an image (0~1) are remapped into its rectangle
+// with remapUvs(), and getPage() is the atlas page or array layer to bind or
+// to pass as the layer index. Remapped coordinates cannot wrap (GL_REPEAT)
+// in an atlas, but can in an array if the image fills its layer.
+// Packing only needs the sizes, so it also works offline: pack, build the
+// pages and save them with Bmp, and store the rectangles with the meshes.
+//
+// Dependencies: none
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef IMAGE_TEXTURE_PACKER_H
+#define IMAGE_TEXTURE_PACKER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace Image
+{
+    class TexturePacker
+    {
+    public:
+        // place of an image without the gutter, in pixels of the page
+        struct Rect
+        {
+            int page;                               // atlas page or array layer
+            int x;
+            int y;
+            int width;
+            int height;
+        };
+
+        TexturePacker();
+
+        // add an image and return its id (0, 1, 2, ...)
+        // The pixels are not copied, they must be valid until buildPage().
+        // They can be null if only the rectangles are needed. stride is the
+        // bytes between rows (0 = packed rows).
+        int  add(int width, int height, const unsigned char* data=0, std::size_t stride=0);
+        void clear();
+
+        // place all images, false if an image (with its gutter) is larger than
+        // a page, or the sizes are not valid
+        bool packAtlas(int pageWidth, int pageHeight, int gutter=2, int alignment=4);
+        bool packArray(int layerWidth=0, int layerHeight=0);  // 0 = largest image
+
+        // copy the images of a page to dst with the edges repeated into the
+        // gutters, the rest is cleared to 0
+        // All images must have the same channelCount (1 to 4).
+        bool buildPage(int page, int channelCount, unsigned char* dst, std::size_t stride=0) const;
+
+        int  getImageCount() const                  { return (int)entries.size(); }
+        int  getPageCount() const                   { return pageCount; }
+        int  getPageWidth() const                   { return pageWidth; }
+        int  getPageHeight() const                  { return pageHeight; }
+        std::size_t getPageSize(int channelCount) const { return (std::size_t)pageWidth * pageHeight * channelCount; }
+        const Rect& getRect(int id) const           { return entries[id].rect; }
+        int  getPage(int id) const                  { return entries[id].rect.page; }
+        float getOccupancy() const;                 // image area / area of all pages
+        const char* getError() const                { return errorMessage.c_str(); }
+
+        // rectangle of an image in texture coordinates of its page, v = 0 at
+        // the first row
+        void getUvRect(int id, float& u0, float& v0, float& u1, float& v1) const;
+
+        // map the texture coordinates (s, t) of an image from 0~1 to its
+        // rectangle in place, stride is the floats between pairs
+        void remapUvs(int id, float* texCoords, int count, int stride=2) const;
+
+    private:
+        struct Entry
+        {
+            int width;
+            int height;
+            const unsigned char* data;
+            std::size_t stride;
+            Rect rect;
+            int slotX;                              // area filled by buildPage()
+            int slotY;
+            int slotWidth;
+            int slotHeight;
+        };
+
+        // top of the used area of a page from x to x + width
+        struct SkylineNode
+        {
+            int x;
+            int y;
+            int width;
+        };
+        typedef std::vector<SkylineNode> Skyline;
+
+        bool findPosition(const Skyline& skyline, int width, int height, int& index, int& y, int& top, int& waste) const;
+        static void addLevel(Skyline& skyline, int index, int x, int y, int width, int height);
+
+        std::vector<Entry> entries;
+        int pageCount;
+        int pageWidth;
+        int pageHeight;
+        mutable std::string errorMessage;           // also set by buildPage()
+    };
+}
+
+#endif // IMAGE_TEXTURE_PACKER_H
@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////
+// ThreadPool.cpp
+// ==============
+// fixed number of worker threads running queued tasks
+//
+// Dependencies: none
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool.h"
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ctor/dtor
+///////////////////////////////////////////////////////////////////////////////
+ThreadPool::ThreadPool(int threadCount) : stopping(false)
+{
+    if(threadCount <= 0)
+        threadCount = (int)std::thread::hardware_concurrency();
+    if(threadCount <= 0)
+        threadCount = 1;
+
+    workers.reserve(threadCount);
+    for(int i = 0; i < threadCount; ++i)
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for(std::size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// queue a task for the workers
+///////////////////////////////////////////////////////////////////////////////
+void ThreadPool::submit(const std::function<void()>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+    taskReady.notify_one();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// split [0, count) into one band per worker plus one for the calling thread
+// The bands are queued as tasks, and the caller runs the first band, then
+// helps with the queued tasks until all bands are done.
+///////////////////////////////////////////////////////////////////////////////
+void ThreadPool::parallelFor(int count, const std::function<void(int, int)>& func, int minCount)
+{
+    if(count <= 0)
+        return;
+    if(minCount < 1)
+        minCount = 1;
+
+    int bandCount = (int)workers.size() + 1;
+    if(bandCount > (count + minCount - 1) / minCount)
+        bandCount = (count + minCount - 1) / minCount;
+    if(bandCount <= 1)
+    {
+        func(0, count);
+        return;
+    }
+
+    // completion counter of this call, lives on the stack until all done
+    std::mutex doneMutex;
+    std::condition_variable doneSignal;
+    int remaining = bandCount - 1;
+
+    for(int i = 1; i < bandCount; ++i)
+    {
+        int first = (int)((long long)count * i / bandCount);
+        int last = (int)((long long)count * (i + 1) / bandCount);
+        submit([&func, &doneMutex, &doneSignal, &remaining, first, last]()
+        {
+            func(first, last);
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if(--remaining == 0)
+                doneSignal.notify_all();
+        });
+    }
+
+    func(0, (int)((long long)count / bandCount));
+
+    // help with queued tasks (the bands, or others) instead of idling
+    while(true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if(remaining == 0)
+                break;
+        }
+        if(!runPendingTask())
+        {
+            // all bands are taken by workers, wait for them
+            std::unique_lock<std::mutex> lock(doneMutex);
+            doneSignal.wait(lock, [&remaining]() { return remaining == 0; });
+            break;
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// pop and run one task in the calling thread
+///////////////////////////////////////////////////////////////////////////////
+bool ThreadPool::runPendingTask()
+{
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(tasks.empty())
+            return false;
+        task.swap(tasks.front());
+        tasks.pop_front();
+    }
+    task();
+    return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// worker thread: run tasks until the pool is destroyed and the queue is empty
+///////////////////////////////////////////////////////////////////////////////
+void ThreadPool::workerLoop()
+{
+    while(true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskReady.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if(tasks.empty())
+                return;         // stopping and nothing left
+            task.swap(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////////////
+// ThreadPool.h
+// ============
+// fixed number of worker threads running queued tasks
+// submit() queues a task for any worker. parallelFor() splits an index range
+// into bands, runs the first band in the calling thread and the others in the
+// workers, and returns when all bands are done. While waiting, the caller runs
+// queued tasks too, so parallelFor() can be called from a task of the same
+// pool without deadlock.
+// The destructor finishes all queued tasks before joining the workers.
+//
+// Dependencies: none
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threadCount=0);     // threadCount=0 uses all hardware threads
+    ~ThreadPool();
+
+    int  getThreadCount() const                 { return (int)workers.size(); }
+
+    void submit(const std::function<void()>& task);
+
+    // call func(first, last) for bands of [0, count), each band has at least
+    // minCount indices (except when count is smaller)
+    void parallelFor(int count, const std::function<void(int, int)>& func, int minCount=1);
+
+private:
+    ThreadPool(const ThreadPool&);              // not copyable
+    ThreadPool& operator=(const ThreadPool&);
+
+    void workerLoop();
+    bool runPendingTask();                      // run one queued task, false if none
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()> > tasks;
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    bool stopping;
+};
+
+#endif
@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////
+// Transform.cpp
+// =============
+// 4x4 transform matrix with its classification
+//
+// Dependencies: Vector3, Vector4, Matrix4, Quaternion
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include "Transform.h"
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// find the type of the matrix by inspecting the elements
+// The last row must be exactly (0,0,0,1) for affine transforms, same as
+// Matrix4::invert(). The upper-left 3x3 is Euclidean if its columns are
+// orthonormal within epsilon.
+///////////////////////////////////////////////////////////////////////////////
+Transform::Type Transform::classify(const Matrix4& m, float epsilon)
+{
+    if(m[3] != 0 || m[7] != 0 || m[11] != 0 || m[15] != 1)
+        return GENERAL;
+
+    Vector3 c0(m[0], m[1], m[2]);
+    Vector3 c1(m[4], m[5], m[6]);
+    Vector3 c2(m[8], m[9], m[10]);
+
+    if(fabs(c0.dot(c0) - 1) > epsilon || fabs(c1.dot(c1) - 1) > epsilon || fabs(c2.dot(c2) - 1) > epsilon ||
+       fabs(c0.dot(c1)) > epsilon || fabs(c0.dot(c2)) > epsilon || fabs(c1.dot(c2)) > epsilon)
+        return AFFINE;
+
+    if(fabs(m[1]) > epsilon || fabs(m[2]) > epsilon || fabs(m[4]) > epsilon ||
+       fabs(m[6]) > epsilon || fabs(m[8]) > epsilon || fabs(m[9]) > epsilon ||
+       m[0] < 0 || m[5] < 0 || m[10] < 0)
+        return EUCLIDEAN;
+
+    if(m[12] != 0 || m[13] != 0 || m[14] != 0)
+        return TRANSLATION;
+
+    return IDENTITY;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inverse transform with the method for its type
+// NOTE: EUCLIDEAN uses transpose of the rotation part, so rotations built
+// from non-unit quaternions or drifted after many multiplications should be
+// re-classified with set() before inverting.
+///////////////////////////////////////////////////////////////////////////////
+Transform& Transform::invert()
+{
+    switch(type)
+    {
+    case IDENTITY:
+        break;
+    case TRANSLATION:
+        matrix[12] = -matrix[12];
+        matrix[13] = -matrix[13];
+        matrix[14] = -matrix[14];
+        break;
+    case EUCLIDEAN:
+        matrix.invertEuclidean();
+        break;
+    case AFFINE:
+        matrix.invertAffine();
+        break;
+    default:
+        matrix.invertGeneral();
+        break;
+    }
+    return *this;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// multiply 2 transforms, skip the matrix multiplication if possible
+///////////////////////////////////////////////////////////////////////////////
+Transform Transform::operator*(const Transform& rhs) const
+{
+    if(rhs.type == IDENTITY)
+        return *this;
+    if(type == IDENTITY)
+        return rhs;
+
+    Transform t;
+    if(type == TRANSLATION && rhs.type == TRANSLATION)
+    {
+        t.matrix.translate(matrix[12] + rhs.matrix[12], matrix[13] + rhs.matrix[13], matrix[14] + rhs.matrix[14]);
+        t.type = TRANSLATION;
+        return t;
+    }
+
+    Matrix4::multiply(matrix, rhs.matrix, t.matrix);
+    t.type = (type > rhs.type) ? type : rhs.type;
+    return t;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// rotation about unit axis is Euclidean, otherwise the matrix is scaled
+///////////////////////////////////////////////////////////////////////////////
+Transform::Type Transform::rotationType(float x, float y, float z)
+{
+    const float EPSILON = 0.00001f;
+    float lengthSq = x * x + y * y + z * z;
+    return (fabs(lengthSq - 1) <= EPSILON) ? EUCLIDEAN : AFFINE;
+}
@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////
+// Transform.h
+// ===========
+// 4x4 transform matrix with its classification
+//
+// Matrix4::invert() inspects the matrix every call to choose an inverse
+// method. Transform remembers what kind of transform it is built from, and
+// the type is propagated through translate/rotate/scale and multiplication,
+// so invert() goes straight to the cheapest correct method:
+//   IDENTITY    : nothing to do
+//   TRANSLATION : negate translation
+//   EUCLIDEAN   : rotation/reflection + translation, Matrix4::invertEuclidean()
+//   AFFINE      : with scale/shear, Matrix4::invertAffine()
+//   GENERAL     : projective, Matrix4::invertGeneral()
+// The types are ordered, so the type of a product is the larger one.
+//
+// Dependencies: Vector3, Vector4, Matrix4, Quaternion
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef MATH_TRANSFORM_H
+#define MATH_TRANSFORM_H
+
+#include <iostream>
+#include "Vectors.h"
+#include "Matrices.h"
+
+struct Quaternion;
+
+class Transform
+{
+public:
+    enum Type
+    {
+        IDENTITY = 0,
+        TRANSLATION,
+        EUCLIDEAN,
+        AFFINE,
+        GENERAL
+    };
+
+    // ctors
+    Transform() : type(IDENTITY) {}                         // init with identity
+    explicit Transform(const Matrix4& m);                   // classify m once
+    Transform(const Matrix4& m, Type type) : matrix(m), type(type) {} // trust the given type
+
+    void        set(const Matrix4& m);                      // classify m
+    void        set(const Matrix4& m, Type type);
+    const Matrix4& getMatrix() const    { return matrix; }
+    const float* get() const            { return matrix.get(); }
+    Type        getType() const         { return type; }
+    bool        isRigid() const         { return type <= EUCLIDEAN; }
+
+    // transform functions, same as Matrix4 (pre-multiply the transform)
+    Transform&  identity();
+    Transform&  translate(float x, float y, float z);
+    Transform&  translate(const Vector3& v);
+    Transform&  rotate(float angle, const Vector3& axis);   // angle in degree
+    Transform&  rotate(float angle, float x, float y, float z);
+    Transform&  rotateX(float angle);
+    Transform&  rotateY(float angle);
+    Transform&  rotateZ(float angle);
+    Transform&  rotate(const Quaternion& q);                // unit quaternion
+    Transform&  scale(float s);
+    Transform&  scale(float sx, float sy, float sz);
+
+    Transform&  invert();                                   // no runtime check, dispatch by type
+    Transform   getInverse() const;
+
+    // classify the matrix by inspecting elements (used by ctor and set())
+    static Type classify(const Matrix4& m, float epsilon=0.00001f);
+
+    // operators
+    Transform   operator*(const Transform& rhs) const;
+    Transform&  operator*=(const Transform& rhs);
+    Vector3     operator*(const Vector3& rhs) const         { return matrix * rhs; }
+    Vector4     operator*(const Vector4& rhs) const         { return matrix * rhs; }
+
+    friend std::ostream& operator<<(std::ostream& os, const Transform& t);
+
+private:
+    static Type rotationType(float x, float y, float z);    // EUCLIDEAN if unit axis
+
+    Matrix4 matrix;
+    Type type;
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inline functions for Transform
+///////////////////////////////////////////////////////////////////////////////
+inline Transform::Transform(const Matrix4& m) : matrix(m), type(classify(m))
+{
+}
+
+inline void Transform::set(const Matrix4& m)
+{
+    matrix = m;
+    type = classify(m);
+}
+
+inline void Transform::set(const Matrix4& m, Type type)
+{
+    matrix = m;
+    this->type = type;
+}
+
+inline Transform& Transform::identity()
+{
+    matrix.identity();
+    type = IDENTITY;
+    return *this;
+}
+
+inline Transform& Transform::translate(float x, float y, float z)
+{
+    matrix.translate(x, y, z);
+    if(type < TRANSLATION)
+        type = TRANSLATION;
+    return *this;
+}
+
+inline Transform& Transform::translate(const Vector3& v)
+{
+    return translate(v.x, v.y, v.z);
+}
+
+inline Transform& Transform::rotate(float angle, const Vector3& axis)
+{
+    return rotate(angle, axis.x, axis.y, axis.z);
+}
+
+inline Transform& Transform::rotate(float angle, float x, float y, float z)
+{
+    matrix.rotate(angle, x, y, z);
+    Type t = rotationType(x, y, z);
+    if(type < t)
+        type = t;
+    return *this;
+}
+
+inline Transform& Transform::rotateX(float angle)
+{
+    matrix.rotateX(angle);
+    if(type < EUCLIDEAN)
+        type = EUCLIDEAN;
+    return *this;
+}
+
+inline Transform& Transform::rotateY(float angle)
+{
+    matrix.rotateY(angle);
+    if(type < EUCLIDEAN)
+        type = EUCLIDEAN;
+    return *this;
+}
+
+inline Transform& Transform::rotateZ(float angle)
+{
+    matrix.rotateZ(angle);
+    if(type < EUCLIDEAN)
+        type = EUCLIDEAN;
+    return *this;
+}
+
+inline Transform& Transform::rotate(const Quaternion& q)
+{
+    matrix.rotate(q);
+    if(type < EUCLIDEAN)
+        type = EUCLIDEAN;
+    return *this;
+}
+
+inline Transform& Transform::scale(float s)
+{
+    return scale(s, s, s);
+}
+
+inline Transform& Transform::scale(float sx, float sy, float sz)
+{
+    matrix.scale(sx, sy, sz);
+    if(type < AFFINE && (sx != 1 || sy != 1 || sz != 1))
+        type = AFFINE;
+    return *this;
+}
+
+inline Transform Transform::getInverse() const
+{
+    Transform t(*this);
+    return t.invert();
+}
+
+inline Transform& Transform::operator*=(const Transform& rhs)
+{
+    *this = *this * rhs;
+    return *this;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Transform& t)
+{
+    const char* NAMES[] = {"IDENTITY", "TRANSLATION", "EUCLIDEAN", "AFFINE", "GENERAL"};
+    os << NAMES[t.type] << "\n" << t.matrix;
+    return os;
+}
+// END OF TRANSFORM INLINE ////////////////////////////////////////////////////
+#endif
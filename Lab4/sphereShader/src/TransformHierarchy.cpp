@@ -0,0 +1,283 @@
+///////////////////////////////////////////////////////////////////////////////
+// TransformHierarchy.cpp
+// ======================
+// Parent/child transform nodes with dirty-flag propagation
+//
+// Dependencies: Matrix4, ThreadPool
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <thread>
+#include "TransformHierarchy.h"
+#include "ThreadPool.h"
+
+const int TransformHierarchy::NONE;
+const std::size_t TransformHierarchy::PARALLEL_THRESHOLD;
+const std::size_t TransformHierarchy::PARALLEL_DIRTY_RATIO;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ctor
+///////////////////////////////////////////////////////////////////////////////
+TransformHierarchy::TransformHierarchy() : dirtyCount(0), updatedCount(0), sorted(true)
+{
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// add a new node under the parent (NONE for a root), and return its ID
+// The new node is dirty, so its world matrix is computed by next update().
+// If the node is appended at the end of its parent's subtree, the arrays
+// remain in depth-first order. Otherwise, they are re-sorted in next update().
+///////////////////////////////////////////////////////////////////////////////
+int TransformHierarchy::addNode(int parentId, const Matrix4& local)
+{
+    int id = (int)parentIds.size();
+    int slot = (int)locals.size();
+    int parent = (parentId == NONE) ? NONE : slots[parentId];
+
+    parentIds.push_back(parentId);
+    slots.push_back(slot);
+    locals.push_back(local);
+    worlds.push_back(local);
+    parents.push_back(parent);
+    subtreeEnds.push_back(slot + 1);
+    dirtyFlags.push_back(1);
+    ++dirtyCount;
+
+    if(parent != NONE && sorted)
+    {
+        if(subtreeEnds[parent] != slot)
+        {
+            sorted = false;
+        }
+        else
+        {
+            // extend the subtrees of all ancestors ending at this slot
+            for(int i = parent; i != NONE && subtreeEnds[i] == slot; i = parents[i])
+                subtreeEnds[i] = slot + 1;
+        }
+    }
+    return id;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// reserve memory for the number of nodes
+///////////////////////////////////////////////////////////////////////////////
+void TransformHierarchy::reserve(std::size_t count)
+{
+    parentIds.reserve(count);
+    slots.reserve(count);
+    locals.reserve(count);
+    worlds.reserve(count);
+    parents.reserve(count);
+    subtreeEnds.reserve(count);
+    dirtyFlags.reserve(count);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// remove all nodes
+///////////////////////////////////////////////////////////////////////////////
+void TransformHierarchy::clear()
+{
+    parentIds.clear();
+    slots.clear();
+    locals.clear();
+    worlds.clear();
+    parents.clear();
+    subtreeEnds.clear();
+    dirtyFlags.clear();
+    dirtyCount = updatedCount = 0;
+    sorted = true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// set local matrix of the node, and mark it dirty
+// The descendants are not touched here; update() recomputes the whole
+// subtree of a dirty node.
+///////////////////////////////////////////////////////////////////////////////
+void TransformHierarchy::setLocal(int id, const Matrix4& local)
+{
+    int slot = slots[id];
+    locals[slot] = local;
+    if(!dirtyFlags[slot])
+    {
+        dirtyFlags[slot] = 1;
+        ++dirtyCount;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// recompute world matrices of dirty subtrees
+// The root subtrees are split into contiguous chunks of similar size, one per
+// thread. Small hierarchies or few dirty nodes are updated in the calling
+// thread because starting threads would cost more than the update itself.
+// With a pool, the chunks are run by its workers and the calling thread.
+///////////////////////////////////////////////////////////////////////////////
+void TransformHierarchy::update(int threadCount, ThreadPool* pool)
+{
+    if(!sorted)
+        sortNodes();
+
+    updatedCount = 0;
+    if(dirtyCount == 0)
+        return;
+
+    std::size_t count = locals.size();
+    if(pool)
+        threadCount = pool->getThreadCount() + 1;
+    else if(threadCount <= 0)
+        threadCount = (int)std::thread::hardware_concurrency();
+
+    if(threadCount <= 1 || count < PARALLEL_THRESHOLD || dirtyCount * PARALLEL_DIRTY_RATIO < count)
+    {
+        updatedCount = updateRange(0, count);
+    }
+    else
+    {
+        // find chunk boundaries between root subtrees
+        std::size_t chunk = (count + threadCount - 1) / threadCount;
+        std::vector<std::size_t> bounds(1, 0);
+        std::size_t i = 0;
+        while(i < count)
+        {
+            std::size_t target = i + chunk;
+            while(i < count && i < target)
+                i = subtreeEnds[i];             // jump to next root
+            bounds.push_back(i);
+        }
+
+        std::size_t chunkCount = bounds.size() - 1;
+        std::vector<std::size_t> counts(chunkCount, 0);
+        if(pool)
+        {
+            pool->parallelFor((int)chunkCount, [this, &bounds, &counts](int first, int last)
+            {
+                for(int c = first; c < last; ++c)
+                    counts[c] = updateRange(bounds[c], bounds[c + 1]);
+            });
+        }
+        else
+        {
+            std::vector<std::thread> threads;
+            threads.reserve(chunkCount - 1);
+            for(i = 0; i < chunkCount - 1; ++i)
+                threads.push_back(std::thread([this, &bounds, &counts, i]() { counts[i] = updateRange(bounds[i], bounds[i + 1]); }));
+            counts[i] = updateRange(bounds[i], bounds[i + 1]);
+
+            for(i = 0; i < threads.size(); ++i)
+                threads[i].join();
+        }
+        for(i = 0; i < chunkCount; ++i)
+            updatedCount += counts[i];
+    }
+
+    dirtyCount = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// update dirty subtrees in [first, last), return the number of updated nodes
+// [first, last) must begin and end at root subtree boundaries. A clean node is
+// skipped, and a dirty node recomputes its whole subtree, then jumps over it.
+// The parent of a node is always visited before the node.
+///////////////////////////////////////////////////////////////////////////////
+std::size_t TransformHierarchy::updateRange(std::size_t first, std::size_t last)
+{
+    std::size_t count = 0;
+    std::size_t i = first;
+    while(i < last)
+    {
+        if(!dirtyFlags[i])
+        {
+            ++i;
+            continue;
+        }
+
+        std::size_t end = subtreeEnds[i];
+        for(std::size_t j = i; j < end; ++j)
+        {
+            int parent = parents[j];
+            if(parent == NONE)
+                worlds[j] = locals[j];
+            else
+                Matrix4::multiply(worlds[parent], locals[j], worlds[j]);
+            dirtyFlags[j] = 0;
+        }
+        count += end - i;
+        i = end;
+    }
+    return count;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// re-order nodes in depth-first order (children in the order of creation)
+// Since a parent is always created before its children, the subtree sizes are
+// accumulated in reverse ID order, and the positions are assigned in ID order
+// without recursion.
+///////////////////////////////////////////////////////////////////////////////
+void TransformHierarchy::sortNodes()
+{
+    std::size_t count = parentIds.size();
+    std::vector<int> sizes(count, 1);
+    for(std::size_t id = count; id-- > 0;)
+    {
+        if(parentIds[id] != NONE)
+            sizes[parentIds[id]] += sizes[id];
+    }
+
+    std::vector<int> positions(count);
+    std::vector<int> nextPositions(count);      // next free position for a child
+    int rootPosition = 0;
+    for(std::size_t id = 0; id < count; ++id)
+    {
+        int parentId = parentIds[id];
+        if(parentId == NONE)
+        {
+            positions[id] = rootPosition;
+            rootPosition += sizes[id];
+        }
+        else
+        {
+            positions[id] = nextPositions[parentId];
+            nextPositions[parentId] += sizes[id];
+        }
+        nextPositions[id] = positions[id] + 1;
+    }
+
+    // permute arrays
+    std::vector<Matrix4> newLocals(count);
+    std::vector<Matrix4> newWorlds(count);
+    std::vector<unsigned char> newDirtyFlags(count);
+    for(std::size_t id = 0; id < count; ++id)
+    {
+        int from = slots[id];
+        int to = positions[id];
+        newLocals[to] = locals[from];
+        newWorlds[to] = worlds[from];
+        newDirtyFlags[to] = dirtyFlags[from];
+        parents[to] = (parentIds[id] == NONE) ? NONE : positions[parentIds[id]];
+        subtreeEnds[to] = to + sizes[id];
+    }
+    locals.swap(newLocals);
+    worlds.swap(newWorlds);
+    dirtyFlags.swap(newDirtyFlags);
+    slots.swap(positions);
+
+    sorted = true;
+}
@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////
+// TransformHierarchy.h
+// ====================
+// Parent/child transform nodes with dirty-flag propagation
+//
+// The world matrix of a node is world(parent) * local(node). Nodes are kept
+// in flat arrays of local/world Matrix4 (structure of arrays), sorted in
+// depth-first order, so the descendants of a node are the contiguous range
+// [slot, subtreeEnd). setLocal() only raises the dirty flag of the node, and
+// update() recomputes the world matrices of the dirty subtrees only, skipping
+// clean subtrees. Root subtrees are independent, so update() splits them
+// into threads when the hierarchy is large, the workers of a ThreadPool if
+// one is given, or new threads for the call.
+//
+// Node IDs returned by addNode() stay valid when the arrays are re-sorted.
+//
+// Dependencies: Matrix4, ThreadPool
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TRANSFORM_HIERARCHY_H
+#define TRANSFORM_HIERARCHY_H
+
+#include <vector>
+#include <cstddef>
+#include "Matrices.h"
+
+class ThreadPool;                                       // ThreadPool.h
+
+class TransformHierarchy
+{
+public:
+    static const int NONE = -1;                         // parent of root nodes
+
+    // update() uses multiple threads if the number of nodes is at least
+    // PARALLEL_THRESHOLD and at least 1/PARALLEL_DIRTY_RATIO of them are dirty
+    static const std::size_t PARALLEL_THRESHOLD = 65536;
+    static const std::size_t PARALLEL_DIRTY_RATIO = 16;
+
+    TransformHierarchy();
+    ~TransformHierarchy() {}
+
+    int         addNode(int parentId, const Matrix4& local=Matrix4()); // return node ID, parent must exist
+    void        reserve(std::size_t count);
+    void        clear();
+
+    void        setLocal(int id, const Matrix4& local); // set local matrix and mark dirty
+    const Matrix4& getLocal(int id) const       { return locals[slots[id]]; }
+    const Matrix4& getWorld(int id) const       { return worlds[slots[id]]; }   // valid after update()
+    int         getParent(int id) const         { return parentIds[id]; }
+    bool        isDirty(int id) const           { return dirtyFlags[slots[id]] != 0; }
+    std::size_t getNodeCount() const            { return parentIds.size(); }
+    std::size_t getUpdatedCount() const         { return updatedCount; } // # of world matrices computed by last update()
+
+    void        update(int threadCount=0, ThreadPool* pool=0); // threadCount=0 uses all hardware threads, ignored with pool
+
+protected:
+
+private:
+    void        sortNodes();                    // depth-first order, compute subtree ranges
+    std::size_t updateRange(std::size_t first, std::size_t last);
+
+    // per node ID
+    std::vector<int> parentIds;
+    std::vector<int> slots;                     // ID -> array index
+
+    // per array index, in depth-first order
+    std::vector<Matrix4> locals;
+    std::vector<Matrix4> worlds;
+    std::vector<int> parents;                   // array index of parent, NONE for root
+    std::vector<int> subtreeEnds;               // one past the last descendant
+    std::vector<unsigned char> dirtyFlags;
+
+    std::size_t dirtyCount;
+    std::size_t updatedCount;
+    bool sorted;
+};
+
+#endif
@@ -0,0 +1,470 @@
+///////////////////////////////////////////////////////////////////////////////
+// VectorArrays.cpp
+// ================
+// Arrays of 3D/4D vectors stored as structure of arrays (SoA)
+//
+// Dependencies: Vector3, Vector4
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include "VectorArrays.h"
+#include "Simd.h"
+
+// kernels on component arrays, 4 elements per iteration then scalar tail
+static void addArray(float* a, const float* b, std::size_t count);
+static void addScalar(float* a, float s, std::size_t count);
+static void subtractArray(float* a, const float* b, std::size_t count);
+static void scaleArray(float* a, float s, std::size_t count);
+static void addScaledArray(float* a, const float* b, float s, std::size_t count);
+static void lerpArray(float* a, const float* b, float t, std::size_t count);
+static void dotArrays(const float* const a[], const float* const b[], int componentCount, float* out, std::size_t count);
+static void lengthArrays(const float* const a[], int componentCount, float* out, std::size_t count);
+static void invLengthFastArrays(const float* const a[], int componentCount, float* out, std::size_t count);
+static void normalizeArrays(float* const a[], std::size_t count);   // x, y, z
+static void normalizeFastArrays(float* const a[], std::size_t count);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Vector3Array
+///////////////////////////////////////////////////////////////////////////////
+Vector3Array& Vector3Array::add(const Vector3Array& rhs)
+{
+    addArray(x.data(), rhs.x.data(), size());
+    addArray(y.data(), rhs.y.data(), size());
+    addArray(z.data(), rhs.z.data(), size());
+    return *this;
+}
+
+Vector3Array& Vector3Array::add(const Vector3& v)
+{
+    addScalar(x.data(), v.x, size());
+    addScalar(y.data(), v.y, size());
+    addScalar(z.data(), v.z, size());
+    return *this;
+}
+
+Vector3Array& Vector3Array::subtract(const Vector3Array& rhs)
+{
+    subtractArray(x.data(), rhs.x.data(), size());
+    subtractArray(y.data(), rhs.y.data(), size());
+    subtractArray(z.data(), rhs.z.data(), size());
+    return *this;
+}
+
+Vector3Array& Vector3Array::scale(float s)
+{
+    scaleArray(x.data(), s, size());
+    scaleArray(y.data(), s, size());
+    scaleArray(z.data(), s, size());
+    return *this;
+}
+
+Vector3Array& Vector3Array::addScaled(const Vector3Array& rhs, float s)
+{
+    addScaledArray(x.data(), rhs.x.data(), s, size());
+    addScaledArray(y.data(), rhs.y.data(), s, size());
+    addScaledArray(z.data(), rhs.z.data(), s, size());
+    return *this;
+}
+
+Vector3Array& Vector3Array::lerp(const Vector3Array& to, float alpha)
+{
+    lerpArray(x.data(), to.x.data(), alpha, size());
+    lerpArray(y.data(), to.y.data(), alpha, size());
+    lerpArray(z.data(), to.z.data(), alpha, size());
+    return *this;
+}
+
+Vector3Array& Vector3Array::normalize()
+{
+    float* const a[3] = {x.data(), y.data(), z.data()};
+    normalizeArrays(a, size());
+    return *this;
+}
+
+Vector3Array& Vector3Array::normalizeFast()
+{
+    float* const a[3] = {x.data(), y.data(), z.data()};
+    normalizeFastArrays(a, size());
+    return *this;
+}
+
+void Vector3Array::dot(const Vector3Array& rhs, float* out) const
+{
+    const float* const a[3] = {x.data(), y.data(), z.data()};
+    const float* const b[3] = {rhs.x.data(), rhs.y.data(), rhs.z.data()};
+    dotArrays(a, b, 3, out, size());
+}
+
+void Vector3Array::length(float* out) const
+{
+    const float* const a[3] = {x.data(), y.data(), z.data()};
+    lengthArrays(a, 3, out, size());
+}
+
+void Vector3Array::invLengthFast(float* out) const
+{
+    const float* const a[3] = {x.data(), y.data(), z.data()};
+    invLengthFastArrays(a, 3, out, size());
+}
+
+void Vector3Array::cross(const Vector3Array& rhs, Vector3Array& out) const
+{
+    std::size_t count = size();
+    out.resize(count);
+    const float* ax = x.data();     const float* ay = y.data();     const float* az = z.data();
+    const float* bx = rhs.x.data(); const float* by = rhs.y.data(); const float* bz = rhs.z.data();
+    float* ox = out.x.data();       float* oy = out.y.data();       float* oz = out.z.data();
+
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    for(; i + 4 <= count; i += 4)
+    {
+        simd4f x1 = simdLoad(ax + i), y1 = simdLoad(ay + i), z1 = simdLoad(az + i);
+        simd4f x2 = simdLoad(bx + i), y2 = simdLoad(by + i), z2 = simdLoad(bz + i);
+        simdStore(ox + i, simdSub(simdMul(y1, z2), simdMul(z1, y2)));
+        simdStore(oy + i, simdSub(simdMul(z1, x2), simdMul(x1, z2)));
+        simdStore(oz + i, simdSub(simdMul(x1, y2), simdMul(y1, x2)));
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        float x1 = ax[i], y1 = ay[i], z1 = az[i];
+        float x2 = bx[i], y2 = by[i], z2 = bz[i];
+        ox[i] = y1 * z2 - z1 * y2;
+        oy[i] = z1 * x2 - x1 * z2;
+        oz[i] = x1 * y2 - y1 * x2;
+    }
+}
+
+void Vector3Array::load(const ConstVector3View& view)
+{
+    resize(view.count);
+    for(std::size_t i = 0; i < view.count; ++i)
+    {
+        const float* p = view.at(i);
+        x[i] = p[0];
+        y[i] = p[1];
+        z[i] = p[2];
+    }
+}
+
+void Vector3Array::store(const Vector3View& view) const
+{
+    std::size_t count = size();
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        float* p = view.at(i);
+        p[0] = x[i];
+        p[1] = y[i];
+        p[2] = z[i];
+    }
+}
+// END OF VECTOR3ARRAY ////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Vector4Array
+///////////////////////////////////////////////////////////////////////////////
+Vector4Array& Vector4Array::add(const Vector4Array& rhs)
+{
+    addArray(x.data(), rhs.x.data(), size());
+    addArray(y.data(), rhs.y.data(), size());
+    addArray(z.data(), rhs.z.data(), size());
+    addArray(w.data(), rhs.w.data(), size());
+    return *this;
+}
+
+Vector4Array& Vector4Array::add(const Vector4& v)
+{
+    addScalar(x.data(), v.x, size());
+    addScalar(y.data(), v.y, size());
+    addScalar(z.data(), v.z, size());
+    addScalar(w.data(), v.w, size());
+    return *this;
+}
+
+Vector4Array& Vector4Array::subtract(const Vector4Array& rhs)
+{
+    subtractArray(x.data(), rhs.x.data(), size());
+    subtractArray(y.data(), rhs.y.data(), size());
+    subtractArray(z.data(), rhs.z.data(), size());
+    subtractArray(w.data(), rhs.w.data(), size());
+    return *this;
+}
+
+Vector4Array& Vector4Array::scale(float s)
+{
+    scaleArray(x.data(), s, size());
+    scaleArray(y.data(), s, size());
+    scaleArray(z.data(), s, size());
+    scaleArray(w.data(), s, size());
+    return *this;
+}
+
+Vector4Array& Vector4Array::addScaled(const Vector4Array& rhs, float s)
+{
+    addScaledArray(x.data(), rhs.x.data(), s, size());
+    addScaledArray(y.data(), rhs.y.data(), s, size());
+    addScaledArray(z.data(), rhs.z.data(), s, size());
+    addScaledArray(w.data(), rhs.w.data(), s, size());
+    return *this;
+}
+
+Vector4Array& Vector4Array::lerp(const Vector4Array& to, float alpha)
+{
+    lerpArray(x.data(), to.x.data(), alpha, size());
+    lerpArray(y.data(), to.y.data(), alpha, size());
+    lerpArray(z.data(), to.z.data(), alpha, size());
+    lerpArray(w.data(), to.w.data(), alpha, size());
+    return *this;
+}
+
+Vector4Array& Vector4Array::normalize()
+{
+    float* const a[3] = {x.data(), y.data(), z.data()};
+    normalizeArrays(a, size());
+    return *this;
+}
+
+Vector4Array& Vector4Array::normalizeFast()
+{
+    float* const a[3] = {x.data(), y.data(), z.data()};
+    normalizeFastArrays(a, size());
+    return *this;
+}
+
+void Vector4Array::dot(const Vector4Array& rhs, float* out) const
+{
+    const float* const a[4] = {x.data(), y.data(), z.data(), w.data()};
+    const float* const b[4] = {rhs.x.data(), rhs.y.data(), rhs.z.data(), rhs.w.data()};
+    dotArrays(a, b, 4, out, size());
+}
+
+void Vector4Array::length(float* out) const
+{
+    const float* const a[4] = {x.data(), y.data(), z.data(), w.data()};
+    lengthArrays(a, 4, out, size());
+}
+
+void Vector4Array::invLengthFast(float* out) const
+{
+    const float* const a[4] = {x.data(), y.data(), z.data(), w.data()};
+    invLengthFastArrays(a, 4, out, size());
+}
+
+void Vector4Array::load(const ConstVector4View& view)
+{
+    resize(view.count);
+    for(std::size_t i = 0; i < view.count; ++i)
+    {
+        const float* p = view.at(i);
+        x[i] = p[0];
+        y[i] = p[1];
+        z[i] = p[2];
+        w[i] = p[3];
+    }
+}
+
+void Vector4Array::store(const Vector4View& view) const
+{
+    std::size_t count = size();
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        float* p = view.at(i);
+        p[0] = x[i];
+        p[1] = y[i];
+        p[2] = z[i];
+        p[3] = w[i];
+    }
+}
+// END OF VECTOR4ARRAY ////////////////////////////////////////////////////////
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// component-wise kernels
+///////////////////////////////////////////////////////////////////////////////
+static void addArray(float* a, const float* b, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    for(; i + 4 <= count; i += 4)
+        simdStore(a + i, simdAdd(simdLoad(a + i), simdLoad(b + i)));
+#endif
+    for(; i < count; ++i)
+        a[i] += b[i];
+}
+
+static void addScalar(float* a, float s, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    simd4f vs = simdSet1(s);
+    for(; i + 4 <= count; i += 4)
+        simdStore(a + i, simdAdd(simdLoad(a + i), vs));
+#endif
+    for(; i < count; ++i)
+        a[i] += s;
+}
+
+static void subtractArray(float* a, const float* b, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    for(; i + 4 <= count; i += 4)
+        simdStore(a + i, simdSub(simdLoad(a + i), simdLoad(b + i)));
+#endif
+    for(; i < count; ++i)
+        a[i] -= b[i];
+}
+
+static void scaleArray(float* a, float s, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    simd4f vs = simdSet1(s);
+    for(; i + 4 <= count; i += 4)
+        simdStore(a + i, simdMul(simdLoad(a + i), vs));
+#endif
+    for(; i < count; ++i)
+        a[i] *= s;
+}
+
+static void addScaledArray(float* a, const float* b, float s, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    simd4f vs = simdSet1(s);
+    for(; i + 4 <= count; i += 4)
+        simdStore(a + i, simdMadd(simdLoad(b + i), vs, simdLoad(a + i)));
+#endif
+    for(; i < count; ++i)
+        a[i] += b[i] * s;
+}
+
+static void lerpArray(float* a, const float* b, float t, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    simd4f vt = simdSet1(t);
+    for(; i + 4 <= count; i += 4)
+    {
+        simd4f va = simdLoad(a + i);
+        simdStore(a + i, simdMadd(simdSub(simdLoad(b + i), va), vt, va));
+    }
+#endif
+    for(; i < count; ++i)
+        a[i] += (b[i] - a[i]) * t;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// kernels across components (3 or 4 arrays)
+///////////////////////////////////////////////////////////////////////////////
+static void dotArrays(const float* const a[], const float* const b[], int componentCount, float* out, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    for(; i + 4 <= count; i += 4)
+    {
+        simd4f sum = simdMul(simdLoad(a[0] + i), simdLoad(b[0] + i));
+        for(int c = 1; c < componentCount; ++c)
+            sum = simdMadd(simdLoad(a[c] + i), simdLoad(b[c] + i), sum);
+        simdStore(out + i, sum);
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        float sum = a[0][i] * b[0][i];
+        for(int c = 1; c < componentCount; ++c)
+            sum += a[c][i] * b[c][i];
+        out[i] = sum;
+    }
+}
+
+static void lengthArrays(const float* const a[], int componentCount, float* out, std::size_t count)
+{
+    dotArrays(a, a, componentCount, out, count);
+
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    for(; i + 4 <= count; i += 4)
+        simdStore(out + i, simdSqrt(simdLoad(out + i)));
+#endif
+    for(; i < count; ++i)
+        out[i] = sqrtf(out[i]);
+}
+
+static void invLengthFastArrays(const float* const a[], int componentCount, float* out, std::size_t count)
+{
+    dotArrays(a, a, componentCount, out, count);
+
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    for(; i + 4 <= count; i += 4)
+        simdStore(out + i, simdInvSqrtFast(simdLoad(out + i)));
+#endif
+    for(; i < count; ++i)
+        out[i] = invSqrtFast(out[i]);
+}
+
+static void normalizeArrays(float* const a[], std::size_t count)
+{
+    float* x = a[0];
+    float* y = a[1];
+    float* z = a[2];
+
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    simd4f one = simdSet1(1.0f);
+    for(; i + 4 <= count; i += 4)
+    {
+        simd4f vx = simdLoad(x + i), vy = simdLoad(y + i), vz = simdLoad(z + i);
+        simd4f lengthSq = simdMadd(vx, vx, simdMadd(vy, vy, simdMul(vz, vz)));
+        simd4f invLength = simdDiv(one, simdSqrt(lengthSq));
+        simdStore(x + i, simdMul(vx, invLength));
+        simdStore(y + i, simdMul(vy, invLength));
+        simdStore(z + i, simdMul(vz, invLength));
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        float invLength = 1.0f / sqrtf(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        x[i] *= invLength;
+        y[i] *= invLength;
+        z[i] *= invLength;
+    }
+}
+
+static void normalizeFastArrays(float* const a[], std::size_t count)
+{
+    float* x = a[0];
+    float* y = a[1];
+    float* z = a[2];
+
+    std::size_t i = 0;
+#if defined(SIMD_FLOAT4)
+    for(; i + 4 <= count; i += 4)
+    {
+        simd4f vx = simdLoad(x + i), vy = simdLoad(y + i), vz = simdLoad(z + i);
+        simd4f invLength = simdInvSqrtFast(simdMadd(vx, vx, simdMadd(vy, vy, simdMul(vz, vz))));
+        simdStore(x + i, simdMul(vx, invLength));
+        simdStore(y + i, simdMul(vy, invLength));
+        simdStore(z + i, simdMul(vz, invLength));
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        float invLength = invSqrtFast(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        x[i] *= invLength;
+        y[i] *= invLength;
+        z[i] *= invLength;
+    }
+}
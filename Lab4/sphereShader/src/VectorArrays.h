@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////
+// VectorArrays.h
+// ==============
+// Arrays of 3D/4D vectors stored as structure of arrays (SoA)
+//
+// Each component is a separate float array aligned to 32 bytes, so the bulk
+// operations process 4 vectors per SIMD instruction without shuffles, instead
+// of one Vector3 temporary at a time. The bulk operations work in place
+// (this = this op rhs) and the arrays must have the same size.
+//
+// Vector3View/Vector4View refer to interleaved (array of structures) vertex
+// data with a byte stride without copying, e.g. positions and normals of
+// Sphere::getInterleavedVertices() (stride=32, offset 0 and 12 bytes).
+// load() deinterleaves a view into the arrays, and store() interleaves back.
+//
+// Dependencies: Vector3, Vector4
+//
+// CREATED: 2026-10-19
+// UPDATED: 2026-10-19
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef MATH_VECTOR_ARRAYS_H
+#define MATH_VECTOR_ARRAYS_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "Vectors.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// std allocator returning memory aligned to ALIGN bytes
+///////////////////////////////////////////////////////////////////////////////
+template<class T, std::size_t ALIGN=32>
+struct AlignedAllocator
+{
+    typedef T value_type;
+    template<class U> struct rebind { typedef AlignedAllocator<U, ALIGN> other; };
+
+    AlignedAllocator() {}
+    template<class U> AlignedAllocator(const AlignedAllocator<U, ALIGN>&) {}
+
+    // allocate extra ALIGN bytes, and keep the original pointer before the aligned block
+    T* allocate(std::size_t n)
+    {
+        void* p = std::malloc(n * sizeof(T) + ALIGN + sizeof(void*));
+        if(!p)
+            throw std::bad_alloc();
+        std::size_t addr = ((std::size_t)p + sizeof(void*) + ALIGN - 1) & ~(ALIGN - 1);
+        ((void**)addr)[-1] = p;
+        return (T*)addr;
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+        if(p)
+            std::free(((void**)p)[-1]);
+    }
+
+    template<class U> bool operator==(const AlignedAllocator<U, ALIGN>&) const { return true; }
+    template<class U> bool operator!=(const AlignedAllocator<U, ALIGN>&) const { return false; }
+};
+
+typedef std::vector<float, AlignedAllocator<float> > FloatArray;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// views of interleaved vectors, stride is in bytes
+// T is float or const float
+///////////////////////////////////////////////////////////////////////////////
+template<class T>
+struct StridedVector3
+{
+    T* data;
+    int stride;
+    std::size_t count;
+
+    StridedVector3(T* data, int stride, std::size_t count) : data(data), stride(stride), count(count) {}
+    T* at(std::size_t i) const                  { return (T*)((const char*)data + i * stride); }
+    Vector3 get(std::size_t i) const            { T* p = at(i); return Vector3(p[0], p[1], p[2]); }
+    void set(std::size_t i, const Vector3& v) const { T* p = at(i); p[0] = v.x; p[1] = v.y; p[2] = v.z; }
+};
+
+template<class T>
+struct StridedVector4
+{
+    T* data;
+    int stride;
+    std::size_t count;
+
+    StridedVector4(T* data, int stride, std::size_t count) : data(data), stride(stride), count(count) {}
+    T* at(std::size_t i) const                  { return (T*)((const char*)data + i * stride); }
+    Vector4 get(std::size_t i) const            { T* p = at(i); return Vector4(p[0], p[1], p[2], p[3]); }
+    void set(std::size_t i, const Vector4& v) const { T* p = at(i); p[0] = v.x; p[1] = v.y; p[2] = v.z; p[3] = v.w; }
+};
+
+typedef StridedVector3<float>       Vector3View;
+typedef StridedVector3<const float> ConstVector3View;
+typedef StridedVector4<float>       Vector4View;
+typedef StridedVector4<const float> ConstVector4View;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SoA array of Vector3
+///////////////////////////////////////////////////////////////////////////////
+class Vector3Array
+{
+public:
+    Vector3Array() {}
+    explicit Vector3Array(std::size_t count) : x(count), y(count), z(count) {}
+    explicit Vector3Array(const ConstVector3View& view)     { load(view); }
+    ~Vector3Array() {}
+
+    std::size_t size() const                    { return x.size(); }
+    void        resize(std::size_t count)       { x.resize(count); y.resize(count); z.resize(count); }
+    void        reserve(std::size_t count)      { x.reserve(count); y.reserve(count); z.reserve(count); }
+    void        clear()                         { x.clear(); y.clear(); z.clear(); }
+    void        append(const Vector3& v)        { x.push_back(v.x); y.push_back(v.y); z.push_back(v.z); }
+    void        set(std::size_t i, const Vector3& v) { x[i] = v.x; y[i] = v.y; z[i] = v.z; }
+    Vector3     get(std::size_t i) const        { return Vector3(x[i], y[i], z[i]); }
+
+    float*       getX()                         { return x.data(); }
+    float*       getY()                         { return y.data(); }
+    float*       getZ()                         { return z.data(); }
+    const float* getX() const                   { return x.data(); }
+    const float* getY() const                   { return y.data(); }
+    const float* getZ() const                   { return z.data(); }
+
+    // bulk operations
+    Vector3Array& add(const Vector3Array& rhs);                     // this += rhs
+    Vector3Array& add(const Vector3& v);                            // this += v for all
+    Vector3Array& subtract(const Vector3Array& rhs);                // this -= rhs
+    Vector3Array& scale(float s);                                   // this *= s
+    Vector3Array& addScaled(const Vector3Array& rhs, float s);      // this += rhs * s
+    Vector3Array& lerp(const Vector3Array& to, float alpha);        // this += (to - this) * alpha
+    Vector3Array& normalize();                                      // zero vectors become NaN
+    Vector3Array& normalizeFast();                                  // approximate, see invSqrtFast()
+    void        dot(const Vector3Array& rhs, float* out) const;     // out[i] = this[i] . rhs[i]
+    void        length(float* out) const;                           // out[i] = |this[i]|
+    void        invLengthFast(float* out) const;                    // out[i] ~ 1/|this[i]|
+    void        cross(const Vector3Array& rhs, Vector3Array& out) const; // out = this x rhs, out may be this
+
+    // deinterleave/interleave
+    void        load(const ConstVector3View& view);                 // resize and copy from view
+    void        store(const Vector3View& view) const;               // copy to view, view.count >= size()
+
+private:
+    FloatArray x, y, z;
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SoA array of Vector4
+// Same as Vector4, dot() and length() use 4 components and normalize()
+// leaves w untouched.
+///////////////////////////////////////////////////////////////////////////////
+class Vector4Array
+{
+public:
+    Vector4Array() {}
+    explicit Vector4Array(std::size_t count) : x(count), y(count), z(count), w(count) {}
+    explicit Vector4Array(const ConstVector4View& view)     { load(view); }
+    ~Vector4Array() {}
+
+    std::size_t size() const                    { return x.size(); }
+    void        resize(std::size_t count)       { x.resize(count); y.resize(count); z.resize(count); w.resize(count); }
+    void        reserve(std::size_t count)      { x.reserve(count); y.reserve(count); z.reserve(count); w.reserve(count); }
+    void        clear()                         { x.clear(); y.clear(); z.clear(); w.clear(); }
+    void        append(const Vector4& v)        { x.push_back(v.x); y.push_back(v.y); z.push_back(v.z); w.push_back(v.w); }
+    void        set(std::size_t i, const Vector4& v) { x[i] = v.x; y[i] = v.y; z[i] = v.z; w[i] = v.w; }
+    Vector4     get(std::size_t i) const        { return Vector4(x[i], y[i], z[i], w[i]); }
+
+    float*       getX()                         { return x.data(); }
+    float*       getY()                         { return y.data(); }
+    float*       getZ()                         { return z.data(); }
+    float*       getW()                         { return w.data(); }
+    const float* getX() const                   { return x.data(); }
+    const float* getY() const                   { return y.data(); }
+    const float* getZ() const                   { return z.data(); }
+    const float* getW() const                   { return w.data(); }
+
+    // bulk operations
+    Vector4Array& add(const Vector4Array& rhs);
+    Vector4Array& add(const Vector4& v);
+    Vector4Array& subtract(const Vector4Array& rhs);
+    Vector4Array& scale(float s);
+    Vector4Array& addScaled(const Vector4Array& rhs, float s);
+    Vector4Array& lerp(const Vector4Array& to, float alpha);
+    Vector4Array& normalize();                                      // xyz only
+    Vector4Array& normalizeFast();                                  // xyz only
+    void        dot(const Vector4Array& rhs, float* out) const;
+    void        length(float* out) const;
+    void        invLengthFast(float* out) const;
+
+    // deinterleave/interleave
+    void        load(const ConstVector4View& view);
+    void        store(const Vector4View& view) const;
+
+private:
+    FloatArray x, y, z, w;
+};
+
+#endif
@@ -16,6 +16,7 @@
 
 #include <cmath>
 #include <iostream>
+#include "Simd.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 // 2D vector
@@ -26,36 +27,36 @@ struct Vector2
     float y;
 
     // ctors
-    Vector2() : x(0), y(0) {};
-    Vector2(float x, float y) : x(x), y(y) {};
+    constexpr Vector2() : x(0), y(0) {};
+    constexpr Vector2(float x, float y) : x(x), y(y) {};
 
     // utils functions
-    Vector2&    set(float x, float y);
+    constexpr Vector2&    set(float x, float y);
     float       length() const;                         //
     float       distance(const Vector2& vec) const;     // distance between two vectors
     Vector2&    normalize();                            //
-    float       dot(const Vector2& vec) const;          // dot product
+    constexpr float       dot(const Vector2& vec) const;          // dot product
     bool        equal(const Vector2& vec, float e) const; // compare with epsilon
 
     // operators
-    Vector2     operator-() const;                      // unary operator (negate)
-    Vector2     operator+(const Vector2& rhs) const;    // add rhs
-    Vector2     operator-(const Vector2& rhs) const;    // subtract rhs
-    Vector2&    operator+=(const Vector2& rhs);         // add rhs and update this object
-    Vector2&    operator-=(const Vector2& rhs);         // subtract rhs and update this object
-    Vector2     operator*(const float scale) const;     // scale
-    Vector2     operator*(const Vector2& rhs) const;    // multiply each element
-    Vector2&    operator*=(const float scale);          // scale and update this object
-    Vector2&    operator*=(const Vector2& rhs);         // multiply each element and update this object
-    Vector2     operator/(const float scale) const;     // inverse scale
-    Vector2&    operator/=(const float scale);          // scale and update this object
-    bool        operator==(const Vector2& rhs) const;   // exact compare, no epsilon
-    bool        operator!=(const Vector2& rhs) const;   // exact compare, no epsilon
-    bool        operator<(const Vector2& rhs) const;    // comparison for sort
+    constexpr Vector2     operator-() const;                      // unary operator (negate)
+    constexpr Vector2     operator+(const Vector2& rhs) const;    // add rhs
+    constexpr Vector2     operator-(const Vector2& rhs) const;    // subtract rhs
+    constexpr Vector2&    operator+=(const Vector2& rhs);         // add rhs and update this object
+    constexpr Vector2&    operator-=(const Vector2& rhs);         // subtract rhs and update this object
+    constexpr Vector2     operator*(const float scale) const;     // scale
+    constexpr Vector2     operator*(const Vector2& rhs) const;    // multiply each element
+    constexpr Vector2&    operator*=(const float scale);          // scale and update this object
+    constexpr Vector2&    operator*=(const Vector2& rhs);         // multiply each element and update this object
+    constexpr Vector2     operator/(const float scale) const;     // inverse scale
+    constexpr Vector2&    operator/=(const float scale);          // scale and update this object
+    constexpr bool        operator==(const Vector2& rhs) const;   // exact compare, no epsilon
+    constexpr bool        operator!=(const Vector2& rhs) const;   // exact compare, no epsilon
+    constexpr bool        operator<(const Vector2& rhs) const;    // comparison for sort
     float       operator[](int index) const;            // subscript operator v[0], v[1]
     float&      operator[](int index);                  // subscript operator v[0], v[1]
 
-    friend Vector2 operator*(const float a, const Vector2 vec);
+    friend constexpr Vector2 operator*(const float a, const Vector2 vec);
     friend std::ostream& operator<<(std::ostream& os, const Vector2& vec);
 };
 
@@ -71,38 +72,40 @@ struct Vector3
     float z;
 
     // ctors
-    Vector3() : x(0), y(0), z(0) {};
-    Vector3(float x, float y, float z) : x(x), y(y), z(z) {};
+    constexpr Vector3() : x(0), y(0), z(0) {};
+    constexpr Vector3(float x, float y, float z) : x(x), y(y), z(z) {};
 
     // utils functions
-    Vector3&    set(float x, float y, float z);
+    constexpr Vector3&    set(float x, float y, float z);
     float       length() const;                         //
     float       distance(const Vector3& vec) const;     // distance between two vectors
     float       angle(const Vector3& vec) const;        // angle between two vectors
     Vector3&    normalize();                            //
-    float       dot(const Vector3& vec) const;          // dot product
-    Vector3     cross(const Vector3& vec) const;        // cross product
+    float       invLengthFast() const;                  // approximate 1/length, see invSqrtFast()
+    Vector3&    normalizeFast();                        // approximate normalize, zero vector becomes NaN as normalize()
+    constexpr float       dot(const Vector3& vec) const;          // dot product
+    constexpr Vector3     cross(const Vector3& vec) const;        // cross product
     bool        equal(const Vector3& vec, float e) const; // compare with epsilon
 
     // operators
-    Vector3     operator-() const;                      // unary operator (negate)
-    Vector3     operator+(const Vector3& rhs) const;    // add rhs
-    Vector3     operator-(const Vector3& rhs) const;    // subtract rhs
-    Vector3&    operator+=(const Vector3& rhs);         // add rhs and update this object
-    Vector3&    operator-=(const Vector3& rhs);         // subtract rhs and update this object
-    Vector3     operator*(const float scale) const;     // scale
-    Vector3     operator*(const Vector3& rhs) const;    // multiplay each element
-    Vector3&    operator*=(const float scale);          // scale and update this object
-    Vector3&    operator*=(const Vector3& rhs);         // product each element and update this object
-    Vector3     operator/(const float scale) const;     // inverse scale
-    Vector3&    operator/=(const float scale);          // scale and update this object
-    bool        operator==(const Vector3& rhs) const;   // exact compare, no epsilon
-    bool        operator!=(const Vector3& rhs) const;   // exact compare, no epsilon
-    bool        operator<(const Vector3& rhs) const;    // comparison for sort
+    constexpr Vector3     operator-() const;                      // unary operator (negate)
+    constexpr Vector3     operator+(const Vector3& rhs) const;    // add rhs
+    constexpr Vector3     operator-(const Vector3& rhs) const;    // subtract rhs
+    constexpr Vector3&    operator+=(const Vector3& rhs);         // add rhs and update this object
+    constexpr Vector3&    operator-=(const Vector3& rhs);         // subtract rhs and update this object
+    constexpr Vector3     operator*(const float scale) const;     // scale
+    constexpr Vector3     operator*(const Vector3& rhs) const;    // multiplay each element
+    constexpr Vector3&    operator*=(const float scale);          // scale and update this object
+    constexpr Vector3&    operator*=(const Vector3& rhs);         // product each element and update this object
+    constexpr Vector3     operator/(const float scale) const;     // inverse scale
+    constexpr Vector3&    operator/=(const float scale);          // scale and update this object
+    constexpr bool        operator==(const Vector3& rhs) const;   // exact compare, no epsilon
+    constexpr bool        operator!=(const Vector3& rhs) const;   // exact compare, no epsilon
+    constexpr bool        operator<(const Vector3& rhs) const;    // comparison for sort
     float       operator[](int index) const;            // subscript operator v[0], v[1]
     float&      operator[](int index);                  // subscript operator v[0], v[1]
 
-    friend Vector3 operator*(const float a, const Vector3 vec);
+    friend constexpr Vector3 operator*(const float a, const Vector3 vec);
     friend std::ostream& operator<<(std::ostream& os, const Vector3& vec);
 };
 
@@ -119,36 +122,38 @@ struct Vector4
     float w;
 
     // ctors
-    Vector4() : x(0), y(0), z(0), w(0) {};
-    Vector4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {};
+    constexpr Vector4() : x(0), y(0), z(0), w(0) {};
+    constexpr Vector4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {};
 
     // utils functions
-    Vector4&    set(float x, float y, float z, float w);
+    constexpr Vector4&    set(float x, float y, float z, float w);
     float       length() const;                         //
     float       distance(const Vector4& vec) const;     // distance between two vectors
     Vector4&    normalize();                            //
-    float       dot(const Vector4& vec) const;          // dot product
+    float       invLengthFast() const;                  // approximate 1/length, see invSqrtFast()
+    Vector4&    normalizeFast();                        // approximate normalize, zero vector becomes NaN as normalize()
+    constexpr float       dot(const Vector4& vec) const;          // dot product
     bool        equal(const Vector4& vec, float e) const; // compare with epsilon
 
     // operators
-    Vector4     operator-() const;                      // unary operator (negate)
-    Vector4     operator+(const Vector4& rhs) const;    // add rhs
-    Vector4     operator-(const Vector4& rhs) const;    // subtract rhs
-    Vector4&    operator+=(const Vector4& rhs);         // add rhs and update this object
-    Vector4&    operator-=(const Vector4& rhs);         // subtract rhs and update this object
-    Vector4     operator*(const float scale) const;     // scale
-    Vector4     operator*(const Vector4& rhs) const;    // multiply each element
-    Vector4&    operator*=(const float scale);          // scale and update this object
-    Vector4&    operator*=(const Vector4& rhs);         // multiply each element and update this object
-    Vector4     operator/(const float scale) const;     // inverse scale
-    Vector4&    operator/=(const float scale);          // scale and update this object
-    bool        operator==(const Vector4& rhs) const;   // exact compare, no epsilon
-    bool        operator!=(const Vector4& rhs) const;   // exact compare, no epsilon
-    bool        operator<(const Vector4& rhs) const;    // comparison for sort
+    constexpr Vector4     operator-() const;                      // unary operator (negate)
+    constexpr Vector4     operator+(const Vector4& rhs) const;    // add rhs
+    constexpr Vector4     operator-(const Vector4& rhs) const;    // subtract rhs
+    constexpr Vector4&    operator+=(const Vector4& rhs);         // add rhs and update this object
+    constexpr Vector4&    operator-=(const Vector4& rhs);         // subtract rhs and update this object
+    constexpr Vector4     operator*(const float scale) const;     // scale
+    constexpr Vector4     operator*(const Vector4& rhs) const;    // multiply each element
+    constexpr Vector4&    operator*=(const float scale);          // scale and update this object
+    constexpr Vector4&    operator*=(const Vector4& rhs);         // multiply each element and update this object
+    constexpr Vector4     operator/(const float scale) const;     // inverse scale
+    constexpr Vector4&    operator/=(const float scale);          // scale and update this object
+    constexpr bool        operator==(const Vector4& rhs) const;   // exact compare, no epsilon
+    constexpr bool        operator!=(const Vector4& rhs) const;   // exact compare, no epsilon
+    constexpr bool        operator<(const Vector4& rhs) const;    // comparison for sort
     float       operator[](int index) const;            // subscript operator v[0], v[1]
     float&      operator[](int index);                  // subscript operator v[0], v[1]
 
-    friend Vector4 operator*(const float a, const Vector4 vec);
+    friend constexpr Vector4 operator*(const float a, const Vector4 vec);
     friend std::ostream& operator<<(std::ostream& os, const Vector4& vec);
 };
 
@@ -165,64 +170,90 @@ inline float invSqrt(float x)
     return x;
 }
 
+// approximate 1/sqrt(x) with hardware estimate and Newton step(s)
+// Max relative error is about 2.7e-7 (SSE, 1 step) vs 9e-8 of 1/sqrtf(x).
+// It pays off only where sqrt and divide are slow (older x86, small ARM cores);
+// recent x86 pipelines sqrtss/divss well and this is no faster, so measure
+// before using it in a hot loop. Zero becomes inf as 1/sqrtf(); the Newton
+// step would make it NaN (0 * inf), so zero keeps the estimate. Without SIMD
+// it is 1/sqrtf(x). Same result as simdInvSqrtFast() lane by lane.
+inline float invSqrtFast(float x)
+{
+#if defined(SIMD_SSE2)
+    __m128 a = _mm_set_ss(x);
+    __m128 y = _mm_rsqrt_ss(a);
+    __m128 ayy = _mm_mul_ss(_mm_mul_ss(_mm_mul_ss(_mm_set_ss(0.5f), a), y), y);
+    __m128 r = _mm_mul_ss(y, _mm_sub_ss(_mm_set_ss(1.5f), ayy));
+    __m128 zero = _mm_cmpeq_ss(a, _mm_setzero_ps());
+    return _mm_cvtss_f32(_mm_or_ps(_mm_and_ps(zero, y), _mm_andnot_ps(zero, r)));
+#elif defined(SIMD_NEON)
+    float y0 = vrsqrtes_f32(x);
+    float y = y0 * vrsqrtss_f32(x * y0, y0);
+    y *= vrsqrtss_f32(x * y, y);
+    return (x == 0.0f) ? y0 : y;
+#else
+    return 1.0f / sqrtf(x);
+#endif
+}
+
 
 
 ///////////////////////////////////////////////////////////////////////////////
 // inline functions for Vector2
 ///////////////////////////////////////////////////////////////////////////////
-inline Vector2 Vector2::operator-() const {
+constexpr Vector2 Vector2::operator-() const {
     return Vector2(-x, -y);
 }
 
-inline Vector2 Vector2::operator+(const Vector2& rhs) const {
+constexpr Vector2 Vector2::operator+(const Vector2& rhs) const {
     return Vector2(x+rhs.x, y+rhs.y);
 }
 
-inline Vector2 Vector2::operator-(const Vector2& rhs) const {
+constexpr Vector2 Vector2::operator-(const Vector2& rhs) const {
     return Vector2(x-rhs.x, y-rhs.y);
 }
 
-inline Vector2& Vector2::operator+=(const Vector2& rhs) {
+constexpr Vector2& Vector2::operator+=(const Vector2& rhs) {
     x += rhs.x; y += rhs.y; return *this;
 }
 
-inline Vector2& Vector2::operator-=(const Vector2& rhs) {
+constexpr Vector2& Vector2::operator-=(const Vector2& rhs) {
     x -= rhs.x; y -= rhs.y; return *this;
 }
 
-inline Vector2 Vector2::operator*(const float a) const {
+constexpr Vector2 Vector2::operator*(const float a) const {
     return Vector2(x*a, y*a);
 }
 
-inline Vector2 Vector2::operator*(const Vector2& rhs) const {
+constexpr Vector2 Vector2::operator*(const Vector2& rhs) const {
     return Vector2(x*rhs.x, y*rhs.y);
 }
 
-inline Vector2& Vector2::operator*=(const float a) {
+constexpr Vector2& Vector2::operator*=(const float a) {
     x *= a; y *= a; return *this;
 }
 
-inline Vector2& Vector2::operator*=(const Vector2& rhs) {
+constexpr Vector2& Vector2::operator*=(const Vector2& rhs) {
     x *= rhs.x; y *= rhs.y; return *this;
 }
 
-inline Vector2 Vector2::operator/(const float a) const {
+constexpr Vector2 Vector2::operator/(const float a) const {
     return Vector2(x/a, y/a);
 }
 
-inline Vector2& Vector2::operator/=(const float a) {
+constexpr Vector2& Vector2::operator/=(const float a) {
     x /= a; y /= a; return *this;
 }
 
-inline bool Vector2::operator==(const Vector2& rhs) const {
+constexpr bool Vector2::operator==(const Vector2& rhs) const {
     return (x == rhs.x) && (y == rhs.y);
 }
 
-inline bool Vector2::operator!=(const Vector2& rhs) const {
+constexpr bool Vector2::operator!=(const Vector2& rhs) const {
     return (x != rhs.x) || (y != rhs.y);
 }
 
-inline bool Vector2::operator<(const Vector2& rhs) const {
+constexpr bool Vector2::operator<(const Vector2& rhs) const {
     if(x < rhs.x) return true;
     if(x > rhs.x) return false;
     if(y < rhs.y) return true;
@@ -238,7 +269,7 @@ inline float& Vector2::operator[](int index) {
     return (&x)[index];
 }
 
-inline Vector2& Vector2::set(float x, float y) {
+constexpr Vector2& Vector2::set(float x, float y) {
     this->x = x; this->y = y; return *this;
 }
 
@@ -263,7 +294,7 @@ inline Vector2& Vector2::normalize() {
     return *this;
 }
 
-inline float Vector2::dot(const Vector2& rhs) const {
+constexpr float Vector2::dot(const Vector2& rhs) const {
     return (x*rhs.x + y*rhs.y);
 }
 
@@ -271,7 +302,7 @@ inline bool Vector2::equal(const Vector2& rhs, float epsilon) const {
     return fabs(x - rhs.x) < epsilon && fabs(y - rhs.y) < epsilon;
 }
 
-inline Vector2 operator*(const float a, const Vector2 vec) {
+constexpr Vector2 operator*(const float a, const Vector2 vec) {
     return Vector2(a*vec.x, a*vec.y);
 }
 
@@ -287,59 +318,59 @@ inline std::ostream& operator<<(std::ostream& os, const Vector2& vec) {
 ///////////////////////////////////////////////////////////////////////////////
 // inline functions for Vector3
 ///////////////////////////////////////////////////////////////////////////////
-inline Vector3 Vector3::operator-() const {
+constexpr Vector3 Vector3::operator-() const {
     return Vector3(-x, -y, -z);
 }
 
-inline Vector3 Vector3::operator+(const Vector3& rhs) const {
+constexpr Vector3 Vector3::operator+(const Vector3& rhs) const {
     return Vector3(x+rhs.x, y+rhs.y, z+rhs.z);
 }
 
-inline Vector3 Vector3::operator-(const Vector3& rhs) const {
+constexpr Vector3 Vector3::operator-(const Vector3& rhs) const {
     return Vector3(x-rhs.x, y-rhs.y, z-rhs.z);
 }
 
-inline Vector3& Vector3::operator+=(const Vector3& rhs) {
+constexpr Vector3& Vector3::operator+=(const Vector3& rhs) {
     x += rhs.x; y += rhs.y; z += rhs.z; return *this;
 }
 
-inline Vector3& Vector3::operator-=(const Vector3& rhs) {
+constexpr Vector3& Vector3::operator-=(const Vector3& rhs) {
     x -= rhs.x; y -= rhs.y; z -= rhs.z; return *this;
 }
 
-inline Vector3 Vector3::operator*(const float a) const {
+constexpr Vector3 Vector3::operator*(const float a) const {
     return Vector3(x*a, y*a, z*a);
 }
 
-inline Vector3 Vector3::operator*(const Vector3& rhs) const {
+constexpr Vector3 Vector3::operator*(const Vector3& rhs) const {
     return Vector3(x*rhs.x, y*rhs.y, z*rhs.z);
 }
 
-inline Vector3& Vector3::operator*=(const float a) {
+constexpr Vector3& Vector3::operator*=(const float a) {
     x *= a; y *= a; z *= a; return *this;
 }
 
-inline Vector3& Vector3::operator*=(const Vector3& rhs) {
+constexpr Vector3& Vector3::operator*=(const Vector3& rhs) {
     x *= rhs.x; y *= rhs.y; z *= rhs.z; return *this;
 }
 
-inline Vector3 Vector3::operator/(const float a) const {
+constexpr Vector3 Vector3::operator/(const float a) const {
     return Vector3(x/a, y/a, z/a);
 }
 
-inline Vector3& Vector3::operator/=(const float a) {
+constexpr Vector3& Vector3::operator/=(const float a) {
     x /= a; y /= a; z /= a; return *this;
 }
 
-inline bool Vector3::operator==(const Vector3& rhs) const {
+constexpr bool Vector3::operator==(const Vector3& rhs) const {
     return (x == rhs.x) && (y == rhs.y) && (z == rhs.z);
 }
 
-inline bool Vector3::operator!=(const Vector3& rhs) const {
+constexpr bool Vector3::operator!=(const Vector3& rhs) const {
     return (x != rhs.x) || (y != rhs.y) || (z != rhs.z);
 }
 
-inline bool Vector3::operator<(const Vector3& rhs) const {
+constexpr bool Vector3::operator<(const Vector3& rhs) const {
     if(x < rhs.x) return true;
     if(x > rhs.x) return false;
     if(y < rhs.y) return true;
@@ -357,7 +388,7 @@ inline float& Vector3::operator[](int index) {
     return (&x)[index];
 }
 
-inline Vector3& Vector3::set(float x, float y, float z) {
+constexpr Vector3& Vector3::set(float x, float y, float z) {
     this->x = x; this->y = y; this->z = z; return *this;
 }
 
@@ -392,11 +423,23 @@ inline Vector3& Vector3::normalize() {
     return *this;
 }
 
-inline float Vector3::dot(const Vector3& rhs) const {
+inline float Vector3::invLengthFast() const {
+    return invSqrtFast(x*x + y*y + z*z);
+}
+
+inline Vector3& Vector3::normalizeFast() {
+    float invLength = invSqrtFast(x*x + y*y + z*z);
+    x *= invLength;
+    y *= invLength;
+    z *= invLength;
+    return *this;
+}
+
+constexpr float Vector3::dot(const Vector3& rhs) const {
     return (x*rhs.x + y*rhs.y + z*rhs.z);
 }
 
-inline Vector3 Vector3::cross(const Vector3& rhs) const {
+constexpr Vector3 Vector3::cross(const Vector3& rhs) const {
     return Vector3(y*rhs.z - z*rhs.y, z*rhs.x - x*rhs.z, x*rhs.y - y*rhs.x);
 }
 
@@ -404,7 +447,7 @@ inline bool Vector3::equal(const Vector3& rhs, float epsilon) const {
     return fabs(x - rhs.x) < epsilon && fabs(y - rhs.y) < epsilon && fabs(z - rhs.z) < epsilon;
 }
 
-inline Vector3 operator*(const float a, const Vector3 vec) {
+constexpr Vector3 operator*(const float a, const Vector3 vec) {
     return Vector3(a*vec.x, a*vec.y, a*vec.z);
 }
 
@@ -419,59 +462,59 @@ inline std::ostream& operator<<(std::ostream& os, const Vector3& vec) {
 ///////////////////////////////////////////////////////////////////////////////
 // inline functions for Vector4
 ///////////////////////////////////////////////////////////////////////////////
-inline Vector4 Vector4::operator-() const {
+constexpr Vector4 Vector4::operator-() const {
     return Vector4(-x, -y, -z, -w);
 }
 
-inline Vector4 Vector4::operator+(const Vector4& rhs) const {
+constexpr Vector4 Vector4::operator+(const Vector4& rhs) const {
     return Vector4(x+rhs.x, y+rhs.y, z+rhs.z, w+rhs.w);
 }
 
-inline Vector4 Vector4::operator-(const Vector4& rhs) const {
+constexpr Vector4 Vector4::operator-(const Vector4& rhs) const {
     return Vector4(x-rhs.x, y-rhs.y, z-rhs.z, w-rhs.w);
 }
 
-inline Vector4& Vector4::operator+=(const Vector4& rhs) {
+constexpr Vector4& Vector4::operator+=(const Vector4& rhs) {
     x += rhs.x; y += rhs.y; z += rhs.z; w += rhs.w; return *this;
 }
 
-inline Vector4& Vector4::operator-=(const Vector4& rhs) {
+constexpr Vector4& Vector4::operator-=(const Vector4& rhs) {
     x -= rhs.x; y -= rhs.y; z -= rhs.z; w -= rhs.w; return *this;
 }
 
-inline Vector4 Vector4::operator*(const float a) const {
+constexpr Vector4 Vector4::operator*(const float a) const {
     return Vector4(x*a, y*a, z*a, w*a);
 }
 
-inline Vector4 Vector4::operator*(const Vector4& rhs) const {
+constexpr Vector4 Vector4::operator*(const Vector4& rhs) const {
     return Vector4(x*rhs.x, y*rhs.y, z*rhs.z, w*rhs.w);
 }
 
-inline Vector4& Vector4::operator*=(const float a) {
+constexpr Vector4& Vector4::operator*=(const float a) {
     x *= a; y *= a; z *= a; w *= a; return *this;
 }
 
-inline Vector4& Vector4::operator*=(const Vector4& rhs) {
+constexpr Vector4& Vector4::operator*=(const Vector4& rhs) {
     x *= rhs.x; y *= rhs.y; z *= rhs.z; w *= rhs.w; return *this;
 }
 
-inline Vector4 Vector4::operator/(const float a) const {
+constexpr Vector4 Vector4::operator/(const float a) const {
     return Vector4(x/a, y/a, z/a, w/a);
 }
 
-inline Vector4& Vector4::operator/=(const float a) {
+constexpr Vector4& Vector4::operator/=(const float a) {
     x /= a; y /= a; z /= a; w /= a; return *this;
 }
 
-inline bool Vector4::operator==(const Vector4& rhs) const {
+constexpr bool Vector4::operator==(const Vector4& rhs) const {
     return (x == rhs.x) && (y == rhs.y) && (z == rhs.z) && (w == rhs.w);
 }
 
-inline bool Vector4::operator!=(const Vector4& rhs) const {
+constexpr bool Vector4::operator!=(const Vector4& rhs) const {
     return (x != rhs.x) || (y != rhs.y) || (z != rhs.z) || (w != rhs.w);
 }
 
-inline bool Vector4::operator<(const Vector4& rhs) const {
+constexpr bool Vector4::operator<(const Vector4& rhs) const {
     if(x < rhs.x) return true;
     if(x > rhs.x) return false;
     if(y < rhs.y) return true;
@@ -491,7 +534,7 @@ inline float& Vector4::operator[](int index) {
     return (&x)[index];
 }
 
-inline Vector4& Vector4::set(float x, float y, float z, float w) {
+constexpr Vector4& Vector4::set(float x, float y, float z, float w) {
     this->x = x; this->y = y; this->z = z; this->w = w; return *this;
 }
 
@@ -518,7 +561,20 @@ inline Vector4& Vector4::normalize() {
     return *this;
 }
 
-inline float Vector4::dot(const Vector4& rhs) const {
+inline float Vector4::invLengthFast() const {
+    return invSqrtFast(x*x + y*y + z*z + w*w);
+}
+
+inline Vector4& Vector4::normalizeFast() {
+    //NOTE: leave w-component untouched
+    float invLength = invSqrtFast(x*x + y*y + z*z);
+    x *= invLength;
+    y *= invLength;
+    z *= invLength;
+    return *this;
+}
+
+constexpr float Vector4::dot(const Vector4& rhs) const {
     return (x*rhs.x + y*rhs.y + z*rhs.z + w*rhs.w);
 }
 
@@ -527,7 +583,7 @@ inline bool Vector4::equal(const Vector4& rhs, float epsilon) const {
            fabs(z - rhs.z) < epsilon && fabs(w - rhs.w) < epsilon;
 }
 
-inline Vector4 operator*(const float a, const Vector4 vec) {
+constexpr Vector4 operator*(const float a, const Vector4 vec) {
     return Vector4(a*vec.x, a*vec.y, a*vec.z, a*vec.w);
 }
 
@@ -17,11 +17,14 @@
 #include <iomanip>
 #include <fstream>
 #include "Matrices.h"
-#include "Bmp.h"
+#include "Quaternion.h"
+#include "Frustum.h"
+#include "TransformHierarchy.h"
 #include "BitmapFontData.h"     // to draw bitmap font with GLFW
 #include "fontCourier20.h"      // font:courier new, height:20px
 #include "Timer.h"
 #include "Sphere.h"
+#include "TextureLoader.h"
 
 // glfw callbacks
 void errorCallback(int error, const char* description);
@@ -41,7 +44,6 @@ bool initGLSL();
 void initVBO();
 bool initSharedMem();
 void clearSharedMem();
-GLuint loadTexture(const char* fileName, bool wrap=true);
 void showInfo();
 void showFPS();
 
@@ -125,6 +127,11 @@ const int   WINDOW_WIDTH    = 1500;
 const int   WINDOW_HEIGHT   = 500;
 const float CAMERA_DISTANCE = 4.0f;
 
+// fixed offsets of left and right spheres, built at compile-time
+constexpr Matrix4 MATRIX_SHIFT_LEFT  = Matrix4().translate(-2.5f, 0, 0);
+constexpr Matrix4 MATRIX_SHIFT_RIGHT = Matrix4().translate( 2.5f, 0, 0);
+static_assert(MATRIX_SHIFT_LEFT[12] == -2.5f && MATRIX_SHIFT_RIGHT[12] == 2.5f, "sphere offsets must be folded at compile-time");
+
 
 // global variables
 GLFWwindow* window;
@@ -140,11 +147,16 @@ double mouseX, mouseY;
 float cameraAngleX;
 float cameraAngleY;
 float cameraDistance;
+bool cameraRotated;         // true if camera angles changed since last frame
+TransformHierarchy sceneNodes;
+int nodeOrbits[3];          // left, center, right sphere nodes (child of offset)
 int drawMode;
 GLuint vaoId1, vaoId2;      // IDs of VAO for vertex array states
 GLuint vboId1, vboId2;      // IDs of VBO for vertex arrays
 GLuint iboId1, iboId2;      // IDs of VBO for index array
-GLuint texId;
+Image::TextureCache textureCache;   // decoded mipmaps, kept in textureCache/ for next runs
+TextureLoader textureLoader;    // decodes BMP in threads, uploads in preFrame()
+int texHandle;
 BitmapFontData bmFont;
 Matrix4 matrixModelView;
 Matrix4 matrixProjection;
@@ -234,16 +246,17 @@ int main(int argc, char **argv)
     glfwSetCursorPosCallback(window, cursorPosCallback);
     glfwSetErrorCallback(errorCallback);
 
-    // load BMP image
-    texId = loadTexture("earth2048.bmp", true);
-    if(texId)
-    {
-        std::cout << "Loaded a texture: ID=" << texId << std::endl;
-    }
-    else
-    {
-        std::cout << "[ERROR] Failed to load a texture" << std::endl;
-    }
+    // queue BMP image, a gray placeholder is used until it is uploaded
+    // BC1 takes 1/6 of the video memory of RGB8
+    textureLoader.setCompression(true);
+    // larger images than the GPU supports are downscaled, lower the limit (or
+    // add a byte limit per texture) for devices with less video memory
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    textureLoader.setSizeLimit(maxTextureSize);
+    if(textureCache.setDirectory("textureCache"))
+        textureLoader.setCache(&textureCache);
+    texHandle = textureLoader.load("earth2048.bmp", true);
 
     // init projection matrix
     toPerspective();
@@ -489,13 +502,20 @@ bool initSharedMem()
 
     cameraAngleX = cameraAngleY = 0.0f;
     cameraDistance = CAMERA_DISTANCE;
+    cameraRotated = true;
+
+    // each sphere orbits at its fixed offset: world = offset * orbit
+    const Matrix4 offsets[3] = { MATRIX_SHIFT_LEFT, Matrix4(), MATRIX_SHIFT_RIGHT };
+    sceneNodes.clear();
+    for(int i = 0; i < 3; ++i)
+        nodeOrbits[i] = sceneNodes.addNode(sceneNodes.addNode(TransformHierarchy::NONE, offsets[i]));
 
     drawMode = 0; // 0:fill, 1: wireframe, 2:points
 
     vaoId1 = vaoId2 = 0;
     vboId1 = vboId2 = 0;
     iboId1 = iboId2 = 0;
-    texId = 0;
+    texHandle = -1;
 
     // debug
     sphere2.printSelf();
@@ -524,65 +544,8 @@ void clearSharedMem()
     vaoId1 = vaoId2 = 0;
 
     // clean up tex
-    glDeleteTextures(1, &texId);
-    texId = 0;
-}
-
-
-
-///////////////////////////////////////////////////////////////////////////////
-// load raw image as a texture
-///////////////////////////////////////////////////////////////////////////////
-GLuint loadTexture(const char* fileName, bool wrap)
-{
-    Image::Bmp bmp;
-    if(!bmp.read(fileName))
-        return 0;     // exit if failed load image
-
-    // get bmp info
-    int width = bmp.getWidth();
-    int height = bmp.getHeight();
-    const unsigned char* data = bmp.getDataRGB();
-    GLenum type = GL_UNSIGNED_BYTE;    // only allow BMP with 8-bit per channel
-
-    // We assume the image is 8-bit, 24-bit or 32-bit BMP
-    GLenum format;
-    int bpp = bmp.getBitCount();
-    if(bpp == 8)
-        format = GL_LUMINANCE;
-    else if(bpp == 24)
-        format = GL_RGB;
-    else if(bpp == 32)
-        format = GL_RGBA;
-    else
-        return 0;               // NOT supported, exit
-
-    // gen texture ID
-    GLuint texture;
-    glGenTextures(1, &texture);
-
-    // set active texture and configure it
-    glBindTexture(GL_TEXTURE_2D, texture);
-
-    // select modulate to mix texture with color for shading
-    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    //glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
-
-    // if wrap is true, the texture wraps over at the edges (repeat)
-    //       ... false, the texture ends at the edges (clamp)
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap ? GL_REPEAT : GL_CLAMP);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap ? GL_REPEAT : GL_CLAMP);
-    //glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    //glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    // copy texture data
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, type, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    return texture;
+    textureLoader.clear();
+    texHandle = -1;
 }
 
 
@@ -738,6 +701,15 @@ void toPerspective()
 ///////////////////////////////////////////////////////////////////////////////
 void preFrame(double frameTime)
 {
+    // upload decoded textures within the per-frame budget
+    if(textureLoader.update() > 0)
+    {
+        if(textureLoader.getState(texHandle) == TextureLoader::STATE_READY)
+            std::cout << "Loaded a texture: ID=" << textureLoader.getTexture(texHandle)
+                      << (textureCache.getDiskHitCount() > 0 ? " (cached)" : "") << std::endl;
+        else if(textureLoader.getState(texHandle) == TextureLoader::STATE_FAILED)
+            std::cout << "[ERROR] Failed to load a texture: " << textureLoader.getError(texHandle) << std::endl;
+    }
 }
 
 void frame(double frameTime)
@@ -749,76 +721,90 @@ void frame(double frameTime)
     Matrix4 matrixView;
     matrixView.translate(0, 0, -cameraDistance);
 
-    // common model matrix
-    Matrix4 matrixModelCommon;
-    matrixModelCommon.rotateY(cameraAngleY);
-    matrixModelCommon.rotateX(cameraAngleX);
+    // common model matrix, same as rotateY(cameraAngleY) then rotateX(cameraAngleX)
+    // only if the camera is rotated, otherwise the world matrices are reused
+    if(cameraRotated)
+    {
+        Quaternion orbit = Quaternion(Vector3(1, 0, 0), cameraAngleX) * Quaternion(Vector3(0, 1, 0), cameraAngleY);
+        Matrix4 matrixModelCommon = orbit.getMatrix();
+        for(int i = 0; i < 3; ++i)
+            sceneNodes.setLocal(nodeOrbits[i], matrixModelCommon);
+        cameraRotated = false;
+    }
+    sceneNodes.update();
 
     // model matrix for each instance
-    Matrix4 matrixModel1(matrixModelCommon);    // left
-    Matrix4 matrixModel2(matrixModelCommon);    // center
-    Matrix4 matrixModel3(matrixModelCommon);    // right
-    matrixModel1.translate(-2.5f, 0, 0);        // shift left
-    matrixModel3.translate(2.5f, 0, 0);         // shift right
+    const Matrix4& matrixModel1 = sceneNodes.getWorld(nodeOrbits[0]);  // left
+    const Matrix4& matrixModel2 = sceneNodes.getWorld(nodeOrbits[1]);  // center
+    const Matrix4& matrixModel3 = sceneNodes.getWorld(nodeOrbits[2]);  // right
 
     // bind GLSL, texture
     glUseProgram(progId);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texId);
+    glBindTexture(GL_TEXTURE_2D, textureLoader.getTexture(texHandle));
+
+    Matrix4 matrixModelViewProjection;
+    Matrix4 matrixNormal;
 
-    // set model matrix uniforms for left sphere
-    matrixModelView = matrixView * matrixModel1;
-    Matrix4 matrixModelViewProjection = matrixProjection * matrixModelView;
-    Matrix4 matrixNormal = matrixModelView;
-    matrixNormal.setColumn(3, Vector4(0,0,0,1));
-    glUniformMatrix4fv(uniformMatrixModelView, 1, false, matrixModelView.get());
-    glUniformMatrix4fv(uniformMatrixModelViewProjection, 1, false, matrixModelViewProjection.get());
-    glUniformMatrix4fv(uniformMatrixNormal, 1, false, matrixNormal.get());
+    // skip the spheres outside of the view frustum (world space)
+    Frustum frustum(matrixProjection * matrixView);
 
     // left and center spheres do not use texture
     glUniform1i(uniformTextureUsed, 0);
 
-    // draw left sphere
-    glBindVertexArray(vaoId1);
-    glDrawElements(GL_TRIANGLES,            // primitive type
-                   sphere1.getIndexCount(), // # of indices
-                   GL_UNSIGNED_INT,         // data type
-                   (void*)0);               // ptr to indices
-
-    // set matrix uniforms for center sphere
-    matrixModelView = matrixView * matrixModel2;
-    matrixModelViewProjection = matrixProjection * matrixModelView;
-    matrixNormal = matrixModelView;
-    matrixNormal.setColumn(3, Vector4(0,0,0,1));
-    glUniformMatrix4fv(uniformMatrixModelView, 1, false, matrixModelView.get());
-    glUniformMatrix4fv(uniformMatrixModelViewProjection, 1, false, matrixModelViewProjection.get());
-    glUniformMatrix4fv(uniformMatrixNormal, 1, false, matrixNormal.get());
-
-    // draw center sphere
-    glBindVertexArray(vaoId2);
-    glDrawElements(GL_TRIANGLES,            // primitive type
-                   sphere2.getIndexCount(), // # of indices
-                   GL_UNSIGNED_INT,         // data type
-                   (void*)0);               // ptr to indices
-
-    // set matric uniforms for right sphere
-    matrixModelView = matrixView * matrixModel3;
-    matrixModelViewProjection = matrixProjection * matrixModelView;
-    matrixNormal = matrixModelView;
-    matrixNormal.setColumn(3, Vector4(0,0,0,1));
-    glUniformMatrix4fv(uniformMatrixModelView, 1, false, matrixModelView.get());
-    glUniformMatrix4fv(uniformMatrixModelViewProjection, 1, false, matrixModelViewProjection.get());
-    glUniformMatrix4fv(uniformMatrixNormal, 1, false, matrixNormal.get());
-
-    // right sphere is rendered with texture
-    glUniform1i(uniformTextureUsed, 1);
+    if(frustum.intersectsSphere(Vector3(matrixModel1[12], matrixModel1[13], matrixModel1[14]), sphere1.getRadius()))
+    {
+        // set model matrix uniforms for left sphere
+        Matrix4::computeMVPandNormal(matrixProjection, matrixView, matrixModel1,
+                                     matrixModelView, matrixModelViewProjection, matrixNormal);
+        glUniformMatrix4fv(uniformMatrixModelView, 1, false, matrixModelView.get());
+        glUniformMatrix4fv(uniformMatrixModelViewProjection, 1, false, matrixModelViewProjection.get());
+        glUniformMatrix4fv(uniformMatrixNormal, 1, false, matrixNormal.get());
+
+        // draw left sphere
+        glBindVertexArray(vaoId1);
+        glDrawElements(GL_TRIANGLES,            // primitive type
+                       sphere1.getIndexCount(), // # of indices
+                       GL_UNSIGNED_INT,         // data type
+                       (void*)0);               // ptr to indices
+    }
 
-    // draw right sphere
-    glBindVertexArray(vaoId2);
-    glDrawElements(GL_TRIANGLES,            // primitive type
-                   sphere2.getIndexCount(), // # of indices
-                   GL_UNSIGNED_INT,         // data type
-                   (void*)0);               // ptr to indices
+    if(frustum.intersectsSphere(Vector3(matrixModel2[12], matrixModel2[13], matrixModel2[14]), sphere2.getRadius()))
+    {
+        // set matrix uniforms for center sphere
+        Matrix4::computeMVPandNormal(matrixProjection, matrixView, matrixModel2,
+                                     matrixModelView, matrixModelViewProjection, matrixNormal);
+        glUniformMatrix4fv(uniformMatrixModelView, 1, false, matrixModelView.get());
+        glUniformMatrix4fv(uniformMatrixModelViewProjection, 1, false, matrixModelViewProjection.get());
+        glUniformMatrix4fv(uniformMatrixNormal, 1, false, matrixNormal.get());
+
+        // draw center sphere
+        glBindVertexArray(vaoId2);
+        glDrawElements(GL_TRIANGLES,            // primitive type
+                       sphere2.getIndexCount(), // # of indices
+                       GL_UNSIGNED_INT,         // data type
+                       (void*)0);               // ptr to indices
+    }
+
+    if(frustum.intersectsSphere(Vector3(matrixModel3[12], matrixModel3[13], matrixModel3[14]), sphere2.getRadius()))
+    {
+        // set matric uniforms for right sphere
+        Matrix4::computeMVPandNormal(matrixProjection, matrixView, matrixModel3,
+                                     matrixModelView, matrixModelViewProjection, matrixNormal);
+        glUniformMatrix4fv(uniformMatrixModelView, 1, false, matrixModelView.get());
+        glUniformMatrix4fv(uniformMatrixModelViewProjection, 1, false, matrixModelViewProjection.get());
+        glUniformMatrix4fv(uniformMatrixNormal, 1, false, matrixNormal.get());
+
+        // right sphere is rendered with texture
+        glUniform1i(uniformTextureUsed, 1);
+
+        // draw right sphere
+        glBindVertexArray(vaoId2);
+        glDrawElements(GL_TRIANGLES,            // primitive type
+                       sphere2.getIndexCount(), // # of indices
+                       GL_UNSIGNED_INT,         // data type
+                       (void*)0);               // ptr to indices
+    }
 
     // unbind
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -938,6 +924,7 @@ void cursorPosCallback(GLFWwindow* window, double x, double y)
     {
         cameraAngleY += (x - mouseX);
         cameraAngleX += (y - mouseY);
+        cameraRotated = true;
         mouseX = x;
         mouseY = y;
     }